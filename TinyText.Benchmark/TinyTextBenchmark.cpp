@@ -0,0 +1,851 @@
+/*=================================================================================
+
+    PROJECT:        Tiny Text Library for DirectX 10
+
+    DESCRIPTION:    Measures the speed of the text encoder, without a GPU. Text is
+                    encoded into a plain block of memory in place of the mapped
+                    vertex buffer, so this builds and runs on any platform
+
+    USAGE:          TinyText.Benchmark [options] [seconds per case]
+
+                    - Each case encodes frames of text until the time is up.
+                      With '--replay <capture file>', the frames recorded by
+                      'TinyTextContext_c::BeginCapture' are also encoded,
+                      repeatedly and without pacing. Each case reports:
+
+                        - characters/s: characters passed to 'Print'
+                        - glyphs/s: characters that were encoded as quads
+                        - bytes/glyph: vertex data written per encoded glyph
+                        - bytes/char: vertex data written per character passed
+                          to 'Print' (blank characters cost nothing)
+                        - dropped: characters that didn't fit in the buffer
+                        - allocs/frame: heap allocations made while encoding
+
+                    - The encoder is given enough capacity for the largest frame
+                      in a replayed capture
+
+                    - '--write-baseline <file>' saves glyphs/s, bytes/glyph and
+                      allocs/frame for each case. '--baseline <file>' compares
+                      the results with a saved baseline and exits with 1 if any
+                      of them is worse by more than '--threshold <percent>'
+                      (10% by default) - so a build of the library can be
+                      checked against the one it replaces. Cases in the
+                      baseline that aren't run (such as the replay, without
+                      '--replay') also fail the check. Each case is run
+                      three times and the fastest is kept. Baselines are only
+                      comparable on the same machine
+
+                    - Build an optimised binary before comparing results. See
+                      README.md for how to build it with g++
+
+=================================================================================*/
+
+/*---------------------------------------------------------------------------------
+    Includes
+---------------------------------------------------------------------------------*/
+#include "../TinyText.Core/TinyTextEncoder.h"
+#include "../TinyText.Core/TinyTextCapture.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <new>
+#if defined( _WIN32 )
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+/*---------------------------------------------------------------------------------
+    Constants
+---------------------------------------------------------------------------------*/
+//namespace
+//{
+    // Time spent on each case, unless overridden on the command line
+    const double        DefaultSecondsPerCase   = 0.5;
+
+    // Size of the viewport that text is encoded for
+    const float         ViewportWidth           = 1920.0f;
+    const float         ViewportHeight          = 1080.0f;
+
+    // Text that each case's strings are cut from - debug overlay text, with the mix
+    // of words, numbers and spaces that implies
+    const char          SampleText[]            = "Frame 18422  CPU 6.81 ms  GPU 12.40 ms  Draws 1934  Triangles 2.41M  Textures 312 MB  Buffers 96 MB  Entities 8120 visible of 21544  Shadow cascades 4  Lights 61 (9 shadowed)  Particles 45210  Streaming 12 requests pending  ";
+
+    // Capacity (in characters) of the encoder in all but the capacity pressure cases
+    const size_t        DefaultCapacity         = 65536;
+
+    // How far (as a percentage) a result may be worse than its baseline, unless
+    // overridden on the command line
+    const double        DefaultThreshold        = 10.0;
+
+    // Number of times each case is run when its result is compared with, or saved
+    // as, a baseline - the fastest run is kept, to reduce noise
+    const int           BaselineRunCount        = 3;
+
+    // Limits on the contents of a baseline file
+    const size_t        MaxBaselineEntries      = 64;
+    const size_t        MaxCaseNameLength       = 64;
+
+    // Name of the replay case in the results and in baseline files
+    const char          ReplayCaseName[]        = "replay";
+//}
+
+/*---------------------------------------------------------------------------------
+    Private Implementation
+---------------------------------------------------------------------------------*/
+//namespace
+//{
+    /*---------------------------------------------------------------------------------
+        BenchmarkCase_s
+        Describes a single benchmark
+    ---------------------------------------------------------------------------------*/
+    struct BenchmarkCase_s
+    {
+        const char * name;
+        size_t characterCount;      // Length of the string passed to each 'Print'
+        size_t printsPerFrame;      // Number of calls to 'Print' between 'Begin' and 'End'
+        size_t capacity;            // Capacity of the encoder, in characters
+        int wrapWidth;              // Width to wrap formatted text to - negative for unformatted text
+        bool varyColour;            // Whether each 'Print' uses a different colour
+    };
+
+    // The cases that are run, covering string length, formatting, colour and
+    // capacity pressure
+    const BenchmarkCase_s BenchmarkCases[] =
+    {
+        { "plain, 8 chars",                 8,      2048,   DefaultCapacity,    -1,     false },
+        { "plain, 32 chars",                32,     1024,   DefaultCapacity,    -1,     false },
+        { "plain, 128 chars",               128,    256,    DefaultCapacity,    -1,     false },
+        { "plain, 240 chars (full line)",   240,    64,     DefaultCapacity,    -1,     false },
+        { "plain, 32 chars, colours",       32,     1024,   DefaultCapacity,    -1,     true  },
+        { "formatted, 32 chars",            32,     1024,   DefaultCapacity,    0,      false },
+        { "formatted, 1024 chars, wrapped", 1024,   32,     DefaultCapacity,    640,    false },
+        { "plain, 128 chars, 2x capacity",  128,    256,    16384,              -1,     false },
+        { "plain, 128 chars, 4x capacity",  128,    256,    8192,               -1,     false },
+        { "formatted, 1024 chars, 4x capacity", 1024, 32,   8192,               640,    false },
+    };
+
+    const size_t BenchmarkCaseCount = sizeof( BenchmarkCases ) / sizeof( BenchmarkCases[ 0 ] );
+
+    /*---------------------------------------------------------------------------------
+        BenchmarkResult_s
+        The totals accumulated while running a benchmark
+    ---------------------------------------------------------------------------------*/
+    struct BenchmarkResult_s
+    {
+        double seconds;
+        double frames;
+        double characters;
+        double glyphs;
+        double bytes;
+        double dropped;
+        double allocations;
+    };
+
+    /*---------------------------------------------------------------------------------
+        BaselineEntry_s
+        The saved result of one case
+    ---------------------------------------------------------------------------------*/
+    struct BaselineEntry_s
+    {
+        char name[ MaxCaseNameLength ];
+        double glyphsPerSecond;
+        double bytesPerGlyph;
+        double allocationsPerFrame;
+    };
+
+    // Number of heap allocations made by the process so far
+    size_t AllocationCount = 0;
+
+    /*---------------------------------------------------------------------------------
+        GetSeconds
+        Returns the time, in seconds, from an arbitrary starting point
+    ---------------------------------------------------------------------------------*/
+    double GetSeconds( )
+    {
+    #if defined( _WIN32 )
+        LARGE_INTEGER frequency;
+        LARGE_INTEGER counter;
+        QueryPerformanceFrequency( &frequency );
+        QueryPerformanceCounter( &counter );
+        return double( counter.QuadPart ) / double( frequency.QuadPart );
+    #else
+        timespec time;
+        clock_gettime( CLOCK_MONOTONIC, &time );
+        return double( time.tv_sec ) + double( time.tv_nsec ) * 1.0e-9;
+    #endif
+    }
+
+    /*---------------------------------------------------------------------------------
+        MakeText
+        Returns a string of the specified length, cut from 'SampleText'. The caller
+        must free the string
+    ---------------------------------------------------------------------------------*/
+    char * MakeText( size_t characterCount )
+    {
+        char * text = ( char * ) malloc( characterCount + 1 );
+        if ( !text )
+        {
+            return 0;
+        }
+
+        const size_t sampleLength = sizeof( SampleText ) - 1;
+
+        for ( size_t i = 0; i < characterCount; ++i )
+        {
+            text[ i ] = SampleText[ i % sampleLength ];
+        }
+
+        text[ characterCount ] = '\0';
+        return text;
+    }
+
+    /*---------------------------------------------------------------------------------
+        AddFrame
+        Adds the work done by the encoder since 'Begin' to a result
+    ---------------------------------------------------------------------------------*/
+    void AddFrame( const TinyTextEncoder_c & encoder, size_t characterCount, BenchmarkResult_s * result )
+    {
+        result->frames += 1.0;
+        result->characters += double( characterCount );
+        result->glyphs += double( encoder.GetNumVertices( ) / TinyTextEncoder_c::NumVerticesPerCharacter );
+        result->bytes += double( encoder.GetNumVertices( ) ) * ( TinyTextEncoder_c::NumVertexElementsPerCharacter / TinyTextEncoder_c::NumVerticesPerCharacter ) * sizeof( unsigned int );
+        result->dropped += double( encoder.GetNumDroppedCharacters( ) );
+    }
+
+    /*---------------------------------------------------------------------------------
+        PrintResult
+        Prints a row of the results table
+    ---------------------------------------------------------------------------------*/
+    void PrintResult( const char * name, const BenchmarkResult_s & result )
+    {
+        printf( "%-36s %12.1f %12.1f %12.1f %11.1f %8.1f%% %13.2f\n",
+                name,
+                result.characters / result.seconds * 1.0e-6,
+                result.glyphs / result.seconds * 1.0e-6,
+                result.glyphs ? result.bytes / result.glyphs : 0.0,
+                result.characters ? result.bytes / result.characters : 0.0,
+                result.characters ? result.dropped / result.characters * 100.0 : 0.0,
+                result.frames ? result.allocations / result.frames : 0.0 );
+    }
+
+    /*---------------------------------------------------------------------------------
+        PrintHeader
+        Prints the heading of the results table
+    ---------------------------------------------------------------------------------*/
+    void PrintHeader( )
+    {
+        printf( "%-36s %12s %12s %12s %11s %9s %13s\n", "case", "Mchars/s", "Mglyphs/s", "bytes/glyph", "bytes/char", "dropped", "allocs/frame" );
+    }
+
+    /*---------------------------------------------------------------------------------
+        RunBenchmark
+        Encodes frames of text for (at least) the specified time. Returns 'false' if
+        memory couldn't be allocated
+    ---------------------------------------------------------------------------------*/
+    bool RunBenchmark( const BenchmarkCase_s & benchmark, double seconds, BenchmarkResult_s * result )
+    {
+        TinyTextEncoder_c encoder;
+        if ( !encoder.Initialise( benchmark.capacity ) )
+        {
+            return false;
+        }
+
+        unsigned int * vertices = new unsigned int[ benchmark.capacity * TinyTextEncoder_c::NumVertexElementsPerCharacter ];
+        char * text = MakeText( benchmark.characterCount );
+        if ( !text )
+        {
+            delete [] vertices;
+            return false;
+        }
+
+        TinyTextFormat_c format( benchmark.wrapWidth > 0 ? benchmark.wrapWidth : 0 );
+
+        memset( result, 0, sizeof( BenchmarkResult_s ) );
+
+        // Each line of text gets its own row, so that none are culled
+        const int rowCount = int( ViewportHeight ) / TinyTextEncoder_c::LineHeight;
+
+        size_t allocationCount = AllocationCount;
+        double start = GetSeconds( );
+        double elapsed = 0.0;
+
+        while ( elapsed < seconds )
+        {
+            encoder.Begin( vertices );
+
+            for ( size_t i = 0; i < benchmark.printsPerFrame; ++i )
+            {
+                int y = int( i % rowCount ) * TinyTextEncoder_c::LineHeight;
+                unsigned int colour = benchmark.varyColour ? 0xFF000000 | ( ( unsigned int ) i * 0x00452301 ) : 0xFFFFFFFF;
+
+                if ( benchmark.wrapWidth < 0 )
+                {
+                    encoder.Print( ViewportWidth, ViewportHeight, benchmark.characterCount, text, 0, y, colour );
+                }
+                else
+                {
+                    encoder.Print( ViewportWidth, ViewportHeight, format, benchmark.characterCount, text, 0, y, colour );
+                }
+            }
+
+            encoder.End( );
+            AddFrame( encoder, benchmark.characterCount * benchmark.printsPerFrame, result );
+
+            elapsed = GetSeconds( ) - start;
+        }
+
+        result->seconds = elapsed;
+        result->allocations = double( AllocationCount - allocationCount );
+
+        free( text );
+        delete [] vertices;
+        return true;
+    }
+
+    /*---------------------------------------------------------------------------------
+        GetLargestCaptureFrame
+        Returns the most characters printed in any frame of a capture. Returns 'false'
+        if the capture is corrupt
+    ---------------------------------------------------------------------------------*/
+    bool GetLargestCaptureFrame( TinyTextCaptureReader_c & reader, size_t * largestFrame )
+    {
+        TinyTextCaptureReader_c::Print_s print;
+        size_t frame = 0;
+
+        *largestFrame = 0;
+        reader.Rewind( );
+
+        for ( ;; )
+        {
+            TinyTextCaptureReader_c::RecordType type = reader.Read( &print );
+
+            if ( type == TinyTextCaptureReader_c::RecordPrint )
+            {
+                frame += print.characterCount;
+                continue;
+            }
+
+            if ( frame > *largestFrame )
+            {
+                *largestFrame = frame;
+            }
+
+            frame = 0;
+
+            if ( type == TinyTextCaptureReader_c::RecordEnd )
+            {
+                return true;
+            }
+
+            if ( type == TinyTextCaptureReader_c::RecordInvalid )
+            {
+                return false;
+            }
+        }
+    }
+
+    /*---------------------------------------------------------------------------------
+        RunReplay
+        Encodes the frames of a capture, over and over, for (at least) the specified
+        time. Returns 'false' if memory couldn't be allocated
+    ---------------------------------------------------------------------------------*/
+    bool RunReplay( TinyTextCaptureReader_c & reader, size_t capacity, double seconds, BenchmarkResult_s * result )
+    {
+        TinyTextEncoder_c encoder;
+        if ( !encoder.Initialise( capacity ) )
+        {
+            return false;
+        }
+
+        unsigned int * vertices = new unsigned int[ capacity * TinyTextEncoder_c::NumVertexElementsPerCharacter ];
+        TinyTextCaptureReader_c::Print_s print;
+
+        // The character map and scale that the encoder was last set to
+        const unsigned char * characterMap = 0;
+        bool utf8 = false;
+
+        memset( result, 0, sizeof( BenchmarkResult_s ) );
+
+        size_t allocationCount = AllocationCount;
+        double start = GetSeconds( );
+        double elapsed = 0.0;
+
+        while ( elapsed < seconds )
+        {
+            reader.Rewind( );
+
+            size_t characterCount = 0;
+            encoder.Begin( vertices );
+
+            for ( ;; )
+            {
+                TinyTextCaptureReader_c::RecordType type = reader.Read( &print );
+
+                if ( type == TinyTextCaptureReader_c::RecordPrint )
+                {
+                    if ( print.characterMap != characterMap || print.utf8 != utf8 )
+                    {
+                        if ( print.utf8 )
+                        {
+                            encoder.SetCodePage( TinyTextEncoder_c::CodePageUTF8 );
+                        }
+                        else if ( print.characterMap )
+                        {
+                            encoder.SetCharacterMap( print.characterMap );
+                        }
+                        else
+                        {
+                            encoder.SetCodePage( TinyTextEncoder_c::CodePageWindows1252 );
+                        }
+
+                        characterMap = print.characterMap;
+                        utf8 = print.utf8;
+                    }
+
+                    if ( print.fontScale != encoder.GetFontScale( ) )
+                    {
+                        encoder.SetFontScale( print.fontScale );
+                    }
+
+                    if ( print.formatted )
+                    {
+                        encoder.Print( print.viewportWidth, print.viewportHeight, print.format, print.characterCount, print.text, print.x, print.y, print.colour );
+                    }
+                    else
+                    {
+                        encoder.Print( print.viewportWidth, print.viewportHeight, print.characterCount, print.text, print.x, print.y, print.colour );
+                    }
+
+                    characterCount += print.characterCount;
+                    continue;
+                }
+
+                // Prints after the last render still make up a frame
+                if ( type == TinyTextCaptureReader_c::RecordRender || characterCount )
+                {
+                    encoder.End( );
+                    AddFrame( encoder, characterCount, result );
+
+                    characterCount = 0;
+                    encoder.Begin( vertices );
+                }
+
+                if ( type != TinyTextCaptureReader_c::RecordRender )
+                {
+                    break;
+                }
+            }
+
+            encoder.End( );
+            elapsed = GetSeconds( ) - start;
+        }
+
+        result->seconds = elapsed;
+        result->allocations = double( AllocationCount - allocationCount );
+
+        delete [] vertices;
+        return true;
+    }
+
+    /*---------------------------------------------------------------------------------
+        Replay
+        Loads a capture and replays it. Returns 'false', having reported the error,
+        if it fails
+    ---------------------------------------------------------------------------------*/
+    bool Replay( const char * fileName, double seconds, BenchmarkResult_s * result )
+    {
+        TinyTextCaptureReader_c reader;
+        if ( !reader.Load( fileName ) )
+        {
+            fprintf( stderr, "%s: couldn't read capture file (or it is not a supported version)\n", fileName );
+            return false;
+        }
+
+        size_t capacity;
+        if ( !GetLargestCaptureFrame( reader, &capacity ) )
+        {
+            fprintf( stderr, "%s: capture file is corrupt\n", fileName );
+            return false;
+        }
+
+        if ( !RunReplay( reader, capacity ? capacity : 1, seconds, result ) )
+        {
+            fprintf( stderr, "%s: out of memory\n", fileName );
+            return false;
+        }
+
+        return true;
+    }
+
+    /*---------------------------------------------------------------------------------
+        KeepFastest
+        Replaces 'fastest' with 'result' if it encoded more glyphs per second
+    ---------------------------------------------------------------------------------*/
+    void KeepFastest( const BenchmarkResult_s & result, BenchmarkResult_s * fastest )
+    {
+        if ( result.glyphs * fastest->seconds > fastest->glyphs * result.seconds )
+        {
+            *fastest = result;
+        }
+    }
+
+    /*---------------------------------------------------------------------------------
+        MakeBaselineEntry
+        Converts a result to the form saved in a baseline file
+    ---------------------------------------------------------------------------------*/
+    void MakeBaselineEntry( const char * name, const BenchmarkResult_s & result, BaselineEntry_s * entry )
+    {
+        strncpy( entry->name, name, MaxCaseNameLength - 1 );
+        entry->name[ MaxCaseNameLength - 1 ] = '\0';
+        entry->glyphsPerSecond = result.seconds ? result.glyphs / result.seconds : 0.0;
+        entry->bytesPerGlyph = result.glyphs ? result.bytes / result.glyphs : 0.0;
+        entry->allocationsPerFrame = result.frames ? result.allocations / result.frames : 0.0;
+    }
+
+    /*---------------------------------------------------------------------------------
+        WriteBaseline
+        Writes a baseline file. Each line holds the glyphs/s, bytes/glyph and
+        allocs/frame of a case, followed by its name. Returns 'false' on failure
+    ---------------------------------------------------------------------------------*/
+    bool WriteBaseline( const char * fileName, const BaselineEntry_s * entries, size_t entryCount )
+    {
+        FILE * file = fopen( fileName, "w" );
+        if ( !file )
+        {
+            return false;
+        }
+
+        fprintf( file, "# TinyText.Benchmark baseline: glyphs/s bytes/glyph allocs/frame case\n" );
+        fprintf( file, "# Speeds are only comparable on the machine that recorded them - record a new\n" );
+        fprintf( file, "# baseline with '--write-baseline' before comparing on another\n" );
+
+        for ( size_t i = 0; i < entryCount; ++i )
+        {
+            fprintf( file, "%.0f %.3f %.3f %s\n", entries[ i ].glyphsPerSecond, entries[ i ].bytesPerGlyph, entries[ i ].allocationsPerFrame, entries[ i ].name );
+        }
+
+        bool written = !ferror( file );
+        return fclose( file ) == 0 && written;
+    }
+
+    /*---------------------------------------------------------------------------------
+        ReadBaseline
+        Reads a baseline file written by 'WriteBaseline'. Blank lines and lines that
+        start with '#' are ignored. Returns 'false' on failure
+    ---------------------------------------------------------------------------------*/
+    bool ReadBaseline( const char * fileName, BaselineEntry_s * entries, size_t * entryCount )
+    {
+        FILE * file = fopen( fileName, "r" );
+        if ( !file )
+        {
+            return false;
+        }
+
+        char line[ 256 ];
+        bool valid = true;
+
+        *entryCount = 0;
+
+        while ( valid && fgets( line, sizeof( line ), file ) )
+        {
+            line[ strcspn( line, "\r\n" ) ] = '\0';
+
+            if ( line[ 0 ] == '\0' || line[ 0 ] == '#' )
+            {
+                continue;
+            }
+
+            BaselineEntry_s & entry = entries[ *entryCount ];
+            int nameOffset = 0;
+
+            valid = *entryCount < MaxBaselineEntries
+                 && sscanf( line, "%lf %lf %lf %n", &entry.glyphsPerSecond, &entry.bytesPerGlyph, &entry.allocationsPerFrame, &nameOffset ) == 3
+                 && nameOffset > 0
+                 && line[ nameOffset ] != '\0'
+                 && strlen( line + nameOffset ) < MaxCaseNameLength;
+
+            if ( valid )
+            {
+                strcpy( entry.name, line + nameOffset );
+                ++*entryCount;
+            }
+        }
+
+        fclose( file );
+        return valid;
+    }
+
+    /*---------------------------------------------------------------------------------
+        CompareWithBaseline
+        Prints how each result compares with its baseline - returns 'false' if any
+        metric is worse by more than 'threshold' percent. Cases without a baseline
+        (and baselines without a case) are reported, but don't count as regressions
+    ---------------------------------------------------------------------------------*/
+    bool CompareWithBaseline( const BaselineEntry_s * baseline, size_t baselineCount, const BaselineEntry_s * results, size_t resultCount, double threshold )
+    {
+        const double worse = threshold * 0.01;
+        bool passed = true;
+
+        printf( "\n%-36s %12s %12s %13s\n", "compared with baseline", "glyphs/s", "bytes/glyph", "allocs/frame" );
+
+        for ( size_t i = 0; i < resultCount; ++i )
+        {
+            const BaselineEntry_s & result = results[ i ];
+            const BaselineEntry_s * saved = 0;
+
+            for ( size_t j = 0; j < baselineCount && !saved; ++j )
+            {
+                if ( strcmp( baseline[ j ].name, result.name ) == 0 )
+                {
+                    saved = &baseline[ j ];
+                }
+            }
+
+            if ( !saved )
+            {
+                printf( "%-36s no baseline\n", result.name );
+                continue;
+            }
+
+            // Speed must not fall, while size and allocations must not rise
+            bool slower = result.glyphsPerSecond < saved->glyphsPerSecond * ( 1.0 - worse );
+            bool larger = result.bytesPerGlyph > saved->bytesPerGlyph * ( 1.0 + worse );
+            bool allocates = result.allocationsPerFrame > saved->allocationsPerFrame * ( 1.0 + worse );
+
+            printf( "%-36s %+11.1f%% %+11.1f%% %+12.1f%s\n",
+                    result.name,
+                    saved->glyphsPerSecond ? ( result.glyphsPerSecond / saved->glyphsPerSecond - 1.0 ) * 100.0 : 0.0,
+                    saved->bytesPerGlyph ? ( result.bytesPerGlyph / saved->bytesPerGlyph - 1.0 ) * 100.0 : 0.0,
+                    result.allocationsPerFrame - saved->allocationsPerFrame,
+                    slower || larger || allocates ? "  REGRESSED" : "" );
+
+            passed = passed && !slower && !larger && !allocates;
+        }
+
+        for ( size_t j = 0; j < baselineCount; ++j )
+        {
+            bool found = false;
+
+            for ( size_t i = 0; i < resultCount && !found; ++i )
+            {
+                found = strcmp( baseline[ j ].name, results[ i ].name ) == 0;
+            }
+
+            // A case that wasn't run (the replay, without '--replay') can't be
+            // checked, so it fails rather than passing unnoticed
+            if ( !found )
+            {
+                printf( "%-36s NOT RUN\n", baseline[ j ].name );
+                passed = false;
+            }
+        }
+
+        printf( "\n%s (threshold %.1f%%)\n", passed ? "No regressions" : "REGRESSIONS FOUND", threshold );
+        return passed;
+    }
+
+    /*---------------------------------------------------------------------------------
+        PrintUsage
+        Describes the command line
+    ---------------------------------------------------------------------------------*/
+    void PrintUsage( const char * program )
+    {
+        fprintf( stderr,
+                 "usage: %s [options] [seconds per case]\n"
+                 "  --replay <capture file>     also replay a capture\n"
+                 "  --baseline <file>           compare the results with a baseline, failing on regressions\n"
+                 "  --threshold <percent>       how much worse a result may be than its baseline (default %.0f)\n"
+                 "  --write-baseline <file>     save the results as a baseline\n",
+                 program, DefaultThreshold );
+    }
+//}
+
+/*---------------------------------------------------------------------------------
+    operator new
+    Replaced so that the allocations made while encoding can be counted
+---------------------------------------------------------------------------------*/
+void * operator new( size_t size )
+{
+    ++AllocationCount;
+
+    void * memory = malloc( size ? size : 1 );
+    if ( !memory )
+    {
+        throw std::bad_alloc( );
+    }
+
+    return memory;
+}
+
+void * operator new( size_t size, const std::nothrow_t & )
+{
+    ++AllocationCount;
+    return malloc( size ? size : 1 );
+}
+
+/*---------------------------------------------------------------------------------
+    operator delete
+    Matches the replaced operator new
+---------------------------------------------------------------------------------*/
+void operator delete( void * memory )
+{
+    free( memory );
+}
+
+void operator delete( void * memory, const std::nothrow_t & )
+{
+    free( memory );
+}
+
+#if defined( __cpp_sized_deallocation )
+void operator delete( void * memory, size_t )
+{
+    free( memory );
+}
+#endif
+
+/*---------------------------------------------------------------------------------
+    main
+    Runs every benchmark and prints a table of the results, then compares them with
+    a baseline or saves them as one, if asked to
+---------------------------------------------------------------------------------*/
+int main( int argc, char ** argv )
+{
+    double seconds = DefaultSecondsPerCase;
+    double threshold = DefaultThreshold;
+    const char * replayFileName = 0;
+    const char * baselineFileName = 0;
+    const char * writeBaselineFileName = 0;
+    bool secondsSet = false;
+
+    for ( int i = 1; i < argc; ++i )
+    {
+        const char * value = i + 1 < argc ? argv[ i + 1 ] : 0;
+        bool valid = true;
+
+        if ( strcmp( argv[ i ], "--replay" ) == 0 )
+        {
+            replayFileName = value;
+            valid = value != 0;
+            ++i;
+        }
+        else if ( strcmp( argv[ i ], "--baseline" ) == 0 )
+        {
+            baselineFileName = value;
+            valid = value != 0;
+            ++i;
+        }
+        else if ( strcmp( argv[ i ], "--write-baseline" ) == 0 )
+        {
+            writeBaselineFileName = value;
+            valid = value != 0;
+            ++i;
+        }
+        else if ( strcmp( argv[ i ], "--threshold" ) == 0 )
+        {
+            threshold = value ? atof( value ) : -1.0;
+            valid = threshold >= 0.0;
+            ++i;
+        }
+        else
+        {
+            seconds = atof( argv[ i ] );
+            valid = !secondsSet && seconds > 0.0;
+            secondsSet = true;
+        }
+
+        if ( !valid )
+        {
+            PrintUsage( argv[ 0 ] );
+            return 1;
+        }
+    }
+
+    BaselineEntry_s baseline[ MaxBaselineEntries ];
+    size_t baselineCount = 0;
+
+    // Read the baseline first, so that a bad file doesn't waste a run
+    if ( baselineFileName && !ReadBaseline( baselineFileName, baseline, &baselineCount ) )
+    {
+        fprintf( stderr, "%s: couldn't read baseline file\n", baselineFileName );
+        return 1;
+    }
+
+    BaselineEntry_s results[ BenchmarkCaseCount + 1 ];
+    size_t resultCount = 0;
+
+    const int runCount = baselineFileName || writeBaselineFileName ? BaselineRunCount : 1;
+
+    PrintHeader( );
+
+    for ( size_t i = 0; i < BenchmarkCaseCount; ++i )
+    {
+        const BenchmarkCase_s & benchmark = BenchmarkCases[ i ];
+
+        BenchmarkResult_s result;
+
+        for ( int run = 0; run < runCount; ++run )
+        {
+            BenchmarkResult_s runResult;
+            if ( !RunBenchmark( benchmark, seconds, &runResult ) )
+            {
+                fprintf( stderr, "%s: out of memory\n", benchmark.name );
+                return 1;
+            }
+
+            if ( run == 0 )
+            {
+                result = runResult;
+            }
+            else
+            {
+                KeepFastest( runResult, &result );
+            }
+        }
+
+        PrintResult( benchmark.name, result );
+        MakeBaselineEntry( benchmark.name, result, &results[ resultCount++ ] );
+    }
+
+    if ( replayFileName )
+    {
+        BenchmarkResult_s result;
+
+        for ( int run = 0; run < runCount; ++run )
+        {
+            BenchmarkResult_s runResult;
+            if ( !Replay( replayFileName, seconds, &runResult ) )
+            {
+                return 1;
+            }
+
+            if ( run == 0 )
+            {
+                result = runResult;
+            }
+            else
+            {
+                KeepFastest( runResult, &result );
+            }
+        }
+
+        PrintResult( ReplayCaseName, result );
+        MakeBaselineEntry( ReplayCaseName, result, &results[ resultCount++ ] );
+
+        printf( "\n%.0f frames replayed, %.1f frames/s\n", result.frames, result.frames / result.seconds );
+    }
+
+    if ( writeBaselineFileName && !WriteBaseline( writeBaselineFileName, results, resultCount ) )
+    {
+        fprintf( stderr, "%s: couldn't write baseline file\n", writeBaselineFileName );
+        return 1;
+    }
+
+    if ( baselineFileName && !CompareWithBaseline( baseline, baselineCount, results, resultCount, threshold ) )
+    {
+        return 1;
+    }
+
+    return 0;
+}
@@ -33,78 +33,27 @@
 ---------------------------------------------------------------------------------*/
 #include "TinyText.h"
 #include <d3dx11.h>
+#include <stdio.h>
+#include <new>
 
 /*---------------------------------------------------------------------------------
     Constants
 ---------------------------------------------------------------------------------*/
 //namespace
 //{
-    // The font texture data, encoded as a monochrome bitmap
-    const unsigned char TextTexture[]           = { 66 , 77 , 62 , 8 , 0 , 0 , 0 , 0 , 0 , 0 , 62 , 0 , 0 , 0 , 40 , 0 , 0 , 0 , 128 , 0 , 0 , 0 , 128 , 0 , 0 , 0 , 1 , 0 , 1 , 0 , 0 , 0 , 0 , 0 , 0 , 8 , 0 , 0 , 18 , 11 , 0 , 0 , 18 , 11 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 255 , 255 , 255 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 63 , 191 , 192 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 8 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 8 , 34 , 13 , 132 , 64 , 131 , 251 , 252 , 16 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 8 , 17 , 7 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 8 , 8 , 159 , 193 , 1 , 64 , 192 , 136 , 140 , 62 , 0 , 0 , 0 , 0 , 0 , 0 , 24 , 17 , 7 , 2 , 129 , 64 , 32 , 80 , 146 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 34 , 13 , 129 , 1 , 64 , 64 , 32 , 98 , 62 , 4 , 0 , 0 , 0 , 0 , 0 , 30 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 4 , 0 , 128 , 0 , 0 , 0 , 33 , 8 , 7 , 132 , 36 , 144 , 240 , 124 , 58 , 54 , 4 , 15 , 128 , 0 , 0 , 0 , 6 , 8 , 8 , 68 , 36 , 145 , 8 , 132 , 70 , 73 , 0 , 0 , 0 , 0 , 0 , 0 , 24 , 8 , 8 , 68 , 36 , 145 , 0 , 132 , 66 , 72 , 15 , 15 , 129 , 0 , 128 , 128 , 33 , 8 , 8 , 68 , 36 , 145 , 0 , 124 , 66 , 63 , 16 , 140 , 66 , 0 , 64 , 64 , 30 , 12 , 136 , 70 , 36 , 145 , 8 , 4 , 66 , 9 , 16 , 10 , 64 , 0 , 0 , 0 , 0 , 11 , 7 , 133 , 199 , 96 , 240 , 120 , 66 , 54 , 31 , 137 , 66 , 33 , 192 , 192 , 8 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 16 , 136 , 196 , 64 , 128 , 32 , 28 , 32 , 2 , 2 , 1 , 1 , 224 , 4 , 120 , 65 , 15 , 7 , 200 , 128 , 64 , 64 , 34 , 16 , 0 , 1 , 0 , 128 , 0 , 8 , 0 , 34 , 0 , 0 , 4 , 65 , 64 , 32 , 32 , 8 , 0 , 0 , 0 , 64 , 192 , 16 , 56 , 20 , 4 , 15 , 194 , 32 , 128 , 192 , 34 , 4 , 15 , 128 , 0 , 33 , 32 , 32 , 72 , 8 , 0 , 4 , 0 , 0 , 0 , 0 , 28 , 2 , 0 , 0 , 0 , 65 , 32 , 64 , 56 , 20 , 0 , 2 , 4 , 33 , 64 , 64 , 8 , 1 , 0 , 0 , 0 , 129 , 32 , 128 , 8 , 34 , 0 , 1 , 2 , 66 , 160 , 160 , 0 , 0 , 130 , 1 , 1 , 0 , 193 , 0 , 48 , 65 , 0 , 0 , 129 , 130 , 160 , 160 , 64 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 4 , 15 , 193 , 130 , 160 , 160 , 32 , 14 , 15 , 134 , 1 , 192 , 240 , 48 , 12 , 28 , 0 , 0 , 2 , 68 , 17 , 16 , 60 , 4 , 4 , 1 , 2 , 32 , 8 , 16 , 16 , 34 , 0 , 136 , 4 , 36 , 17 , 16 , 34 , 4 , 4 , 1 , 5 , 80 , 8 , 120 , 16 , 77 , 0 , 136 , 0 , 0 , 0 , 0 , 34 , 63 , 143 , 2 , 133 , 144 , 248 , 132 , 16 , 81 , 15 , 143 , 128 , 128 , 130 , 8 , 34 , 10 , 4 , 2 , 133 , 81 , 8 , 128 , 16 , 81 , 16 , 136 , 65 , 0 , 129 , 240 , 34 , 63 , 136 , 4 , 69 , 145 , 8 , 128 , 60 , 77 , 16 , 136 , 66 , 0 , 129 , 16 , 34 , 17 , 9 , 4 , 66 , 33 , 8 , 132 , 16 , 34 , 16 , 136 , 68 , 7 , 241 , 16 , 0 , 59 , 134 , 8 , 33 , 192 , 248 , 120 , 16 , 28 , 16 , 136 , 66 , 0 , 129 , 16 , 31 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 15 , 143 , 129 , 0 , 129 , 240 , 33 , 15 , 135 , 195 , 225 , 240 , 240 , 120 , 60 , 30 , 0 , 0 , 0 , 128 , 130 , 8 , 33 , 16 , 136 , 68 , 34 , 17 , 8 , 132 , 66 , 33 , 4 , 2 , 0 , 0 , 0 , 0 , 31 , 16 , 136 , 68 , 34 , 17 , 0 , 128 , 64 , 32 , 4 , 2 , 1 , 0 , 128 , 240 , 1 , 15 , 135 , 195 , 225 , 241 , 248 , 252 , 126 , 63 , 4 , 2 , 1 , 0 , 129 , 8 , 30 , 0 , 128 , 64 , 32 , 17 , 8 , 132 , 66 , 33 , 4 , 2 , 1 , 0 , 129 , 8 , 0 , 15 , 7 , 195 , 193 , 224 , 240 , 120 , 60 , 30 , 4 , 2 , 1 , 0 , 129 , 8 , 4 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 4 , 2 , 1 , 0 , 128 , 240 , 8 , 2 , 2 , 132 , 192 , 0 , 32 , 32 , 20 , 0 , 0 , 0 , 1 , 0 , 128 , 16 , 0 , 1 , 1 , 3 , 33 , 32 , 64 , 16 , 8 , 18 , 4 , 2 , 0 , 0 , 0 , 160 , 32 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 8 , 1 , 2 , 128 , 0 , 64 , 32 , 4 , 30 , 15 , 224 , 160 , 8 , 28 , 2 , 28 , 0 , 0 , 1 , 0 , 192 , 160 , 32 , 4 , 17 , 0 , 0 , 162 , 121 , 8 , 158 , 34 , 39 , 143 , 0 , 0 , 0 , 0 , 32 , 4 , 2 , 129 , 0 , 161 , 40 , 132 , 74 , 32 , 36 , 8 , 139 , 130 , 1 , 112 , 62 , 4 , 4 , 129 , 0 , 160 , 152 , 84 , 38 , 32 , 60 , 8 , 68 , 66 , 1 , 8 , 33 , 4 , 9 , 1 , 3 , 163 , 201 , 232 , 210 , 16 , 36 , 8 , 74 , 35 , 225 , 8 , 33 , 4 , 18 , 15 , 231 , 161 , 32 , 144 , 40 , 8 , 39 , 30 , 74 , 34 , 17 , 8 , 33 , 4 , 20 , 1 , 7 , 161 , 16 , 136 , 68 , 8 , 20 , 8 , 73 , 34 , 17 , 112 , 62 , 0 , 8 , 129 , 7 , 161 , 8 , 132 , 34 , 0 , 20 , 8 , 72 , 162 , 17 , 16 , 0 , 4 , 7 , 129 , 3 , 227 , 1 , 128 , 192 , 8 , 20 , 8 , 136 , 163 , 225 , 16 , 8 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 15 , 143 , 4 , 66 , 1 , 16 , 8 , 15 , 2 , 2 , 132 , 16 , 65 , 252 , 124 , 31 , 0 , 0 , 3 , 162 , 0 , 224 , 8 , 16 , 130 , 5 , 68 , 16 , 65 , 0 , 66 , 33 , 4 , 8 , 64 , 0 , 0 , 0 , 8 , 16 , 133 , 5 , 66 , 32 , 64 , 128 , 66 , 33 , 4 , 8 , 65 , 1 , 16 , 48 , 8 , 16 , 133 , 5 , 65 , 64 , 64 , 64 , 66 , 33 , 4 , 8 , 65 , 1 , 32 , 64 , 8 , 16 , 136 , 133 , 64 , 128 , 160 , 32 , 66 , 33 , 4 , 8 , 65 , 1 , 64 , 64 , 8 , 16 , 136 , 136 , 33 , 65 , 16 , 16 , 124 , 31 , 4 , 12 , 65 , 1 , 192 , 64 , 8 , 16 , 144 , 72 , 34 , 34 , 8 , 8 , 64 , 1 , 15 , 11 , 129 , 1 , 32 , 64 , 127 , 16 , 144 , 72 , 36 , 18 , 8 , 4 , 64 , 1 , 4 , 8 , 1 , 1 , 16 , 64 , 0 , 16 , 144 , 72 , 36 , 18 , 9 , 252 , 64 , 1 , 4 , 8 , 0 , 1 , 0 , 64 , 63 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 3 , 8 , 0 , 1 , 0 , 64 , 32 , 16 , 7 , 132 , 33 , 192 , 240 , 132 , 126 , 65 , 0 , 0 , 1 , 1 , 0 , 64 , 32 , 16 , 8 , 68 , 32 , 129 , 8 , 136 , 64 , 65 , 16 , 135 , 0 , 0 , 0 , 0 , 32 , 16 , 16 , 68 , 32 , 128 , 8 , 144 , 64 , 65 , 17 , 136 , 131 , 162 , 17 , 240 , 60 , 16 , 17 , 196 , 32 , 128 , 8 , 160 , 64 , 73 , 18 , 144 , 68 , 66 , 34 , 8 , 32 , 30 , 16 , 7 , 224 , 128 , 8 , 192 , 64 , 73 , 18 , 144 , 72 , 162 , 64 , 8 , 32 , 16 , 16 , 4 , 32 , 128 , 8 , 160 , 64 , 85 , 18 , 144 , 72 , 34 , 128 , 8 , 32 , 16 , 16 , 4 , 32 , 128 , 8 , 144 , 64 , 85 , 20 , 144 , 72 , 35 , 225 , 240 , 63 , 16 , 8 , 68 , 32 , 128 , 8 , 136 , 64 , 99 , 20 , 144 , 72 , 34 , 18 , 0 , 0 , 31 , 135 , 132 , 33 , 192 , 248 , 132 , 64 , 65 , 24 , 136 , 136 , 34 , 18 , 0 , 28 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 16 , 135 , 4 , 66 , 18 , 8 , 34 , 2 , 7 , 3 , 129 , 0 , 192 , 116 , 58 , 8 , 0 , 0 , 3 , 131 , 225 , 240 , 2 , 2 , 8 , 132 , 65 , 0 , 32 , 140 , 70 , 0 , 14 , 8 , 64 , 0 , 0 , 0 , 2 , 2 , 0 , 132 , 64 , 128 , 16 , 132 , 66 , 8 , 16 , 8 , 71 , 193 , 225 , 224 , 12 , 31 , 0 , 132 , 64 , 128 , 16 , 132 , 66 , 8 , 39 , 8 , 68 , 34 , 17 , 16 , 2 , 18 , 15 , 7 , 128 , 64 , 240 , 132 , 66 , 4 , 42 , 143 , 196 , 36 , 1 , 8 , 2 , 10 , 8 , 4 , 0 , 65 , 16 , 132 , 66 , 2 , 42 , 136 , 68 , 36 , 1 , 8 , 34 , 10 , 8 , 4 , 0 , 33 , 16 , 0 , 0 , 2 , 42 , 136 , 71 , 196 , 1 , 8 , 28 , 6 , 8 , 2 , 0 , 33 , 16 , 40 , 0 , 34 , 38 , 132 , 132 , 36 , 1 , 8 , 0 , 2 , 15 , 129 , 131 , 224 , 224 , 16 , 36 , 28 , 16 , 132 , 132 , 36 , 1 , 8 , 20 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 15 , 3 , 4 , 34 , 17 , 16 , 20 , 4 , 0 , 131 , 97 , 224 , 240 , 120 , 60 , 30 , 0 , 0 , 7 , 193 , 225 , 224 , 62 , 14 , 17 , 68 , 130 , 17 , 8 , 132 , 66 , 33 , 14 , 135 , 64 , 0 , 0 , 0 , 20 , 17 , 8 , 132 , 66 , 17 , 8 , 132 , 66 , 33 , 17 , 136 , 195 , 128 , 129 , 240 , 20 , 1 , 4 , 2 , 162 , 17 , 8 , 132 , 66 , 33 , 16 , 136 , 68 , 64 , 129 , 0 , 20 , 14 , 2 , 1 , 2 , 17 , 8 , 132 , 66 , 33 , 16 , 136 , 68 , 64 , 128 , 128 , 62 , 16 , 1 , 2 , 129 , 224 , 240 , 120 , 60 , 30 , 16 , 136 , 68 , 64 , 128 , 64 , 20 , 17 , 8 , 130 , 64 , 0 , 0 , 0 , 0 , 0 , 16 , 136 , 68 , 64 , 128 , 32 , 20 , 14 , 20 , 66 , 64 , 64 , 64 , 72 , 76 , 0 , 0 , 0 , 4 , 64 , 128 , 16 , 0 , 4 , 8 , 1 , 128 , 128 , 32 , 48 , 50 , 18 , 2 , 2 , 4 , 66 , 128 , 16 , 32 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 4 , 1 , 4 , 65 , 129 , 16 , 32 , 24 , 7 , 131 , 128 , 96 , 224 , 112 , 96 , 28 , 0 , 0 , 3 , 128 , 128 , 224 , 62 , 4 , 8 , 68 , 64 , 129 , 16 , 136 , 16 , 34 , 6 , 7 , 192 , 0 , 0 , 0 , 33 , 4 , 8 , 72 , 32 , 130 , 9 , 4 , 16 , 65 , 2 , 8 , 67 , 128 , 129 , 8 , 33 , 10 , 8 , 72 , 32 , 130 , 9 , 4 , 16 , 65 , 15 , 8 , 68 , 64 , 1 , 8 , 33 , 10 , 8 , 72 , 32 , 130 , 9 , 4 , 16 , 65 , 16 , 135 , 196 , 64 , 129 , 8 , 33 , 17 , 8 , 72 , 35 , 2 , 9 , 4 , 12 , 65 , 32 , 0 , 68 , 64 , 129 , 8 , 62 , 17 , 8 , 72 , 32 , 130 , 9 , 4 , 16 , 65 , 32 , 7 , 131 , 128 , 129 , 136 , 32 , 32 , 136 , 68 , 64 , 129 , 16 , 136 , 16 , 34 , 32 , 0 , 4 , 64 , 129 , 112 , 32 , 0 , 9 , 67 , 128 , 128 , 224 , 112 , 16 , 28 , 32 , 2 , 4 , 64 , 128 , 0 , 32 , 4 , 2 , 0 , 0 , 130 , 112 , 80 , 16 , 8 , 16 , 133 , 4 , 64 , 129 , 48 , 0 , 2 , 4 , 4 , 64 , 97 , 200 , 32 , 96 , 4 , 15 , 2 , 3 , 128 , 128 , 200 , 8 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 8 , 31 , 143 , 199 , 227 , 241 , 8 , 132 , 66 , 28 , 15 , 12 , 3 , 129 , 224 , 240 , 8 , 16 , 8 , 4 , 2 , 1 , 8 , 132 , 66 , 16 , 16 , 130 , 0 , 130 , 17 , 8 , 8 , 16 , 8 , 4 , 2 , 1 , 248 , 132 , 66 , 16 , 16 , 130 , 0 , 130 , 17 , 8 , 8 , 16 , 8 , 4 , 2 , 1 , 8 , 252 , 126 , 16 , 16 , 133 , 0 , 130 , 17 , 8 , 8 , 30 , 15 , 7 , 131 , 193 , 8 , 132 , 66 , 16 , 16 , 133 , 0 , 130 , 17 , 8 , 8 , 16 , 8 , 4 , 2 , 1 , 8 , 132 , 66 , 16 , 16 , 136 , 128 , 130 , 17 , 8 , 8 , 16 , 8 , 4 , 2 , 0 , 144 , 72 , 36 , 16 , 16 , 136 , 128 , 130 , 17 , 8 , 12 , 16 , 8 , 4 , 2 , 0 , 144 , 72 , 36 , 16 , 16 , 144 , 64 , 130 , 17 , 8 , 8 , 31 , 143 , 199 , 227 , 240 , 96 , 48 , 24 , 16 , 16 , 128 , 0 , 130 , 17 , 72 , 16 , 0 , 5 , 1 , 0 , 128 , 144 , 0 , 76 , 16 , 0 , 0 , 0 , 128 , 192 , 32 , 0 , 17 , 2 , 0 , 129 , 0 , 96 , 72 , 50 , 28 , 16 , 136 , 131 , 128 , 192 , 16 , 8 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 8 , 16 , 136 , 71 , 2 , 16 , 64 , 112 , 66 , 8 , 2 , 4 , 1 , 0 , 128 , 64 , 8 , 16 , 136 , 64 , 130 , 16 , 64 , 136 , 70 , 8 , 4 , 2 , 1 , 0 , 128 , 64 , 8 , 16 , 136 , 64 , 130 , 16 , 65 , 4 , 70 , 8 , 4 , 2 , 1 , 0 , 128 , 64 , 8 , 31 , 143 , 192 , 131 , 240 , 65 , 4 , 74 , 8 , 8 , 1 , 1 , 0 , 128 , 64 , 8 , 16 , 136 , 64 , 130 , 16 , 65 , 4 , 74 , 8 , 8 , 1 , 1 , 1 , 64 , 64 , 8 , 16 , 136 , 64 , 130 , 16 , 1 , 4 , 82 , 8 , 8 , 1 , 1 , 1 , 64 , 64 , 8 , 9 , 4 , 128 , 129 , 32 , 65 , 4 , 98 , 8 , 8 , 1 , 1 , 2 , 32 , 64 , 8 , 9 , 4 , 128 , 129 , 32 , 64 , 136 , 98 , 8 , 8 , 1 , 1 , 2 , 32 , 64 , 8 , 6 , 7 , 0 , 0 , 224 , 64 , 112 , 66 , 8 , 4 , 2 , 1 , 4 , 80 , 192 , 8 , 9 , 2 , 0 , 0 , 64 , 64 , 32 , 140 , 0 , 4 , 2 , 2 , 128 , 128 , 64 , 8 , 6 , 1 , 0 , 128 , 128 , 64 , 64 , 114 , 20 , 2 , 4 , 1 , 0 , 64 , 32 };
+    // The shaders. The font is a texture array, and the top bit of each texture
+    // coordinate selects its slice. 'PSMainDistanceField' draws distance field fonts,
+    // which are sampled bilinearly and kept wherever they are inside the glyph
+    const char          Shaders[]               = "Texture2DArray font : register( t0 ); SamplerState fontSampler { Filter = MIN_MIP_MAG_POINT; }; struct VertexIn { float2 pos : POSITIONT; uint2 texCoord : TEXCOORD0; float4 colour : COLOR0; }; struct VertexOut { float4 pos : SV_Position; float3 texCoord : TEXCOORD0; float4 colour : TEXCOORD1; }; VertexOut VSMain( VertexIn input ) { VertexOut output; output.pos = float4( input.pos, 0.0f, 1.0f ); output.colour = input.colour; output.texCoord = float3( input.texCoord & 0x7FFF, ( input.texCoord.x >> 15 ) | ( ( input.texCoord.y >> 15 ) << 1 ) ); return output; } float4 PSMain( VertexOut input ) : SV_Target0 { uint3 fontSize; font.GetDimensions( fontSize.x, fontSize.y, fontSize.z ); float fontValue = font.SampleLevel( fontSampler, float3( input.texCoord.xy / float2( fontSize.xy ), input.texCoord.z ), 0 ); if ( fontValue < 1.0f ) discard; return fontValue.xxxx * input.colour; } float4 PSMainDistanceField( VertexOut input ) : SV_Target0 { uint3 fontSize; font.GetDimensions( fontSize.x, fontSize.y, fontSize.z ); float fieldValue = font.SampleLevel( fontSampler, float3( input.texCoord.xy / float2( fontSize.xy ), input.texCoord.z ), 0 ); if ( fieldValue < 0.5f ) discard; return input.colour; }";
 
-    // The size of the font texture data in bytes
-    const unsigned int  TextTextureByteCount    = 2110;
-
-    // The width (in pixels) of the texture
-    const unsigned int  TextTextureWidth        = 128;
-
-    // The height (in pixels) of the texture
-    const unsigned int  TextTextureHeight       = 128;
-
-    // Number of bytes per character. 1 byte for X coordinate, 1 byte for Y coordinate, and 1 byte whose upper 4-bits contains the y-offset, and the lower 4-bits contains the height
-    const unsigned int  CharacterByteCount      = 3;
-
-    // Total number of characters
-    const unsigned int  CharacterCount          = 256;
-
-    // Width of each character (using a fixed-width font)
-    const unsigned int  CharacterWidth          = 8;
-
-    // The character data
-    const unsigned char CharacterData[]         = { 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 72 , 124 , 208 , 108 , 24 , 41 , 36 , 120 , 35 , 0 , 37 , 41 , 9 , 36 , 41 , 18 , 36 , 41 , 27 , 36 , 41 , 81 , 118 , 35 , 81 , 0 , 43 , 90 , 0 , 43 , 18 , 120 , 69 , 108 , 94 , 71 , 117 , 115 , 162 , 45 , 124 , 113 , 36 , 124 , 161 , 9 , 105 , 55 , 99 , 34 , 41 , 108 , 34 , 41 , 117 , 34 , 41 , 0 , 47 , 41 , 9 , 46 , 41 , 18 , 46 , 41 , 27 , 46 , 41 , 36 , 46 , 41 , 99 , 24 , 41 , 45 , 46 , 41 , 81 , 104 , 86 , 27 , 105 , 87 , 99 , 94 , 71 , 72 , 120 , 83 , 36 , 105 , 71 , 72 , 46 , 41 , 81 , 45 , 41 , 90 , 45 , 41 , 99 , 44 , 41 , 108 , 44 , 41 , 117 , 44 , 41 , 0 , 57 , 41 , 9 , 56 , 41 , 18 , 56 , 41 , 27 , 56 , 41 , 36 , 56 , 41 , 45 , 56 , 41 , 54 , 56 , 41 , 63 , 56 , 41 , 72 , 56 , 41 , 81 , 55 , 41 , 90 , 55 , 41 , 0 , 77 , 41 , 99 , 54 , 41 , 108 , 54 , 41 , 117 , 54 , 41 , 0 , 67 , 41 , 9 , 66 , 41 , 18 , 66 , 41 , 27 , 66 , 41 , 36 , 66 , 41 , 45 , 66 , 41 , 54 , 66 , 41 , 72 , 12 , 43 , 54 , 105 , 55 , 99 , 12 , 43 , 54 , 120 , 19 , 54 , 124 , 193 , 99 , 115 , 34 , 54 , 113 , 86 , 63 , 66 , 41 , 45 , 113 , 86 , 72 , 66 , 41 , 81 , 111 , 86 , 81 , 65 , 41 , 45 , 96 , 88 , 90 , 65 , 41 , 99 , 64 , 41 , 27 , 0 , 43 , 108 , 64 , 41 , 117 , 64 , 41 , 36 , 113 , 86 , 27 , 113 , 86 , 18 , 113 , 86 , 90 , 95 , 88 , 81 , 95 , 88 , 9 , 113 , 86 , 0 , 114 , 86 , 63 , 96 , 56 , 63 , 113 , 86 , 117 , 102 , 86 , 108 , 102 , 86 , 99 , 102 , 86 , 27 , 96 , 88 , 90 , 104 , 86 , 36 , 24 , 43 , 0 , 0 , 28 , 63 , 24 , 43 , 63 , 120 , 51 , 27 , 126 , 208 , 108 , 24 , 41 , 0 , 127 , 208 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 117 , 118 , 208 , 108 , 24 , 41 , 99 , 118 , 208 , 108 , 118 , 208 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 81 , 122 , 208 , 108 , 24 , 41 , 108 , 24 , 41 , 90 , 121 , 208 , 9 , 76 , 41 , 0 , 106 , 71 , 18 , 96 , 56 , 117 , 94 , 39 , 9 , 96 , 56 , 45 , 0 , 43 , 18 , 76 , 41 , 27 , 124 , 33 , 72 , 96 , 40 , 63 , 105 , 39 , 99 , 109 , 101 , 90 , 118 , 82 , 9 , 126 , 113 , 36 , 96 , 40 , 18 , 126 , 17 , 27 , 120 , 35 , 27 , 76 , 41 , 108 , 109 , 37 , 117 , 109 , 37 , 108 , 115 , 34 , 0 , 97 , 88 , 36 , 76 , 41 , 63 , 124 , 113 , 45 , 120 , 163 , 0 , 121 , 37 , 45 , 105 , 39 , 9 , 120 , 101 , 45 , 76 , 41 , 54 , 76 , 41 , 63 , 76 , 41 , 72 , 76 , 41 , 36 , 0 , 11 , 18 , 0 , 11 , 9 , 0 , 11 , 63 , 12 , 11 , 54 , 12 , 11 , 45 , 12 , 11 , 81 , 75 , 41 , 81 , 24 , 58 , 36 , 12 , 11 , 27 , 12 , 11 , 18 , 12 , 11 , 9 , 12 , 11 , 0 , 13 , 11 , 117 , 0 , 11 , 99 , 0 , 11 , 72 , 0 , 11 , 90 , 75 , 41 , 63 , 0 , 11 , 54 , 0 , 11 , 72 , 24 , 11 , 54 , 24 , 11 , 45 , 24 , 11 , 27 , 24 , 11 , 72 , 105 , 71 , 99 , 74 , 41 , 18 , 24 , 11 , 117 , 12 , 11 , 108 , 12 , 11 , 81 , 12 , 11 , 108 , 0 , 11 , 108 , 74 , 41 , 117 , 74 , 41 , 0 , 87 , 41 , 9 , 86 , 41 , 18 , 86 , 41 , 27 , 86 , 41 , 36 , 86 , 41 , 90 , 24 , 26 , 72 , 113 , 86 , 54 , 96 , 88 , 45 , 86 , 41 , 54 , 86 , 41 , 63 , 86 , 41 , 72 , 86 , 41 , 81 , 85 , 41 , 90 , 85 , 41 , 99 , 84 , 41 , 108 , 84 , 41 , 117 , 84 , 41 , 117 , 24 , 41 , 36 , 36 , 41 , 45 , 36 , 41 , 54 , 36 , 41 , 63 , 36 , 41 , 72 , 36 , 41 , 18 , 105 , 71 , 90 , 111 , 86 , 81 , 35 , 41 , 90 , 35 , 41 , 54 , 46 , 41 , 63 , 46 , 41 , 9 , 24 , 43 , 0 , 25 , 43 , 90 , 12 , 43 };
+    // Total number of vertices for each character
+    const unsigned int NumVerticesPerCharacter = TinyTextEncoder_c::NumVerticesPerCharacter;
 
-    // The shaders
-    const char          Shaders[]               = "Texture2D font : register( t0 ); SamplerState fontSampler { Filter = MIN_MIP_MAG_POINT; }; struct VertexIn { float2 pos : POSITIONT; uint2 texCoord : TEXCOORD0; float4 colour : COLOR0; }; struct VertexOut { float4 pos : SV_Position; float2 texCoord : TEXCOORD0; float4 colour : TEXCOORD1; }; VertexOut VSMain( VertexIn input ) { VertexOut output; output.pos = float4( input.pos, 0.0f, 1.0f ); output.colour = input.colour; output.texCoord = input.texCoord / float2( 128.0f, 128.0f ); return output; } float4 PSMain( VertexOut input ) : SV_Target0 { float fontValue = font.SampleLevel( fontSampler, input.texCoord, 0 ); if ( fontValue < 1.0f ) discard; return fontValue.xxxx * input.colour; }";
+    // Number of 32-bit values in the vertices of each character
+    const unsigned int NumVertexElementsPerCharacter = TinyTextEncoder_c::NumVertexElementsPerCharacter;
 
-    // Total number of vertices for each character
-    const unsigned int NumVerticesPerCharacter = 6;
-
-    // Meaningful description of each element of the vertex stream for
-    // a single character
-    enum VertexStreamElements
-    {
-        Triangle0_Vertex0_Position_X,
-        Triangle0_Vertex0_Position_Y,
-        Triangle0_Vertex0_UV,
-        Triangle0_Vertex0_Colour,
-
-        Triangle0_Vertex1_Position_X,
-        Triangle0_Vertex1_Position_Y,
-        Triangle0_Vertex1_UV,
-        Triangle0_Vertex1_Colour,
-
-        Triangle0_Vertex2_Position_X,
-        Triangle0_Vertex2_Position_Y,
-        Triangle0_Vertex2_UV,
-        Triangle0_Vertex2_Colour,
-
-        Triangle1_Vertex0_Position_X,
-        Triangle1_Vertex0_Position_Y,
-        Triangle1_Vertex0_UV,
-        Triangle1_Vertex0_Colour,
-
-        Triangle1_Vertex1_Position_X,
-        Triangle1_Vertex1_Position_Y,
-        Triangle1_Vertex1_UV,
-        Triangle1_Vertex1_Colour,
-
-        Triangle1_Vertex2_Position_X,
-        Triangle1_Vertex2_Position_Y,
-        Triangle1_Vertex2_UV,
-        Triangle1_Vertex2_Colour,
-
-        NumVertexElementsPerCharacter
-    };
+    // Number of device context calls made to set up the render state for drawing text
+    const unsigned int NumRenderStateCalls = 11;
 //}
 
 /*---------------------------------------------------------------------------------
@@ -158,6 +107,11 @@
 
         // Releases any interfaces that have been obtained
         void Release( );
+
+    public:
+
+        // Number of device context calls made by each of 'Capture' and 'Restore'
+        static const unsigned int NumDeviceContextCalls = 11;
     };
 
     /*---------------------------------------------------------------------------------
@@ -289,35 +243,166 @@
         }
     }
 
+    /*---------------------------------------------------------------------------------
+        CreateTextureArrayView
+        Creates a shader resource view of a texture as an array, which is how the
+        shaders read every font texture - even one that isn't an array
+    ---------------------------------------------------------------------------------*/
+    ID3D11ShaderResourceView * CreateTextureArrayView( ID3D11Device * device, ID3D11Resource * texture, DXGI_FORMAT format, UINT arraySize )
+    {
+        D3D11_SHADER_RESOURCE_VIEW_DESC textureDesc;
+        textureDesc.Format = format;
+        textureDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2DARRAY;
+        textureDesc.Texture2DArray.MostDetailedMip = 0;
+        textureDesc.Texture2DArray.MipLevels = 1;
+        textureDesc.Texture2DArray.FirstArraySlice = 0;
+        textureDesc.Texture2DArray.ArraySize = arraySize;
+
+        ID3D11ShaderResourceView * textureView = 0;
+
+        if ( FAILED ( device->CreateShaderResourceView( texture, &textureDesc, &textureView ) ) )
+        {
+            return 0;
+        }
+
+        return textureView;
+    }
+
     /*---------------------------------------------------------------------------------
         CreateTextureView
         Creates a shader resource view of the font texture
     ---------------------------------------------------------------------------------*/
     ID3D11ShaderResourceView * CreateTextureView( ID3D11Device * device )
     {
+        unsigned int textureByteCount;
+        const unsigned char * textureData = TinyTextEncoder_c::GetFontBitmap( &textureByteCount );
+
         ID3D11Resource * texture = 0;
         
-        if ( FAILED ( D3DX11CreateTextureFromMemory( device, TextTexture, TextTextureByteCount, 0, 0, &texture, 0 ) ) || !texture )
+        if ( FAILED ( D3DX11CreateTextureFromMemory( device, textureData, textureByteCount, 0, 0, &texture, 0 ) ) || !texture )
         {
             return 0;
         }
 
-        D3D11_SHADER_RESOURCE_VIEW_DESC textureDesc;
-        textureDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
-        textureDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
-        textureDesc.Texture2D.MipLevels = 1;
-        textureDesc.Texture2D.MostDetailedMip = 0;
-
-        ID3D11ShaderResourceView * textureView = 0;    
-     
-        HRESULT hr = device->CreateShaderResourceView(texture, &textureDesc, &textureView );
+        ID3D11ShaderResourceView * textureView = CreateTextureArrayView( device, texture, DXGI_FORMAT_R8G8B8A8_UNORM, 1 );
         texture->Release( );
-        
-        if ( FAILED ( hr ) )
+
+        return textureView;
+    }
+
+    /*---------------------------------------------------------------------------------
+        CreateFontArrayTextureView
+        Creates a shader resource view of a texture array of fonts, one byte per
+        texel with each slice following the last. The texture is initialised straight
+        from 'texels', which for a single font pack is its atlas - usually a mapped
+        file
+    ---------------------------------------------------------------------------------*/
+    ID3D11ShaderResourceView * CreateFontArrayTextureView( ID3D11Device * device, int width, int height, unsigned int sliceCount, const unsigned char * texels )
+    {
+        D3D11_TEXTURE2D_DESC desc;
+        desc.Width = width;
+        desc.Height = height;
+        desc.MipLevels = 1;
+        desc.ArraySize = sliceCount;
+        desc.Format = DXGI_FORMAT_R8_UNORM;
+        desc.SampleDesc.Count = 1;
+        desc.SampleDesc.Quality = 0;
+        desc.Usage = D3D11_USAGE_IMMUTABLE;
+        desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+        desc.CPUAccessFlags = 0;
+        desc.MiscFlags = 0;
+
+        D3D11_SUBRESOURCE_DATA initialData[ TinyTextEncoder_c::MaxFonts ];
+
+        for ( unsigned int i = 0; i < sliceCount; ++i )
+        {
+            initialData[ i ].pSysMem = texels + size_t( width ) * height * i;
+            initialData[ i ].SysMemPitch = width;
+            initialData[ i ].SysMemSlicePitch = 0;
+        }
+
+        ID3D11Texture2D * texture = 0;
+
+        if ( FAILED ( device->CreateTexture2D( &desc, initialData, &texture ) ) || !texture )
+        {
+            return 0;
+        }
+
+        ID3D11ShaderResourceView * textureView = CreateTextureArrayView( device, texture, DXGI_FORMAT_R8_UNORM, sliceCount );
+        texture->Release( );
+
+        return textureView;
+    }
+
+    /*---------------------------------------------------------------------------------
+        CreateFontsTextureView
+        Creates a shader resource view of the texture of some fonts - font packs, or
+        NULL for the built-in font
+    ---------------------------------------------------------------------------------*/
+    ID3D11ShaderResourceView * CreateFontsTextureView( ID3D11Device * device, const TinyTextFontPack_c * const * fonts, unsigned int fontCount )
+    {
+        if ( fontCount == 1 )
+        {
+            const TinyTextFontPack_c * font = fonts[ 0 ];
+            return font ? CreateFontArrayTextureView( device, font->GetHeader( )->atlasWidth, font->GetHeader( )->atlasHeight, 1, font->GetAtlas( ) ) : CreateTextureView( device );
+        }
+
+        int width;
+        int height;
+        unsigned char * texels = TinyTextEncoder_c::CreateFontArray( fonts, fontCount, &width, &height );
+
+        if ( !texels )
+        {
+            return 0;
+        }
+
+        ID3D11ShaderResourceView * textureView = CreateFontArrayTextureView( device, width, height, fontCount, texels );
+        delete [] texels;
+
+        return textureView;
+    }
+
+    /*---------------------------------------------------------------------------------
+        CreateGlyphCacheTextureView
+        Creates the texture of a glyph cache, and a shader resource view of it. The
+        texture is updated as glyphs are copied into the cache, so it isn't immutable
+    ---------------------------------------------------------------------------------*/
+    ID3D11ShaderResourceView * CreateGlyphCacheTextureView( ID3D11Device * device, const TinyTextGlyphCache_c & glyphCache, ID3D11Texture2D ** texturePtr )
+    {
+        D3D11_TEXTURE2D_DESC desc;
+        desc.Width = glyphCache.GetTextureWidth( );
+        desc.Height = glyphCache.GetTextureHeight( );
+        desc.MipLevels = 1;
+        desc.ArraySize = 1;
+        desc.Format = DXGI_FORMAT_R8_UNORM;
+        desc.SampleDesc.Count = 1;
+        desc.SampleDesc.Quality = 0;
+        desc.Usage = D3D11_USAGE_DEFAULT;
+        desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+        desc.CPUAccessFlags = 0;
+        desc.MiscFlags = 0;
+
+        D3D11_SUBRESOURCE_DATA initialData;
+        initialData.pSysMem = glyphCache.GetTexels( );
+        initialData.SysMemPitch = glyphCache.GetTextureWidth( );
+        initialData.SysMemSlicePitch = 0;
+
+        ID3D11Texture2D * texture = 0;
+
+        if ( FAILED ( device->CreateTexture2D( &desc, &initialData, &texture ) ) || !texture )
+        {
+            return 0;
+        }
+
+        ID3D11ShaderResourceView * textureView = CreateTextureArrayView( device, texture, DXGI_FORMAT_R8_UNORM, 1 );
+
+        if ( !textureView )
         {
+            texture->Release( );
             return 0;
         }
 
+        *texturePtr = texture;
         return textureView;
     }
 
@@ -367,10 +452,10 @@
         CreatePixelShader
         Creates a pixel shader that will be used to render the font characters
     ---------------------------------------------------------------------------------*/
-    ID3D11PixelShader * CreatePixelShader( ID3D11Device * device )
+    ID3D11PixelShader * CreatePixelShader( ID3D11Device * device, const char * entryPoint )
     {
         // Compile the shader
-        ID3D10Blob * bytecode = CompileShader("PSMain", "ps_4_0");
+        ID3D10Blob * bytecode = CompileShader(entryPoint, "ps_4_0");
         if ( !bytecode )
         {
             return 0;
@@ -448,18 +533,18 @@
         Creates a sampler state which will be used by the pixel shader when sampling
         the font texture
     ---------------------------------------------------------------------------------*/
-    ID3D11SamplerState * CreateSamplerState( ID3D11Device * device )
+    ID3D11SamplerState * CreateSamplerState( ID3D11Device * device, D3D11_FILTER filter, D3D11_TEXTURE_ADDRESS_MODE addressMode )
     {
         D3D11_SAMPLER_DESC desc;
-        desc.AddressU = D3D11_TEXTURE_ADDRESS_WRAP;
-        desc.AddressV = D3D11_TEXTURE_ADDRESS_WRAP;
-        desc.AddressW = D3D11_TEXTURE_ADDRESS_WRAP;
+        desc.AddressU = addressMode;
+        desc.AddressV = addressMode;
+        desc.AddressW = addressMode;
         desc.BorderColor[0] = 0.0f;
         desc.BorderColor[1] = 0.0f;
         desc.BorderColor[2] = 0.0f;
         desc.BorderColor[3] = 0.0f;
         desc.ComparisonFunc = D3D11_COMPARISON_ALWAYS;
-        desc.Filter = D3D11_FILTER_MIN_MAG_MIP_POINT;
+        desc.Filter = filter;
         desc.MaxAnisotropy = 0;
         desc.MinLOD = 0.0f;
         desc.MaxLOD = 0.0f;
@@ -506,30 +591,176 @@
     }
 
     /*---------------------------------------------------------------------------------
-        EncodePositionCoord
-        Encodes the specified position coordinate into a dword that will be inserted
-        into the vertex stream
+        StatsTimer_c
+        Adds the time between its construction and destruction to a count of
+        performance counter ticks, if timing is enabled
     ---------------------------------------------------------------------------------*/
-    DWORD EncodePositionCoord( float pos )
+    class StatsTimer_c
     {
-        return *( ( DWORD * ) &pos );
-    }
+    private:
+
+        LONGLONG * ticks;
+        LARGE_INTEGER start;
+
+    public:
+
+        // Constructor - starts the timer
+        StatsTimer_c( bool enabled, LONGLONG & ticks )
+            : ticks( enabled ? &ticks : 0 )
+        {
+            if ( this->ticks )
+            {
+                QueryPerformanceCounter( &start );
+            }
+        }
+
+        // Destructor - stops the timer
+        ~StatsTimer_c( )
+        {
+            if ( ticks )
+            {
+                LARGE_INTEGER end;
+                QueryPerformanceCounter( &end );
+                *ticks += end.QuadPart - start.QuadPart;
+            }
+        }
+    };
 
+//}
+
+/*---------------------------------------------------------------------------------
+    TraceEvent_s
+    A timed event, recorded while tracing
+---------------------------------------------------------------------------------*/
+struct TraceEvent_s
+{
+    const char * name;
+    LONGLONG start;
+    LONGLONG end;
+    DWORD threadId;
+    int glyphCount;                 // Negative if the event doesn't encode glyphs
+    volatile unsigned int sequence; // One more than the event's number, written last
+};
+
+/*---------------------------------------------------------------------------------
+    TraceRing_s
+    A ring of the most recent trace events. Writers claim a slot by atomically
+    incrementing 'count', so events can be recorded from any thread without locking.
+    A slot's 'sequence' is cleared before its event is written, and set once it is
+    complete, so that a reader can skip events that are still being written
+---------------------------------------------------------------------------------*/
+struct TraceRing_s
+{
+    TraceEvent_s * events;
+    unsigned int mask;                  // The capacity (a power of two), minus one
+    volatile unsigned int count;        // Total number of events ever recorded
+    LONGLONG frequency;
+};
+
+//namespace
+//{
     /*---------------------------------------------------------------------------------
-        EncodeUVCoords
-        Encodes the specified u and v coordinate into a dword that will be inserted
-        into the vertex stream
+        TraceScope_c
+        Records a trace event spanning its construction and destruction, if tracing
+        is enabled
     ---------------------------------------------------------------------------------*/
-    DWORD EncodeUVCoords( int u, int v )
+    class TraceScope_c
     {
-        DWORD result = u & 0x0000FFFF;
-        result |= ( v << 16 ) & 0xFFFF0000;
-        return result;
-    }
+    private:
+
+        TraceRing_s * ring;
+        const char * name;
+        LARGE_INTEGER start;
+        int glyphCount;
+
+    public:
+
+        // Constructor - starts the event
+        TraceScope_c( TraceRing_s * ring, const char * name )
+            : ring( ring ), name( name ), glyphCount( -1 )
+        {
+            if ( ring )
+            {
+                QueryPerformanceCounter( &start );
+            }
+        }
+
+        // Destructor - ends the event and adds it to the ring
+        ~TraceScope_c( )
+        {
+            if ( ring )
+            {
+                LARGE_INTEGER end;
+                QueryPerformanceCounter( &end );
+
+                unsigned int sequence = ( unsigned int ) InterlockedIncrement( ( volatile LONG * ) &ring->count );
+
+                TraceEvent_s & event = ring->events[ ( sequence - 1 ) & ring->mask ];
+                event.sequence = 0;
+                MemoryBarrier( );
+
+                event.name = name;
+                event.start = start.QuadPart;
+                event.end = end.QuadPart;
+                event.threadId = GetCurrentThreadId( );
+                event.glyphCount = glyphCount;
+
+                MemoryBarrier( );
+                event.sequence = sequence;
+            }
+        }
+
+        // Records the number of glyphs encoded during the event
+        void SetGlyphCount( unsigned int count )
+        {
+            glyphCount = int( count );
+        }
+    };
 //}
 
 //namespace
 //{
+    /*---------------------------------------------------------------------------------
+        TinyTextStats_c::TinyTextStats_c
+        Constructor
+    ---------------------------------------------------------------------------------*/
+    TinyTextStats_c::TinyTextStats_c( )
+    :   glyphsEncoded( 0 ),
+        glyphsDropped( 0 ),
+        verticesDrawn( 0 ),
+        verticesSkipped( 0 ),
+        bytesUploaded( 0 ),
+        mapCount( 0 ),
+        capacityHighWater( 0 ),
+        deviceContextCalls( 0 ),
+        drawCalls( 0 ),
+        printMilliseconds( 0.0f ),
+        mapMilliseconds( 0.0f ),
+        renderMilliseconds( 0.0f ),
+        gpuMilliseconds( 0.0f )
+    {
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextPrintSite_c::TinyTextPrintSite_c
+        Constructor
+    ---------------------------------------------------------------------------------*/
+    TinyTextPrintSite_c::TinyTextPrintSite_c( )
+    :   name( 0 ),
+        line( 0 ),
+        printCount( 0 ),
+        glyphsEncoded( 0 ),
+        glyphsDropped( 0 )
+    {
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextContext_c::UnattributedPrintSite, TinyTextContext_c::OtherPrintSites
+        Names of the sites that collect calls which can't be given a site of their own
+    ---------------------------------------------------------------------------------*/
+    const char TinyTextContext_c::UnattributedPrintSite[ ] = "(unattributed)";
+    const char TinyTextContext_c::OtherPrintSites[ ] = "(other sites)";
+
     /*---------------------------------------------------------------------------------
         TinyTextContext_c::Initialise
         Initialises this object
@@ -576,7 +807,7 @@
         }
 
         // Create pixel shader
-        ID3D11PixelShader * pixelShader = CreatePixelShader( device );
+        ID3D11PixelShader * pixelShader = CreatePixelShader( device, "PSMain" );
         if ( !pixelShader )
         {
             vertexShader->Release( );
@@ -597,7 +828,7 @@
         }
 
         // Create the sampler state
-        ID3D11SamplerState * samplerState = CreateSamplerState( device );
+        ID3D11SamplerState * samplerState = CreateSamplerState( device, D3D11_FILTER_MIN_MAG_MIP_POINT, D3D11_TEXTURE_ADDRESS_WRAP );
         if ( !samplerState )
         {
             vertexShader->Release( );
@@ -621,6 +852,19 @@
             return false;
         }
 
+        // Allocate layout scratch space
+        if ( !m_Encoder.Initialise( characterCapacity ) )
+        {
+            vertexShader->Release( );
+            inputLayout->Release( );
+            textureView->Release( );
+            pixelShader->Release( );
+            vertexBuffer->Release( );
+            samplerState->Release( );
+            depthStencilState->Release( );
+            return false;
+        }
+
         // Success - set object state and return success code
         m_Device = device;
         m_DeviceContext = deviceContext;
@@ -644,17 +888,52 @@
     :   m_Device( 0 ),
         m_DeviceContext( 0 ),
         m_TextureView( 0 ),
+        m_GlyphCacheTexture( 0 ),
+        m_GlyphCacheTextureView( 0 ),
         m_VertexShader( 0 ),
         m_PixelShader( 0 ),
+        m_DistanceFieldPixelShader( 0 ),
         m_InputLayout( 0 ),
         m_VertexBuffer( 0 ),
         m_SamplerState( 0 ),
+        m_DistanceFieldSamplerState( 0 ),
         m_DepthStencilState( 0 ),
-        m_NumVertices( 0 ),
-        m_Capacity( characterCapacity ),
-        m_VertexBufferWriteAddress( 0 )
+        m_DistanceField( false ),
+        m_StatsEnabled( false ),
+        m_TimerFrequency( 0 ),
+        m_PrintTicks( 0 ),
+        m_MapTicks( 0 ),
+        m_RenderTicks( 0 ),
+        m_GpuTimerIssueIndex( 0 ),
+        m_GpuTimerReadIndex( 0 ),
+        m_GpuStatsEnabled( false ),
+        m_StatsOverlayEnabled( false ),
+        m_StatsOverlayX( 0 ),
+        m_StatsOverlayY( 0 ),
+        m_StatsOverlayColour( DefaultColour ),
+        m_StatsOverlayVertices( 0 ),
+        m_StatsOverlaySkippedVertices( 0 ),
+        m_StatsOverlayDropped( 0 ),
+        m_StatsOverlayMapped( false ),
+        m_TraceRing( 0 ),
+        m_StatsHistoryIndex( 0 ),
+        m_StatsHistoryCount( 0 ),
+        m_PrintSiteName( 0 ),
+        m_PrintSiteLine( 0 ),
+        m_PrintSiteCount( 0 ),
+        m_PrintSiteReportCount( 0 )
     {
-        bool result = Initialise( device, deviceContext, m_Capacity );
+        ZeroMemory( m_GpuTimers, sizeof( m_GpuTimers ) );
+        ZeroMemory( &m_StatsOverlayViewport, sizeof( m_StatsOverlayViewport ) );
+        ZeroMemory( &m_SharedCounters, sizeof( m_SharedCounters ) );
+
+        LARGE_INTEGER frequency;
+        if ( QueryPerformanceFrequency( &frequency ) )
+        {
+            m_TimerFrequency = frequency.QuadPart;
+        }
+
+        bool result = Initialise( device, deviceContext, characterCapacity );
         if ( resultPtr )
         {
             *resultPtr = result;
@@ -668,12 +947,20 @@
     TinyTextContext_c::~TinyTextContext_c( )
     {
         UnmapVertexBuffer( );
+        ReleaseGpuTimers( );
+        EnableTrace( 0 );
 
         if ( m_TextureView )
         {
             m_TextureView->Release( );
         }
 
+        if ( m_GlyphCacheTexture )
+        {
+            m_GlyphCacheTexture->Release( );
+            m_GlyphCacheTextureView->Release( );
+        }
+
         if ( m_VertexShader )
         {
             m_VertexShader->Release( );
@@ -684,6 +971,11 @@
             m_PixelShader->Release( );
         }
 
+        if ( m_DistanceFieldPixelShader )
+        {
+            m_DistanceFieldPixelShader->Release( );
+        }
+
         if ( m_InputLayout )
         {
             m_InputLayout->Release( );
@@ -699,6 +991,11 @@
             m_SamplerState->Release( );
         }
 
+        if ( m_DistanceFieldSamplerState )
+        {
+            m_DistanceFieldSamplerState->Release( );
+        }
+
         if ( m_DepthStencilState )
         {
             m_DepthStencilState->Release( );
@@ -720,166 +1017,452 @@
     ---------------------------------------------------------------------------------*/
     bool TinyTextContext_c::Print( const D3D11_VIEWPORT & viewport, size_t maxCharacterCount, const char * text, int x, int y, DWORD colour )
     {
+        m_CaptureWriter.WritePrint( viewport.Width, viewport.Height, 0, maxCharacterCount, text, x, y, colour );
+
+        StatsTimer_c timer( m_StatsEnabled, m_PrintTicks );
+        TraceScope_c trace( m_TraceRing, "Print" );
+
         // If we haven't yet mapped the vertex buffer to CPU memory, then map it now
         if ( !MapVertexBuffer( ) )
         {
+            AddToPrintSite( 0, 0 );
             return false;
         }
 
-        // Add characters to the vertex buffer
-        char currentChar;
-
-        while ( ( currentChar = *( text++ ) ) != 0 && maxCharacterCount-- )
-        {
-            // If we have reached capacity already, return false immediately
-            if ( ( m_NumVertices / NumVerticesPerCharacter ) == m_Capacity )
-            {
-                return false;
-            }
-
-            // Extract character data
-            int u = CharacterData[ ( currentChar * CharacterByteCount ) + 0 ];
-            int v = CharacterData[ ( currentChar * CharacterByteCount ) + 1 ];
-            int height = CharacterData[ ( currentChar * CharacterByteCount ) + 2 ] & 0x0F;
-            int yoffset = ( CharacterData[ ( currentChar * CharacterByteCount ) + 2 ] ) >> 4;
-            int charY = y + yoffset;
-        
-            // Compute bottom-left and top-right vertices of the character
-            float bottomLeftX = ( ( 2 * x ) / float( viewport.Width ) ) - 1.0f;
-            float bottomLeftY = ( ( -2 * ( charY + height ) ) / float( viewport.Height ) ) + 1.0f;
-            int bottomLeftU = u;
-            int bottomLeftV = v + height;
-
-            float topRightX = ( ( 2 * ( x + CharacterWidth ) ) / float( viewport.Width ) ) - 1.0f;
-            float topRightY = ( ( -2 * ( charY ) ) / float( viewport.Height ) ) + 1.0f;
-            int topRightU = u + CharacterWidth;
-            int topRightV = v;
-        
-            // Add triangle vertices for this character to the vertex buffer
-            m_VertexBufferWriteAddress[ Triangle0_Vertex0_Position_X ] = EncodePositionCoord(bottomLeftX);
-            m_VertexBufferWriteAddress[ Triangle0_Vertex0_Position_Y ] = EncodePositionCoord(bottomLeftY);
-            m_VertexBufferWriteAddress[ Triangle0_Vertex0_UV ] = EncodeUVCoords(bottomLeftU, bottomLeftV);
-            m_VertexBufferWriteAddress[ Triangle0_Vertex0_Colour ] = colour;
-
-            m_VertexBufferWriteAddress[ Triangle0_Vertex1_Position_X ] = EncodePositionCoord(bottomLeftX);
-            m_VertexBufferWriteAddress[ Triangle0_Vertex1_Position_Y ] = EncodePositionCoord(topRightY);
-            m_VertexBufferWriteAddress[ Triangle0_Vertex1_UV ] = EncodeUVCoords(bottomLeftU, topRightV);
-            m_VertexBufferWriteAddress[ Triangle0_Vertex1_Colour ] = colour;
-
-            m_VertexBufferWriteAddress[ Triangle0_Vertex2_Position_X ] = EncodePositionCoord(topRightX);
-            m_VertexBufferWriteAddress[ Triangle0_Vertex2_Position_Y ] = EncodePositionCoord(bottomLeftY);
-            m_VertexBufferWriteAddress[ Triangle0_Vertex2_UV ] = EncodeUVCoords(topRightU, bottomLeftV);
-            m_VertexBufferWriteAddress[ Triangle0_Vertex2_Colour ] = colour;
-
-            m_VertexBufferWriteAddress[ Triangle1_Vertex0_Position_X ] = EncodePositionCoord(topRightX);
-            m_VertexBufferWriteAddress[ Triangle1_Vertex0_Position_Y ] = EncodePositionCoord(topRightY);
-            m_VertexBufferWriteAddress[ Triangle1_Vertex0_UV ] = EncodeUVCoords(topRightU, topRightV);
-            m_VertexBufferWriteAddress[ Triangle1_Vertex0_Colour ] = colour;
-
-            m_VertexBufferWriteAddress[ Triangle1_Vertex1_Position_X ] = EncodePositionCoord(topRightX);
-            m_VertexBufferWriteAddress[ Triangle1_Vertex1_Position_Y ] = EncodePositionCoord(bottomLeftY);
-            m_VertexBufferWriteAddress[ Triangle1_Vertex1_UV ] = EncodeUVCoords(topRightU, bottomLeftV);
-            m_VertexBufferWriteAddress[ Triangle1_Vertex1_Colour ] = colour;
-
-            m_VertexBufferWriteAddress[ Triangle1_Vertex2_Position_X ] = EncodePositionCoord(bottomLeftX);
-            m_VertexBufferWriteAddress[ Triangle1_Vertex2_Position_Y ] = EncodePositionCoord(topRightY);
-            m_VertexBufferWriteAddress[ Triangle1_Vertex2_UV ] = EncodeUVCoords(bottomLeftU, topRightV);
-            m_VertexBufferWriteAddress[ Triangle1_Vertex2_Colour ] = colour;
-        
-            // Update vertex buffer write position
-            m_VertexBufferWriteAddress += NumVertexElementsPerCharacter;
+        unsigned int numVertices = m_Encoder.GetNumVertices( );
+        unsigned int numDropped = m_Encoder.GetNumDroppedCharacters( );
+        bool result = m_Encoder.Print( viewport.Width, viewport.Height, maxCharacterCount, text, x, y, colour );
 
-            // Update vertex count
-            m_NumVertices += NumVerticesPerCharacter;
+        unsigned int glyphsEncoded = ( m_Encoder.GetNumVertices( ) - numVertices ) / NumVerticesPerCharacter;
+        trace.SetGlyphCount( glyphsEncoded );
+        AddToPrintSite( glyphsEncoded, m_Encoder.GetNumDroppedCharacters( ) - numDropped );
 
-            // Update current x position
-            x += CharacterWidth;
-        }
+        return result;
+    }
 
-        return true;
+    /*---------------------------------------------------------------------------------
+        TinyTextContext_c::Print
+        Print some text to the context, laid out according to 'format'. Colour is of
+        form 0xAABBGGRR
+    ---------------------------------------------------------------------------------*/
+    bool TinyTextContext_c::Print( const D3D11_VIEWPORT & viewport, const TinyTextFormat_c & format, const char * text, int x, int y, DWORD colour, int * width, int * height )
+    {
+        return Print( viewport, format, 0xffffffff, text, x, y, colour, width, height );
     }
 
     /*---------------------------------------------------------------------------------
-        TinyTextContext_c::Render
-        Render the context onto the screen
+        TinyTextContext_c::Print
+        Print some text to the context, laid out according to 'format'. Colour is of
+        form 0xAABBGGRR
     ---------------------------------------------------------------------------------*/
-    bool TinyTextContext_c::Render( bool maintainState )
+    bool TinyTextContext_c::Print( const D3D11_VIEWPORT & viewport, const TinyTextFormat_c & format, size_t maxCharacterCount, const char * text, int x, int y, DWORD colour, int * width, int * height )
     {
-        // If we haven't got a device, then we cannot continue
-        if ( !m_Device ) return false;
+        m_CaptureWriter.WritePrint( viewport.Width, viewport.Height, &format, maxCharacterCount, text, x, y, colour );
 
-        // If we haven't got a render-target, then we cannot continue
-        ID3D11RenderTargetView * rtv = 0;
-        m_DeviceContext->OMGetRenderTargets( 1, &rtv, 0 );
-        if ( rtv == 0 ) return false;
-        rtv->Release( ); rtv = 0;
+        StatsTimer_c timer( m_StatsEnabled, m_PrintTicks );
+        TraceScope_c trace( m_TraceRing, "Print" );
 
-        // Ensure the vertex buffer isn't mapped
-        UnmapVertexBuffer( );
-   
-        // Save previous device state
-        PreviousState_c state;
-        if ( maintainState )
+        // If we haven't yet mapped the vertex buffer to CPU memory, then map it now. The
+        // size of the text is still returned if it can't be printed
+        if ( !MapVertexBuffer( ) )
         {
-            state.Capture( m_DeviceContext );
+            if ( width || height )
+            {
+                m_Encoder.MeasureText( format, maxCharacterCount, text, width, height );
+            }
+
+            AddToPrintSite( 0, 0 );
+            return false;
         }
-        
-        // Setup render state
-        UINT vertexStride = ( NumVertexElementsPerCharacter / NumVerticesPerCharacter ) * sizeof( DWORD );
-        UINT vertexOffset = 0;
 
-        m_DeviceContext->VSSetShader( m_VertexShader, NULL, 0 );
-        m_DeviceContext->GSSetShader( 0, NULL, 0 );
-        m_DeviceContext->PSSetShader( m_PixelShader, NULL, 0 );
-        m_DeviceContext->PSSetShaderResources( 0, 1, &m_TextureView );
-        m_DeviceContext->PSSetSamplers( 0, 1, &m_SamplerState );
-        m_DeviceContext->IASetInputLayout( m_InputLayout );
-        m_DeviceContext->IASetVertexBuffers( 0, 1, &m_VertexBuffer, &vertexStride, &vertexOffset );
-        m_DeviceContext->IASetPrimitiveTopology( D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST );
-        m_DeviceContext->OMSetDepthStencilState( m_DepthStencilState, 0 );
-        m_DeviceContext->OMSetBlendState( 0, 0, 0xffffffff );
-        m_DeviceContext->RSSetState( 0 );
-        
-        // Render the font
-        m_DeviceContext->Draw(m_NumVertices, 0);
+        unsigned int numVertices = m_Encoder.GetNumVertices( );
+        unsigned int numDropped = m_Encoder.GetNumDroppedCharacters( );
+        bool result = m_Encoder.Print( viewport.Width, viewport.Height, format, maxCharacterCount, text, x, y, colour, width, height );
 
-        // Restore previous render state
-        if ( maintainState )
-        {
-            state.Restore( m_DeviceContext );
-        }
+        unsigned int glyphsEncoded = ( m_Encoder.GetNumVertices( ) - numVertices ) / NumVerticesPerCharacter;
+        trace.SetGlyphCount( glyphsEncoded );
+        AddToPrintSite( glyphsEncoded, m_Encoder.GetNumDroppedCharacters( ) - numDropped );
 
-        return true;
+        return result;
     }
 
     /*---------------------------------------------------------------------------------
-        TinyTextContext_c::MapVertexBuffer
-        Maps the vertex buffer to CPU memory (if it isn't already mapped)
+        TinyTextContext_c::MeasureText
+        Measure the size that some text would occupy if it was printed with 'format'
     ---------------------------------------------------------------------------------*/
-    bool TinyTextContext_c::MapVertexBuffer( )
+    void TinyTextContext_c::MeasureText( const TinyTextFormat_c & format, const char * text, int * width, int * height ) const
     {
-        // If we haven't got a device, then we cannot continue
-        if ( !m_DeviceContext ) return false;
+        MeasureText( format, 0xffffffff, text, width, height );
+    }
 
-        // If we haven't got a vertex buffer, then we cannot continue
-        if ( !m_VertexBuffer ) return false;
-    
-        if ( m_VertexBufferWriteAddress == 0 )
-        {
-            m_NumVertices = 0;
+    /*---------------------------------------------------------------------------------
+        TinyTextContext_c::MeasureText
+        Measure the size that some text would occupy if it was printed with 'format'
+    ---------------------------------------------------------------------------------*/
+    void TinyTextContext_c::MeasureText( const TinyTextFormat_c & format, size_t maxCharacterCount, const char * text, int * width, int * height ) const
+    {
+        m_Encoder.MeasureText( format, maxCharacterCount, text, width, height );
+    }
 
-            //m_VertexBuffer->Map( D3D11_MAP_WRITE_DISCARD, 0, ( void ** ) &m_VertexBufferWriteAddress );
+    /*---------------------------------------------------------------------------------
+        TinyTextContext_c::SetCodePage
+        Select the character set used to interpret the bytes passed to 'Print'
+    ---------------------------------------------------------------------------------*/
+    void TinyTextContext_c::SetCodePage( CodePage codePage )
+    {
+        m_Encoder.SetCodePage( TinyTextEncoder_c::CodePage( codePage ) );
+        m_CaptureWriter.WriteCharacterMap( m_Encoder.IsUTF8( ), m_Encoder.GetCharacterMap( ) );
+    }
 
-            D3D11_MAPPED_SUBRESOURCE mappedSubresource;
-            ZeroMemory( &mappedSubresource, sizeof( D3D11_MAPPED_SUBRESOURCE ) );
+    /*---------------------------------------------------------------------------------
+        TinyTextContext_c::SetCharacterMap
+        Set a custom mapping from each byte passed to 'Print' to a character of the font
+    ---------------------------------------------------------------------------------*/
+    void TinyTextContext_c::SetCharacterMap( const unsigned char characterMap[ 256 ] )
+    {
+        m_Encoder.SetCharacterMap( characterMap );
+        m_CaptureWriter.WriteCharacterMap( m_Encoder.IsUTF8( ), m_Encoder.GetCharacterMap( ) );
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextContext_c::SetFont
+        Select the font that text is printed with - a font pack, or NULL for the
+        built-in font
+    ---------------------------------------------------------------------------------*/
+    bool TinyTextContext_c::SetFont( const TinyTextFontPack_c * font )
+    {
+        return SetFonts( &font, 1 );
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextContext_c::SetFonts
+        Select several fonts at once, to be picked between by each run of text
+    ---------------------------------------------------------------------------------*/
+    bool TinyTextContext_c::SetFonts( const TinyTextFontPack_c * const * fonts, unsigned int fontCount )
+    {
+        if ( !m_Device || m_Encoder.IsEncoding( ) || !TinyTextEncoder_c::ValidateFonts( fonts, fontCount ) )
+        {
+            return false;
+        }
+
+        const bool distanceField = fonts[ 0 ] && fonts[ 0 ]->IsDistanceField( );
+
+        if ( distanceField && !CreateDistanceFieldState( ) )
+        {
+            return false;
+        }
+
+        ID3D11ShaderResourceView * textureView = CreateFontsTextureView( m_Device, fonts, fontCount );
+
+        if ( !textureView )
+        {
+            return false;
+        }
+
+        m_TextureView->Release( );
+        m_TextureView = textureView;
+        m_DistanceField = distanceField;
+
+        m_Encoder.SetFonts( fonts, fontCount );
+
+        return true;
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextContext_c::SetGlyphCache
+        Select a glyph cache to take glyphs from instead of the font, or NULL to go
+        back to the font
+    ---------------------------------------------------------------------------------*/
+    bool TinyTextContext_c::SetGlyphCache( TinyTextGlyphCache_c * glyphCache )
+    {
+        if ( !m_Device || m_Encoder.IsEncoding( ) || ( glyphCache && !glyphCache->GetTexels( ) ) )
+        {
+            return false;
+        }
+
+        if ( glyphCache && glyphCache->IsDistanceField( ) && !CreateDistanceFieldState( ) )
+        {
+            return false;
+        }
+
+        ID3D11Texture2D * texture = 0;
+        ID3D11ShaderResourceView * textureView = 0;
+
+        // The texture starts out as a copy of the cache, so nothing needs uploading
+        // until more glyphs are copied in
+        if ( glyphCache )
+        {
+            textureView = CreateGlyphCacheTextureView( m_Device, *glyphCache, &texture );
+
+            if ( !textureView )
+            {
+                return false;
+            }
+
+            glyphCache->ClearDirtyRows( );
+        }
+
+        if ( m_GlyphCacheTexture )
+        {
+            m_GlyphCacheTexture->Release( );
+            m_GlyphCacheTextureView->Release( );
+        }
+
+        m_GlyphCacheTexture = texture;
+        m_GlyphCacheTextureView = textureView;
+
+        m_Encoder.SetGlyphCache( glyphCache );
+
+        return true;
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextContext_c::SetFontScale
+        Scale every character of the font
+    ---------------------------------------------------------------------------------*/
+    void TinyTextContext_c::SetFontScale( float scale )
+    {
+        m_Encoder.SetFontScale( scale );
+        m_CaptureWriter.WriteFontScale( m_Encoder.GetFontScale( ) );
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextContext_c::CreateDistanceFieldState
+        Creates the pixel shader and sampler state of distance field fonts, the first
+        time that one is selected
+    ---------------------------------------------------------------------------------*/
+    bool TinyTextContext_c::CreateDistanceFieldState( )
+    {
+        if ( m_DistanceFieldPixelShader )
+        {
+            return true;
+        }
+
+        // The field is filtered, and clamped so that glyphs at the edges of the atlas
+        // don't pick up texels from the opposite edge
+        ID3D11PixelShader * pixelShader = CreatePixelShader( m_Device, "PSMainDistanceField" );
+        if ( !pixelShader )
+        {
+            return false;
+        }
+
+        ID3D11SamplerState * samplerState = CreateSamplerState( m_Device, D3D11_FILTER_MIN_MAG_MIP_LINEAR, D3D11_TEXTURE_ADDRESS_CLAMP );
+        if ( !samplerState )
+        {
+            pixelShader->Release( );
+            return false;
+        }
+
+        m_DistanceFieldPixelShader = pixelShader;
+        m_DistanceFieldSamplerState = samplerState;
+
+        return true;
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextContext_c::Render
+        Render the context onto the screen
+    ---------------------------------------------------------------------------------*/
+    bool TinyTextContext_c::Render( bool maintainState )
+    {
+        bool result;
+
+        // The overlay is encoded outside of the timer, so that it doesn't count
+        // towards the time that it displays
+        if ( m_StatsOverlayEnabled )
+        {
+            AddStatsOverlay( );
+        }
+
+        {
+            StatsTimer_c timer( m_StatsEnabled, m_RenderTicks );
+            result = RenderVertexBuffer( maintainState );
+        }
+
+        if ( m_Encoder.GetGlyphCache( ) )
+        {
+            m_Encoder.GetGlyphCache( )->EndFrame( );
+        }
+
+        m_CaptureWriter.WriteRender( );
+        EndFrame( );
+        EndPrintSiteFrame( );
+
+        return result;
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextContext_c::RenderVertexBuffer
+        Draws the contents of the vertex buffer
+    ---------------------------------------------------------------------------------*/
+    bool TinyTextContext_c::RenderVertexBuffer( bool maintainState )
+    {
+        // If we haven't got a device, then we cannot continue
+        if ( !m_Device ) return false;
+
+        // If we haven't got a render-target, then we cannot continue
+        ID3D11RenderTargetView * rtv = 0;
+        m_DeviceContext->OMGetRenderTargets( 1, &rtv, 0 );
+        ++m_FrameStats.deviceContextCalls;
+        if ( rtv == 0 ) return false;
+        rtv->Release( ); rtv = 0;
+
+        // Ensure the vertex buffer isn't mapped
+        UnmapVertexBuffer( );
+
+        // Upload the glyphs copied into the glyph cache this frame
+        UploadGlyphCache( );
+
+        // Collect any GPU timings from previous frames, and start timing this one if
+        // there is a free set of queries. If the GPU is so far behind that there
+        // isn't, this frame goes untimed rather than stalling
+        ReadGpuTimers( );
+
+        GpuTimer_s * gpuTimer = 0;
+        if ( m_GpuStatsEnabled && !m_GpuTimers[ m_GpuTimerIssueIndex ].pending )
+        {
+            gpuTimer = &m_GpuTimers[ m_GpuTimerIssueIndex ];
+            m_DeviceContext->Begin( gpuTimer->disjoint );
+            m_DeviceContext->End( gpuTimer->begin );
+            m_FrameStats.deviceContextCalls += 2;
+        }
+   
+        // Save previous device state
+        PreviousState_c state;
+        if ( maintainState )
+        {
+            TraceScope_c trace( m_TraceRing, "Capture" );
+            state.Capture( m_DeviceContext );
+            m_FrameStats.deviceContextCalls += PreviousState_c::NumDeviceContextCalls;
+        }
+        
+        // Setup render state
+        UINT vertexStride = ( NumVertexElementsPerCharacter / NumVerticesPerCharacter ) * sizeof( DWORD );
+        UINT vertexOffset = 0;
+
+        const TinyTextGlyphCache_c * glyphCache = m_Encoder.GetGlyphCache( );
+        ID3D11ShaderResourceView * textureView = glyphCache ? m_GlyphCacheTextureView : m_TextureView;
+
+        // Distance field fonts have a pixel shader and sampler of their own
+        const bool distanceField = glyphCache ? glyphCache->IsDistanceField( ) : m_DistanceField;
+        ID3D11PixelShader * pixelShader = distanceField ? m_DistanceFieldPixelShader : m_PixelShader;
+        ID3D11SamplerState * samplerState = distanceField ? m_DistanceFieldSamplerState : m_SamplerState;
+
+        m_DeviceContext->VSSetShader( m_VertexShader, NULL, 0 );
+        m_DeviceContext->GSSetShader( 0, NULL, 0 );
+        m_DeviceContext->PSSetShader( pixelShader, NULL, 0 );
+        m_DeviceContext->PSSetShaderResources( 0, 1, &textureView );
+        m_DeviceContext->PSSetSamplers( 0, 1, &samplerState );
+        m_DeviceContext->IASetInputLayout( m_InputLayout );
+        m_DeviceContext->IASetVertexBuffers( 0, 1, &m_VertexBuffer, &vertexStride, &vertexOffset );
+        m_DeviceContext->IASetPrimitiveTopology( D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST );
+        m_DeviceContext->OMSetDepthStencilState( m_DepthStencilState, 0 );
+        m_DeviceContext->OMSetBlendState( 0, 0, 0xffffffff );
+        m_DeviceContext->RSSetState( 0 );
+        m_FrameStats.deviceContextCalls += NumRenderStateCalls;
+        
+        // Render the font
+        {
+            TraceScope_c trace( m_TraceRing, "Draw" );
+            m_DeviceContext->Draw(m_Encoder.GetNumVertices( ), 0);
+        }
+
+        m_FrameStats.verticesDrawn = m_Encoder.GetNumVertices( );
+        ++m_FrameStats.deviceContextCalls;
+        ++m_FrameStats.drawCalls;
+
+        if ( gpuTimer )
+        {
+            m_DeviceContext->End( gpuTimer->end );
+            m_DeviceContext->End( gpuTimer->disjoint );
+            m_FrameStats.deviceContextCalls += 2;
+            gpuTimer->pending = true;
+            m_GpuTimerIssueIndex = ( m_GpuTimerIssueIndex + 1 ) % GpuTimerCount;
+        }
+
+        // Restore previous render state
+        if ( maintainState )
+        {
+            TraceScope_c trace( m_TraceRing, "Restore" );
+            state.Restore( m_DeviceContext );
+            m_FrameStats.deviceContextCalls += PreviousState_c::NumDeviceContextCalls;
+        }
+
+        return true;
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextContext_c::UploadGlyphCache
+        Uploads the rows of the glyph cache that have changed since the last frame, all
+        in a single update. Frames that only print cached glyphs upload nothing
+    ---------------------------------------------------------------------------------*/
+    void TinyTextContext_c::UploadGlyphCache( )
+    {
+        TinyTextGlyphCache_c * glyphCache = m_Encoder.GetGlyphCache( );
+        int firstRow;
+        int rowCount;
+
+        if ( !glyphCache || !glyphCache->GetDirtyRows( &firstRow, &rowCount ) )
+        {
+            return;
+        }
+
+        const UINT width = glyphCache->GetTextureWidth( );
+
+        D3D11_BOX box;
+        box.left = 0;
+        box.top = firstRow;
+        box.front = 0;
+        box.right = width;
+        box.bottom = firstRow + rowCount;
+        box.back = 1;
+
+        TraceScope_c trace( m_TraceRing, "UploadGlyphs" );
+        m_DeviceContext->UpdateSubresource( m_GlyphCacheTexture, 0, &box, glyphCache->GetTexels( ) + firstRow * width, width, 0 );
+        ++m_FrameStats.deviceContextCalls;
+
+        glyphCache->ClearDirtyRows( );
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextContext_c::MapVertexBuffer
+        Maps the vertex buffer to CPU memory (if it isn't already mapped)
+    ---------------------------------------------------------------------------------*/
+    bool TinyTextContext_c::MapVertexBuffer( )
+    {
+        // If we haven't got a device, then we cannot continue
+        if ( !m_DeviceContext ) return false;
+
+        // If we haven't got a vertex buffer, then we cannot continue
+        if ( !m_VertexBuffer ) return false;
+    
+        if ( !m_Encoder.IsEncoding( ) )
+        {
+            // The statistics overlay's own map isn't counted, timed or traced
+            const bool record = !m_StatsOverlayMapped;
+
+            if ( record )
+            {
+                ++m_FrameStats.mapCount;
+                ++m_FrameStats.deviceContextCalls;
+            }
+
+            StatsTimer_c timer( m_StatsEnabled && record, m_MapTicks );
+            TraceScope_c trace( record ? m_TraceRing : 0, "MapVertexBuffer" );
+
+            //m_VertexBuffer->Map( D3D11_MAP_WRITE_DISCARD, 0, ( void ** ) &m_VertexBufferWriteAddress );
+
+            D3D11_MAPPED_SUBRESOURCE mappedSubresource;
+            ZeroMemory( &mappedSubresource, sizeof( D3D11_MAPPED_SUBRESOURCE ) );
 
             HRESULT hr = m_DeviceContext->Map( m_VertexBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedSubresource );
-            m_VertexBufferWriteAddress = (DWORD*)mappedSubresource.pData;
 
-            if ( FAILED ( hr ) )
+            if ( FAILED ( hr ) || !mappedSubresource.pData )
             {
                 return false;
             }
+
+            m_Encoder.Begin( ( unsigned int * ) mappedSubresource.pData );
         }
 
         return true;
@@ -891,15 +1474,674 @@
     ---------------------------------------------------------------------------------*/
     void TinyTextContext_c::UnmapVertexBuffer( )
     {
-        if ( m_VertexBufferWriteAddress != 0 )
+        if ( m_Encoder.IsEncoding( ) )
         {
-            m_VertexBufferWriteAddress = 0;
+            TraceScope_c trace( m_StatsOverlayMapped ? 0 : m_TraceRing, "UnmapVertexBuffer" );
+            m_Encoder.End( );
 
             if ( m_VertexBuffer )
             {
                 // m_VertexBuffer->Unmap( );
                 m_DeviceContext->Unmap( m_VertexBuffer, 0 );
+                m_FrameStats.deviceContextCalls += m_StatsOverlayMapped ? 0 : 1;
+            }
+        }
+    }
+//}
+
+    /*---------------------------------------------------------------------------------
+        TinyTextContext_c::EnableStats
+        Enable or disable the timing of 'Print' and 'Render'
+    ---------------------------------------------------------------------------------*/
+    void TinyTextContext_c::EnableStats( bool enable )
+    {
+        m_StatsEnabled = enable && m_TimerFrequency;
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextContext_c::EnableGpuStats
+        Enable or disable the timing of 'Render' on the GPU
+    ---------------------------------------------------------------------------------*/
+    bool TinyTextContext_c::EnableGpuStats( bool enable )
+    {
+        if ( !enable )
+        {
+            m_GpuStatsEnabled = false;
+            return true;
+        }
+
+        if ( !m_Device )
+        {
+            return false;
+        }
+
+        if ( !m_GpuTimers[ 0 ].disjoint )
+        {
+            D3D11_QUERY_DESC disjointDesc = { D3D11_QUERY_TIMESTAMP_DISJOINT, 0 };
+            D3D11_QUERY_DESC timestampDesc = { D3D11_QUERY_TIMESTAMP, 0 };
+
+            for ( unsigned int i = 0; i < GpuTimerCount; ++i )
+            {
+                GpuTimer_s & timer = m_GpuTimers[ i ];
+
+                if ( FAILED ( m_Device->CreateQuery( &disjointDesc, &timer.disjoint ) ) ||
+                     FAILED ( m_Device->CreateQuery( &timestampDesc, &timer.begin ) ) ||
+                     FAILED ( m_Device->CreateQuery( &timestampDesc, &timer.end ) ) )
+                {
+                    ReleaseGpuTimers( );
+                    return false;
+                }
+            }
+        }
+
+        m_GpuStatsEnabled = true;
+        return true;
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextContext_c::ReadGpuTimers
+        Collects the results of any GPU timestamp queries that have completed. Queries
+        complete in the order they were issued, so this stops at the first that hasn't
+    ---------------------------------------------------------------------------------*/
+    void TinyTextContext_c::ReadGpuTimers( )
+    {
+        while ( m_GpuTimers[ m_GpuTimerReadIndex ].pending )
+        {
+            GpuTimer_s & timer = m_GpuTimers[ m_GpuTimerReadIndex ];
+
+            D3D11_QUERY_DATA_TIMESTAMP_DISJOINT disjoint;
+            UINT64 begin;
+            UINT64 end;
+
+            ++m_FrameStats.deviceContextCalls;
+            if ( m_DeviceContext->GetData( timer.disjoint, &disjoint, sizeof( disjoint ), D3D11_ASYNC_GETDATA_DONOTFLUSH ) != S_OK )
+            {
+                break;
+            }
+
+            // The disjoint query ends last, so once it is complete the timestamps are too
+            m_FrameStats.deviceContextCalls += 2;
+            bool complete = m_DeviceContext->GetData( timer.begin, &begin, sizeof( begin ), D3D11_ASYNC_GETDATA_DONOTFLUSH ) == S_OK &&
+                            m_DeviceContext->GetData( timer.end, &end, sizeof( end ), D3D11_ASYNC_GETDATA_DONOTFLUSH ) == S_OK;
+
+            // Timestamps are meaningless if the GPU clock changed in between
+            if ( complete && !disjoint.Disjoint && disjoint.Frequency )
+            {
+                m_FrameStats.gpuMilliseconds = float( double( end - begin ) * 1000.0 / double( disjoint.Frequency ) );
+            }
+
+            timer.pending = false;
+            m_GpuTimerReadIndex = ( m_GpuTimerReadIndex + 1 ) % GpuTimerCount;
+        }
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextContext_c::ReleaseGpuTimers
+        Releases the GPU timestamp queries
+    ---------------------------------------------------------------------------------*/
+    void TinyTextContext_c::ReleaseGpuTimers( )
+    {
+        for ( unsigned int i = 0; i < GpuTimerCount; ++i )
+        {
+            GpuTimer_s & timer = m_GpuTimers[ i ];
+
+            if ( timer.disjoint )
+            {
+                timer.disjoint->Release( );
+            }
+
+            if ( timer.begin )
+            {
+                timer.begin->Release( );
+            }
+
+            if ( timer.end )
+            {
+                timer.end->Release( );
+            }
+        }
+
+        ZeroMemory( m_GpuTimers, sizeof( m_GpuTimers ) );
+        m_GpuTimerIssueIndex = 0;
+        m_GpuTimerReadIndex = 0;
+        m_GpuStatsEnabled = false;
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextContext_c::EnableTrace
+        Start (or stop) recording trace events
+    ---------------------------------------------------------------------------------*/
+    bool TinyTextContext_c::EnableTrace( unsigned int eventCapacity )
+    {
+        if ( m_TraceRing )
+        {
+            delete [] m_TraceRing->events;
+            delete m_TraceRing;
+            m_TraceRing = 0;
+        }
+
+        if ( !eventCapacity || !m_TimerFrequency )
+        {
+            return eventCapacity == 0;
+        }
+
+        // Round the capacity up to a power of two, so that slots can be found with a mask
+        unsigned int capacity = 1;
+        while ( capacity < eventCapacity && capacity < 0x80000000 )
+        {
+            capacity <<= 1;
+        }
+
+        TraceRing_s * ring = new ( std::nothrow ) TraceRing_s;
+        if ( !ring )
+        {
+            return false;
+        }
+
+        ring->events = new ( std::nothrow ) TraceEvent_s[ capacity ];
+        if ( !ring->events )
+        {
+            delete ring;
+            return false;
+        }
+
+        for ( unsigned int i = 0; i < capacity; ++i )
+        {
+            ring->events[ i ].sequence = 0;
+        }
+
+        ring->mask = capacity - 1;
+        ring->count = 0;
+        ring->frequency = m_TimerFrequency;
+
+        m_TraceRing = ring;
+        return true;
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextContext_c::WriteTrace
+        Write the recorded trace events to a file, as Chrome trace JSON. Timestamps are
+        the raw performance counter (in microseconds), so the events line up with any
+        other trace that is based on it
+    ---------------------------------------------------------------------------------*/
+    bool TinyTextContext_c::WriteTrace( const char * fileName ) const
+    {
+        if ( !m_TraceRing || !fileName )
+        {
+            return false;
+        }
+
+        FILE * file = 0;
+    #if defined( _MSC_VER )
+        fopen_s( &file, fileName, "w" );
+    #else
+        file = fopen( fileName, "w" );
+    #endif
+        if ( !file )
+        {
+            return false;
+        }
+
+        // Only the most recent events are still in the ring
+        unsigned int count = m_TraceRing->count;
+        unsigned int first = ( count > m_TraceRing->mask + 1 ) ? count - ( m_TraceRing->mask + 1 ) : 0;
+        double microsecondsPerTick = 1000000.0 / double( m_TraceRing->frequency );
+        DWORD processId = GetCurrentProcessId( );
+        const char * separator = "";
+
+        fprintf( file, "[" );
+
+        for ( unsigned int i = first; i < count; ++i )
+        {
+            // Copy the event, and skip it unless it was complete both before and after
+            // the copy - it may still be being written, or have been overwritten by a
+            // newer event
+            const TraceEvent_s & slot = m_TraceRing->events[ i & m_TraceRing->mask ];
+
+            if ( slot.sequence != i + 1 )
+            {
+                continue;
+            }
+
+            MemoryBarrier( );
+            TraceEvent_s event;
+            event.name = slot.name;
+            event.start = slot.start;
+            event.end = slot.end;
+            event.threadId = slot.threadId;
+            event.glyphCount = slot.glyphCount;
+            MemoryBarrier( );
+
+            if ( slot.sequence != i + 1 )
+            {
+                continue;
+            }
+
+            fprintf( file, "%s\n{\"name\":\"%s\",\"cat\":\"TinyText\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%lu,\"tid\":%lu",
+                     separator, event.name, double( event.start ) * microsecondsPerTick, double( event.end - event.start ) * microsecondsPerTick,
+                     ( unsigned long ) processId, ( unsigned long ) event.threadId );
+
+            if ( event.glyphCount >= 0 )
+            {
+                fprintf( file, ",\"args\":{\"glyphs\":%d}", event.glyphCount );
+            }
+
+            fprintf( file, "}" );
+            separator = ",";
+        }
+
+        fprintf( file, "\n]\n" );
+
+        bool result = !ferror( file );
+        fclose( file );
+        return result;
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextContext_c::BeginCapture
+        Start logging every call to 'Print' to a file
+    ---------------------------------------------------------------------------------*/
+    bool TinyTextContext_c::BeginCapture( const char * fileName )
+    {
+        if ( !m_CaptureWriter.Open( fileName ) )
+        {
+            return false;
+        }
+
+        // The log starts with the current settings, so that it replays the same
+        // whatever was selected before it was opened
+        m_CaptureWriter.WriteCharacterMap( m_Encoder.IsUTF8( ), m_Encoder.GetCharacterMap( ) );
+        m_CaptureWriter.WriteFontScale( m_Encoder.GetFontScale( ) );
+
+        return true;
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextContext_c::EndCapture
+        Stop logging calls to 'Print'
+    ---------------------------------------------------------------------------------*/
+    bool TinyTextContext_c::EndCapture( )
+    {
+        return m_CaptureWriter.Close( );
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextContext_c::GetStats
+        Retrieve the statistics for the last frame, and averaged over recent frames
+    ---------------------------------------------------------------------------------*/
+    void TinyTextContext_c::GetStats( TinyTextStats_c * frame, TinyTextStats_c * rolling ) const
+    {
+        if ( frame )
+        {
+            *frame = m_StatsHistoryCount ? m_StatsHistory[ ( m_StatsHistoryIndex + StatsHistoryLength - 1 ) % StatsHistoryLength ] : TinyTextStats_c( );
+        }
+
+        if ( rolling )
+        {
+            *rolling = TinyTextStats_c( );
+
+            if ( !m_StatsHistoryCount )
+            {
+                return;
+            }
+
+            // Sum the history, then divide by the number of frames it covers
+            float printMilliseconds = 0.0f;
+            float mapMilliseconds = 0.0f;
+            float renderMilliseconds = 0.0f;
+            float gpuMilliseconds = 0.0f;
+            unsigned int gpuFrameCount = 0;
+
+            for ( unsigned int i = 0; i < m_StatsHistoryCount; ++i )
+            {
+                const TinyTextStats_c & history = m_StatsHistory[ i ];
+                rolling->glyphsEncoded += history.glyphsEncoded;
+                rolling->glyphsDropped += history.glyphsDropped;
+                rolling->verticesDrawn += history.verticesDrawn;
+                rolling->verticesSkipped += history.verticesSkipped;
+                rolling->bytesUploaded += history.bytesUploaded;
+                rolling->mapCount += history.mapCount;
+                rolling->deviceContextCalls += history.deviceContextCalls;
+                rolling->drawCalls += history.drawCalls;
+                printMilliseconds += history.printMilliseconds;
+                mapMilliseconds += history.mapMilliseconds;
+                renderMilliseconds += history.renderMilliseconds;
+
+                // Frames without a GPU result don't count towards the GPU average
+                if ( history.gpuMilliseconds > 0.0f )
+                {
+                    gpuMilliseconds += history.gpuMilliseconds;
+                    ++gpuFrameCount;
+                }
             }
+
+            rolling->glyphsEncoded /= m_StatsHistoryCount;
+            rolling->glyphsDropped /= m_StatsHistoryCount;
+            rolling->verticesDrawn /= m_StatsHistoryCount;
+            rolling->verticesSkipped /= m_StatsHistoryCount;
+            rolling->bytesUploaded /= m_StatsHistoryCount;
+            rolling->mapCount /= m_StatsHistoryCount;
+            rolling->deviceContextCalls /= m_StatsHistoryCount;
+            rolling->drawCalls /= m_StatsHistoryCount;
+            rolling->capacityHighWater = m_FrameStats.capacityHighWater;
+            rolling->printMilliseconds = printMilliseconds / m_StatsHistoryCount;
+            rolling->mapMilliseconds = mapMilliseconds / m_StatsHistoryCount;
+            rolling->renderMilliseconds = renderMilliseconds / m_StatsHistoryCount;
+            rolling->gpuMilliseconds = gpuFrameCount ? gpuMilliseconds / gpuFrameCount : 0.0f;
+        }
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextContext_c::EnableSharedCounters
+        Publish the statistics of each frame in shared memory
+    ---------------------------------------------------------------------------------*/
+    bool TinyTextContext_c::EnableSharedCounters( bool enable )
+    {
+        if ( !enable )
+        {
+            m_SharedCountersWriter.Close( );
+            return true;
+        }
+
+        if ( m_SharedCountersWriter.IsOpen( ) )
+        {
+            return true;
+        }
+
+        ZeroMemory( &m_SharedCounters, sizeof( m_SharedCounters ) );
+        return m_SharedCountersWriter.Open( );
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextContext_c::EnableStatsOverlay
+        Draw the statistics of the last frame as part of every call to 'Render'
+    ---------------------------------------------------------------------------------*/
+    void TinyTextContext_c::EnableStatsOverlay( const D3D11_VIEWPORT * viewport, int x, int y, DWORD colour )
+    {
+        m_StatsOverlayEnabled = viewport != 0;
+
+        if ( viewport )
+        {
+            m_StatsOverlayViewport = *viewport;
+            m_StatsOverlayX = x;
+            m_StatsOverlayY = y;
+            m_StatsOverlayColour = colour;
+        }
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextContext_c::AddStatsOverlay
+        Encodes the statistics overlay. It goes straight to the encoder rather than
+        through 'Print', so it isn't timed, traced, captured or attributed to a site,
+        and the counts that it adds are recorded so that 'EndFrame' can take them out.
+        If it has to map the vertex buffer itself, the map isn't counted either
+    ---------------------------------------------------------------------------------*/
+    void TinyTextContext_c::AddStatsOverlay( )
+    {
+        TinyTextStats_c frame;
+        GetStats( &frame, 0 );
+
+        // If nothing was printed this frame, the map is the overlay's own
+        m_StatsOverlayMapped = !m_Encoder.IsEncoding( );
+
+        if ( !MapVertexBuffer( ) )
+        {
+            m_StatsOverlayMapped = false;
+            return;
+        }
+
+        const char * textFormat = "TinyText  %u / %u glyphs (%.0f%%)  %u dropped\nupload %.1f KB  %u maps  %u draws  %u calls\n%s";
+        const char * timingsFormat = m_StatsEnabled ? "CPU print %.3f ms  render %.3f ms  GPU %.3f ms" : "timings off - see EnableStats";
+        size_t capacity = m_Encoder.GetCapacity( );
+
+        char timings[ 128 ];
+        char text[ 384 ];
+
+    #if defined( _MSC_VER )
+        sprintf_s( timings, sizeof( timings ), timingsFormat, frame.printMilliseconds, frame.renderMilliseconds, frame.gpuMilliseconds );
+        sprintf_s( text, sizeof( text ), textFormat,
+    #else
+        sprintf( timings, timingsFormat, frame.printMilliseconds, frame.renderMilliseconds, frame.gpuMilliseconds );
+        sprintf( text, textFormat,
+    #endif
+                 frame.glyphsEncoded, ( unsigned int ) capacity, capacity ? frame.glyphsEncoded * 100.0 / capacity : 0.0, frame.glyphsDropped,
+                 frame.bytesUploaded / 1024.0, frame.mapCount, frame.drawCalls, frame.deviceContextCalls,
+                 timings );
+
+        unsigned int numVertices = m_Encoder.GetNumVertices( );
+        unsigned int numSkippedVertices = m_Encoder.GetNumSkippedVertices( );
+        unsigned int numDropped = m_Encoder.GetNumDroppedCharacters( );
+
+        m_Encoder.Print( m_StatsOverlayViewport.Width, m_StatsOverlayViewport.Height, TinyTextFormat_c( ), 0xffffffff, text, m_StatsOverlayX, m_StatsOverlayY, m_StatsOverlayColour );
+
+        m_StatsOverlayVertices += m_Encoder.GetNumVertices( ) - numVertices;
+        m_StatsOverlaySkippedVertices += m_Encoder.GetNumSkippedVertices( ) - numSkippedVertices;
+        m_StatsOverlayDropped += m_Encoder.GetNumDroppedCharacters( ) - numDropped;
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextContext_c::EndFrame
+        Records the statistics of the frame that has just been rendered
+    ---------------------------------------------------------------------------------*/
+    void TinyTextContext_c::EndFrame( )
+    {
+        TinyTextStats_c & frame = m_StatsHistory[ m_StatsHistoryIndex ];
+        frame = m_FrameStats;
+
+        // The vertex buffer only holds new characters if it was mapped this frame. The
+        // statistics overlay's characters are left out
+        if ( frame.mapCount )
+        {
+            unsigned int numVertices = m_Encoder.GetNumVertices( ) - m_StatsOverlayVertices;
+
+            frame.glyphsEncoded = numVertices / NumVerticesPerCharacter;
+            frame.glyphsDropped = m_Encoder.GetNumDroppedCharacters( ) - m_StatsOverlayDropped;
+            frame.verticesSkipped = m_Encoder.GetNumSkippedVertices( ) - m_StatsOverlaySkippedVertices;
+            frame.bytesUploaded = numVertices * ( NumVertexElementsPerCharacter / NumVerticesPerCharacter ) * sizeof( DWORD );
+        }
+
+        frame.verticesDrawn -= m_StatsOverlayVertices < frame.verticesDrawn ? m_StatsOverlayVertices : frame.verticesDrawn;
+
+        m_StatsOverlayVertices = 0;
+        m_StatsOverlaySkippedVertices = 0;
+        m_StatsOverlayDropped = 0;
+        m_StatsOverlayMapped = false;
+
+        if ( frame.glyphsEncoded > frame.capacityHighWater )
+        {
+            frame.capacityHighWater = frame.glyphsEncoded;
+        }
+
+        if ( m_TimerFrequency )
+        {
+            frame.printMilliseconds = float( m_PrintTicks * 1000.0 / m_TimerFrequency );
+            frame.mapMilliseconds = float( m_MapTicks * 1000.0 / m_TimerFrequency );
+            frame.renderMilliseconds = float( m_RenderTicks * 1000.0 / m_TimerFrequency );
+        }
+
+        if ( m_SharedCountersWriter.IsOpen( ) )
+        {
+            ++m_SharedCounters.frameCount;
+            m_SharedCounters.glyphsEncoded = frame.glyphsEncoded;
+            m_SharedCounters.capacity = ( unsigned int ) m_Encoder.GetCapacity( );
+            m_SharedCounters.glyphsDropped = frame.glyphsDropped;
+            m_SharedCounters.totalGlyphsDropped += frame.glyphsDropped;
+            m_SharedCounters.bytesUploaded = frame.bytesUploaded;
+            m_SharedCounters.drawCalls = frame.drawCalls;
+            m_SharedCounters.deviceContextCalls = frame.deviceContextCalls;
+            m_SharedCounters.printMilliseconds = frame.printMilliseconds;
+            m_SharedCounters.renderMilliseconds = frame.renderMilliseconds;
+            m_SharedCounters.gpuMilliseconds = frame.gpuMilliseconds;
+
+            m_SharedCountersWriter.Publish( m_SharedCounters );
+        }
+
+        m_StatsHistoryIndex = ( m_StatsHistoryIndex + 1 ) % StatsHistoryLength;
+        if ( m_StatsHistoryCount < StatsHistoryLength )
+        {
+            ++m_StatsHistoryCount;
+        }
+
+        // Start the next frame, carrying over the high-water mark
+        unsigned int capacityHighWater = frame.capacityHighWater;
+        m_FrameStats = TinyTextStats_c( );
+        m_FrameStats.capacityHighWater = capacityHighWater;
+        m_PrintTicks = 0;
+        m_MapTicks = 0;
+        m_RenderTicks = 0;
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextContext_c::AddToPrintSite
+        Adds the result of a call to 'Print' to the current site, and clears it
+    ---------------------------------------------------------------------------------*/
+    void TinyTextContext_c::AddToPrintSite( unsigned int glyphsEncoded, unsigned int glyphsDropped )
+    {
+        const char * name = m_PrintSiteName ? m_PrintSiteName : UnattributedPrintSite;
+        int line = m_PrintSiteName ? m_PrintSiteLine : 0;
+
+        m_PrintSiteName = 0;
+        m_PrintSiteLine = 0;
+
+        // Find the site's entry by probing from its hash, claiming the first empty entry
+        // if it isn't there yet. When only one entry is left it is kept for
+        // 'OtherPrintSites', and new sites are added to that instead
+        TinyTextPrintSite_c * site = 0;
+
+        for ( int attempt = 0; attempt < 2 && !site; ++attempt )
+        {
+            size_t hash = ( size_t( name ) >> 3 ) ^ ( size_t( line ) * 2654435761u );
+
+            for ( unsigned int probe = 0; probe < MaxPrintSites; ++probe )
+            {
+                TinyTextPrintSite_c & entry = m_PrintSites[ ( hash + probe ) & ( MaxPrintSites - 1 ) ];
+
+                if ( entry.name == name && entry.line == line )
+                {
+                    site = &entry;
+                    break;
+                }
+
+                if ( !entry.name )
+                {
+                    if ( m_PrintSiteCount + 1 < MaxPrintSites || name == OtherPrintSites )
+                    {
+                        entry.name = name;
+                        entry.line = line;
+                        ++m_PrintSiteCount;
+                        site = &entry;
+                    }
+
+                    break;
+                }
+            }
+
+            name = OtherPrintSites;
+            line = 0;
+        }
+
+        ++site->printCount;
+        site->glyphsEncoded += glyphsEncoded;
+        site->glyphsDropped += glyphsDropped;
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextContext_c::EndPrintSiteFrame
+        Sorts the sites of the frame that has just been rendered into a report, and
+        clears the table for the next frame
+    ---------------------------------------------------------------------------------*/
+    void TinyTextContext_c::EndPrintSiteFrame( )
+    {
+        m_PrintSiteReportCount = 0;
+
+        if ( !m_PrintSiteCount )
+        {
+            return;
+        }
+
+        // Insertion sort, busiest first - there are only a handful of sites
+        for ( unsigned int i = 0; i < MaxPrintSites; ++i )
+        {
+            const TinyTextPrintSite_c & site = m_PrintSites[ i ];
+            if ( !site.name )
+            {
+                continue;
+            }
+
+            unsigned int total = site.glyphsEncoded + site.glyphsDropped;
+            unsigned int j = m_PrintSiteReportCount++;
+
+            while ( j > 0 && m_PrintSiteReport[ j - 1 ].glyphsEncoded + m_PrintSiteReport[ j - 1 ].glyphsDropped < total )
+            {
+                m_PrintSiteReport[ j ] = m_PrintSiteReport[ j - 1 ];
+                --j;
+            }
+
+            m_PrintSiteReport[ j ] = site;
+            m_PrintSites[ i ] = TinyTextPrintSite_c( );
         }
+
+        m_PrintSiteCount = 0;
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextContext_c::GetTopPrintSites
+        Retrieve the sites that printed the most glyphs in the last frame
+    ---------------------------------------------------------------------------------*/
+    unsigned int TinyTextContext_c::GetTopPrintSites( TinyTextPrintSite_c * sites, unsigned int maxSites ) const
+    {
+        unsigned int count = maxSites < m_PrintSiteReportCount ? maxSites : m_PrintSiteReportCount;
+
+        for ( unsigned int i = 0; i < count; ++i )
+        {
+            sites[ i ] = m_PrintSiteReport[ i ];
+        }
+
+        return count;
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextContext_c::PrintSiteSummary
+        Print a list of the busiest sites of the last frame
+    ---------------------------------------------------------------------------------*/
+    bool TinyTextContext_c::PrintSiteSummary( const D3D11_VIEWPORT & viewport, int x, int y, unsigned int maxSites, DWORD colour )
+    {
+        static const char SummaryTag[ ] = "TinyText site summary";
+
+        SetPrintSite( SummaryTag, 0 );
+        bool result = Print( viewport, "  glyphs dropped  site", x, y, colour );
+
+        unsigned int count = maxSites < m_PrintSiteReportCount ? maxSites : m_PrintSiteReportCount;
+
+        for ( unsigned int i = 0; i < count; ++i )
+        {
+            const TinyTextPrintSite_c & site = m_PrintSiteReport[ i ];
+
+            // Only show the file name of a call site - the path is rarely needed
+            const char * name = site.name;
+            if ( site.line )
+            {
+                for ( const char * c = site.name; *c; ++c )
+                {
+                    if ( *c == '\\' || *c == '/' )
+                    {
+                        name = c + 1;
+                    }
+                }
+            }
+
+            const char * lineFormat = site.line ? "%8u %7u  %.80s(%d)" : "%8u %7u  %.80s";
+
+            char line[ 128 ];
+        #if defined( _MSC_VER )
+            sprintf_s( line, sizeof( line ), lineFormat, site.glyphsEncoded, site.glyphsDropped, name, site.line );
+        #else
+            sprintf( line, lineFormat, site.glyphsEncoded, site.glyphsDropped, name, site.line );
+        #endif
+
+            SetPrintSite( SummaryTag, 0 );
+            result = Print( viewport, line, x, y + int( i + 1 ) * m_Encoder.GetLineHeight( ), colour ) && result;
+        }
+
+        return result;
     }
-//}
\ No newline at end of file
@@ -16,6 +16,73 @@
                           an additional character count which can be used to
                           avoid buffer overruns
 
+                        - Passing a 'TinyTextFormat_c' lays the text out over
+                          multiple lines, honouring newlines, tab stops and an
+                          optional wrap width. It can also clip the text to a
+                          rectangle, so panels don't need their own draw calls,
+                          and anchor it by its centre, right or bottom edge. Its
+                          'scale' draws the text at a whole multiple of its size
+                          - see 'TinyTextFormat_c::GetScaleForDPI' for high-DPI
+                          monitors
+
+                    - 'TinyTextContext_c::MeasureText' returns the size of some
+                      text without printing it. A formatted 'Print' can also
+                      return the size of the text it prints
+
+                    - 'TinyTextContext_c::GetStats' reports the work done by the
+                      context, both for the last frame and averaged over recent
+                      frames. Timings are only collected after calling
+                      'TinyTextContext_c::EnableStats', and GPU timings after
+                      calling 'TinyTextContext_c::EnableGpuStats'
+
+                    - 'TinyTextContext_c::EnableStatsOverlay' makes 'Render' draw
+                      a panel of the last frame's statistics along with the
+                      text, in the same draw call. The panel's own glyphs and
+                      time aren't counted in the statistics that it displays
+
+                    - 'TinyTextContext_c::EnableSharedCounters' publishes the
+                      counters of each frame in shared memory, where other
+                      processes can read them without stopping the application
+                      (see 'TinyTextCounters.h')
+
+                    - 'TinyTextContext_c::EnableTrace' records the context's work
+                      as timed events, which 'TinyTextContext_c::WriteTrace'
+                      saves in the Chrome trace format (for chrome://tracing
+                      or Perfetto)
+
+                    - Printing through the 'TINYTEXT_PRINT' macro (or
+                      'TINYTEXT_PRINT_TAGGED') attributes the glyphs to the call
+                      site (or a tag). 'TinyTextContext_c::GetTopPrintSites'
+                      returns the sites that printed the most in the last frame,
+                      and 'TinyTextContext_c::PrintSiteSummary' lists them on
+                      screen - useful for finding who is filling the context
+
+                    - 'TinyTextContext_c::BeginCapture' logs every call to 'Print'
+                      to a file, which the benchmark tool can replay offline
+
+                    - Text is interpreted as Windows-1252 by default. Other code
+                      pages (or a custom mapping) can be selected with
+                      'TinyTextContext_c::SetCodePage' or 'SetCharacterMap'
+
+                    - Text uses the built-in font unless a font pack (see
+                      'TinyTextFontPack.h') is selected with
+                      'TinyTextContext_c::SetFont'
+
+                    - 'TinyTextContext_c::SetFonts' selects up to four fonts at
+                      once, held in a 'Texture2DArray', and each 'Print' picks
+                      one with 'TinyTextFormat_c::font'. Text in every font is
+                      still drawn with one 'Draw' and no state changes
+
+                    - Distance field font packs are drawn with a filtered
+                      sampler and a pixel shader of their own, so that
+                      'TinyTextContext_c::SetFontScale' can draw them at any
+                      size - one pack serves a 4K display and a 1080p one alike
+
+                    - For UTF-8 text in fonts too large for a single texture
+                      (CJK, say), select 'CodePageUTF8' and a glyph cache (see
+                      'TinyTextGlyphCache.h') with
+                      'TinyTextContext_c::SetGlyphCache'
+
                     - At the end of your frame, call 'TinyTextContext_c::Render'
                       to draw all text to the screen
 
@@ -33,6 +100,89 @@
     Includes
 ---------------------------------------------------------------------------------*/
 #include <d3d11.h>
+#include "TinyTextEncoder.h"
+#include "TinyTextCapture.h"
+#include "TinyTextCounters.h"
+
+/*---------------------------------------------------------------------------------
+    TinyTextStats_c
+    Describes the work done by a text context during a frame (from one call to
+    'TinyTextContext_c::Render' to the next)
+---------------------------------------------------------------------------------*/
+class TinyTextStats_c
+{
+public:
+
+    // Constructor - zeroes all statistics
+    TinyTextStats_c( );
+
+    // Characters added to the vertex buffer
+    unsigned int glyphsEncoded;
+
+    // Characters that were not added because the context was full
+    unsigned int glyphsDropped;
+
+    // Vertices drawn by 'Render'
+    unsigned int verticesDrawn;
+
+    // Vertices that blank characters would have added, had they not been skipped
+    unsigned int verticesSkipped;
+
+    // Bytes written to the vertex buffer
+    unsigned int bytesUploaded;
+
+    // Number of times the vertex buffer was mapped (and unmapped)
+    unsigned int mapCount;
+
+    // The most characters that the context has held in any frame
+    unsigned int capacityHighWater;
+
+    // Calls made to the device context - state changes (including those that save
+    // and restore the application's state), queries, maps and draws
+    unsigned int deviceContextCalls;
+
+    // Draw calls issued by 'Render'
+    unsigned int drawCalls;
+
+    // CPU time spent in 'Print', mapping the vertex buffer (which is also counted as
+    // part of 'Print') and 'Render'. Only measured while stats are enabled
+    float printMilliseconds;
+    float mapMilliseconds;
+    float renderMilliseconds;
+
+    // GPU time spent on the state setup and draw of 'Render'. Timestamp queries are
+    // read back without stalling, so this is the most recent result to become
+    // available, typically from a few frames earlier. Only measured while GPU stats
+    // are enabled
+    float gpuMilliseconds;
+};
+
+/*---------------------------------------------------------------------------------
+    TinyTextPrintSite_c
+    The glyphs printed during a frame from a single call site (or tag)
+---------------------------------------------------------------------------------*/
+class TinyTextPrintSite_c
+{
+public:
+
+    // Constructor - zeroes all counts
+    TinyTextPrintSite_c( );
+
+    // The file of the call site, or the tag. NULL for an unused entry
+    const char * name;
+
+    // The line of the call site, or zero for a tag
+    int line;
+
+    // Calls made to 'Print'
+    unsigned int printCount;
+
+    // Characters added to the vertex buffer
+    unsigned int glyphsEncoded;
+
+    // Characters that were not added because the context was full
+    unsigned int glyphsDropped;
+};
 
 /*---------------------------------------------------------------------------------
     TinyTextContext_c
@@ -54,15 +204,155 @@ public:
 
     // Default text colour = opaque white
     static const DWORD DefaultColour = 0xFFFFFFFF;
+
+    // Width of each character of the built-in font (in pixels) - the font is
+    // fixed-width
+    static const int CharacterWidth = TinyTextEncoder_c::CharacterWidth;
+
+    // Distance between the tops of consecutive lines of text in the built-in font
+    // (in pixels)
+    static const int LineHeight = TinyTextEncoder_c::LineHeight;
+
+    // Character sets that the bytes passed to 'Print' can be interpreted as
+    enum CodePage
+    {
+        CodePageWindows1252     = TinyTextEncoder_c::CodePageWindows1252,   // The character set of the font itself (the default)
+        CodePageLatin1          = TinyTextEncoder_c::CodePageLatin1,        // ISO 8859-1 - bytes 0x80-0x9F are control characters
+        CodePage437             = TinyTextEncoder_c::CodePage437,           // The IBM PC character set - line drawing is approximated
+        CodePageUTF8            = TinyTextEncoder_c::CodePageUTF8           // Unicode - characters the font doesn't have are drawn as '?'
+    };
+
+    // Select the character set used to interpret the bytes passed to 'Print'
+    void SetCodePage( CodePage codePage );
+
+    // Set a custom mapping from each byte passed to 'Print' to a character of the font,
+    // which uses the Windows-1252 character set
+    void SetCharacterMap( const unsigned char characterMap[ 256 ] );
+
+    // Select the font that text is printed with - a font pack, or NULL for the
+    // built-in font. The font texture is created from the pack's atlas, so the pack
+    // can be closed afterwards. Returns 'false' (and keeps the current font) if the
+    // texture can't be created, or if text has been printed since the last 'Render'
+    bool SetFont( const TinyTextFontPack_c * font );
+
+    // Select several fonts at once - font packs, or NULL for the built-in font - to be
+    // picked between by 'TinyTextFormat_c::font'. See
+    // 'TinyTextEncoder_c::ValidateFonts' for the fonts that can be selected together.
+    // Otherwise works as 'SetFont' does
+    bool SetFonts( const TinyTextFontPack_c * const * fonts, unsigned int fontCount );
+
+    // Select a glyph cache to take glyphs from instead of the font, or NULL to go
+    // back to the font. The cache must outlive the context, or be deselected first.
+    // Returns 'false' if the cache's texture can't be created, or if text has been
+    // printed since the last 'Render'
+    bool SetGlyphCache( TinyTextGlyphCache_c * glyphCache );
+
+    // Scale the font - see 'TinyTextEncoder_c::SetFontScale'. Distance field fonts
+    // stay sharp at any scale
+    void SetFontScale( float scale );
+    float GetFontScale( ) const { return m_Encoder.GetFontScale( ); }
+
+    // Size of each character's cell in one of the current fonts, once scaled (in
+    // pixels)
+    int GetCharacterWidth( unsigned int font = 0 ) const { return m_Encoder.GetCharacterWidth( font ); }
+    int GetLineHeight( unsigned int font = 0 ) const { return m_Encoder.GetLineHeight( font ); }
+
+    // Whether one of the current fonts lays characters out by their own advances
+    bool IsProportional( unsigned int font = 0 ) const { return m_Encoder.IsProportional( font ); }
     
     // Print some text to the context - returns 'true' on success or 'false' on failure.
     // 'colour' is expected to be in the form: 0xAABBGGRR.
     bool Print( const D3D11_VIEWPORT & viewport, const char * text, int x, int y, DWORD colour = DefaultColour );
     bool Print( const D3D11_VIEWPORT & viewport, size_t maxCharacterCount, const char * text, int x, int y, DWORD colour = DefaultColour );
+
+    // Print some text to the context, laid out according to 'format'. Newlines, tabs
+    // and wrapping are all resolved in a single pass over the text. If 'width' or
+    // 'height' isn't NULL, it receives the size of the text, as 'MeasureText' would
+    // return it, from that same pass
+    bool Print( const D3D11_VIEWPORT & viewport, const TinyTextFormat_c & format, const char * text, int x, int y, DWORD colour = DefaultColour, int * width = 0, int * height = 0 );
+    bool Print( const D3D11_VIEWPORT & viewport, const TinyTextFormat_c & format, size_t maxCharacterCount, const char * text, int x, int y, DWORD colour = DefaultColour, int * width = 0, int * height = 0 );
     
+    // Measure the size (in pixels) that some text would occupy if it was printed with
+    // 'format'. The width is that of the widest line; either pointer may be NULL
+    void MeasureText( const TinyTextFormat_c & format, const char * text, int * width, int * height ) const;
+    void MeasureText( const TinyTextFormat_c & format, size_t maxCharacterCount, const char * text, int * width, int * height ) const;
+
     // Render the context onto the screen - returns 'true' on success or 'false' on failure
     bool Render( bool maintainState = true );
 
+    // Returns the number of vertices that characters with no visible pixels (such as
+    // spaces) would have added to the current frame, had they not been skipped
+    unsigned int GetNumSkippedVertices( ) const { return m_Encoder.GetNumSkippedVertices( ); }
+
+    // Number of frames that rolling statistics are averaged over
+    static const unsigned int StatsHistoryLength = 32;
+
+    // Enable or disable the timing of 'Print' and 'Render'. The counters are always
+    // maintained, as they cost next to nothing
+    void EnableStats( bool enable );
+
+    // Enable or disable the timing of 'Render' on the GPU - returns 'false' if the
+    // timestamp queries could not be created
+    bool EnableGpuStats( bool enable );
+
+    // Start recording trace events (for 'Print', mapping and unmapping the vertex
+    // buffer, saving and restoring device state, and drawing) into a ring that holds
+    // the most recent 'eventCapacity' events. Zero stops recording. Returns 'false'
+    // if the ring could not be allocated
+    bool EnableTrace( unsigned int eventCapacity );
+
+    // Write the recorded trace events to a file, as Chrome trace JSON. Events can be
+    // recorded from any thread, even while the trace is being written - any that are
+    // still being recorded are left out
+    bool WriteTrace( const char * fileName ) const;
+
+    // Start logging every call to 'Print' (with the end of each frame, and changes of
+    // code page, character map and font scale) to a file, for replay by the
+    // benchmark tool - returns 'false' if the file can't be created
+    bool BeginCapture( const char * fileName );
+
+    // Stop logging - returns 'false' if any of the log couldn't be written
+    bool EndCapture( );
+
+    // Retrieve the statistics for the last frame, and averaged over the last
+    // 'StatsHistoryLength' frames. Either pointer may be NULL
+    void GetStats( TinyTextStats_c * frame, TinyTextStats_c * rolling ) const;
+
+    // Publish the statistics of each frame in shared memory, for other processes to
+    // read with 'TinyTextCountersReader_c' - returns 'false' if the shared memory
+    // couldn't be created, or if another context in this process publishes them
+    bool EnableSharedCounters( bool enable );
+
+    // Draw the statistics of the last frame (glyphs and capacity used, bytes
+    // uploaded, timings and dropped characters) at the specified position, as part
+    // of every call to 'Render'. The panel's own glyphs, bytes and time aren't
+    // included in the statistics, nor is the map it makes on a frame where nothing
+    // else was printed. Pass a NULL viewport to turn the panel off
+    void EnableStatsOverlay( const D3D11_VIEWPORT * viewport, int x = 8, int y = 8, DWORD colour = DefaultColour );
+
+    // Maximum number of call sites (and tags) tracked in each frame. Any more are
+    // counted together, under 'OtherPrintSites'
+    static const unsigned int MaxPrintSites = 64;
+
+    // Names of the sites that collect calls to 'Print' made without a site, and calls
+    // from sites that didn't fit in the table
+    static const char UnattributedPrintSite[ ];
+    static const char OtherPrintSites[ ];
+
+    // Attribute the next call to 'Print' to a call site or, with a line of zero, a
+    // tag. Sites are told apart by the address of 'name', which must remain valid -
+    // use the 'TINYTEXT_PRINT' macros, which pass '__FILE__' and '__LINE__' (or a
+    // string literal as the tag)
+    void SetPrintSite( const char * name, int line ) { m_PrintSiteName = name; m_PrintSiteLine = line; }
+
+    // Retrieve the sites that printed the most glyphs (encoded or dropped) in the last
+    // frame, busiest first - returns the number of sites written to 'sites'
+    unsigned int GetTopPrintSites( TinyTextPrintSite_c * sites, unsigned int maxSites ) const;
+
+    // Print a list of the busiest sites of the last frame, one per line - returns
+    // 'false' if any of it didn't fit. The list is attributed to a site of its own
+    bool PrintSiteSummary( const D3D11_VIEWPORT & viewport, int x, int y, unsigned int maxSites = 8, DWORD colour = DefaultColour );
+
 private:
 
     // Deliberately not implemented - this object cannot be copied or assigned to
@@ -75,9 +365,40 @@ private:
     // Maps the vertex buffer to CPU memory (if it isn't already mapped)
     bool MapVertexBuffer( );
 
+    // Draws the contents of the vertex buffer - returns 'true' on success or 'false'
+    // on failure
+    bool RenderVertexBuffer( bool maintainState );
+
+    // Uploads the rows of the glyph cache's texture that have changed
+    void UploadGlyphCache( );
+
+    // Records the statistics of the frame that has just been rendered
+    void EndFrame( );
+
+    // Encodes the statistics overlay, keeping its glyphs out of the statistics
+    void AddStatsOverlay( );
+
+    // Adds the result of a call to 'Print' to the site set by 'SetPrintSite', and
+    // clears it
+    void AddToPrintSite( unsigned int glyphsEncoded, unsigned int glyphsDropped );
+
+    // Sorts the sites of the frame that has just been rendered into a report, and
+    // clears the table
+    void EndPrintSiteFrame( );
+
+    // Collects the results of any GPU timestamp queries that have completed
+    void ReadGpuTimers( );
+
+    // Releases the GPU timestamp queries
+    void ReleaseGpuTimers( );
+
     // Unmaps the vertex buffer to CPU memory (if it isn't already unmapped)
     void UnmapVertexBuffer( );
 
+    // Creates the pixel shader and sampler state of distance field fonts (if they
+    // haven't been already) - returns 'false' on failure
+    bool CreateDistanceFieldState( );
+
     // The Direct3D10 device associated with this text context
     ID3D11Device * m_Device;
 
@@ -87,11 +408,17 @@ private:
     // A view of the font texture resource
     ID3D11ShaderResourceView * m_TextureView;
 
+    // The texture of the glyph cache (if one is selected), and a view of it
+    ID3D11Texture2D * m_GlyphCacheTexture;
+    ID3D11ShaderResourceView * m_GlyphCacheTextureView;
+
     // The vertex shader
     ID3D11VertexShader * m_VertexShader;
 
-    // The pixel shader
+    // The pixel shader, and the one for distance field fonts (created when one is
+    // first selected)
     ID3D11PixelShader * m_PixelShader;
+    ID3D11PixelShader * m_DistanceFieldPixelShader;
 
     // The input layout
     ID3D11InputLayout * m_InputLayout;
@@ -99,20 +426,109 @@ private:
     // The vertex buffer
     ID3D11Buffer * m_VertexBuffer;
 
-    // The sampler state
+    // The sampler state, and the one for distance field fonts
     ID3D11SamplerState * m_SamplerState;
+    ID3D11SamplerState * m_DistanceFieldSamplerState;
 
     // The depth-stencil state
     ID3D11DepthStencilState * m_DepthStencilState;
 
-    // Number of vertices written to the vertex buffer
-    unsigned int m_NumVertices;
-
-    // Total capacity
-    const unsigned int m_Capacity;
-
-    // The current write position of the vertex buffer (when mapped to CPU memory)
-    DWORD * m_VertexBufferWriteAddress;
+    // Set if the font is a distance field
+    bool m_DistanceField;
+
+    // Lays out text and encodes it into the vertex buffer while it is mapped
+    TinyTextEncoder_c m_Encoder;
+
+    // Whether timings are being collected
+    bool m_StatsEnabled;
+
+    // Frequency of the performance counter used for timings
+    LONGLONG m_TimerFrequency;
+
+    // Statistics for the frame in progress, and the time (in performance counter
+    // ticks) spent in each timed function
+    TinyTextStats_c m_FrameStats;
+    LONGLONG m_PrintTicks;
+    LONGLONG m_MapTicks;
+    LONGLONG m_RenderTicks;
+
+    // Number of frames of GPU timestamp queries that can be in flight at once
+    static const unsigned int GpuTimerCount = 4;
+
+    // The queries that time a single call to 'Render' on the GPU
+    struct GpuTimer_s
+    {
+        ID3D11Query * disjoint;
+        ID3D11Query * begin;
+        ID3D11Query * end;
+        bool pending;
+    };
+
+    // A ring of GPU timers, the index of the next to be issued and the oldest that
+    // hasn't been read back
+    GpuTimer_s m_GpuTimers[ GpuTimerCount ];
+    unsigned int m_GpuTimerIssueIndex;
+    unsigned int m_GpuTimerReadIndex;
+    bool m_GpuStatsEnabled;
+
+    // The statistics overlay - where it is drawn, and the vertices, skipped vertices
+    // and dropped characters that it added to the frame in progress. When nothing
+    // else was printed, the overlay maps the vertex buffer itself, and that map and
+    // unmap are left out of the statistics and the trace
+    bool m_StatsOverlayEnabled;
+    D3D11_VIEWPORT m_StatsOverlayViewport;
+    int m_StatsOverlayX;
+    int m_StatsOverlayY;
+    DWORD m_StatsOverlayColour;
+    unsigned int m_StatsOverlayVertices;
+    unsigned int m_StatsOverlaySkippedVertices;
+    unsigned int m_StatsOverlayDropped;
+    bool m_StatsOverlayMapped;
+
+    // Publishes the statistics of each frame to other processes, and the counters
+    // that it last published
+    TinyTextCountersWriter_c m_SharedCountersWriter;
+    TinyTextCounters_s m_SharedCounters;
+
+    // Logs calls to 'Print' while capturing
+    TinyTextCaptureWriter_c m_CaptureWriter;
+
+    // The ring of trace events, or NULL when not tracing
+    struct TraceRing_s * m_TraceRing;
+
+    // Statistics for recent frames, and the index of the next to be written
+    TinyTextStats_c m_StatsHistory[ StatsHistoryLength ];
+    unsigned int m_StatsHistoryIndex;
+    unsigned int m_StatsHistoryCount;
+
+    // The site that the next call to 'Print' is attributed to
+    const char * m_PrintSiteName;
+    int m_PrintSiteLine;
+
+    // A hash table of the sites that have printed during the frame in progress (open
+    // addressing, so its size must be a power of two), and the number in use
+    TinyTextPrintSite_c m_PrintSites[ MaxPrintSites ];
+    unsigned int m_PrintSiteCount;
+
+    // The sites of the last frame, busiest first
+    TinyTextPrintSite_c m_PrintSiteReport[ MaxPrintSites ];
+    unsigned int m_PrintSiteReportCount;
 
 };
 //}
+
+/*---------------------------------------------------------------------------------
+    TINYTEXT_PRINT
+    Calls 'TinyTextContext_c::Print' (with any of its sets of arguments), attributing
+    the glyphs to the file and line of the call
+---------------------------------------------------------------------------------*/
+#define TINYTEXT_PRINT( context, ... ) \
+    ( ( context ).SetPrintSite( __FILE__, __LINE__ ), ( context ).Print( __VA_ARGS__ ) )
+
+/*---------------------------------------------------------------------------------
+    TINYTEXT_PRINT_TAGGED
+    Calls 'TinyTextContext_c::Print', attributing the glyphs to a tag - which should
+    be a string literal, such as the name of a subsystem
+---------------------------------------------------------------------------------*/
+#define TINYTEXT_PRINT_TAGGED( context, tag, ... ) \
+    ( ( context ).SetPrintSite( ( tag ), 0 ), ( context ).Print( __VA_ARGS__ ) )
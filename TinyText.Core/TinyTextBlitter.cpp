@@ -0,0 +1,798 @@
+/*=================================================================================
+
+    PROJECT:        Tiny Text Library for DirectX 10
+
+    AUTHOR:         James Bird (http://www.jb101.co.uk/)
+
+    DESCRIPTION:    The CPU text blitter. See 'TinyTextBlitter.h' for usage
+
+=================================================================================*/
+
+/*---------------------------------------------------------------------------------
+    Includes
+---------------------------------------------------------------------------------*/
+#include "TinyTextBlitter.h"
+#include <string.h>
+#include <new>
+#if defined( _WIN32 )
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#endif
+#if defined( _M_IX86 ) || defined( _M_X64 ) || defined( __SSE2__ )
+#define TINYTEXT_BLITTER_SSE2
+#include <emmintrin.h>
+#endif
+
+/*---------------------------------------------------------------------------------
+    BlitterGlyph_s
+    A character being drawn, clipped to the frame
+---------------------------------------------------------------------------------*/
+struct BlitterGlyph_s
+{
+    // The pixels covered, and the texel drawn at the top-left of them
+    short left;
+    short top;
+    unsigned char width;
+    unsigned char height;
+    unsigned char u;
+    unsigned char v;
+
+    // The colour, already in the format of the frame - a 32-bit pixel, or the Y, U
+    // and V bytes of NV12 from the least significant byte up
+    unsigned int colour;
+};
+
+/*---------------------------------------------------------------------------------
+    BlitterWorkers_s
+    The worker threads of a blitter, which sleep until 'generation' changes, then
+    draw tiles alongside the calling thread
+---------------------------------------------------------------------------------*/
+struct BlitterWorkers_s
+{
+#if defined( _WIN32 )
+    CRITICAL_SECTION lock;
+    CONDITION_VARIABLE start;
+    CONDITION_VARIABLE finished;
+    HANDLE threads[ TinyTextBlitter_c::MaxThreads ];
+#else
+    pthread_mutex_t lock;
+    pthread_cond_t start;
+    pthread_cond_t finished;
+    pthread_t threads[ TinyTextBlitter_c::MaxThreads ];
+#endif
+
+    TinyTextBlitter_c * blitter;
+    int numThreads;
+
+    // Incremented for each frame, and the number of workers still drawing it
+    unsigned int generation;
+    int numBusy;
+
+    // Set when the workers should exit
+    bool quit;
+
+    // The body of each worker thread
+    static void Run( BlitterWorkers_s * workers );
+};
+
+/*---------------------------------------------------------------------------------
+    Constants
+---------------------------------------------------------------------------------*/
+//namespace
+//{
+    // The elements of a character's vertices that are read - see
+    // 'RasterizerVertexElements' in 'TinyTextRasterizer.cpp'
+    enum BlitterVertexElements
+    {
+        BottomLeft_Position_X   = 0,
+        BottomLeft_Position_Y   = 1,
+        BottomLeft_UV           = 2,
+        Colour                  = 3,
+        TopRight_Position_X     = 12,
+        TopRight_Position_Y     = 13,
+        TopRight_UV             = 14
+    };
+
+    // Tiles are at least 1 << 'MinTileShift' rows high. Tiles are always a power of
+    // two rows high, so that glyphs are sorted into tiles with shifts rather than
+    // divisions, and so that each row of NV12 chroma belongs to a single tile
+    const int           MinTileShift            = 5;
+
+    // Frames with fewer glyphs than this are drawn by the calling thread alone
+    const unsigned int  MinGlyphsPerThread      = 256;
+
+    // Added to pixel coordinates while they are rounded, so that they are positive
+    const int           PixelCoordBias          = 32768;
+//}
+
+/*---------------------------------------------------------------------------------
+    Private Implementation
+---------------------------------------------------------------------------------*/
+//namespace
+//{
+    /*---------------------------------------------------------------------------------
+        DecodePixelCoord
+        Decodes a position coordinate from the vertex stream, and converts it from
+        clip space to the nearest pixel edge. The offset includes 'PixelCoordBias', so
+        that the result can be rounded by truncation rather than the slower 'floor'
+    ---------------------------------------------------------------------------------*/
+    inline int DecodePixelCoord( unsigned int element, float scale, float offset )
+    {
+        float coord;
+        memcpy( &coord, &element, sizeof( coord ) );
+        return int( ( coord * scale ) + offset + 0.5f ) - PixelCoordBias;
+    }
+
+    /*---------------------------------------------------------------------------------
+        ReadBitmapUInt32
+        Reads a little-endian 32-bit value from the font bitmap
+    ---------------------------------------------------------------------------------*/
+    unsigned int ReadBitmapUInt32( const unsigned char * data )
+    {
+        return data[ 0 ] | ( data[ 1 ] << 8 ) | ( data[ 2 ] << 16 ) | ( ( unsigned int ) data[ 3 ] << 24 );
+    }
+
+    /*---------------------------------------------------------------------------------
+        ConvertColour
+        Converts a vertex colour (0xAABBGGRR) to the format of a frame. NV12 uses the
+        BT.601 studio-swing conversion
+    ---------------------------------------------------------------------------------*/
+    unsigned int ConvertColour( unsigned int colour, TinyTextFrame_s::PixelFormat format )
+    {
+        int red = colour & 0xFF;
+        int green = ( colour >> 8 ) & 0xFF;
+        int blue = ( colour >> 16 ) & 0xFF;
+
+        switch ( format )
+        {
+        case TinyTextFrame_s::PixelFormatBGRA:
+            return ( colour & 0xFF00FF00 ) | ( blue ) | ( red << 16 );
+
+        case TinyTextFrame_s::PixelFormatNV12:
+            {
+                int y = ( ( 66 * red + 129 * green + 25 * blue + 128 ) >> 8 ) + 16;
+                int u = ( ( -38 * red - 74 * green + 112 * blue + 128 ) >> 8 ) + 128;
+                int v = ( ( 112 * red - 94 * green - 18 * blue + 128 ) >> 8 ) + 128;
+                return y | ( u << 8 ) | ( v << 16 );
+            }
+
+        default:
+            return colour;
+        }
+    }
+
+    /*---------------------------------------------------------------------------------
+        BlendRow32
+        Writes a 32-bit colour to the pixels of a glyph row that are set in 'mask'.
+        When 'full' is set, all 8 pixels lie within the frame
+    ---------------------------------------------------------------------------------*/
+    void BlendRow32( unsigned char * pixels, unsigned int mask, unsigned int colour, bool full )
+    {
+    #if defined( TINYTEXT_BLITTER_SSE2 )
+        if ( full )
+        {
+            // Expand each bit of the mask to a 32-bit lane, then select between the
+            // colour and the existing pixels
+            const __m128i highBits = _mm_set_epi32( 0x10, 0x20, 0x40, 0x80 );
+            const __m128i lowBits = _mm_set_epi32( 0x01, 0x02, 0x04, 0x08 );
+
+            __m128i bits = _mm_set1_epi32( int( mask ) );
+            __m128i fill = _mm_set1_epi32( int( colour ) );
+
+            __m128i select0 = _mm_cmpeq_epi32( _mm_and_si128( bits, highBits ), highBits );
+            __m128i select1 = _mm_cmpeq_epi32( _mm_and_si128( bits, lowBits ), lowBits );
+
+            __m128i * destination = ( __m128i * ) pixels;
+            __m128i pixels0 = _mm_loadu_si128( destination );
+            __m128i pixels1 = _mm_loadu_si128( destination + 1 );
+
+            _mm_storeu_si128( destination, _mm_or_si128( _mm_and_si128( select0, fill ), _mm_andnot_si128( select0, pixels0 ) ) );
+            _mm_storeu_si128( destination + 1, _mm_or_si128( _mm_and_si128( select1, fill ), _mm_andnot_si128( select1, pixels1 ) ) );
+            return;
+        }
+    #else
+        ( void ) full;
+    #endif
+
+        for ( int i = 0; mask; ++i, mask = ( mask << 1 ) & 0xFF )
+        {
+            if ( mask & 0x80 )
+            {
+                memcpy( pixels + i * 4, &colour, 4 );
+            }
+        }
+    }
+
+    /*---------------------------------------------------------------------------------
+        BlendRow8
+        Writes an 8-bit value to the pixels of a glyph row that are set in 'mask'.
+        When 'full' is set, all 8 pixels lie within the frame
+    ---------------------------------------------------------------------------------*/
+    void BlendRow8( unsigned char * pixels, unsigned int mask, unsigned char value, bool full )
+    {
+    #if defined( TINYTEXT_BLITTER_SSE2 )
+        if ( full )
+        {
+            // Expand each bit of the mask to a byte lane - only the low 8 lanes are used
+            const __m128i rowBits = _mm_setr_epi8( -128, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01, 0, 0, 0, 0, 0, 0, 0, 0 );
+
+            __m128i bits = _mm_set1_epi8( char( mask ) );
+            __m128i fill = _mm_set1_epi8( char( value ) );
+            __m128i select = _mm_cmpeq_epi8( _mm_and_si128( bits, rowBits ), rowBits );
+
+            __m128i existing = _mm_loadl_epi64( ( const __m128i * ) pixels );
+            _mm_storel_epi64( ( __m128i * ) pixels, _mm_or_si128( _mm_and_si128( select, fill ), _mm_andnot_si128( select, existing ) ) );
+            return;
+        }
+    #else
+        ( void ) full;
+    #endif
+
+        for ( int i = 0; mask; ++i, mask = ( mask << 1 ) & 0xFF )
+        {
+            if ( mask & 0x80 )
+            {
+                pixels[ i ] = value;
+            }
+        }
+    }
+
+    /*---------------------------------------------------------------------------------
+        AtomicIncrement
+        Increments a value shared between threads, and returns the new value
+    ---------------------------------------------------------------------------------*/
+    long AtomicIncrement( volatile long * value )
+    {
+    #if defined( _WIN32 )
+        return InterlockedIncrement( value );
+    #else
+        return __sync_add_and_fetch( value, 1 );
+    #endif
+    }
+
+    /*---------------------------------------------------------------------------------
+        GetNumProcessors
+        Returns the number of processors available to this process
+    ---------------------------------------------------------------------------------*/
+    int GetNumProcessors( )
+    {
+    #if defined( _WIN32 )
+        SYSTEM_INFO info;
+        GetSystemInfo( &info );
+        return int( info.dwNumberOfProcessors );
+    #else
+        long count = sysconf( _SC_NPROCESSORS_ONLN );
+        return count > 0 ? int( count ) : 1;
+    #endif
+    }
+
+    /*---------------------------------------------------------------------------------
+        LockWorkers, UnlockWorkers, WaitForWorkers, WakeWorkers
+        Thin wrappers around the platform's mutex and condition variable
+    ---------------------------------------------------------------------------------*/
+#if defined( _WIN32 )
+    void LockWorkers( BlitterWorkers_s * workers )                              { EnterCriticalSection( &workers->lock ); }
+    void UnlockWorkers( BlitterWorkers_s * workers )                            { LeaveCriticalSection( &workers->lock ); }
+    void WaitForWorkers( BlitterWorkers_s * workers, CONDITION_VARIABLE * event ) { SleepConditionVariableCS( event, &workers->lock, INFINITE ); }
+    void WakeWorkers( CONDITION_VARIABLE * event )                              { WakeAllConditionVariable( event ); }
+#else
+    void LockWorkers( BlitterWorkers_s * workers )                              { pthread_mutex_lock( &workers->lock ); }
+    void UnlockWorkers( BlitterWorkers_s * workers )                            { pthread_mutex_unlock( &workers->lock ); }
+    void WaitForWorkers( BlitterWorkers_s * workers, pthread_cond_t * event )   { pthread_cond_wait( event, &workers->lock ); }
+    void WakeWorkers( pthread_cond_t * event )                                  { pthread_cond_broadcast( event ); }
+#endif
+
+    /*---------------------------------------------------------------------------------
+        WorkerThread
+        Entry point of each worker thread
+    ---------------------------------------------------------------------------------*/
+#if defined( _WIN32 )
+    DWORD WINAPI WorkerThread( LPVOID parameter )
+    {
+        BlitterWorkers_s::Run( ( BlitterWorkers_s * ) parameter );
+        return 0;
+    }
+#else
+    void * WorkerThread( void * parameter )
+    {
+        BlitterWorkers_s::Run( ( BlitterWorkers_s * ) parameter );
+        return 0;
+    }
+#endif
+//}
+
+//namespace
+//{
+    /*---------------------------------------------------------------------------------
+        BlitterWorkers_s::Run
+        Draws tiles each time the calling thread starts a frame, until told to quit
+    ---------------------------------------------------------------------------------*/
+    void BlitterWorkers_s::Run( BlitterWorkers_s * workers )
+    {
+        // Workers are all started before the first frame, so start from generation 0
+        unsigned int generation = 0;
+
+        LockWorkers( workers );
+
+        for ( ;; )
+        {
+            while ( workers->generation == generation && !workers->quit )
+            {
+                WaitForWorkers( workers, &workers->start );
+            }
+
+            if ( workers->quit )
+            {
+                break;
+            }
+
+            generation = workers->generation;
+            UnlockWorkers( workers );
+
+            workers->blitter->BlitTiles( );
+
+            LockWorkers( workers );
+            if ( --workers->numBusy == 0 )
+            {
+                WakeWorkers( &workers->finished );
+            }
+        }
+
+        UnlockWorkers( workers );
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextBlitter_c::TinyTextBlitter_c
+        Constructor - decodes the font texture
+    ---------------------------------------------------------------------------------*/
+    TinyTextBlitter_c::TinyTextBlitter_c( )
+    :   m_Glyphs( 0 ),
+        m_Capacity( 0 ),
+        m_NumGlyphs( 0 ),
+        m_TileGlyphs( 0 ),
+        m_NumTiles( 0 ),
+        m_TileShift( 0 ),
+        m_Frame( 0 ),
+        m_NextTile( 0 ),
+        m_Workers( 0 )
+    {
+        unsigned int byteCount;
+        const unsigned char * bitmap = TinyTextEncoder_c::GetFontBitmap( &byteCount );
+
+        // The bitmap is stored bottom-up, one bit per texel with rows padded to 4
+        // bytes - which is already the layout of a row of 'm_Font'. Texels are drawn
+        // where they are white, so the bits are inverted if white is entry 0 of the
+        // palette (stored blue, green, red, reserved after the 40 byte header)
+        const unsigned char * pixels = bitmap + ReadBitmapUInt32( bitmap + 10 );
+        const unsigned char * palette = bitmap + 14 + ReadBitmapUInt32( bitmap + 14 );
+        const unsigned char invert = palette[ 2 ] == 0xFF ? 0xFF : 0x00;
+
+        memset( m_Font, 0, sizeof( m_Font ) );
+
+        for ( int y = 0; y < 128; ++y )
+        {
+            const unsigned char * row = pixels + ( 127 - y ) * 16;
+
+            for ( int x = 0; x < 16; ++x )
+            {
+                m_Font[ y ][ x ] = row[ x ] ^ invert;
+            }
+        }
+
+        memset( m_TileStart, 0, sizeof( m_TileStart ) );
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextBlitter_c::~TinyTextBlitter_c
+        Destructor
+    ---------------------------------------------------------------------------------*/
+    TinyTextBlitter_c::~TinyTextBlitter_c( )
+    {
+        Release( );
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextBlitter_c::Initialise
+        Allocates the glyphs and starts the worker threads
+    ---------------------------------------------------------------------------------*/
+    bool TinyTextBlitter_c::Initialise( size_t characterCapacity, int threadCount )
+    {
+        Release( );
+
+        m_Glyphs = new ( std::nothrow ) BlitterGlyph_s[ characterCapacity ];
+        m_TileGlyphs = new ( std::nothrow ) unsigned int[ characterCapacity * 2 ];
+
+        if ( !m_Glyphs || !m_TileGlyphs )
+        {
+            Release( );
+            return false;
+        }
+
+        m_Capacity = characterCapacity;
+
+        if ( threadCount <= 0 )
+        {
+            threadCount = GetNumProcessors( );
+        }
+
+        if ( threadCount > MaxThreads )
+        {
+            threadCount = MaxThreads;
+        }
+
+        // The calling thread draws too, so only start the rest
+        if ( threadCount > 1 )
+        {
+            m_Workers = new ( std::nothrow ) BlitterWorkers_s;
+            if ( !m_Workers )
+            {
+                Release( );
+                return false;
+            }
+
+            m_Workers->blitter = this;
+            m_Workers->numThreads = 0;
+            m_Workers->generation = 0;
+            m_Workers->numBusy = 0;
+            m_Workers->quit = false;
+
+        #if defined( _WIN32 )
+            InitializeCriticalSection( &m_Workers->lock );
+            InitializeConditionVariable( &m_Workers->start );
+            InitializeConditionVariable( &m_Workers->finished );
+        #else
+            pthread_mutex_init( &m_Workers->lock, 0 );
+            pthread_cond_init( &m_Workers->start, 0 );
+            pthread_cond_init( &m_Workers->finished, 0 );
+        #endif
+
+            for ( int i = 1; i < threadCount; ++i )
+            {
+            #if defined( _WIN32 )
+                HANDLE thread = CreateThread( 0, 0, WorkerThread, m_Workers, 0, 0 );
+                if ( !thread )
+                {
+                    Release( );
+                    return false;
+                }
+            #else
+                pthread_t thread;
+                if ( pthread_create( &thread, 0, WorkerThread, m_Workers ) != 0 )
+                {
+                    Release( );
+                    return false;
+                }
+            #endif
+
+                m_Workers->threads[ m_Workers->numThreads++ ] = thread;
+            }
+        }
+
+        return true;
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextBlitter_c::Release
+        Releases the glyphs and stops the worker threads
+    ---------------------------------------------------------------------------------*/
+    void TinyTextBlitter_c::Release( )
+    {
+        if ( m_Workers )
+        {
+            LockWorkers( m_Workers );
+            m_Workers->quit = true;
+            WakeWorkers( &m_Workers->start );
+            UnlockWorkers( m_Workers );
+
+            for ( int i = 0; i < m_Workers->numThreads; ++i )
+            {
+            #if defined( _WIN32 )
+                WaitForSingleObject( m_Workers->threads[ i ], INFINITE );
+                CloseHandle( m_Workers->threads[ i ] );
+            #else
+                pthread_join( m_Workers->threads[ i ], 0 );
+            #endif
+            }
+
+        #if defined( _WIN32 )
+            DeleteCriticalSection( &m_Workers->lock );
+        #else
+            pthread_cond_destroy( &m_Workers->finished );
+            pthread_cond_destroy( &m_Workers->start );
+            pthread_mutex_destroy( &m_Workers->lock );
+        #endif
+
+            delete m_Workers;
+            m_Workers = 0;
+        }
+
+        delete [] m_Glyphs;
+        delete [] m_TileGlyphs;
+
+        m_Glyphs = 0;
+        m_TileGlyphs = 0;
+        m_Capacity = 0;
+        m_NumGlyphs = 0;
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextBlitter_c::GetNumThreads
+        Returns the number of threads that draw each frame
+    ---------------------------------------------------------------------------------*/
+    int TinyTextBlitter_c::GetNumThreads( ) const
+    {
+        return m_Workers ? m_Workers->numThreads + 1 : 1;
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextBlitter_c::Blit
+        Draws encoded text into a frame
+    ---------------------------------------------------------------------------------*/
+    void TinyTextBlitter_c::Blit( const unsigned int * vertices, unsigned int vertexCount, const TinyTextFrame_s & frame )
+    {
+        if ( frame.width <= 0 || frame.height <= 0 )
+        {
+            return;
+        }
+
+        m_Frame = &frame;
+
+        // Split the frame into the smallest tiles that there are enough of
+        m_TileShift = MinTileShift;
+        while ( ( frame.height >> m_TileShift ) >= MaxTiles )
+        {
+            ++m_TileShift;
+        }
+
+        m_NumTiles = ( ( frame.height - 1 ) >> m_TileShift ) + 1;
+
+        AddGlyphs( vertices, vertexCount );
+
+        m_NextTile = -1;
+
+        if ( !m_Workers || m_NumGlyphs < MinGlyphsPerThread || m_NumTiles < 2 )
+        {
+            BlitTiles( );
+            return;
+        }
+
+        // Wake the workers, draw alongside them, then wait for them all to finish
+        LockWorkers( m_Workers );
+        m_Workers->numBusy = m_Workers->numThreads;
+        ++m_Workers->generation;
+        WakeWorkers( &m_Workers->start );
+        UnlockWorkers( m_Workers );
+
+        BlitTiles( );
+
+        LockWorkers( m_Workers );
+        while ( m_Workers->numBusy )
+        {
+            WaitForWorkers( m_Workers, &m_Workers->finished );
+        }
+        UnlockWorkers( m_Workers );
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextBlitter_c::AddGlyphs
+        Decodes the characters from the vertex stream, clips them to the frame, and
+        sorts them into tiles
+    ---------------------------------------------------------------------------------*/
+    void TinyTextBlitter_c::AddGlyphs( const unsigned int * vertices, unsigned int vertexCount )
+    {
+        const TinyTextFrame_s & frame = *m_Frame;
+
+        unsigned int characterCount = vertexCount / TinyTextEncoder_c::NumVerticesPerCharacter;
+        if ( characterCount > m_Capacity )
+        {
+            characterCount = ( unsigned int ) m_Capacity;
+        }
+
+        // The viewport transform, from clip space to pixels with y pointing down
+        const float scaleX = frame.width * 0.5f;
+        const float scaleY = frame.height * -0.5f;
+        const float offsetX = frame.width * 0.5f + PixelCoordBias;
+        const float offsetY = frame.height * 0.5f + PixelCoordBias;
+
+        // Consecutive characters are usually the same colour, so only convert changes
+        unsigned int vertexColour = 0;
+        unsigned int colour = ConvertColour( vertexColour, frame.format );
+
+        memset( m_TileStart, 0, sizeof( m_TileStart ) );
+        m_NumGlyphs = 0;
+
+        for ( unsigned int i = 0; i < characterCount; ++i )
+        {
+            const unsigned int * character = vertices + i * TinyTextEncoder_c::NumVertexElementsPerCharacter;
+
+            int left = DecodePixelCoord( character[ BottomLeft_Position_X ], scaleX, offsetX );
+            int top = DecodePixelCoord( character[ TopRight_Position_Y ], scaleY, offsetY );
+            int u = character[ BottomLeft_UV ] & 0xFFFF;
+            int v = character[ TopRight_UV ] >> 16;
+
+            // Texels map 1:1 onto pixels, so the size comes from the texture
+            // coordinates. Characters drawn at any other scale can't be copied from the
+            // font, and are skipped
+            int right = left + int( character[ TopRight_UV ] & 0xFFFF ) - u;
+            int bottom = top + int( character[ BottomLeft_UV ] >> 16 ) - v;
+
+            if ( DecodePixelCoord( character[ TopRight_Position_X ], scaleX, offsetX ) != right ||
+                 DecodePixelCoord( character[ BottomLeft_Position_Y ], scaleY, offsetY ) != bottom )
+            {
+                continue;
+            }
+
+            if ( right > left + TinyTextEncoder_c::CharacterWidth )
+            {
+                right = left + TinyTextEncoder_c::CharacterWidth;
+            }
+
+            // Clip to the frame, trimming the texture coordinates by the same amounts
+            if ( left < 0 )
+            {
+                u -= left;
+                left = 0;
+            }
+
+            if ( top < 0 )
+            {
+                v -= top;
+                top = 0;
+            }
+
+            right = right > frame.width ? frame.width : right;
+            bottom = bottom > frame.height ? frame.height : bottom;
+
+            if ( right <= left || bottom <= top || u < 0 || v < 0 || u + ( right - left ) > 128 || v + ( bottom - top ) > 128 )
+            {
+                continue;
+            }
+
+            BlitterGlyph_s & glyph = m_Glyphs[ m_NumGlyphs++ ];
+            glyph.left = short( left );
+            glyph.top = short( top );
+            glyph.width = ( unsigned char )( right - left );
+            glyph.height = ( unsigned char )( bottom - top );
+            glyph.u = ( unsigned char ) u;
+            glyph.v = ( unsigned char ) v;
+
+            if ( character[ Colour ] != vertexColour )
+            {
+                vertexColour = character[ Colour ];
+                colour = ConvertColour( vertexColour, frame.format );
+            }
+
+            glyph.colour = colour;
+
+            // Count the glyph in each tile that it overlaps
+            for ( int tile = top >> m_TileShift; tile <= ( bottom - 1 ) >> m_TileShift; ++tile )
+            {
+                ++m_TileStart[ tile + 1 ];
+            }
+        }
+
+        // Turn the counts into the first entry of each tile, then fill in the entries
+        unsigned int next[ MaxTiles ];
+
+        for ( int tile = 0; tile < m_NumTiles; ++tile )
+        {
+            m_TileStart[ tile + 1 ] += m_TileStart[ tile ];
+            next[ tile ] = m_TileStart[ tile ];
+        }
+
+        for ( unsigned int i = 0; i < m_NumGlyphs; ++i )
+        {
+            const BlitterGlyph_s & glyph = m_Glyphs[ i ];
+
+            for ( int tile = glyph.top >> m_TileShift; tile <= ( glyph.top + glyph.height - 1 ) >> m_TileShift; ++tile )
+            {
+                m_TileGlyphs[ next[ tile ]++ ] = i;
+            }
+        }
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextBlitter_c::BlitTiles
+        Claims and draws tiles until there are none left
+    ---------------------------------------------------------------------------------*/
+    void TinyTextBlitter_c::BlitTiles( )
+    {
+        int tile;
+        while ( ( tile = int( AtomicIncrement( &m_NextTile ) ) ) < m_NumTiles )
+        {
+            BlitTile( tile );
+        }
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextBlitter_c::GetGlyphRow
+        Returns a row of a glyph's texels as an 8-bit mask
+    ---------------------------------------------------------------------------------*/
+    inline unsigned int TinyTextBlitter_c::GetGlyphRow( const BlitterGlyph_s & glyph, int row ) const
+    {
+        const unsigned char * texels = &m_Font[ glyph.v + row ][ glyph.u >> 3 ];
+        unsigned int bits = ( ( texels[ 0 ] << 8 ) | texels[ 1 ] ) << ( glyph.u & 7 );
+        return ( bits >> 8 ) & ( 0xFF00 >> glyph.width ) & 0xFF;
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextBlitter_c::BlitTile
+        Draws the glyphs that overlap a tile, clipped to it
+    ---------------------------------------------------------------------------------*/
+    void TinyTextBlitter_c::BlitTile( int tile )
+    {
+        const TinyTextFrame_s & frame = *m_Frame;
+
+        const int tileTop = tile << m_TileShift;
+        const int tileBottom = ( ( tile + 1 ) << m_TileShift ) < frame.height ? ( ( tile + 1 ) << m_TileShift ) : frame.height;
+
+        for ( unsigned int i = m_TileStart[ tile ]; i < m_TileStart[ tile + 1 ]; ++i )
+        {
+            const BlitterGlyph_s & glyph = m_Glyphs[ m_TileGlyphs[ i ] ];
+
+            const int top = glyph.top > tileTop ? glyph.top : tileTop;
+            const int bottom = glyph.top + glyph.height < tileBottom ? glyph.top + glyph.height : tileBottom;
+
+            // Glyphs near the right edge of the frame can't be written 8 pixels at a time
+            const bool full = glyph.left + TinyTextEncoder_c::CharacterWidth <= frame.width;
+
+            if ( frame.format == TinyTextFrame_s::PixelFormatNV12 )
+            {
+                // Luma is one byte per pixel, and chroma is one U and V pair for each
+                // 2x2 block of pixels. A block is coloured if any of its pixels are, so
+                // the rows are combined in pairs and written on the second of each
+                unsigned char * pixels = frame.planes[ 0 ] + top * frame.pitches[ 0 ] + glyph.left;
+                unsigned int blockMask = 0;
+
+                const int firstColumn = glyph.left >> 1;
+                const int lastColumn = ( glyph.left + glyph.width - 1 ) >> 1;
+
+                for ( int y = top; y < bottom; ++y, pixels += frame.pitches[ 0 ] )
+                {
+                    unsigned int mask = GetGlyphRow( glyph, y - glyph.top );
+                    if ( mask )
+                    {
+                        BlendRow8( pixels, mask, ( unsigned char ) glyph.colour, full );
+                        blockMask |= mask;
+                    }
+
+                    if ( !blockMask || ( !( y & 1 ) && y + 1 < bottom ) )
+                    {
+                        continue;
+                    }
+
+                    // Line the mask up with the blocks, so that each block is two bits
+                    blockMask <<= 2 - ( glyph.left & 1 );
+
+                    unsigned char * chroma = frame.planes[ 1 ] + ( y >> 1 ) * frame.pitches[ 1 ] + firstColumn * 2;
+
+                    for ( int column = firstColumn; column <= lastColumn; ++column, chroma += 2, blockMask <<= 2 )
+                    {
+                        if ( blockMask & 0x300 )
+                        {
+                            chroma[ 0 ] = ( unsigned char )( glyph.colour >> 8 );
+                            chroma[ 1 ] = ( unsigned char )( glyph.colour >> 16 );
+                        }
+                    }
+
+                    blockMask = 0;
+                }
+            }
+            else
+            {
+                unsigned char * pixels = frame.planes[ 0 ] + top * frame.pitches[ 0 ] + glyph.left * 4;
+
+                for ( int y = top; y < bottom; ++y, pixels += frame.pitches[ 0 ] )
+                {
+                    unsigned int mask = GetGlyphRow( glyph, y - glyph.top );
+                    if ( mask )
+                    {
+                        BlendRow32( pixels, mask, glyph.colour, full );
+                    }
+                }
+            }
+        }
+    }
+//}
@@ -0,0 +1,154 @@
+/*=================================================================================
+
+    PROJECT:        Tiny Text Library for DirectX 10
+
+    AUTHOR:         James Bird (http://www.jb101.co.uk/)
+
+    DESCRIPTION:    Burns encoded text directly into video frames in memory, for
+                    pipelines that never touch the GPU
+
+    USAGE:          - Encode text with 'TinyTextEncoder_c' into a plain block of
+                      memory, using the size of the frame as the viewport, then
+                      pass the vertices to 'TinyTextBlitter_c::Blit'
+
+                    - Frames can be RGBA, BGRA (both 32 bits per pixel) or NV12.
+                      In NV12 frames the luma of each pixel is written, and the
+                      chroma of each 2x2 block that contains part of a glyph
+
+                    - Each row of a glyph is 8 pixels wide, so it is expanded
+                      from a single byte of the font into a mask of 8 pixels
+                      with SSE2 (where available), and blended into the frame in
+                      one go
+
+                    - The frame is split into horizontal tiles, which are shared
+                      out between the calling thread and the worker threads
+                      created by 'TinyTextBlitter_c::Initialise'. Each glyph is
+                      drawn by every tile that it overlaps, clipped to the tile,
+                      so no two threads ever write to the same row
+
+                    - Only the built-in font is supported, as its glyphs are all
+                      8 pixels wide - encode with no font pack selected
+
+                    - Glyphs are copied texel for texel, so text is only drawn at
+                      a scale of 1. Characters encoded with a font scale or a
+                      'TinyTextFormat_c::scale' that makes them any other size
+                      are skipped
+
+=================================================================================*/
+#pragma once
+
+/*---------------------------------------------------------------------------------
+    Includes
+---------------------------------------------------------------------------------*/
+#include "TinyTextEncoder.h"
+
+/*---------------------------------------------------------------------------------
+    TinyTextFrame_s
+    A video frame in memory
+---------------------------------------------------------------------------------*/
+struct TinyTextFrame_s
+{
+    // Layouts of the pixels of a frame
+    enum PixelFormat
+    {
+        PixelFormatRGBA,    // One plane - red, green, blue and alpha bytes
+        PixelFormatBGRA,    // One plane - blue, green, red and alpha bytes
+        PixelFormatNV12     // A plane of luma bytes, then a half-size plane of U and V bytes
+    };
+
+    PixelFormat format;
+
+    // Size of the frame, in pixels
+    int width;
+    int height;
+
+    // The planes of the frame, and the number of bytes between their rows. Only
+    // NV12 frames have a second plane
+    unsigned char * planes[ 2 ];
+    int pitches[ 2 ];
+};
+
+/*---------------------------------------------------------------------------------
+    TinyTextBlitter_c
+    Draws encoded text into video frames on the CPU. For usage, see comments at the
+    top of this file
+---------------------------------------------------------------------------------*/
+class TinyTextBlitter_c
+{
+public:
+
+    // Maximum number of threads (including the calling thread) that draw each frame
+    static const int MaxThreads = 16;
+
+    // Constructor - the blitter has no capacity until it has been initialised
+    TinyTextBlitter_c( );
+
+    // Destructor - stops the worker threads
+    ~TinyTextBlitter_c( );
+
+    // Allocates space for the specified number of characters, and starts worker
+    // threads so that 'threadCount' threads in all (one per processor if zero) draw
+    // each frame - returns 'true' on success or 'false' on failure
+    bool Initialise( size_t characterCapacity, int threadCount = 0 );
+
+    // Draws 'vertexCount' vertices, as written by 'TinyTextEncoder_c' with a viewport
+    // the size of the frame, into the frame. Characters beyond the capacity are
+    // ignored
+    void Blit( const unsigned int * vertices, unsigned int vertexCount, const TinyTextFrame_s & frame );
+
+    // Number of threads that draw each frame
+    int GetNumThreads( ) const;
+
+private:
+
+    // Deliberately not implemented - this object cannot be copied or assigned to
+    TinyTextBlitter_c( const TinyTextBlitter_c & );
+    TinyTextBlitter_c & operator = ( const TinyTextBlitter_c & );
+
+    // The workers call 'BlitTiles'
+    friend struct BlitterWorkers_s;
+
+    // Maximum number of tiles in a frame
+    static const int MaxTiles = 256;
+
+    // Releases the glyphs and stops the worker threads
+    void Release( );
+
+    // Decodes and clips the characters, then sorts them into tiles
+    void AddGlyphs( const unsigned int * vertices, unsigned int vertexCount );
+
+    // Draws tiles until there are none left - called by every thread
+    void BlitTiles( );
+
+    // Draws the glyphs that overlap a single tile
+    void BlitTile( int tile );
+
+    // Returns a row of a glyph's texels as an 8-bit mask - the leftmost pixel is the
+    // most significant bit
+    unsigned int GetGlyphRow( const struct BlitterGlyph_s & glyph, int row ) const;
+
+    // The characters being drawn, and the number of them
+    struct BlitterGlyph_s * m_Glyphs;
+    size_t m_Capacity;
+    unsigned int m_NumGlyphs;
+
+    // The glyphs in each tile, as indices into 'm_Glyphs' - 'm_TileStart[ i ]' is the
+    // first for tile 'i', and a glyph can appear in two tiles. Tiles are
+    // 1 << 'm_TileShift' rows high
+    unsigned int * m_TileGlyphs;
+    unsigned int m_TileStart[ MaxTiles + 1 ];
+    int m_NumTiles;
+    int m_TileShift;
+
+    // The frame being drawn, and the next tile to be claimed by a thread
+    const TinyTextFrame_s * m_Frame;
+    volatile long m_NextTile;
+
+    // The worker threads (if any)
+    struct BlitterWorkers_s * m_Workers;
+
+    // The font texture, top row first - one bit per texel, with the leftmost texel of
+    // each byte in its most significant bit. Rows have a spare byte at the end, so
+    // that any 8 texels can be read as two bytes
+    unsigned char m_Font[ 128 ][ 17 ];
+};
@@ -0,0 +1,515 @@
+/*=================================================================================
+
+    PROJECT:        Tiny Text Library for DirectX 10
+
+    AUTHOR:         James Bird (http://www.jb101.co.uk/)
+
+    DESCRIPTION:    Capture logs of calls to 'TinyTextContext_c::Print'. See
+                    'TinyTextCapture.h' for usage and the format
+
+=================================================================================*/
+
+/*---------------------------------------------------------------------------------
+    Includes
+---------------------------------------------------------------------------------*/
+#include "TinyTextCapture.h"
+#include <stdlib.h>
+#include <string.h>
+
+/*---------------------------------------------------------------------------------
+    Constants
+---------------------------------------------------------------------------------*/
+//namespace
+//{
+    // The first four bytes of every log
+    const char          CaptureMagic[]          = { 'T', 'T', 'X', 'C' };
+
+    // Number of entries in a character map
+    const size_t        CaptureCharacterCount   = 256;
+
+    // Zero bytes appended to a loaded log, so that the encoder's reads past the end
+    // of the last string stay within the allocation
+    const size_t        CapturePadding          = 16;
+//}
+
+/*---------------------------------------------------------------------------------
+    Private Implementation
+---------------------------------------------------------------------------------*/
+//namespace
+//{
+    /*---------------------------------------------------------------------------------
+        FloatToUInt32
+        Returns the bits of a float
+    ---------------------------------------------------------------------------------*/
+    unsigned int FloatToUInt32( float value )
+    {
+        unsigned int result;
+        memcpy( &result, &value, sizeof( result ) );
+        return result;
+    }
+
+    /*---------------------------------------------------------------------------------
+        CountCaptureCharacters
+        Returns the length of 'text', up to 'maxCharacterCount' characters
+    ---------------------------------------------------------------------------------*/
+    size_t CountCaptureCharacters( const char * text, size_t maxCharacterCount )
+    {
+        size_t count = 0;
+
+        while ( count < maxCharacterCount && text[ count ] )
+        {
+            ++count;
+        }
+
+        return count;
+    }
+//}
+
+//namespace
+//{
+    /*---------------------------------------------------------------------------------
+        TinyTextCaptureWriter_c::TinyTextCaptureWriter_c
+        Constructor
+    ---------------------------------------------------------------------------------*/
+    TinyTextCaptureWriter_c::TinyTextCaptureWriter_c( )
+    :   m_File( 0 ),
+        m_ViewportWidth( 0.0f ),
+        m_ViewportHeight( 0.0f )
+    {
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextCaptureWriter_c::~TinyTextCaptureWriter_c
+        Destructor
+    ---------------------------------------------------------------------------------*/
+    TinyTextCaptureWriter_c::~TinyTextCaptureWriter_c( )
+    {
+        Close( );
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextCaptureWriter_c::Open
+        Creates a log file
+    ---------------------------------------------------------------------------------*/
+    bool TinyTextCaptureWriter_c::Open( const char * fileName )
+    {
+        Close( );
+
+        if ( !fileName )
+        {
+            return false;
+        }
+
+    #if defined( _MSC_VER )
+        fopen_s( &m_File, fileName, "wb" );
+    #else
+        m_File = fopen( fileName, "wb" );
+    #endif
+        if ( !m_File )
+        {
+            return false;
+        }
+
+        // No viewport has been written yet
+        m_ViewportWidth = -1.0f;
+        m_ViewportHeight = -1.0f;
+
+        fwrite( CaptureMagic, 1, sizeof( CaptureMagic ), m_File );
+        WriteUInt32( Version );
+
+        return true;
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextCaptureWriter_c::Close
+        Closes the log
+    ---------------------------------------------------------------------------------*/
+    bool TinyTextCaptureWriter_c::Close( )
+    {
+        if ( !m_File )
+        {
+            return true;
+        }
+
+        bool result = !ferror( m_File );
+        result = ( fclose( m_File ) == 0 ) && result;
+        m_File = 0;
+
+        return result;
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextCaptureWriter_c::WritePrint
+        Records a call to 'Print'
+    ---------------------------------------------------------------------------------*/
+    void TinyTextCaptureWriter_c::WritePrint( float viewportWidth, float viewportHeight, const TinyTextFormat_c * format, size_t maxCharacterCount, const char * text, int x, int y, unsigned int colour )
+    {
+        if ( !m_File || !text )
+        {
+            return;
+        }
+
+        if ( viewportWidth != m_ViewportWidth || viewportHeight != m_ViewportHeight )
+        {
+            fputc( 'V', m_File );
+            WriteUInt32( FloatToUInt32( viewportWidth ) );
+            WriteUInt32( FloatToUInt32( viewportHeight ) );
+
+            m_ViewportWidth = viewportWidth;
+            m_ViewportHeight = viewportHeight;
+        }
+
+        if ( format )
+        {
+            fputc( 'F', m_File );
+            WriteUInt32( format->wrapWidth );
+            WriteUInt32( format->tabSize );
+            WriteUInt32( format->anchor );
+            WriteUInt32( format->scale );
+            WriteUInt32( format->font );
+            fputc( format->clip ? 1 : 0, m_File );
+
+            if ( format->clip )
+            {
+                WriteUInt32( format->clipRect.left );
+                WriteUInt32( format->clipRect.top );
+                WriteUInt32( format->clipRect.right );
+                WriteUInt32( format->clipRect.bottom );
+            }
+        }
+        else
+        {
+            fputc( 'P', m_File );
+        }
+
+        size_t characterCount = CountCaptureCharacters( text, maxCharacterCount );
+
+        WriteUInt32( x );
+        WriteUInt32( y );
+        WriteUInt32( colour );
+        WriteUInt32( ( unsigned int ) characterCount );
+        fwrite( text, 1, characterCount, m_File );
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextCaptureWriter_c::WriteCharacterMap
+        Records a change of code page or character map
+    ---------------------------------------------------------------------------------*/
+    void TinyTextCaptureWriter_c::WriteCharacterMap( bool utf8, const unsigned char characterMap[ 256 ] )
+    {
+        if ( m_File )
+        {
+            fputc( 'C', m_File );
+            fputc( utf8 ? 1 : 0, m_File );
+            fwrite( characterMap, 1, CaptureCharacterCount, m_File );
+        }
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextCaptureWriter_c::WriteFontScale
+        Records a change of font scale
+    ---------------------------------------------------------------------------------*/
+    void TinyTextCaptureWriter_c::WriteFontScale( float scale )
+    {
+        if ( m_File )
+        {
+            fputc( 'S', m_File );
+            WriteUInt32( FloatToUInt32( scale ) );
+        }
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextCaptureWriter_c::WriteRender
+        Records the end of a frame
+    ---------------------------------------------------------------------------------*/
+    void TinyTextCaptureWriter_c::WriteRender( )
+    {
+        if ( m_File )
+        {
+            fputc( 'R', m_File );
+        }
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextCaptureWriter_c::WriteUInt32
+        Writes a 32-bit value, least significant byte first
+    ---------------------------------------------------------------------------------*/
+    void TinyTextCaptureWriter_c::WriteUInt32( unsigned int value )
+    {
+        unsigned char bytes[ 4 ];
+        bytes[ 0 ] = ( unsigned char ) ( value );
+        bytes[ 1 ] = ( unsigned char ) ( value >> 8 );
+        bytes[ 2 ] = ( unsigned char ) ( value >> 16 );
+        bytes[ 3 ] = ( unsigned char ) ( value >> 24 );
+        fwrite( bytes, 1, sizeof( bytes ), m_File );
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextCaptureReader_c::TinyTextCaptureReader_c
+        Constructor
+    ---------------------------------------------------------------------------------*/
+    TinyTextCaptureReader_c::TinyTextCaptureReader_c( )
+    :   m_Data( 0 ),
+        m_Size( 0 ),
+        m_Position( 0 ),
+        m_Version( 0 ),
+        m_ViewportWidth( 0.0f ),
+        m_ViewportHeight( 0.0f ),
+        m_UTF8( false ),
+        m_CharacterMap( 0 ),
+        m_FontScale( 1.0f )
+    {
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextCaptureReader_c::~TinyTextCaptureReader_c
+        Destructor
+    ---------------------------------------------------------------------------------*/
+    TinyTextCaptureReader_c::~TinyTextCaptureReader_c( )
+    {
+        free( m_Data );
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextCaptureReader_c::Load
+        Loads a log file
+    ---------------------------------------------------------------------------------*/
+    bool TinyTextCaptureReader_c::Load( const char * fileName )
+    {
+        free( m_Data );
+        m_Data = 0;
+        m_Size = 0;
+        m_Position = 0;
+
+        if ( !fileName )
+        {
+            return false;
+        }
+
+        FILE * file = 0;
+    #if defined( _MSC_VER )
+        fopen_s( &file, fileName, "rb" );
+    #else
+        file = fopen( fileName, "rb" );
+    #endif
+        if ( !file )
+        {
+            return false;
+        }
+
+        // Read the whole file, growing the buffer as needed
+        size_t capacity = 0;
+        bool result = true;
+
+        for ( ;; )
+        {
+            if ( m_Size + CapturePadding >= capacity )
+            {
+                size_t newCapacity = capacity ? capacity * 2 : 65536;
+                unsigned char * data = ( unsigned char * ) realloc( m_Data, newCapacity );
+                if ( !data )
+                {
+                    result = false;
+                    break;
+                }
+
+                m_Data = data;
+                capacity = newCapacity;
+            }
+
+            size_t bytesRead = fread( m_Data + m_Size, 1, capacity - m_Size - CapturePadding, file );
+            m_Size += bytesRead;
+
+            if ( bytesRead == 0 )
+            {
+                result = !ferror( file );
+                break;
+            }
+        }
+
+        fclose( file );
+
+        if ( m_Data )
+        {
+            memset( m_Data + m_Size, 0, CapturePadding );
+        }
+
+        // Check the header
+        unsigned int version = 0;
+        m_Position = sizeof( CaptureMagic );
+
+        if ( !result || m_Size < sizeof( CaptureMagic ) || memcmp( m_Data, CaptureMagic, sizeof( CaptureMagic ) ) != 0 ||
+             !ReadUInt32( &version ) || version < 1 || version > TinyTextCaptureWriter_c::Version )
+        {
+            free( m_Data );
+            m_Data = 0;
+            m_Size = 0;
+            m_Position = 0;
+            return false;
+        }
+
+        m_Version = version;
+        Rewind( );
+        return true;
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextCaptureReader_c::Rewind
+        Returns to the first record
+    ---------------------------------------------------------------------------------*/
+    void TinyTextCaptureReader_c::Rewind( )
+    {
+        m_Position = sizeof( CaptureMagic ) + sizeof( unsigned int );
+        m_ViewportWidth = 0.0f;
+        m_ViewportHeight = 0.0f;
+        m_UTF8 = false;
+        m_CharacterMap = 0;
+        m_FontScale = 1.0f;
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextCaptureReader_c::Read
+        Reads the next record
+    ---------------------------------------------------------------------------------*/
+    TinyTextCaptureReader_c::RecordType TinyTextCaptureReader_c::Read( Print_s * print )
+    {
+        for ( ;; )
+        {
+            if ( !m_Data || m_Position >= m_Size )
+            {
+                return RecordEnd;
+            }
+
+            char type = ( char ) m_Data[ m_Position++ ];
+
+            switch ( type )
+            {
+            case 'V':
+                if ( !ReadFloat( &m_ViewportWidth ) || !ReadFloat( &m_ViewportHeight ) )
+                {
+                    return RecordInvalid;
+                }
+                break;
+
+            case 'C':
+                if ( m_Size - m_Position < 1 + CaptureCharacterCount )
+                {
+                    return RecordInvalid;
+                }
+
+                m_UTF8 = m_Data[ m_Position ] != 0;
+                m_CharacterMap = m_Data + m_Position + 1;
+                m_Position += 1 + CaptureCharacterCount;
+                break;
+
+            case 'S':
+                if ( !ReadFloat( &m_FontScale ) )
+                {
+                    return RecordInvalid;
+                }
+                break;
+
+            case 'R':
+                return RecordRender;
+
+            case 'P':
+            case 'F':
+                {
+                    print->viewportWidth = m_ViewportWidth;
+                    print->viewportHeight = m_ViewportHeight;
+                    print->utf8 = m_UTF8;
+                    print->characterMap = m_CharacterMap;
+                    print->fontScale = m_FontScale;
+                    print->formatted = ( type == 'F' );
+                    print->format = TinyTextFormat_c( );
+
+                    if ( print->formatted )
+                    {
+                        if ( !ReadInt32( &print->format.wrapWidth ) || !ReadInt32( &print->format.tabSize ) || !ReadInt32( &print->format.anchor ) ||
+                             ( m_Version >= 2 && !ReadInt32( &print->format.scale ) ) ||
+                             ( m_Version >= 3 && !ReadInt32( &print->format.font ) ) || m_Position >= m_Size )
+                        {
+                            return RecordInvalid;
+                        }
+
+                        if ( m_Data[ m_Position++ ] )
+                        {
+                            TinyTextRect_s & rect = print->format.clipRect;
+                            if ( !ReadInt32( &rect.left ) || !ReadInt32( &rect.top ) || !ReadInt32( &rect.right ) || !ReadInt32( &rect.bottom ) )
+                            {
+                                return RecordInvalid;
+                            }
+
+                            print->format.clip = true;
+                        }
+                    }
+
+                    unsigned int characterCount;
+                    if ( !ReadInt32( &print->x ) || !ReadInt32( &print->y ) || !ReadUInt32( &print->colour ) || !ReadUInt32( &characterCount ) ||
+                         characterCount > m_Size - m_Position )
+                    {
+                        return RecordInvalid;
+                    }
+
+                    print->text = ( const char * ) m_Data + m_Position;
+                    print->characterCount = characterCount;
+                    m_Position += characterCount;
+                }
+                return RecordPrint;
+
+            default:
+                return RecordInvalid;
+            }
+        }
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextCaptureReader_c::ReadUInt32
+        Reads a 32-bit value, least significant byte first
+    ---------------------------------------------------------------------------------*/
+    bool TinyTextCaptureReader_c::ReadUInt32( unsigned int * value )
+    {
+        if ( m_Size - m_Position < 4 )
+        {
+            return false;
+        }
+
+        const unsigned char * bytes = m_Data + m_Position;
+        *value = bytes[ 0 ] | ( bytes[ 1 ] << 8 ) | ( bytes[ 2 ] << 16 ) | ( ( unsigned int ) bytes[ 3 ] << 24 );
+        m_Position += 4;
+
+        return true;
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextCaptureReader_c::ReadInt32
+        Reads a signed 32-bit value
+    ---------------------------------------------------------------------------------*/
+    bool TinyTextCaptureReader_c::ReadInt32( int * value )
+    {
+        unsigned int bits;
+        if ( !ReadUInt32( &bits ) )
+        {
+            return false;
+        }
+
+        *value = ( int ) bits;
+        return true;
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextCaptureReader_c::ReadFloat
+        Reads a 32-bit float
+    ---------------------------------------------------------------------------------*/
+    bool TinyTextCaptureReader_c::ReadFloat( float * value )
+    {
+        unsigned int bits;
+        if ( !ReadUInt32( &bits ) )
+        {
+            return false;
+        }
+
+        memcpy( value, &bits, sizeof( bits ) );
+        return true;
+    }
+//}
@@ -0,0 +1,197 @@
+/*=================================================================================
+
+    PROJECT:        Tiny Text Library for DirectX 10
+
+    AUTHOR:         James Bird (http://www.jb101.co.uk/)
+
+    DESCRIPTION:    Records the calls made to 'TinyTextContext_c::Print' in a
+                    compact binary log, and reads them back, so that real
+                    workloads can be replayed through the encoder offline
+
+    USAGE:          - Call 'TinyTextContext_c::BeginCapture' to start logging to
+                      a file, and 'TinyTextContext_c::EndCapture' to finish
+
+                    - Replay the log with the benchmark tool:
+                      TinyText.Benchmark --replay <file> [seconds per case]
+
+                    - The log starts with the four characters 'TTXC' and a
+                      32-bit version number, followed by a sequence of records.
+                      Each record is a single type byte followed by its fields.
+                      All values are little-endian:
+
+                        'V' viewport: width, height (32-bit floats). Written
+                            whenever the viewport of a 'Print' differs from the
+                            last
+
+                        'P' print: x, y (32-bit ints), colour (32-bit), byte
+                            count (32-bit), then the bytes of the text
+
+                        'F' formatted print: as 'P', preceded by wrap width,
+                            tab size, anchor, scale, font (32-bit ints), a clip
+                            flag (byte) and, if the flag is set, the clip
+                            rectangle (four 32-bit ints). Version 1 logs have no
+                            scale, and version 1 and 2 logs have no font
+
+                        'C' character map: a UTF-8 flag (byte), then the
+                            character of the font that each of the 256 bytes of
+                            text is drawn with. Written when the log is opened,
+                            and whenever the code page or character map changes
+
+                        'S' font scale: the scale (32-bit float). Written when
+                            the log is opened, and whenever the scale changes
+
+                        'R' render: marks the end of a frame
+
+                    - Version 1 to 3 logs have no 'C' or 'S' records, so they
+                      replay with the default code page and a scale of 1
+
+=================================================================================*/
+#pragma once
+
+/*---------------------------------------------------------------------------------
+    Includes
+---------------------------------------------------------------------------------*/
+#include "TinyTextEncoder.h"
+#include <stdio.h>
+
+/*---------------------------------------------------------------------------------
+    TinyTextCaptureWriter_c
+    Writes a capture log
+---------------------------------------------------------------------------------*/
+class TinyTextCaptureWriter_c
+{
+public:
+
+    // Version of the log format that is written. Logs of every earlier version can
+    // still be read
+    static const unsigned int Version = 4;
+
+    // Constructor
+    TinyTextCaptureWriter_c( );
+
+    // Destructor - closes the log
+    ~TinyTextCaptureWriter_c( );
+
+    // Creates a log file, replacing any that is already open - returns 'true' on
+    // success or 'false' on failure
+    bool Open( const char * fileName );
+
+    // Closes the log - returns 'false' if any writes failed
+    bool Close( );
+
+    // Returns 'true' while a log is open
+    bool IsOpen( ) const { return m_File != 0; }
+
+    // Records a call to 'Print'. 'format' is NULL for unformatted text
+    void WritePrint( float viewportWidth, float viewportHeight, const TinyTextFormat_c * format, size_t maxCharacterCount, const char * text, int x, int y, unsigned int colour );
+
+    // Records a change of code page or character map
+    void WriteCharacterMap( bool utf8, const unsigned char characterMap[ 256 ] );
+
+    // Records a change of font scale
+    void WriteFontScale( float scale );
+
+    // Records the end of a frame
+    void WriteRender( );
+
+private:
+
+    // Deliberately not implemented - this object cannot be copied or assigned to
+    TinyTextCaptureWriter_c( const TinyTextCaptureWriter_c & );
+    TinyTextCaptureWriter_c & operator = ( const TinyTextCaptureWriter_c & );
+
+    // Writes a 32-bit value
+    void WriteUInt32( unsigned int value );
+
+    // The open log file
+    FILE * m_File;
+
+    // The viewport of the last recorded 'Print'
+    float m_ViewportWidth;
+    float m_ViewportHeight;
+};
+
+/*---------------------------------------------------------------------------------
+    TinyTextCaptureReader_c
+    Reads a capture log, which is loaded into memory in its entirety so that it can
+    be replayed without touching the disk
+---------------------------------------------------------------------------------*/
+class TinyTextCaptureReader_c
+{
+public:
+
+    // The types of record that can be read
+    enum RecordType
+    {
+        RecordPrint,        // A call to 'Print'
+        RecordRender,       // The end of a frame
+        RecordEnd,          // The end of the log
+        RecordInvalid       // The log is truncated or corrupt
+    };
+
+    // A call to 'Print'. 'text' points into the loaded log, and is not terminated.
+    // 'characterMap' also points into the log, and is NULL until the log sets one,
+    // meaning the default code page
+    struct Print_s
+    {
+        float viewportWidth;
+        float viewportHeight;
+        bool utf8;
+        const unsigned char * characterMap;
+        float fontScale;
+        bool formatted;
+        TinyTextFormat_c format;
+        const char * text;
+        size_t characterCount;
+        int x;
+        int y;
+        unsigned int colour;
+    };
+
+    // Constructor
+    TinyTextCaptureReader_c( );
+
+    // Destructor
+    ~TinyTextCaptureReader_c( );
+
+    // Loads a log file - returns 'false' if it can't be read or isn't a supported
+    // version of the format
+    bool Load( const char * fileName );
+
+    // Returns to the first record
+    void Rewind( );
+
+    // Reads the next record. 'print' is filled in for 'RecordPrint'
+    RecordType Read( Print_s * print );
+
+private:
+
+    // Deliberately not implemented - this object cannot be copied or assigned to
+    TinyTextCaptureReader_c( const TinyTextCaptureReader_c & );
+    TinyTextCaptureReader_c & operator = ( const TinyTextCaptureReader_c & );
+
+    // Reads a value - returns 'false' if the log is truncated
+    bool ReadUInt32( unsigned int * value );
+    bool ReadInt32( int * value );
+    bool ReadFloat( float * value );
+
+    // The contents of the log
+    unsigned char * m_Data;
+    size_t m_Size;
+
+    // The current read position
+    size_t m_Position;
+
+    // Version of the log
+    unsigned int m_Version;
+
+    // The viewport set by the last 'V' record
+    float m_ViewportWidth;
+    float m_ViewportHeight;
+
+    // The character map set by the last 'C' record, and the scale set by the last
+    // 'S' record
+    bool m_UTF8;
+    const unsigned char * m_CharacterMap;
+    float m_FontScale;
+};
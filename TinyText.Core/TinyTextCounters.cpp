@@ -0,0 +1,420 @@
+/*=================================================================================
+
+    PROJECT:        Tiny Text Library for DirectX 10
+
+    AUTHOR:         James Bird (http://www.jb101.co.uk/)
+
+    DESCRIPTION:    Shared-memory counters. See 'TinyTextCounters.h' for usage and
+                    the layout
+
+=================================================================================*/
+
+/*---------------------------------------------------------------------------------
+    Includes
+---------------------------------------------------------------------------------*/
+#include "TinyTextCounters.h"
+#include <stdio.h>
+#include <string.h>
+#if defined( _WIN32 )
+#include <windows.h>
+#else
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/*---------------------------------------------------------------------------------
+    SharedCounters_s
+    The layout of the shared block
+---------------------------------------------------------------------------------*/
+struct SharedCounters_s
+{
+    char magic[ 4 ];
+    volatile unsigned int version;      // Written last, once the block is ready
+    unsigned int size;                  // Size of the whole block, in bytes
+    volatile unsigned int sequence;     // Odd while the counters are being written
+    TinyTextCounters_s counters;
+};
+
+/*---------------------------------------------------------------------------------
+    Constants
+---------------------------------------------------------------------------------*/
+//namespace
+//{
+    // The first four bytes of the block
+    const char          CountersMagic[]         = { 'T', 'T', 'S', 'C' };
+
+    // Number of times a reader tries to get a consistent copy before giving up
+    const int           CountersReadAttempts    = 100;
+//}
+
+/*---------------------------------------------------------------------------------
+    State
+---------------------------------------------------------------------------------*/
+//namespace
+//{
+    // Set while a writer in this process has the block open. The block is named
+    // after the process, so there can only be one
+    bool                CountersWriterOpen      = false;
+//}
+
+/*---------------------------------------------------------------------------------
+    Private Implementation
+---------------------------------------------------------------------------------*/
+//namespace
+//{
+    /*---------------------------------------------------------------------------------
+        CountersBarrier
+        Stops the compiler and CPU from moving reads and writes across this point
+    ---------------------------------------------------------------------------------*/
+    inline void CountersBarrier( )
+    {
+    #if defined( _WIN32 )
+        MemoryBarrier( );
+    #else
+        __sync_synchronize( );
+    #endif
+    }
+
+    /*---------------------------------------------------------------------------------
+        MakeCountersName
+        Writes the name of the shared block of a process
+    ---------------------------------------------------------------------------------*/
+    void MakeCountersName( char * name, size_t size, unsigned long processId )
+    {
+    #if defined( _WIN32 )
+        sprintf_s( name, size, "Local\\TinyText.Counters.%lu", processId );
+    #else
+        snprintf( name, size, "/TinyText.Counters.%lu", processId );
+    #endif
+    }
+//}
+
+//namespace
+//{
+    /*---------------------------------------------------------------------------------
+        TinyTextCountersWriter_c::TinyTextCountersWriter_c
+        Constructor
+    ---------------------------------------------------------------------------------*/
+    TinyTextCountersWriter_c::TinyTextCountersWriter_c( )
+    :   m_Block( 0 ),
+        m_Mapping( 0 )
+    {
+        m_Name[ 0 ] = '\0';
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextCountersWriter_c::~TinyTextCountersWriter_c
+        Destructor
+    ---------------------------------------------------------------------------------*/
+    TinyTextCountersWriter_c::~TinyTextCountersWriter_c( )
+    {
+        Close( );
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextCountersWriter_c::Open
+        Creates the shared block
+    ---------------------------------------------------------------------------------*/
+    bool TinyTextCountersWriter_c::Open( )
+    {
+        if ( m_Block )
+        {
+            return true;
+        }
+
+        // Only one writer can publish the counters of a process - any other would
+        // share its block, and remove it from under the first when closed
+        if ( CountersWriterOpen )
+        {
+            return false;
+        }
+
+    #if defined( _WIN32 )
+        MakeCountersName( m_Name, sizeof( m_Name ), GetCurrentProcessId( ) );
+
+        // A mapping that already exists is kept alive by a reader that still has it
+        // open, after an earlier writer in this process closed it. It is opened
+        // rather than rejected, and the header is filled in again below, so that
+        // readers see the new writer's counters
+        HANDLE mapping = CreateFileMappingA( INVALID_HANDLE_VALUE, 0, PAGE_READWRITE, 0, sizeof( SharedCounters_s ), m_Name );
+        if ( !mapping )
+        {
+            return false;
+        }
+
+        SharedCounters_s * block = ( SharedCounters_s * ) MapViewOfFile( mapping, FILE_MAP_WRITE, 0, 0, sizeof( SharedCounters_s ) );
+        if ( !block )
+        {
+            CloseHandle( mapping );
+            return false;
+        }
+
+        m_Mapping = mapping;
+    #else
+        MakeCountersName( m_Name, sizeof( m_Name ), ( unsigned long ) getpid( ) );
+
+        // A block that already exists was left behind by an earlier process with the
+        // same id, which didn't close it, so it is replaced
+        int file = shm_open( m_Name, O_CREAT | O_EXCL | O_RDWR, 0644 );
+        if ( file < 0 && errno == EEXIST )
+        {
+            shm_unlink( m_Name );
+            file = shm_open( m_Name, O_CREAT | O_EXCL | O_RDWR, 0644 );
+        }
+
+        if ( file < 0 )
+        {
+            return false;
+        }
+
+        void * memory = MAP_FAILED;
+        if ( ftruncate( file, sizeof( SharedCounters_s ) ) == 0 )
+        {
+            memory = mmap( 0, sizeof( SharedCounters_s ), PROT_READ | PROT_WRITE, MAP_SHARED, file, 0 );
+        }
+
+        close( file );
+
+        if ( memory == MAP_FAILED )
+        {
+            shm_unlink( m_Name );
+            return false;
+        }
+
+        SharedCounters_s * block = ( SharedCounters_s * ) memory;
+    #endif
+
+        // Fill in the header, and only then the version, so that readers never see a
+        // block that is half set up
+        block->version = 0;
+        CountersBarrier( );
+
+        memcpy( block->magic, CountersMagic, sizeof( CountersMagic ) );
+        block->size = sizeof( SharedCounters_s );
+        block->sequence = 0;
+        memset( &block->counters, 0, sizeof( block->counters ) );
+        CountersBarrier( );
+
+        block->version = Version;
+
+        m_Block = block;
+        CountersWriterOpen = true;
+        return true;
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextCountersWriter_c::Close
+        Removes the shared block
+    ---------------------------------------------------------------------------------*/
+    void TinyTextCountersWriter_c::Close( )
+    {
+        if ( !m_Block )
+        {
+            return;
+        }
+
+    #if defined( _WIN32 )
+        UnmapViewOfFile( m_Block );
+        CloseHandle( m_Mapping );
+    #else
+        munmap( m_Block, sizeof( SharedCounters_s ) );
+        shm_unlink( m_Name );
+    #endif
+
+        m_Block = 0;
+        m_Mapping = 0;
+        CountersWriterOpen = false;
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextCountersWriter_c::Publish
+        Replaces the published counters. There is only ever one writer, so the
+        sequence number needs no atomic operations - just barriers either side of
+        the copy
+    ---------------------------------------------------------------------------------*/
+    void TinyTextCountersWriter_c::Publish( const TinyTextCounters_s & counters )
+    {
+        if ( !m_Block )
+        {
+            return;
+        }
+
+        unsigned int sequence = m_Block->sequence;
+
+        m_Block->sequence = sequence + 1;
+        CountersBarrier( );
+
+        m_Block->counters = counters;
+        CountersBarrier( );
+
+        m_Block->sequence = sequence + 2;
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextCountersReader_c::TinyTextCountersReader_c
+        Constructor
+    ---------------------------------------------------------------------------------*/
+    TinyTextCountersReader_c::TinyTextCountersReader_c( )
+    :   m_Block( 0 ),
+        m_Size( 0 ),
+        m_Mapping( 0 )
+    {
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextCountersReader_c::~TinyTextCountersReader_c
+        Destructor
+    ---------------------------------------------------------------------------------*/
+    TinyTextCountersReader_c::~TinyTextCountersReader_c( )
+    {
+        Close( );
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextCountersReader_c::Open
+        Opens the shared counters of a process
+    ---------------------------------------------------------------------------------*/
+    bool TinyTextCountersReader_c::Open( unsigned long processId )
+    {
+        Close( );
+
+        char name[ 64 ];
+        MakeCountersName( name, sizeof( name ), processId );
+
+        // Map the whole block, which may be larger (or smaller) than this version's
+    #if defined( _WIN32 )
+        HANDLE mapping = OpenFileMappingA( FILE_MAP_READ, FALSE, name );
+        if ( !mapping )
+        {
+            return false;
+        }
+
+        const SharedCounters_s * block = ( const SharedCounters_s * ) MapViewOfFile( mapping, FILE_MAP_READ, 0, 0, 0 );
+        if ( !block )
+        {
+            CloseHandle( mapping );
+            return false;
+        }
+
+        MEMORY_BASIC_INFORMATION region;
+        size_t size = VirtualQuery( block, &region, sizeof( region ) ) ? region.RegionSize : 0;
+
+        m_Mapping = mapping;
+    #else
+        int file = shm_open( name, O_RDONLY, 0 );
+        if ( file < 0 )
+        {
+            return false;
+        }
+
+        struct stat status;
+        void * memory = MAP_FAILED;
+        size_t size = 0;
+
+        if ( fstat( file, &status ) == 0 && status.st_size > 0 )
+        {
+            size = ( size_t ) status.st_size;
+            memory = mmap( 0, size, PROT_READ, MAP_SHARED, file, 0 );
+        }
+
+        close( file );
+
+        if ( memory == MAP_FAILED )
+        {
+            return false;
+        }
+
+        const SharedCounters_s * block = ( const SharedCounters_s * ) memory;
+    #endif
+
+        m_Block = block;
+        m_Size = size;
+
+        // Check that the block is ready, and laid out as expected
+        bool valid = size >= offsetof( SharedCounters_s, counters )
+                  && block->version == TinyTextCountersWriter_c::Version;
+
+        CountersBarrier( );
+
+        valid = valid
+             && memcmp( block->magic, CountersMagic, sizeof( CountersMagic ) ) == 0
+             && block->size >= offsetof( SharedCounters_s, counters )
+             && block->size <= size;
+
+        if ( !valid )
+        {
+            Close( );
+            return false;
+        }
+
+        return true;
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextCountersReader_c::Close
+        Closes the shared counters
+    ---------------------------------------------------------------------------------*/
+    void TinyTextCountersReader_c::Close( )
+    {
+        if ( !m_Block )
+        {
+            return;
+        }
+
+    #if defined( _WIN32 )
+        UnmapViewOfFile( m_Block );
+        CloseHandle( m_Mapping );
+    #else
+        munmap( ( void * ) m_Block, m_Size );
+    #endif
+
+        m_Block = 0;
+        m_Size = 0;
+        m_Mapping = 0;
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextCountersReader_c::Read
+        Copies the latest counters, retrying if the writer updates them mid-copy.
+        Counters that the writer doesn't know about are zeroed
+    ---------------------------------------------------------------------------------*/
+    bool TinyTextCountersReader_c::Read( TinyTextCounters_s * counters ) const
+    {
+        if ( !m_Block )
+        {
+            return false;
+        }
+
+        size_t size = m_Block->size - offsetof( SharedCounters_s, counters );
+        if ( size > sizeof( TinyTextCounters_s ) )
+        {
+            size = sizeof( TinyTextCounters_s );
+        }
+
+        for ( int attempt = 0; attempt < CountersReadAttempts; ++attempt )
+        {
+            unsigned int sequence = m_Block->sequence;
+            if ( sequence & 1 )
+            {
+                continue;
+            }
+
+            CountersBarrier( );
+
+            memset( counters, 0, sizeof( TinyTextCounters_s ) );
+            memcpy( counters, &m_Block->counters, size );
+
+            CountersBarrier( );
+
+            if ( m_Block->sequence == sequence )
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+//}
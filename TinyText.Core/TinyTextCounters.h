@@ -0,0 +1,164 @@
+/*=================================================================================
+
+    PROJECT:        Tiny Text Library for DirectX 10
+
+    AUTHOR:         James Bird (http://www.jb101.co.uk/)
+
+    DESCRIPTION:    Publishes a text context's counters in a named block of shared
+                    memory, so that other processes can sample them while the
+                    application runs
+
+    USAGE:          - Call 'TinyTextContext_c::EnableSharedCounters' to create the
+                      block. It is updated by every call to 'Render'
+
+                    - Other processes open it with 'TinyTextCountersReader_c',
+                      given the process id of the application, and call
+                      'TinyTextCountersReader_c::Read' as often as they like
+
+                    - The block is named 'Local\TinyText.Counters.<process id>'
+                      on Windows and '/TinyText.Counters.<process id>' (for
+                      'shm_open') elsewhere. It starts with the four characters
+                      'TTSC', then 32-bit values for the version, the size of
+                      the block and a sequence number, followed by a
+                      'TinyTextCounters_s'
+
+                    - Only one text context in a process can publish counters at
+                      a time, since the block is named after the process. While
+                      one has them enabled, enabling them on another fails
+
+                    - Once a writer closes, another in the same process can open
+                      the block again, and starts it afresh. On Windows a reader
+                      that is still attached keeps the old block alive, and sees
+                      the new writer's counters once it opens; elsewhere the old
+                      block is removed, so readers must open the new one
+
+                    - Updates use a sequence lock, so neither side ever waits on
+                      the other: the sequence number is odd while the counters
+                      are being written, and a reader retries if it changes
+                      during a read. The version only changes if existing fields
+                      change - new fields are added to the end, and readers only
+                      copy what both sides know about
+
+=================================================================================*/
+#pragma once
+
+/*---------------------------------------------------------------------------------
+    Includes
+---------------------------------------------------------------------------------*/
+#include <stddef.h>
+
+/*---------------------------------------------------------------------------------
+    TinyTextCounters_s
+    The counters published by a text context. All values are for the last frame,
+    except where stated
+---------------------------------------------------------------------------------*/
+struct TinyTextCounters_s
+{
+    // Frames rendered since the counters were enabled
+    unsigned int frameCount;
+
+    // Characters added to the vertex buffer, and the capacity of the context
+    unsigned int glyphsEncoded;
+    unsigned int capacity;
+
+    // Characters that were not added because the context was full - in the last
+    // frame, and since the counters were enabled
+    unsigned int glyphsDropped;
+    unsigned int totalGlyphsDropped;
+
+    // Bytes written to the vertex buffer
+    unsigned int bytesUploaded;
+
+    // Draw calls, and all calls made to the device context
+    unsigned int drawCalls;
+    unsigned int deviceContextCalls;
+
+    // CPU time spent in 'Print' and 'Render', and GPU time spent in 'Render'. Zero
+    // unless the corresponding stats are enabled
+    float printMilliseconds;
+    float renderMilliseconds;
+    float gpuMilliseconds;
+};
+
+/*---------------------------------------------------------------------------------
+    TinyTextCountersWriter_c
+    Creates the shared counters of this process, and updates them
+---------------------------------------------------------------------------------*/
+class TinyTextCountersWriter_c
+{
+public:
+
+    // Version of the layout of the shared block
+    static const unsigned int Version = 1;
+
+    // Constructor
+    TinyTextCountersWriter_c( );
+
+    // Destructor - removes the shared block
+    ~TinyTextCountersWriter_c( );
+
+    // Creates the shared block - returns 'true' on success or 'false' on failure,
+    // which includes another writer in this process having its block open
+    bool Open( );
+
+    // Removes the shared block
+    void Close( );
+
+    // Returns 'true' while the shared block exists
+    bool IsOpen( ) const { return m_Block != 0; }
+
+    // Replaces the published counters
+    void Publish( const TinyTextCounters_s & counters );
+
+private:
+
+    // Deliberately not implemented - this object cannot be copied or assigned to
+    TinyTextCountersWriter_c( const TinyTextCountersWriter_c & );
+    TinyTextCountersWriter_c & operator = ( const TinyTextCountersWriter_c & );
+
+    // The mapped block
+    struct SharedCounters_s * m_Block;
+
+    // The handle of the file mapping (on Windows), or the name of the block (elsewhere)
+    void * m_Mapping;
+    char m_Name[ 64 ];
+};
+
+/*---------------------------------------------------------------------------------
+    TinyTextCountersReader_c
+    Reads the shared counters of another process
+---------------------------------------------------------------------------------*/
+class TinyTextCountersReader_c
+{
+public:
+
+    // Constructor
+    TinyTextCountersReader_c( );
+
+    // Destructor
+    ~TinyTextCountersReader_c( );
+
+    // Opens the shared counters of a process - returns 'false' if it hasn't created
+    // them, or they are of an unsupported version
+    bool Open( unsigned long processId );
+
+    // Closes the shared counters
+    void Close( );
+
+    // Copies the latest counters - returns 'false' if not open, or if the writer
+    // was mid-update on every attempt
+    bool Read( TinyTextCounters_s * counters ) const;
+
+private:
+
+    // Deliberately not implemented - this object cannot be copied or assigned to
+    TinyTextCountersReader_c( const TinyTextCountersReader_c & );
+    TinyTextCountersReader_c & operator = ( const TinyTextCountersReader_c & );
+
+    // The mapped block, and its size
+    const struct SharedCounters_s * m_Block;
+    size_t m_Size;
+
+    // The handle of the file mapping (on Windows)
+    void * m_Mapping;
+};
@@ -0,0 +1,1996 @@
+/*=================================================================================
+
+    PROJECT:        Tiny Text Library for DirectX 10
+
+    AUTHOR:         James Bird (http://www.jb101.co.uk/)
+
+    DESCRIPTION:    The platform-independent core of the text context. See
+                    'TinyTextEncoder.h' for usage
+
+=================================================================================*/
+
+/*---------------------------------------------------------------------------------
+    Includes
+---------------------------------------------------------------------------------*/
+#include "TinyTextEncoder.h"
+#include "TinyTextGlyphCache.h"
+#include <emmintrin.h>
+#include <limits.h>
+#include <math.h>
+#include <string.h>
+#include <new>
+#if defined( _MSC_VER )
+#include <intrin.h>
+#endif
+
+/*---------------------------------------------------------------------------------
+    Constants
+---------------------------------------------------------------------------------*/
+//namespace
+//{
+    // The font texture data, encoded as a monochrome bitmap
+    const unsigned char TextTexture[]           = { 66 , 77 , 62 , 8 , 0 , 0 , 0 , 0 , 0 , 0 , 62 , 0 , 0 , 0 , 40 , 0 , 0 , 0 , 128 , 0 , 0 , 0 , 128 , 0 , 0 , 0 , 1 , 0 , 1 , 0 , 0 , 0 , 0 , 0 , 0 , 8 , 0 , 0 , 18 , 11 , 0 , 0 , 18 , 11 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 255 , 255 , 255 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 63 , 191 , 192 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 8 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 8 , 34 , 13 , 132 , 64 , 131 , 251 , 252 , 16 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 8 , 17 , 7 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 8 , 8 , 159 , 193 , 1 , 64 , 192 , 136 , 140 , 62 , 0 , 0 , 0 , 0 , 0 , 0 , 24 , 17 , 7 , 2 , 129 , 64 , 32 , 80 , 146 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 34 , 13 , 129 , 1 , 64 , 64 , 32 , 98 , 62 , 4 , 0 , 0 , 0 , 0 , 0 , 30 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 4 , 0 , 128 , 0 , 0 , 0 , 33 , 8 , 7 , 132 , 36 , 144 , 240 , 124 , 58 , 54 , 4 , 15 , 128 , 0 , 0 , 0 , 6 , 8 , 8 , 68 , 36 , 145 , 8 , 132 , 70 , 73 , 0 , 0 , 0 , 0 , 0 , 0 , 24 , 8 , 8 , 68 , 36 , 145 , 0 , 132 , 66 , 72 , 15 , 15 , 129 , 0 , 128 , 128 , 33 , 8 , 8 , 68 , 36 , 145 , 0 , 124 , 66 , 63 , 16 , 140 , 66 , 0 , 64 , 64 , 30 , 12 , 136 , 70 , 36 , 145 , 8 , 4 , 66 , 9 , 16 , 10 , 64 , 0 , 0 , 0 , 0 , 11 , 7 , 133 , 199 , 96 , 240 , 120 , 66 , 54 , 31 , 137 , 66 , 33 , 192 , 192 , 8 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 16 , 136 , 196 , 64 , 128 , 32 , 28 , 32 , 2 , 2 , 1 , 1 , 224 , 4 , 120 , 65 , 15 , 7 , 200 , 128 , 64 , 64 , 34 , 16 , 0 , 1 , 0 , 128 , 0 , 8 , 0 , 34 , 0 , 0 , 4 , 65 , 64 , 32 , 32 , 8 , 0 , 0 , 0 , 64 , 192 , 16 , 56 , 20 , 4 , 15 , 194 , 32 , 128 , 192 , 34 , 4 , 15 , 128 , 0 , 33 , 32 , 32 , 72 , 8 , 0 , 4 , 0 , 0 , 0 , 0 , 28 , 2 , 0 , 0 , 0 , 65 , 32 , 64 , 56 , 20 , 0 , 2 , 4 , 33 , 64 , 64 , 8 , 1 , 0 , 0 , 0 , 129 , 32 , 128 , 8 , 34 , 0 , 1 , 2 , 66 , 160 , 160 , 0 , 0 , 130 , 1 , 1 , 0 , 193 , 0 , 48 , 65 , 0 , 0 , 129 , 130 , 160 , 160 , 64 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 4 , 15 , 193 , 130 , 160 , 160 , 32 , 14 , 15 , 134 , 1 , 192 , 240 , 48 , 12 , 28 , 0 , 0 , 2 , 68 , 17 , 16 , 60 , 4 , 4 , 1 , 2 , 32 , 8 , 16 , 16 , 34 , 0 , 136 , 4 , 36 , 17 , 16 , 34 , 4 , 4 , 1 , 5 , 80 , 8 , 120 , 16 , 77 , 0 , 136 , 0 , 0 , 0 , 0 , 34 , 63 , 143 , 2 , 133 , 144 , 248 , 132 , 16 , 81 , 15 , 143 , 128 , 128 , 130 , 8 , 34 , 10 , 4 , 2 , 133 , 81 , 8 , 128 , 16 , 81 , 16 , 136 , 65 , 0 , 129 , 240 , 34 , 63 , 136 , 4 , 69 , 145 , 8 , 128 , 60 , 77 , 16 , 136 , 66 , 0 , 129 , 16 , 34 , 17 , 9 , 4 , 66 , 33 , 8 , 132 , 16 , 34 , 16 , 136 , 68 , 7 , 241 , 16 , 0 , 59 , 134 , 8 , 33 , 192 , 248 , 120 , 16 , 28 , 16 , 136 , 66 , 0 , 129 , 16 , 31 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 15 , 143 , 129 , 0 , 129 , 240 , 33 , 15 , 135 , 195 , 225 , 240 , 240 , 120 , 60 , 30 , 0 , 0 , 0 , 128 , 130 , 8 , 33 , 16 , 136 , 68 , 34 , 17 , 8 , 132 , 66 , 33 , 4 , 2 , 0 , 0 , 0 , 0 , 31 , 16 , 136 , 68 , 34 , 17 , 0 , 128 , 64 , 32 , 4 , 2 , 1 , 0 , 128 , 240 , 1 , 15 , 135 , 195 , 225 , 241 , 248 , 252 , 126 , 63 , 4 , 2 , 1 , 0 , 129 , 8 , 30 , 0 , 128 , 64 , 32 , 17 , 8 , 132 , 66 , 33 , 4 , 2 , 1 , 0 , 129 , 8 , 0 , 15 , 7 , 195 , 193 , 224 , 240 , 120 , 60 , 30 , 4 , 2 , 1 , 0 , 129 , 8 , 4 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 4 , 2 , 1 , 0 , 128 , 240 , 8 , 2 , 2 , 132 , 192 , 0 , 32 , 32 , 20 , 0 , 0 , 0 , 1 , 0 , 128 , 16 , 0 , 1 , 1 , 3 , 33 , 32 , 64 , 16 , 8 , 18 , 4 , 2 , 0 , 0 , 0 , 160 , 32 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 8 , 1 , 2 , 128 , 0 , 64 , 32 , 4 , 30 , 15 , 224 , 160 , 8 , 28 , 2 , 28 , 0 , 0 , 1 , 0 , 192 , 160 , 32 , 4 , 17 , 0 , 0 , 162 , 121 , 8 , 158 , 34 , 39 , 143 , 0 , 0 , 0 , 0 , 32 , 4 , 2 , 129 , 0 , 161 , 40 , 132 , 74 , 32 , 36 , 8 , 139 , 130 , 1 , 112 , 62 , 4 , 4 , 129 , 0 , 160 , 152 , 84 , 38 , 32 , 60 , 8 , 68 , 66 , 1 , 8 , 33 , 4 , 9 , 1 , 3 , 163 , 201 , 232 , 210 , 16 , 36 , 8 , 74 , 35 , 225 , 8 , 33 , 4 , 18 , 15 , 231 , 161 , 32 , 144 , 40 , 8 , 39 , 30 , 74 , 34 , 17 , 8 , 33 , 4 , 20 , 1 , 7 , 161 , 16 , 136 , 68 , 8 , 20 , 8 , 73 , 34 , 17 , 112 , 62 , 0 , 8 , 129 , 7 , 161 , 8 , 132 , 34 , 0 , 20 , 8 , 72 , 162 , 17 , 16 , 0 , 4 , 7 , 129 , 3 , 227 , 1 , 128 , 192 , 8 , 20 , 8 , 136 , 163 , 225 , 16 , 8 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 15 , 143 , 4 , 66 , 1 , 16 , 8 , 15 , 2 , 2 , 132 , 16 , 65 , 252 , 124 , 31 , 0 , 0 , 3 , 162 , 0 , 224 , 8 , 16 , 130 , 5 , 68 , 16 , 65 , 0 , 66 , 33 , 4 , 8 , 64 , 0 , 0 , 0 , 8 , 16 , 133 , 5 , 66 , 32 , 64 , 128 , 66 , 33 , 4 , 8 , 65 , 1 , 16 , 48 , 8 , 16 , 133 , 5 , 65 , 64 , 64 , 64 , 66 , 33 , 4 , 8 , 65 , 1 , 32 , 64 , 8 , 16 , 136 , 133 , 64 , 128 , 160 , 32 , 66 , 33 , 4 , 8 , 65 , 1 , 64 , 64 , 8 , 16 , 136 , 136 , 33 , 65 , 16 , 16 , 124 , 31 , 4 , 12 , 65 , 1 , 192 , 64 , 8 , 16 , 144 , 72 , 34 , 34 , 8 , 8 , 64 , 1 , 15 , 11 , 129 , 1 , 32 , 64 , 127 , 16 , 144 , 72 , 36 , 18 , 8 , 4 , 64 , 1 , 4 , 8 , 1 , 1 , 16 , 64 , 0 , 16 , 144 , 72 , 36 , 18 , 9 , 252 , 64 , 1 , 4 , 8 , 0 , 1 , 0 , 64 , 63 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 3 , 8 , 0 , 1 , 0 , 64 , 32 , 16 , 7 , 132 , 33 , 192 , 240 , 132 , 126 , 65 , 0 , 0 , 1 , 1 , 0 , 64 , 32 , 16 , 8 , 68 , 32 , 129 , 8 , 136 , 64 , 65 , 16 , 135 , 0 , 0 , 0 , 0 , 32 , 16 , 16 , 68 , 32 , 128 , 8 , 144 , 64 , 65 , 17 , 136 , 131 , 162 , 17 , 240 , 60 , 16 , 17 , 196 , 32 , 128 , 8 , 160 , 64 , 73 , 18 , 144 , 68 , 66 , 34 , 8 , 32 , 30 , 16 , 7 , 224 , 128 , 8 , 192 , 64 , 73 , 18 , 144 , 72 , 162 , 64 , 8 , 32 , 16 , 16 , 4 , 32 , 128 , 8 , 160 , 64 , 85 , 18 , 144 , 72 , 34 , 128 , 8 , 32 , 16 , 16 , 4 , 32 , 128 , 8 , 144 , 64 , 85 , 20 , 144 , 72 , 35 , 225 , 240 , 63 , 16 , 8 , 68 , 32 , 128 , 8 , 136 , 64 , 99 , 20 , 144 , 72 , 34 , 18 , 0 , 0 , 31 , 135 , 132 , 33 , 192 , 248 , 132 , 64 , 65 , 24 , 136 , 136 , 34 , 18 , 0 , 28 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 16 , 135 , 4 , 66 , 18 , 8 , 34 , 2 , 7 , 3 , 129 , 0 , 192 , 116 , 58 , 8 , 0 , 0 , 3 , 131 , 225 , 240 , 2 , 2 , 8 , 132 , 65 , 0 , 32 , 140 , 70 , 0 , 14 , 8 , 64 , 0 , 0 , 0 , 2 , 2 , 0 , 132 , 64 , 128 , 16 , 132 , 66 , 8 , 16 , 8 , 71 , 193 , 225 , 224 , 12 , 31 , 0 , 132 , 64 , 128 , 16 , 132 , 66 , 8 , 39 , 8 , 68 , 34 , 17 , 16 , 2 , 18 , 15 , 7 , 128 , 64 , 240 , 132 , 66 , 4 , 42 , 143 , 196 , 36 , 1 , 8 , 2 , 10 , 8 , 4 , 0 , 65 , 16 , 132 , 66 , 2 , 42 , 136 , 68 , 36 , 1 , 8 , 34 , 10 , 8 , 4 , 0 , 33 , 16 , 0 , 0 , 2 , 42 , 136 , 71 , 196 , 1 , 8 , 28 , 6 , 8 , 2 , 0 , 33 , 16 , 40 , 0 , 34 , 38 , 132 , 132 , 36 , 1 , 8 , 0 , 2 , 15 , 129 , 131 , 224 , 224 , 16 , 36 , 28 , 16 , 132 , 132 , 36 , 1 , 8 , 20 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 15 , 3 , 4 , 34 , 17 , 16 , 20 , 4 , 0 , 131 , 97 , 224 , 240 , 120 , 60 , 30 , 0 , 0 , 7 , 193 , 225 , 224 , 62 , 14 , 17 , 68 , 130 , 17 , 8 , 132 , 66 , 33 , 14 , 135 , 64 , 0 , 0 , 0 , 20 , 17 , 8 , 132 , 66 , 17 , 8 , 132 , 66 , 33 , 17 , 136 , 195 , 128 , 129 , 240 , 20 , 1 , 4 , 2 , 162 , 17 , 8 , 132 , 66 , 33 , 16 , 136 , 68 , 64 , 129 , 0 , 20 , 14 , 2 , 1 , 2 , 17 , 8 , 132 , 66 , 33 , 16 , 136 , 68 , 64 , 128 , 128 , 62 , 16 , 1 , 2 , 129 , 224 , 240 , 120 , 60 , 30 , 16 , 136 , 68 , 64 , 128 , 64 , 20 , 17 , 8 , 130 , 64 , 0 , 0 , 0 , 0 , 0 , 16 , 136 , 68 , 64 , 128 , 32 , 20 , 14 , 20 , 66 , 64 , 64 , 64 , 72 , 76 , 0 , 0 , 0 , 4 , 64 , 128 , 16 , 0 , 4 , 8 , 1 , 128 , 128 , 32 , 48 , 50 , 18 , 2 , 2 , 4 , 66 , 128 , 16 , 32 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 4 , 1 , 4 , 65 , 129 , 16 , 32 , 24 , 7 , 131 , 128 , 96 , 224 , 112 , 96 , 28 , 0 , 0 , 3 , 128 , 128 , 224 , 62 , 4 , 8 , 68 , 64 , 129 , 16 , 136 , 16 , 34 , 6 , 7 , 192 , 0 , 0 , 0 , 33 , 4 , 8 , 72 , 32 , 130 , 9 , 4 , 16 , 65 , 2 , 8 , 67 , 128 , 129 , 8 , 33 , 10 , 8 , 72 , 32 , 130 , 9 , 4 , 16 , 65 , 15 , 8 , 68 , 64 , 1 , 8 , 33 , 10 , 8 , 72 , 32 , 130 , 9 , 4 , 16 , 65 , 16 , 135 , 196 , 64 , 129 , 8 , 33 , 17 , 8 , 72 , 35 , 2 , 9 , 4 , 12 , 65 , 32 , 0 , 68 , 64 , 129 , 8 , 62 , 17 , 8 , 72 , 32 , 130 , 9 , 4 , 16 , 65 , 32 , 7 , 131 , 128 , 129 , 136 , 32 , 32 , 136 , 68 , 64 , 129 , 16 , 136 , 16 , 34 , 32 , 0 , 4 , 64 , 129 , 112 , 32 , 0 , 9 , 67 , 128 , 128 , 224 , 112 , 16 , 28 , 32 , 2 , 4 , 64 , 128 , 0 , 32 , 4 , 2 , 0 , 0 , 130 , 112 , 80 , 16 , 8 , 16 , 133 , 4 , 64 , 129 , 48 , 0 , 2 , 4 , 4 , 64 , 97 , 200 , 32 , 96 , 4 , 15 , 2 , 3 , 128 , 128 , 200 , 8 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 8 , 31 , 143 , 199 , 227 , 241 , 8 , 132 , 66 , 28 , 15 , 12 , 3 , 129 , 224 , 240 , 8 , 16 , 8 , 4 , 2 , 1 , 8 , 132 , 66 , 16 , 16 , 130 , 0 , 130 , 17 , 8 , 8 , 16 , 8 , 4 , 2 , 1 , 248 , 132 , 66 , 16 , 16 , 130 , 0 , 130 , 17 , 8 , 8 , 16 , 8 , 4 , 2 , 1 , 8 , 252 , 126 , 16 , 16 , 133 , 0 , 130 , 17 , 8 , 8 , 30 , 15 , 7 , 131 , 193 , 8 , 132 , 66 , 16 , 16 , 133 , 0 , 130 , 17 , 8 , 8 , 16 , 8 , 4 , 2 , 1 , 8 , 132 , 66 , 16 , 16 , 136 , 128 , 130 , 17 , 8 , 8 , 16 , 8 , 4 , 2 , 0 , 144 , 72 , 36 , 16 , 16 , 136 , 128 , 130 , 17 , 8 , 12 , 16 , 8 , 4 , 2 , 0 , 144 , 72 , 36 , 16 , 16 , 144 , 64 , 130 , 17 , 8 , 8 , 31 , 143 , 199 , 227 , 240 , 96 , 48 , 24 , 16 , 16 , 128 , 0 , 130 , 17 , 72 , 16 , 0 , 5 , 1 , 0 , 128 , 144 , 0 , 76 , 16 , 0 , 0 , 0 , 128 , 192 , 32 , 0 , 17 , 2 , 0 , 129 , 0 , 96 , 72 , 50 , 28 , 16 , 136 , 131 , 128 , 192 , 16 , 8 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 0 , 8 , 16 , 136 , 71 , 2 , 16 , 64 , 112 , 66 , 8 , 2 , 4 , 1 , 0 , 128 , 64 , 8 , 16 , 136 , 64 , 130 , 16 , 64 , 136 , 70 , 8 , 4 , 2 , 1 , 0 , 128 , 64 , 8 , 16 , 136 , 64 , 130 , 16 , 65 , 4 , 70 , 8 , 4 , 2 , 1 , 0 , 128 , 64 , 8 , 31 , 143 , 192 , 131 , 240 , 65 , 4 , 74 , 8 , 8 , 1 , 1 , 0 , 128 , 64 , 8 , 16 , 136 , 64 , 130 , 16 , 65 , 4 , 74 , 8 , 8 , 1 , 1 , 1 , 64 , 64 , 8 , 16 , 136 , 64 , 130 , 16 , 1 , 4 , 82 , 8 , 8 , 1 , 1 , 1 , 64 , 64 , 8 , 9 , 4 , 128 , 129 , 32 , 65 , 4 , 98 , 8 , 8 , 1 , 1 , 2 , 32 , 64 , 8 , 9 , 4 , 128 , 129 , 32 , 64 , 136 , 98 , 8 , 8 , 1 , 1 , 2 , 32 , 64 , 8 , 6 , 7 , 0 , 0 , 224 , 64 , 112 , 66 , 8 , 4 , 2 , 1 , 4 , 80 , 192 , 8 , 9 , 2 , 0 , 0 , 64 , 64 , 32 , 140 , 0 , 4 , 2 , 2 , 128 , 128 , 64 , 8 , 6 , 1 , 0 , 128 , 128 , 64 , 64 , 114 , 20 , 2 , 4 , 1 , 0 , 64 , 32 };
+
+    // The size of the font texture data in bytes
+    const unsigned int  TextTextureByteCount    = 2110;
+
+    // The width (in pixels) of the texture
+    const unsigned int  TextTextureWidth        = 128;
+
+    // The height (in pixels) of the texture
+    const unsigned int  TextTextureHeight       = 128;
+
+    // Number of bytes per character. 1 byte for X coordinate, 1 byte for Y coordinate, and 1 byte whose upper 4-bits contains the y-offset, and the lower 4-bits contains the height
+    const unsigned int  CharacterByteCount      = 3;
+
+    // Total number of characters
+    const unsigned int  CharacterCount          = 256;
+
+    // Drawn in place of malformed UTF-8 (the Unicode replacement character)
+    const unsigned int  ReplacementCodePoint    = 0xFFFD;
+
+    // Number of characters of a proportional font whose pen positions are found at
+    // once. A multiple of 4, the number found by each step of the prefix sum
+    const size_t        PenPositionSpan         = 64;
+
+    // Width of each character of the built-in font (a fixed-width font)
+    const int           CharacterWidth          = TinyTextEncoder_c::CharacterWidth;
+
+    // Distance between the tops of consecutive lines of text. The tallest character
+    // in 'CharacterData' (y-offset plus height) is 13 pixels, plus 1 pixel of leading
+    const int           LineHeight              = TinyTextEncoder_c::LineHeight;
+
+    // The character data
+    const unsigned char CharacterData[]         = { 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 72 , 124 , 208 , 108 , 24 , 41 , 36 , 120 , 35 , 0 , 37 , 41 , 9 , 36 , 41 , 18 , 36 , 41 , 27 , 36 , 41 , 81 , 118 , 35 , 81 , 0 , 43 , 90 , 0 , 43 , 18 , 120 , 69 , 108 , 94 , 71 , 117 , 115 , 162 , 45 , 124 , 113 , 36 , 124 , 161 , 9 , 105 , 55 , 99 , 34 , 41 , 108 , 34 , 41 , 117 , 34 , 41 , 0 , 47 , 41 , 9 , 46 , 41 , 18 , 46 , 41 , 27 , 46 , 41 , 36 , 46 , 41 , 99 , 24 , 41 , 45 , 46 , 41 , 81 , 104 , 86 , 27 , 105 , 87 , 99 , 94 , 71 , 72 , 120 , 83 , 36 , 105 , 71 , 72 , 46 , 41 , 81 , 45 , 41 , 90 , 45 , 41 , 99 , 44 , 41 , 108 , 44 , 41 , 117 , 44 , 41 , 0 , 57 , 41 , 9 , 56 , 41 , 18 , 56 , 41 , 27 , 56 , 41 , 36 , 56 , 41 , 45 , 56 , 41 , 54 , 56 , 41 , 63 , 56 , 41 , 72 , 56 , 41 , 81 , 55 , 41 , 90 , 55 , 41 , 0 , 77 , 41 , 99 , 54 , 41 , 108 , 54 , 41 , 117 , 54 , 41 , 0 , 67 , 41 , 9 , 66 , 41 , 18 , 66 , 41 , 27 , 66 , 41 , 36 , 66 , 41 , 45 , 66 , 41 , 54 , 66 , 41 , 72 , 12 , 43 , 54 , 105 , 55 , 99 , 12 , 43 , 54 , 120 , 19 , 54 , 124 , 193 , 99 , 115 , 34 , 54 , 113 , 86 , 63 , 66 , 41 , 45 , 113 , 86 , 72 , 66 , 41 , 81 , 111 , 86 , 81 , 65 , 41 , 45 , 96 , 88 , 90 , 65 , 41 , 99 , 64 , 41 , 27 , 0 , 43 , 108 , 64 , 41 , 117 , 64 , 41 , 36 , 113 , 86 , 27 , 113 , 86 , 18 , 113 , 86 , 90 , 95 , 88 , 81 , 95 , 88 , 9 , 113 , 86 , 0 , 114 , 86 , 63 , 96 , 56 , 63 , 113 , 86 , 117 , 102 , 86 , 108 , 102 , 86 , 99 , 102 , 86 , 27 , 96 , 88 , 90 , 104 , 86 , 36 , 24 , 43 , 0 , 0 , 28 , 63 , 24 , 43 , 63 , 120 , 51 , 27 , 126 , 208 , 108 , 24 , 41 , 0 , 127 , 208 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 117 , 118 , 208 , 108 , 24 , 41 , 99 , 118 , 208 , 108 , 118 , 208 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 108 , 24 , 41 , 81 , 122 , 208 , 108 , 24 , 41 , 108 , 24 , 41 , 90 , 121 , 208 , 9 , 76 , 41 , 0 , 106 , 71 , 18 , 96 , 56 , 117 , 94 , 39 , 9 , 96 , 56 , 45 , 0 , 43 , 18 , 76 , 41 , 27 , 124 , 33 , 72 , 96 , 40 , 63 , 105 , 39 , 99 , 109 , 101 , 90 , 118 , 82 , 9 , 126 , 113 , 36 , 96 , 40 , 18 , 126 , 17 , 27 , 120 , 35 , 27 , 76 , 41 , 108 , 109 , 37 , 117 , 109 , 37 , 108 , 115 , 34 , 0 , 97 , 88 , 36 , 76 , 41 , 63 , 124 , 113 , 45 , 120 , 163 , 0 , 121 , 37 , 45 , 105 , 39 , 9 , 120 , 101 , 45 , 76 , 41 , 54 , 76 , 41 , 63 , 76 , 41 , 72 , 76 , 41 , 36 , 0 , 11 , 18 , 0 , 11 , 9 , 0 , 11 , 63 , 12 , 11 , 54 , 12 , 11 , 45 , 12 , 11 , 81 , 75 , 41 , 81 , 24 , 58 , 36 , 12 , 11 , 27 , 12 , 11 , 18 , 12 , 11 , 9 , 12 , 11 , 0 , 13 , 11 , 117 , 0 , 11 , 99 , 0 , 11 , 72 , 0 , 11 , 90 , 75 , 41 , 63 , 0 , 11 , 54 , 0 , 11 , 72 , 24 , 11 , 54 , 24 , 11 , 45 , 24 , 11 , 27 , 24 , 11 , 72 , 105 , 71 , 99 , 74 , 41 , 18 , 24 , 11 , 117 , 12 , 11 , 108 , 12 , 11 , 81 , 12 , 11 , 108 , 0 , 11 , 108 , 74 , 41 , 117 , 74 , 41 , 0 , 87 , 41 , 9 , 86 , 41 , 18 , 86 , 41 , 27 , 86 , 41 , 36 , 86 , 41 , 90 , 24 , 26 , 72 , 113 , 86 , 54 , 96 , 88 , 45 , 86 , 41 , 54 , 86 , 41 , 63 , 86 , 41 , 72 , 86 , 41 , 81 , 85 , 41 , 90 , 85 , 41 , 99 , 84 , 41 , 108 , 84 , 41 , 117 , 84 , 41 , 117 , 24 , 41 , 36 , 36 , 41 , 45 , 36 , 41 , 54 , 36 , 41 , 63 , 36 , 41 , 72 , 36 , 41 , 18 , 105 , 71 , 90 , 111 , 86 , 81 , 35 , 41 , 90 , 35 , 41 , 54 , 46 , 41 , 63 , 46 , 41 , 9 , 24 , 43 , 0 , 25 , 43 , 90 , 12 , 43 };
+
+    // The Windows-1252 character used to display each of the code page 437 characters
+    // 0x80-0xFF (the lower half of code page 437 matches ASCII). Where there is no
+    // equivalent, line drawing is approximated with '+', '-', '|' and '=', block
+    // shading with '#', and Greek letters with their Latin counterparts
+    const unsigned char CodePage437Characters[] = { 199 , 252 , 233 , 226 , 228 , 224 , 229 , 231 , 234 , 235 , 232 , 239 , 238 , 236 , 196 , 197 , 201 , 230 , 198 , 244 , 246 , 242 , 251 , 249 , 255 , 214 , 220 , 162 , 163 , 165 , 80 , 131 , 225 , 237 , 243 , 250 , 241 , 209 , 170 , 186 , 191 , 172 , 172 , 189 , 188 , 161 , 171 , 187 , 35 , 35 , 35 , 124 , 43 , 43 , 43 , 43 , 43 , 43 , 124 , 43 , 43 , 43 , 43 , 43 , 43 , 43 , 43 , 43 , 45 , 43 , 43 , 43 , 43 , 43 , 43 , 43 , 43 , 61 , 43 , 43 , 43 , 43 , 43 , 43 , 43 , 43 , 43 , 43 , 43 , 43 , 43 , 35 , 35 , 35 , 35 , 35 , 97 , 223 , 71 , 112 , 83 , 115 , 181 , 116 , 70 , 79 , 79 , 100 , 56 , 102 , 101 , 110 , 61 , 177 , 62 , 60 , 124 , 124 , 247 , 126 , 176 , 183 , 183 , 118 , 110 , 178 , 35 , 160 };
+
+    // Meaningful description of each element of the vertex stream for
+    // a single character
+    enum VertexStreamElements
+    {
+        Triangle0_Vertex0_Position_X,
+        Triangle0_Vertex0_Position_Y,
+        Triangle0_Vertex0_UV,
+        Triangle0_Vertex0_Colour,
+
+        Triangle0_Vertex1_Position_X,
+        Triangle0_Vertex1_Position_Y,
+        Triangle0_Vertex1_UV,
+        Triangle0_Vertex1_Colour,
+
+        Triangle0_Vertex2_Position_X,
+        Triangle0_Vertex2_Position_Y,
+        Triangle0_Vertex2_UV,
+        Triangle0_Vertex2_Colour,
+
+        Triangle1_Vertex0_Position_X,
+        Triangle1_Vertex0_Position_Y,
+        Triangle1_Vertex0_UV,
+        Triangle1_Vertex0_Colour,
+
+        Triangle1_Vertex1_Position_X,
+        Triangle1_Vertex1_Position_Y,
+        Triangle1_Vertex1_UV,
+        Triangle1_Vertex1_Colour,
+
+        Triangle1_Vertex2_Position_X,
+        Triangle1_Vertex2_Position_Y,
+        Triangle1_Vertex2_UV,
+        Triangle1_Vertex2_Colour,
+
+        NumVertexElementsPerCharacter
+    };
+//}
+
+/*---------------------------------------------------------------------------------
+    Private Implementation
+---------------------------------------------------------------------------------*/
+//namespace
+//{
+
+    /*---------------------------------------------------------------------------------
+        IsBlankCharacter
+        Returns 'true' if the character's rectangle in the decoded font texels (see
+        'TinyTextEncoder_c::GetFontTexels') has no texel that the pixel shader keeps.
+        Blank characters would be discarded entirely, so they needn't be added to the
+        vertex buffer at all
+    ---------------------------------------------------------------------------------*/
+    bool IsBlankCharacter( const unsigned char * texels, unsigned int character )
+    {
+        int u = CharacterData[ ( character * CharacterByteCount ) + 0 ];
+        int v = CharacterData[ ( character * CharacterByteCount ) + 1 ];
+        int height = CharacterData[ ( character * CharacterByteCount ) + 2 ] & 0x0F;
+
+        for ( int y = v; y < v + height && y < int( TextTextureHeight ); ++y )
+        {
+            for ( int x = u; x < u + CharacterWidth && x < int( TextTextureWidth ); ++x )
+            {
+                if ( texels[ y * TextTextureWidth + x ] )
+                {
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    /*---------------------------------------------------------------------------------
+        EncodePositionCoord
+        Encodes the specified position coordinate into a dword that will be inserted
+        into the vertex stream
+    ---------------------------------------------------------------------------------*/
+    unsigned int EncodePositionCoord( float pos )
+    {
+        unsigned int result;
+        memcpy( &result, &pos, sizeof( result ) );
+        return result;
+    }
+
+    /*---------------------------------------------------------------------------------
+        EncodeUVCoords
+        Encodes the specified u and v coordinate into a dword that will be inserted
+        into the vertex stream
+    ---------------------------------------------------------------------------------*/
+    unsigned int EncodeUVCoords( int u, int v )
+    {
+        unsigned int result = u & 0x0000FFFF;
+        result |= ( v << 16 ) & 0xFFFF0000;
+        return result;
+    }
+
+    /*---------------------------------------------------------------------------------
+        MakeRect
+        Returns a rectangle with the specified edges
+    ---------------------------------------------------------------------------------*/
+    inline TinyTextRect_s MakeRect( int left, int top, int right, int bottom )
+    {
+        TinyTextRect_s rect;
+        rect.left = left;
+        rect.top = top;
+        rect.right = right;
+        rect.bottom = bottom;
+        return rect;
+    }
+
+    /*---------------------------------------------------------------------------------
+        GetClipRect
+        Returns the rectangle (in pixels) that text printed to the viewport with the
+        specified format is clipped to
+    ---------------------------------------------------------------------------------*/
+    TinyTextRect_s GetClipRect( float viewportWidth, float viewportHeight, const TinyTextFormat_c * format )
+    {
+        TinyTextRect_s clipRect = MakeRect( 0, 0, int( viewportWidth ), int( viewportHeight ) );
+
+        if ( format && format->clip )
+        {
+            if ( format->clipRect.left > clipRect.left ) clipRect.left = format->clipRect.left;
+            if ( format->clipRect.top > clipRect.top ) clipRect.top = format->clipRect.top;
+            if ( format->clipRect.right < clipRect.right ) clipRect.right = format->clipRect.right;
+            if ( format->clipRect.bottom < clipRect.bottom ) clipRect.bottom = format->clipRect.bottom;
+        }
+
+        return clipRect;
+    }
+
+    /*---------------------------------------------------------------------------------
+        CountCharacters
+        Returns the number of characters in 'text', up to 'maxCharacterCount' bytes. In
+        UTF-8, continuation bytes don't count
+    ---------------------------------------------------------------------------------*/
+    size_t CountCharacters( const char * text, size_t maxCharacterCount, bool utf8 )
+    {
+        size_t count = 0;
+        size_t i = 0;
+
+        for ( ; i < maxCharacterCount && text[ i ]; ++i )
+        {
+            if ( ( text[ i ] & 0xC0 ) == 0x80 )
+            {
+                ++count;
+            }
+        }
+
+        return utf8 ? i - count : i;
+    }
+
+    /*---------------------------------------------------------------------------------
+        DecodeUTF8
+        Decodes the UTF-8 sequence at the start of 'text' (no more than 'byteCount'
+        bytes) - returns the number of bytes used. Malformed sequences decode to the
+        replacement character, one byte at a time, so the text resynchronises at the
+        next character
+    ---------------------------------------------------------------------------------*/
+    size_t DecodeUTF8( const char * text, size_t byteCount, unsigned int * codePoint )
+    {
+        const unsigned int lead = ( unsigned char ) text[ 0 ];
+        size_t length;
+        unsigned int minCodePoint;
+
+        if ( lead < 0x80 )
+        {
+            *codePoint = lead;
+            return 1;
+        }
+        else if ( ( lead & 0xE0 ) == 0xC0 )
+        {
+            length = 2;
+            minCodePoint = 0x80;
+            *codePoint = lead & 0x1F;
+        }
+        else if ( ( lead & 0xF0 ) == 0xE0 )
+        {
+            length = 3;
+            minCodePoint = 0x800;
+            *codePoint = lead & 0x0F;
+        }
+        else if ( ( lead & 0xF8 ) == 0xF0 )
+        {
+            length = 4;
+            minCodePoint = 0x10000;
+            *codePoint = lead & 0x07;
+        }
+        else
+        {
+            *codePoint = ReplacementCodePoint;
+            return 1;
+        }
+
+        // The terminator isn't a continuation byte, so this never reads past it
+        for ( size_t i = 1; i < length; ++i )
+        {
+            if ( i >= byteCount || ( text[ i ] & 0xC0 ) != 0x80 )
+            {
+                *codePoint = ReplacementCodePoint;
+                return 1;
+            }
+
+            *codePoint = ( *codePoint << 6 ) | ( text[ i ] & 0x3F );
+        }
+
+        // Overlong encodings, surrogates and values beyond Unicode
+        if ( *codePoint < minCodePoint || *codePoint > 0x10FFFF || ( *codePoint >= 0xD800 && *codePoint < 0xE000 ) )
+        {
+            *codePoint = ReplacementCodePoint;
+        }
+
+        return length;
+    }
+
+    /*---------------------------------------------------------------------------------
+        DecodeSpan
+        Decodes up to 'PenPositionSpan' characters of 'text' (no more than 'byteCount'
+        bytes, and stopping at the terminator) - returns the number of bytes used
+    ---------------------------------------------------------------------------------*/
+    size_t DecodeSpan( const char * text, size_t byteCount, bool utf8, unsigned int * characters, size_t * characterCount )
+    {
+        size_t count = 0;
+        size_t i = 0;
+
+        while ( i < byteCount && text[ i ] && count < PenPositionSpan )
+        {
+            unsigned int character = ( unsigned char ) text[ i ];
+            size_t length = 1;
+
+            if ( character >= 0x80 && utf8 )
+            {
+                length = DecodeUTF8( text + i, byteCount - i, &character );
+            }
+
+            characters[ count++ ] = character;
+            i += length;
+        }
+
+        *characterCount = count;
+        return i;
+    }
+
+    /*---------------------------------------------------------------------------------
+        LowestSetBit
+        Returns the index of the lowest set bit of a non-zero mask
+    ---------------------------------------------------------------------------------*/
+    inline unsigned int LowestSetBit( unsigned int mask )
+    {
+    #if defined( _MSC_VER )
+        unsigned long index;
+        _BitScanForward( &index, mask );
+        return index;
+    #else
+        return __builtin_ctz( mask );
+    #endif
+    }
+
+    /*---------------------------------------------------------------------------------
+        ControlCharacterMask
+        Returns a 16-bit mask with a bit set for each of the 16 characters that is a
+        space, terminator or other control character
+    ---------------------------------------------------------------------------------*/
+    inline unsigned int ControlCharacterMask( __m128i characters )
+    {
+        // Characters <= ' ' are the only ones left unchanged by an unsigned min with ' '
+        __m128i clamped = _mm_min_epu8( characters, _mm_set1_epi8( ' ' ) );
+        return _mm_movemask_epi8( _mm_cmpeq_epi8( clamped, characters ) );
+    }
+
+    /*---------------------------------------------------------------------------------
+        ScanToControlCharacter
+        Returns the number of characters (up to 'maxCharacterCount') before the first
+        space, terminator or other control character in 'text'. Sixteen characters are
+        tested at a time; loads are 16-byte aligned so they never cross into a page
+        beyond the end of the string
+    ---------------------------------------------------------------------------------*/
+    size_t ScanToControlCharacter( const char * text, size_t maxCharacterCount )
+    {
+        size_t misalignment = size_t( text ) & 15;
+        const __m128i * block = ( const __m128i * )( text - misalignment );
+
+        unsigned int mask = ControlCharacterMask( _mm_load_si128( block ) ) >> misalignment;
+        size_t count = 0;
+
+        if ( !mask )
+        {
+            count = 16 - misalignment;
+
+            while ( count < maxCharacterCount )
+            {
+                mask = ControlCharacterMask( _mm_load_si128( ++block ) );
+                if ( mask )
+                {
+                    break;
+                }
+
+                count += 16;
+            }
+        }
+
+        if ( mask )
+        {
+            count += LowestSetBit( mask );
+        }
+
+        return ( count < maxCharacterCount ) ? count : maxCharacterCount;
+    }
+
+//}
+
+/*---------------------------------------------------------------------------------
+    PlacedCharacter_s
+    A character that has been laid out, but not yet added to the vertex buffer
+---------------------------------------------------------------------------------*/
+struct PlacedCharacter_s
+{
+    int x;
+    int y;
+    unsigned int character;     // A byte of the text, or a code point in UTF-8
+};
+
+//namespace
+//{
+    /*---------------------------------------------------------------------------------
+        TextLayout_c
+        Lays out a run of text according to a 'TinyTextFormat_c'. Positions are relative
+        to the anchor point of the run; each line is aligned horizontally as soon as it
+        is complete, and the run is aligned vertically once its height is known. Placed
+        characters wait in the encoder's scratch space until they are added to the
+        vertex buffer, which happens in batches whenever the scratch space fills up
+    ---------------------------------------------------------------------------------*/
+    class TextLayout_c
+    {
+    private:
+
+        const TinyTextFormat_c & format;
+        const TinyTextEncoder_c & encoder;
+        TinyTextEncoder_c * output;
+        PlacedCharacter_s * placedCharacters;
+        size_t placedCharacterCapacity;
+        unsigned int font;
+        float scale;
+        bool utf8;
+        bool proportional;
+        size_t placedCharacterCount;
+        size_t droppedCharacterCount;
+        size_t lineStart;
+        int characterWidth;
+        int lineHeight;
+        int spaceWidth;
+        int tabWidth;
+        int x;
+        int y;
+        int lineWidth;
+        int width;
+        int height;
+        const char * runText;
+        size_t runCharacterCount;
+        bool anchorYKnown;
+        int anchorY;
+        int measuredLineY;
+        int measuredLineWidth;
+        float viewportWidth;
+        float viewportHeight;
+        TinyTextRect_s clipRect;
+        int originX;
+        int originY;
+        unsigned int colour;
+
+    public:
+
+        // Constructor - characters are laid out in one of the encoder's fonts at
+        // 'scale', in cells of the font's size unless the font is proportional. Until
+        // 'SetOutput' is called, the text is only measured
+        TextLayout_c( const TinyTextFormat_c & format, const TinyTextEncoder_c & encoder, unsigned int font, float scale );
+
+        // Adds the characters to an encoder's vertex buffer as they are laid out, with
+        // the anchor point of the run at ('x', 'y'), using its scratch space to hold
+        // characters until their positions are final
+        void SetOutput( TinyTextEncoder_c * outputEncoder, float outputWidth, float outputHeight, const TinyTextRect_s & outputClipRect, int x, int y, unsigned int outputColour );
+
+        // Lays out the text, stopping early once lines start below 'maxY'. Returns
+        // 'false' if there wasn't room in the vertex buffer for every character
+        bool Run( size_t maxCharacterCount, const char * text, int maxY );
+
+        // Accessors for the results of 'Run'
+        size_t GetDroppedCharacterCount( ) const { return droppedCharacterCount; }
+        int GetWidth( ) const { return width; }
+        int GetHeight( ) const { return height; }
+
+    private:
+
+        // Places a character at the current position
+        bool Place( unsigned int character );
+
+        // Makes room in the scratch space by adding the characters whose positions are
+        // known to the vertex buffer - returns 'false' if the buffer was full
+        bool Flush( );
+
+        // Adds the first 'count' placed characters to the vertex buffer, moving those
+        // of the current line by 'lineAnchorX', and removes them from the scratch
+        // space - returns 'false' if the buffer was full
+        bool Emit( size_t count, int lineAnchorX );
+
+        // Lays the whole run out again without placing anything, to find its height
+        // and the width of the line at 'lineY' before this layout has reached the end
+        // of them. Either pointer may be NULL
+        void Measure( int lineY, int * lineWidth, int * runHeight ) const;
+
+        // Offsets that align a line of the specified width, or a run of the specified
+        // height, to the anchor
+        int GetAnchorX( int alignedWidth ) const;
+        int GetAnchorY( int alignedHeight ) const;
+
+        // Places the characters of a word in a proportional font, given the number of
+        // bytes left in the text - returns 'false' if there wasn't room for them all
+        bool PlaceWord( const char * text, size_t wordLength, size_t maxCharacterCount );
+
+        // Finishes the current line and starts a new one
+        void NewLine( );
+
+        // Aligns the characters of the current line and updates the bounds of the run
+        void EndLine( );
+
+        // Returns 'true' if a span of the specified width would overflow the line
+        bool Overflows( int spanWidth ) const
+        {
+            return format.wrapWidth > 0 && x != 0 && x + spanWidth > format.wrapWidth;
+        }
+    };
+
+    /*---------------------------------------------------------------------------------
+        TextLayout_c::TextLayout_c
+        Constructor
+    ---------------------------------------------------------------------------------*/
+    TextLayout_c::TextLayout_c( const TinyTextFormat_c & format, const TinyTextEncoder_c & encoder, unsigned int font, float scale )
+        : format( format ), encoder( encoder ), output( 0 ), placedCharacters( 0 ), placedCharacterCapacity( 0 ),
+          font( font ), scale( scale ), utf8( encoder.m_UTF8 ), proportional( encoder.IsProportional( font ) ),
+          placedCharacterCount( 0 ), droppedCharacterCount( 0 ), lineStart( 0 ),
+          characterWidth( encoder.GetScaledCharacterWidth( scale, font ) ), lineHeight( encoder.GetScaledLineHeight( scale, font ) ),
+          spaceWidth( characterWidth ), tabWidth( ( format.tabSize > 0 ? format.tabSize : 1 ) * characterWidth ),
+          x( 0 ), y( 0 ), lineWidth( 0 ), width( 0 ), height( 0 ), runText( 0 ), runCharacterCount( 0 ),
+          anchorYKnown( ( format.anchor & TinyTextFormat_c::AnchorVerticalMask ) == TinyTextFormat_c::AnchorTop ), anchorY( 0 ),
+          measuredLineY( -1 ), measuredLineWidth( 0 ), viewportWidth( 0.0f ), viewportHeight( 0.0f ),
+          clipRect( MakeRect( 0, 0, 0, 0 ) ), originX( 0 ), originY( 0 ), colour( 0 )
+    {
+        if ( proportional )
+        {
+            spaceWidth = TinyTextEncoder_c::ScaleMetric( encoder.m_Advances[ font ][ encoder.GetFontCharacter( ' ' ) ], scale );
+        }
+    }
+
+    /*---------------------------------------------------------------------------------
+        TextLayout_c::SetOutput
+        Adds the characters to an encoder's vertex buffer as they are laid out
+    ---------------------------------------------------------------------------------*/
+    void TextLayout_c::SetOutput( TinyTextEncoder_c * outputEncoder, float outputWidth, float outputHeight, const TinyTextRect_s & outputClipRect, int x, int y, unsigned int outputColour )
+    {
+        output = outputEncoder;
+        placedCharacters = outputEncoder->m_PlacedCharacters;
+        placedCharacterCapacity = outputEncoder->m_Capacity;
+        viewportWidth = outputWidth;
+        viewportHeight = outputHeight;
+        clipRect = outputClipRect;
+        originX = x;
+        originY = y;
+        colour = outputColour;
+    }
+
+    /*---------------------------------------------------------------------------------
+        TextLayout_c::Run
+        Lays out the text. Words are found with a vectorised scan for spaces and control
+        characters, so ordinary characters are only ever visited to be placed. Bytes of
+        multi-byte UTF-8 sequences are never spaces or control characters, so the scan
+        works on UTF-8 unchanged
+    ---------------------------------------------------------------------------------*/
+    bool TextLayout_c::Run( size_t maxCharacterCount, const char * text, int maxY )
+    {
+        runText = text;
+        runCharacterCount = maxCharacterCount;
+
+        while ( maxCharacterCount && y < maxY )
+        {
+            // Find the extent of the next word
+            size_t wordLength = ScanToControlCharacter( text, maxCharacterCount );
+
+            if ( wordLength && proportional )
+            {
+                if ( !PlaceWord( text, wordLength, maxCharacterCount ) )
+                {
+                    EndLine( );
+                    return false;
+                }
+
+                text += wordLength;
+                maxCharacterCount -= wordLength;
+
+                if ( !maxCharacterCount )
+                {
+                    break;
+                }
+            }
+            else if ( wordLength )
+            {
+                // If the word doesn't fit on the current line, then move it onto the next
+                if ( Overflows( int( utf8 ? CountCharacters( text, wordLength, true ) : wordLength ) * characterWidth ) )
+                {
+                    NewLine( );
+                }
+
+                for ( size_t i = 0, length; i < wordLength; i += length )
+                {
+                    unsigned int character = ( unsigned char ) text[ i ];
+                    length = 1;
+
+                    if ( character >= 0x80 && utf8 )
+                    {
+                        length = DecodeUTF8( text + i, wordLength - i, &character );
+                    }
+
+                    if ( !Place( character ) )
+                    {
+                        droppedCharacterCount += CountCharacters( text + i, maxCharacterCount - i, utf8 );
+                        EndLine( );
+                        return false;
+                    }
+                }
+
+                text += wordLength;
+                maxCharacterCount -= wordLength;
+
+                if ( !maxCharacterCount )
+                {
+                    break;
+                }
+            }
+
+            // The word is followed by a space or a control character
+            char currentChar = *( text++ );
+            --maxCharacterCount;
+
+            if ( currentChar == '\0' )
+            {
+                break;
+            }
+
+            switch ( currentChar )
+            {
+            case '\n':
+                NewLine( );
+                break;
+
+            case '\r':
+                break;
+
+            case '\t':
+                x = ( ( x / tabWidth ) + 1 ) * tabWidth;
+                break;
+
+            case ' ':
+                x += spaceWidth;
+                break;
+
+            default:
+                // Any other control character has a glyph of its own
+                if ( !Place( ( unsigned char ) currentChar ) )
+                {
+                    droppedCharacterCount += 1 + CountCharacters( text, maxCharacterCount, utf8 );
+                    EndLine( );
+                    return false;
+                }
+                break;
+            }
+        }
+
+        EndLine( );
+
+        // Align the run vertically, now that its height is known, and add the rest of
+        // its characters to the vertex buffer
+        if ( !output )
+        {
+            return true;
+        }
+
+        if ( !anchorYKnown )
+        {
+            anchorY = GetAnchorY( height );
+            anchorYKnown = true;
+        }
+
+        return Emit( placedCharacterCount, 0 );
+    }
+
+    /*---------------------------------------------------------------------------------
+        TextLayout_c::Place
+        Places a character at the current position
+    ---------------------------------------------------------------------------------*/
+    bool TextLayout_c::Place( unsigned int character )
+    {
+        // Words that are wider than a whole line are broken wherever they overflow
+        if ( Overflows( characterWidth ) )
+        {
+            NewLine( );
+        }
+
+        if ( output )
+        {
+            if ( placedCharacterCount == placedCharacterCapacity && !Flush( ) )
+            {
+                return false;
+            }
+
+            PlacedCharacter_s & placed = placedCharacters[ placedCharacterCount++ ];
+            placed.x = x;
+            placed.y = y;
+            placed.character = character;
+        }
+
+        x += characterWidth;
+        lineWidth = x;
+        return true;
+    }
+
+    /*---------------------------------------------------------------------------------
+        TextLayout_c::PlaceWord
+        Places the characters of a word in a proportional font. The word is decoded a
+        span at a time, and the pen positions of each span are found at once. Words
+        longer than a span are measured in full first, so that they can be moved onto
+        the next line like any other
+    ---------------------------------------------------------------------------------*/
+    bool TextLayout_c::PlaceWord( const char * text, size_t wordLength, size_t maxCharacterCount )
+    {
+        unsigned int characters[ PenPositionSpan ];
+        int positions[ PenPositionSpan + 4 ];
+        size_t count;
+
+        size_t spanLength = DecodeSpan( text, wordLength, utf8, characters, &count );
+        encoder.GetPenPositions( font, characters, count, -1, scale, positions );
+        int wordWidth = positions[ count ];
+
+        if ( spanLength < wordLength )
+        {
+            for ( size_t offset = spanLength; offset < wordLength; )
+            {
+                const int previous = encoder.GetFontCharacter( characters[ count - 1 ] );
+                offset += DecodeSpan( text + offset, wordLength - offset, utf8, characters, &count );
+                encoder.GetPenPositions( font, characters, count, previous, scale, positions );
+                wordWidth += positions[ count ];
+            }
+
+            spanLength = DecodeSpan( text, wordLength, utf8, characters, &count );
+            encoder.GetPenPositions( font, characters, count, -1, scale, positions );
+        }
+
+        // If the word doesn't fit on the current line, then move it onto the next
+        if ( Overflows( wordWidth ) )
+        {
+            NewLine( );
+        }
+
+        // The pen position that the span's positions are relative to
+        int penX = x;
+
+        for ( size_t offset = 0; ; )
+        {
+            for ( size_t i = 0; i < count; ++i )
+            {
+                x = penX + positions[ i ];
+
+                // Words that are wider than a whole line are broken wherever they overflow
+                if ( Overflows( positions[ i + 1 ] - positions[ i ] ) )
+                {
+                    NewLine( );
+                    penX = -positions[ i ];
+                }
+
+                if ( output )
+                {
+                    if ( placedCharacterCount == placedCharacterCapacity && !Flush( ) )
+                    {
+                        droppedCharacterCount += ( count - i ) + CountCharacters( text + offset + spanLength, maxCharacterCount - offset - spanLength, utf8 );
+                        return false;
+                    }
+
+                    PlacedCharacter_s & placed = placedCharacters[ placedCharacterCount++ ];
+                    placed.x = x;
+                    placed.y = y;
+                    placed.character = characters[ i ];
+                }
+
+                x = penX + positions[ i + 1 ];
+                lineWidth = x;
+            }
+
+            offset += spanLength;
+
+            if ( offset == wordLength )
+            {
+                return true;
+            }
+
+            const int previous = encoder.GetFontCharacter( characters[ count - 1 ] );
+            penX += positions[ count ];
+
+            spanLength = DecodeSpan( text + offset, wordLength - offset, utf8, characters, &count );
+            encoder.GetPenPositions( font, characters, count, previous, scale, positions );
+        }
+    }
+
+    /*---------------------------------------------------------------------------------
+        TextLayout_c::NewLine
+        Finishes the current line and starts a new one
+    ---------------------------------------------------------------------------------*/
+    void TextLayout_c::NewLine( )
+    {
+        EndLine( );
+        x = 0;
+        y += lineHeight;
+    }
+
+    /*---------------------------------------------------------------------------------
+        TextLayout_c::EndLine
+        Aligns the characters of the current line and updates the bounds of the run.
+        Trailing spaces don't count towards the width of a line
+    ---------------------------------------------------------------------------------*/
+    void TextLayout_c::EndLine( )
+    {
+        const int anchorX = GetAnchorX( lineWidth );
+
+        if ( anchorX && output )
+        {
+            for ( size_t i = lineStart; i < placedCharacterCount; ++i )
+            {
+                placedCharacters[ i ].x -= anchorX;
+            }
+        }
+
+        if ( y == measuredLineY )
+        {
+            measuredLineWidth = lineWidth;
+        }
+
+        if ( lineWidth > width )
+        {
+            width = lineWidth;
+        }
+
+        height = y + lineHeight;
+        lineStart = placedCharacterCount;
+        lineWidth = 0;
+    }
+
+    /*---------------------------------------------------------------------------------
+        TextLayout_c::Flush
+        Makes room in the scratch space by adding the characters whose positions are
+        known to the vertex buffer. Lines that are complete have already been aligned
+        horizontally; if the current line fills the scratch space on its own, it is
+        measured first, unless it is aligned to the left. Runs that aren't aligned to
+        the top are measured the first time they are flushed. Either way the scratch
+        space only limits how many characters wait to be added, not how many can be
+    ---------------------------------------------------------------------------------*/
+    bool TextLayout_c::Flush( )
+    {
+        if ( !placedCharacterCount )
+        {
+            return false;
+        }
+
+        // A line is only measured once, however many times it fills the scratch space
+        const bool alignLine = !lineStart && ( format.anchor & TinyTextFormat_c::AnchorHorizontalMask ) != TinyTextFormat_c::AnchorLeft;
+        const bool measureLine = alignLine && measuredLineY != y;
+
+        if ( measureLine || !anchorYKnown )
+        {
+            int measuredHeight;
+            Measure( measureLine ? y : -1, measureLine ? &measuredLineWidth : 0, anchorYKnown ? 0 : &measuredHeight );
+
+            if ( measureLine )
+            {
+                measuredLineY = y;
+            }
+
+            if ( !anchorYKnown )
+            {
+                anchorY = GetAnchorY( measuredHeight );
+                anchorYKnown = true;
+            }
+        }
+
+        return Emit( lineStart ? lineStart : placedCharacterCount, alignLine ? GetAnchorX( measuredLineWidth ) : 0 );
+    }
+
+    /*---------------------------------------------------------------------------------
+        TextLayout_c::Emit
+        Adds the first 'count' placed characters to the vertex buffer, and removes them
+        from the scratch space
+    ---------------------------------------------------------------------------------*/
+    bool TextLayout_c::Emit( size_t count, int lineAnchorX )
+    {
+        for ( size_t i = 0; i < count; ++i )
+        {
+            const PlacedCharacter_s & placed = placedCharacters[ i ];
+            const int placedX = i < lineStart ? placed.x : placed.x - lineAnchorX;
+
+            if ( !output->AddCharacter( viewportWidth, viewportHeight, clipRect, font, placed.character, originX + placedX, originY + placed.y - anchorY, scale, colour ) )
+            {
+                droppedCharacterCount += placedCharacterCount - i;
+                placedCharacterCount = 0;
+                lineStart = 0;
+                return false;
+            }
+        }
+
+        // Whatever is left belongs to the current line
+        memmove( placedCharacters, placedCharacters + count, ( placedCharacterCount - count ) * sizeof( PlacedCharacter_s ) );
+        placedCharacterCount -= count;
+        lineStart = 0;
+        return true;
+    }
+
+    /*---------------------------------------------------------------------------------
+        TextLayout_c::Measure
+        Lays the whole run out again without placing anything. Only called when the
+        scratch space fills up before the positions of its characters are known
+    ---------------------------------------------------------------------------------*/
+    void TextLayout_c::Measure( int lineY, int * lineWidth, int * runHeight ) const
+    {
+        TextLayout_c layout( format, encoder, font, scale );
+        layout.measuredLineY = lineY;
+        layout.Run( runCharacterCount, runText, runHeight ? INT_MAX : lineY + 1 );
+
+        if ( lineWidth )
+        {
+            *lineWidth = layout.measuredLineWidth;
+        }
+
+        if ( runHeight )
+        {
+            *runHeight = layout.height;
+        }
+    }
+
+    /*---------------------------------------------------------------------------------
+        TextLayout_c::GetAnchorX
+        Offset that aligns a line of the specified width to the anchor
+    ---------------------------------------------------------------------------------*/
+    int TextLayout_c::GetAnchorX( int alignedWidth ) const
+    {
+        switch ( format.anchor & TinyTextFormat_c::AnchorHorizontalMask )
+        {
+        case TinyTextFormat_c::AnchorCentre:
+            return alignedWidth / 2;
+
+        case TinyTextFormat_c::AnchorRight:
+            return alignedWidth;
+        }
+
+        return 0;
+    }
+
+    /*---------------------------------------------------------------------------------
+        TextLayout_c::GetAnchorY
+        Offset that aligns a run of the specified height to the anchor
+    ---------------------------------------------------------------------------------*/
+    int TextLayout_c::GetAnchorY( int alignedHeight ) const
+    {
+        switch ( format.anchor & TinyTextFormat_c::AnchorVerticalMask )
+        {
+        case TinyTextFormat_c::AnchorMiddle:
+            return alignedHeight / 2;
+
+        case TinyTextFormat_c::AnchorBottom:
+            return alignedHeight;
+        }
+
+        return 0;
+    }
+//}
+
+//namespace
+//{
+    /*---------------------------------------------------------------------------------
+        TinyTextFormat_c::TinyTextFormat_c
+        Constructor
+    ---------------------------------------------------------------------------------*/
+    TinyTextFormat_c::TinyTextFormat_c( int wrapWidth, int tabSize, int anchor, int scale )
+    :   wrapWidth( wrapWidth ),
+        tabSize( tabSize ),
+        anchor( anchor ),
+        scale( scale ),
+        font( 0 ),
+        clip( false ),
+        clipRect( MakeRect( 0, 0, 0, 0 ) )
+    {
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextFormat_c::SetClipRect
+        Clips all text printed with this format to the specified rectangle
+    ---------------------------------------------------------------------------------*/
+    void TinyTextFormat_c::SetClipRect( int left, int top, int right, int bottom )
+    {
+        clip = true;
+        clipRect = MakeRect( left, top, right, bottom );
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextFormat_c::GetScaleForDPI
+        Returns the whole-number scale that suits a monitor of the specified DPI
+    ---------------------------------------------------------------------------------*/
+    int TinyTextFormat_c::GetScaleForDPI( unsigned int dpi )
+    {
+        // 96 DPI is 100%. Rounding to the nearest scale means that 150% (144 DPI)
+        // doubles the text, while 125% (120 DPI) leaves it as it is
+        int scale = int( ( dpi + 48 ) / 96 );
+        return scale > 1 ? scale : 1;
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextEncoder_c::TinyTextEncoder_c
+        Constructor
+    ---------------------------------------------------------------------------------*/
+    TinyTextEncoder_c::TinyTextEncoder_c( )
+    :   m_FontCount( 0 ),
+        m_FontScale( 1.0f ),
+        m_GlyphCache( 0 ),
+        m_UTF8( false ),
+        m_Capacity( 0 ),
+        m_PlacedCharacters( 0 ),
+        m_WriteAddress( 0 ),
+        m_NumVertices( 0 ),
+        m_NumSkippedVertices( 0 ),
+        m_NumDroppedCharacters( 0 )
+    {
+        memset( m_CharacterMap, 0, sizeof( m_CharacterMap ) );
+        memset( m_FontGlyphs, 0, sizeof( m_FontGlyphs ) );
+        memset( m_CharacterWidth, 0, sizeof( m_CharacterWidth ) );
+        memset( m_LineHeight, 0, sizeof( m_LineHeight ) );
+        memset( m_Proportional, 0, sizeof( m_Proportional ) );
+        memset( m_Advances, 0, sizeof( m_Advances ) );
+        memset( m_KerningStart, 0, sizeof( m_KerningStart ) );
+        memset( &m_CachedGlyph, 0, sizeof( m_CachedGlyph ) );
+
+        SetFont( 0 );
+        SetCodePage( CodePageWindows1252 );
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextEncoder_c::~TinyTextEncoder_c
+        Destructor
+    ---------------------------------------------------------------------------------*/
+    TinyTextEncoder_c::~TinyTextEncoder_c( )
+    {
+        delete [] m_PlacedCharacters;
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextEncoder_c::Initialise
+        Allocates scratch space for the specified number of characters
+    ---------------------------------------------------------------------------------*/
+    bool TinyTextEncoder_c::Initialise( size_t characterCapacity )
+    {
+        PlacedCharacter_s * placedCharacters = new ( std::nothrow ) PlacedCharacter_s[ characterCapacity ];
+        if ( !placedCharacters )
+        {
+            return false;
+        }
+
+        delete [] m_PlacedCharacters;
+        m_PlacedCharacters = placedCharacters;
+        m_Capacity = characterCapacity;
+
+        return true;
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextEncoder_c::SetCodePage
+        Select the character set used to interpret the bytes passed to 'Print'
+    ---------------------------------------------------------------------------------*/
+    void TinyTextEncoder_c::SetCodePage( CodePage codePage )
+    {
+        unsigned char characterMap[ CharacterCount ];
+
+        for ( unsigned int i = 0; i < CharacterCount; ++i )
+        {
+            characterMap[ i ] = ( unsigned char ) i;
+        }
+
+        switch ( codePage )
+        {
+        case CodePageLatin1:
+            // The C1 control characters share the glyph of the C0 control characters
+            for ( unsigned int i = 0x80; i < 0xA0; ++i )
+            {
+                characterMap[ i ] = 0;
+            }
+            break;
+
+        case CodePage437:
+            for ( unsigned int i = 0x80; i < CharacterCount; ++i )
+            {
+                characterMap[ i ] = CodePage437Characters[ i - 0x80 ];
+            }
+            break;
+
+        default:
+            break;
+        }
+
+        SetCharacterMap( characterMap );
+        m_UTF8 = ( codePage == CodePageUTF8 );
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextEncoder_c::SetCharacterMap
+        Set a custom mapping from each byte passed to 'Print' to a character of the font
+    ---------------------------------------------------------------------------------*/
+    void TinyTextEncoder_c::SetCharacterMap( const unsigned char characterMap[ 256 ] )
+    {
+        memcpy( m_CharacterMap, characterMap, sizeof( m_CharacterMap ) );
+        m_UTF8 = false;
+        UpdateGlyphs( );
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextEncoder_c::SetFont
+        Select the font that text is laid out with - a font pack, or NULL for the
+        built-in font
+    ---------------------------------------------------------------------------------*/
+    void TinyTextEncoder_c::SetFont( const TinyTextFontPack_c * font )
+    {
+        const TinyTextFontPack_c * fonts[ 1 ] = { font && font->IsOpen( ) ? font : 0 };
+        SetFonts( fonts, 1 );
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextEncoder_c::SetFonts
+        Select several fonts at once, to be picked between by each run of text
+    ---------------------------------------------------------------------------------*/
+    bool TinyTextEncoder_c::SetFonts( const TinyTextFontPack_c * const * fonts, unsigned int fontCount )
+    {
+        if ( !ValidateFonts( fonts, fontCount ) )
+        {
+            return false;
+        }
+
+        for ( unsigned int i = 0; i < fontCount; ++i )
+        {
+            LoadFont( i, fonts[ i ] );
+        }
+
+        m_FontCount = fontCount;
+        UpdateGlyphs( );
+
+        return true;
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextEncoder_c::ValidateFonts
+        Returns 'true' if the fonts can be selected together
+    ---------------------------------------------------------------------------------*/
+    bool TinyTextEncoder_c::ValidateFonts( const TinyTextFontPack_c * const * fonts, unsigned int fontCount )
+    {
+        if ( !fonts || !fontCount || fontCount > MaxFonts )
+        {
+            return false;
+        }
+
+        // The fonts are drawn with the same pixel shader, so can't mix distance fields
+        // with bitmaps
+        const bool distanceField = fonts[ 0 ] && fonts[ 0 ]->IsOpen( ) && fonts[ 0 ]->IsDistanceField( );
+
+        for ( unsigned int i = 0; i < fontCount; ++i )
+        {
+            const TinyTextFontPack_c * font = fonts[ i ];
+
+            if ( font && ( !font->IsOpen( ) || font->IsDistanceField( ) != distanceField ) )
+            {
+                return false;
+            }
+
+            if ( font && fontCount > 1 && ( font->GetHeader( )->atlasWidth > MaxFontArraySize || font->GetHeader( )->atlasHeight > MaxFontArraySize ) )
+            {
+                return false;
+            }
+
+            if ( !font && distanceField )
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextEncoder_c::LoadFont
+        Fills in the glyphs and metrics of one of the current fonts
+    ---------------------------------------------------------------------------------*/
+    void TinyTextEncoder_c::LoadFont( unsigned int index, const TinyTextFontPack_c * font )
+    {
+        if ( !font )
+        {
+            unsigned char fontTexels[ FontTextureWidth * FontTextureHeight ];
+            GetFontTexels( fontTexels );
+
+            for ( unsigned int character = 0; character < CharacterCount; ++character )
+            {
+                Glyph_s & glyph = m_FontGlyphs[ index ][ character ];
+                glyph.u = CharacterData[ ( character * CharacterByteCount ) + 0 ];
+                glyph.v = CharacterData[ ( character * CharacterByteCount ) + 1 ];
+                glyph.width = CharacterWidth;
+                glyph.height = IsBlankCharacter( fontTexels, character ) ? 0 : CharacterData[ ( character * CharacterByteCount ) + 2 ] & 0x0F;
+                glyph.xOffset = 0;
+                glyph.yOffset = CharacterData[ ( character * CharacterByteCount ) + 2 ] >> 4;
+
+                m_Advances[ index ][ character ] = CharacterWidth;
+            }
+
+            m_CharacterWidth[ index ] = CharacterWidth;
+            m_LineHeight[ index ] = LineHeight;
+            m_Proportional[ index ] = false;
+        }
+        else
+        {
+            const TinyTextFontGlyph_s * replacement = font->FindGlyph( '?' );
+
+            for ( unsigned int character = 0; character < CharacterCount; ++character )
+            {
+                const TinyTextFontGlyph_s * fontGlyph = font->FindGlyph( TinyTextFontPack_c::GetWindows1252CodePoint( ( unsigned char ) character ) );
+                if ( !fontGlyph )
+                {
+                    fontGlyph = replacement;
+                }
+
+                Glyph_s & glyph = m_FontGlyphs[ index ][ character ];
+                memset( &glyph, 0, sizeof( glyph ) );
+
+                if ( fontGlyph )
+                {
+                    glyph.u = fontGlyph->u;
+                    glyph.v = fontGlyph->v;
+                    glyph.width = fontGlyph->width;
+                    glyph.height = fontGlyph->width ? fontGlyph->height : 0;
+                    glyph.xOffset = fontGlyph->xOffset;
+                    glyph.yOffset = fontGlyph->yOffset;
+                }
+
+                m_Advances[ index ][ character ] = fontGlyph ? fontGlyph->advance : 0;
+            }
+
+            m_CharacterWidth[ index ] = font->GetHeader( )->characterWidth;
+            m_LineHeight[ index ] = font->GetHeader( )->lineHeight;
+            m_Proportional[ index ] = font->IsProportional( );
+        }
+
+        LoadKerning( index, m_Proportional[ index ] ? font : 0 );
+
+        // The font's slice of the texture array is carried in the top bit of each
+        // texture coordinate, so every character can go in the same draw call
+        const unsigned short uBit = ( unsigned short )( ( index & 1 ) << 15 );
+        const unsigned short vBit = ( unsigned short )( ( index >> 1 ) << 15 );
+
+        for ( unsigned int character = 0; character < CharacterCount; ++character )
+        {
+            m_FontGlyphs[ index ][ character ].u |= uBit;
+            m_FontGlyphs[ index ][ character ].v |= vBit;
+        }
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextEncoder_c::LoadKerning
+        Fills in the kerning pairs of one of the current fonts, grouped by their first
+        character - a counting sort, as the pack orders them by code point instead
+    ---------------------------------------------------------------------------------*/
+    void TinyTextEncoder_c::LoadKerning( unsigned int index, const TinyTextFontPack_c * font )
+    {
+        unsigned short * start = m_KerningStart[ index ];
+        memset( start, 0, sizeof( m_KerningStart[ index ] ) );
+
+        const TinyTextFontKerningPair_s * pairs = font ? font->GetKerningPairs( ) : 0;
+        const unsigned int pairCount = font ? font->GetNumKerningPairs( ) : 0;
+
+        // Count the pairs of each first character, then turn the counts into the
+        // position of each first character's pairs
+        unsigned int keptCount = 0;
+
+        for ( unsigned int i = 0; i < pairCount && keptCount < MaxKerningPairs; ++i )
+        {
+            unsigned char first;
+            unsigned char second;
+
+            if ( TinyTextFontPack_c::GetWindows1252Character( pairs[ i ].first, &first ) && TinyTextFontPack_c::GetWindows1252Character( pairs[ i ].second, &second ) )
+            {
+                ++start[ first + 1 ];
+                ++keptCount;
+            }
+        }
+
+        for ( unsigned int character = 0; character < CharacterCount; ++character )
+        {
+            start[ character + 1 ] = ( unsigned short )( start[ character + 1 ] + start[ character ] );
+        }
+
+        unsigned short next[ CharacterCount ];
+        memcpy( next, start, sizeof( next ) );
+
+        for ( unsigned int i = 0, placedCount = 0; i < pairCount && placedCount < keptCount; ++i )
+        {
+            unsigned char first;
+            unsigned char second;
+
+            if ( TinyTextFontPack_c::GetWindows1252Character( pairs[ i ].first, &first ) && TinyTextFontPack_c::GetWindows1252Character( pairs[ i ].second, &second ) )
+            {
+                const int amount = pairs[ i ].amount;
+
+                KerningPair_s & pair = m_KerningPairs[ index ][ next[ first ]++ ];
+                pair.second = second;
+                pair.amount = ( signed char )( amount < -128 ? -128 : ( amount > 127 ? 127 : amount ) );
+                ++placedCount;
+            }
+        }
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextEncoder_c::CreateFontArray
+        Creates the texture array of some fonts, one slice for each
+    ---------------------------------------------------------------------------------*/
+    unsigned char * TinyTextEncoder_c::CreateFontArray( const TinyTextFontPack_c * const * fonts, unsigned int fontCount, int * width, int * height )
+    {
+        // Every slice is the size of the largest atlas
+        int arrayWidth = 0;
+        int arrayHeight = 0;
+
+        for ( unsigned int i = 0; i < fontCount; ++i )
+        {
+            int atlasWidth = fonts[ i ] ? fonts[ i ]->GetHeader( )->atlasWidth : FontTextureWidth;
+            int atlasHeight = fonts[ i ] ? fonts[ i ]->GetHeader( )->atlasHeight : FontTextureHeight;
+
+            arrayWidth = atlasWidth > arrayWidth ? atlasWidth : arrayWidth;
+            arrayHeight = atlasHeight > arrayHeight ? atlasHeight : arrayHeight;
+        }
+
+        const size_t sliceByteCount = size_t( arrayWidth ) * arrayHeight;
+
+        unsigned char * texels = new ( std::nothrow ) unsigned char[ sliceByteCount * fontCount ];
+        if ( !texels )
+        {
+            return 0;
+        }
+
+        // Texels outside an atlas are never drawn
+        memset( texels, 0, sliceByteCount * fontCount );
+
+        for ( unsigned int i = 0; i < fontCount; ++i )
+        {
+            unsigned char * slice = texels + sliceByteCount * i;
+
+            if ( fonts[ i ] )
+            {
+                const int atlasWidth = fonts[ i ]->GetHeader( )->atlasWidth;
+                const int atlasHeight = fonts[ i ]->GetHeader( )->atlasHeight;
+
+                for ( int y = 0; y < atlasHeight; ++y )
+                {
+                    memcpy( slice + size_t( y ) * arrayWidth, fonts[ i ]->GetAtlas( ) + size_t( y ) * atlasWidth, atlasWidth );
+                }
+            }
+            else
+            {
+                unsigned char fontTexels[ FontTextureWidth * FontTextureHeight ];
+                GetFontTexels( fontTexels );
+
+                for ( int y = 0; y < FontTextureHeight; ++y )
+                {
+                    memcpy( slice + size_t( y ) * arrayWidth, fontTexels + y * FontTextureWidth, FontTextureWidth );
+                }
+            }
+        }
+
+        *width = arrayWidth;
+        *height = arrayHeight;
+
+        return texels;
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextEncoder_c::GetFontTexels
+        Decodes the built-in font texture, one byte per texel
+    ---------------------------------------------------------------------------------*/
+    void TinyTextEncoder_c::GetFontTexels( unsigned char * texels )
+    {
+        // The bitmap is stored bottom-up, one bit per texel with rows padded to 4
+        // bytes. Its palette follows the 40 byte header, stored blue, green, red,
+        // reserved - the pixel shader reads the red channel, and keeps only 1.0
+        const unsigned char * pixels = TextTexture + ( TextTexture[ 10 ] | ( TextTexture[ 11 ] << 8 ) | ( TextTexture[ 12 ] << 16 ) | ( TextTexture[ 13 ] << 24 ) );
+        const unsigned char * palette = TextTexture + 14 + ( TextTexture[ 14 ] | ( TextTexture[ 15 ] << 8 ) | ( TextTexture[ 16 ] << 16 ) | ( TextTexture[ 17 ] << 24 ) );
+        const unsigned int rowByteCount = ( ( TextTextureWidth + 31 ) / 32 ) * 4;
+
+        const unsigned char white[ 2 ] = { ( unsigned char )( palette[ 2 ] == 0xFF ? 0xFF : 0 ), ( unsigned char )( palette[ 6 ] == 0xFF ? 0xFF : 0 ) };
+
+        for ( int y = 0; y < FontTextureHeight; ++y )
+        {
+            const unsigned char * row = pixels + ( FontTextureHeight - 1 - y ) * rowByteCount;
+
+            for ( int x = 0; x < FontTextureWidth; ++x )
+            {
+                texels[ y * FontTextureWidth + x ] = white[ ( row[ x / 8 ] >> ( 7 - x % 8 ) ) & 1 ];
+            }
+        }
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextEncoder_c::SetFontScale
+        Scale every character of the font
+    ---------------------------------------------------------------------------------*/
+    void TinyTextEncoder_c::SetFontScale( float scale )
+    {
+        if ( scale > 0.0f )
+        {
+            m_FontScale = scale;
+        }
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextEncoder_c::UpdateGlyphs
+        Rebuilds the glyph of each byte from the character map and the fonts
+    ---------------------------------------------------------------------------------*/
+    void TinyTextEncoder_c::UpdateGlyphs( )
+    {
+        for ( unsigned int font = 0; font < m_FontCount; ++font )
+        {
+            for ( unsigned int i = 0; i < CharacterCount; ++i )
+            {
+                m_Glyphs[ font ][ i ] = m_FontGlyphs[ font ][ m_CharacterMap[ i ] ];
+            }
+        }
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextEncoder_c::FindGlyph
+        Looks up the glyph of a character in the glyph cache, or of a code point beyond
+        ASCII in the font. Bytes that aren't UTF-8 go through the character map first
+    ---------------------------------------------------------------------------------*/
+    const TinyTextEncoder_c::Glyph_s * TinyTextEncoder_c::FindGlyph( unsigned int font, unsigned int character )
+    {
+        unsigned int codePoint = m_UTF8 ? character : TinyTextFontPack_c::GetWindows1252CodePoint( m_CharacterMap[ character ] );
+
+        if ( m_GlyphCache )
+        {
+            const TinyTextFontGlyph_s * cachedGlyph = m_GlyphCache->FindGlyph( codePoint );
+            if ( !cachedGlyph )
+            {
+                return 0;
+            }
+
+            m_CachedGlyph.u = cachedGlyph->u;
+            m_CachedGlyph.v = cachedGlyph->v;
+            m_CachedGlyph.width = cachedGlyph->width;
+            m_CachedGlyph.height = cachedGlyph->width ? cachedGlyph->height : 0;
+            m_CachedGlyph.xOffset = cachedGlyph->xOffset;
+            m_CachedGlyph.yOffset = cachedGlyph->yOffset;
+            return &m_CachedGlyph;
+        }
+
+        // The font only has Windows-1252 characters
+        unsigned char fontCharacter;
+
+        if ( !TinyTextFontPack_c::GetWindows1252Character( codePoint, &fontCharacter ) )
+        {
+            fontCharacter = '?';
+        }
+
+        return &m_FontGlyphs[ font ][ fontCharacter ];
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextEncoder_c::GetFontGlyph
+        Retrieves the glyph of a Windows-1252 character in font 0
+    ---------------------------------------------------------------------------------*/
+    void TinyTextEncoder_c::GetFontGlyph( unsigned char character, TinyTextFontGlyph_s * glyph ) const
+    {
+        const Glyph_s & fontGlyph = m_FontGlyphs[ 0 ][ character ];
+
+        memset( glyph, 0, sizeof( TinyTextFontGlyph_s ) );
+        glyph->codePoint = TinyTextFontPack_c::GetWindows1252CodePoint( character );
+        glyph->u = fontGlyph.u;
+        glyph->v = fontGlyph.v;
+        glyph->width = fontGlyph.width;
+        glyph->height = fontGlyph.height;
+        glyph->xOffset = fontGlyph.xOffset;
+        glyph->yOffset = fontGlyph.yOffset;
+        glyph->advance = m_Advances[ 0 ][ character ];
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextEncoder_c::Begin
+        Starts encoding into 'vertices', resetting all of the counts
+    ---------------------------------------------------------------------------------*/
+    void TinyTextEncoder_c::Begin( unsigned int * vertices )
+    {
+        m_WriteAddress = vertices;
+        m_NumVertices = 0;
+        m_NumSkippedVertices = 0;
+        m_NumDroppedCharacters = 0;
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextEncoder_c::End
+        Stops encoding
+    ---------------------------------------------------------------------------------*/
+    void TinyTextEncoder_c::End( )
+    {
+        m_WriteAddress = 0;
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextEncoder_c::Print
+        Encode some text. Colour is of form 0xAABBGGRR
+    ---------------------------------------------------------------------------------*/
+    bool TinyTextEncoder_c::Print( float viewportWidth, float viewportHeight, size_t maxCharacterCount, const char * text, int x, int y, unsigned int colour )
+    {
+        if ( !m_WriteAddress )
+        {
+            return false;
+        }
+
+        // Text that runs off the bottom or right of the viewport can't come back into view
+        const TinyTextRect_s clipRect = GetClipRect( viewportWidth, viewportHeight, 0 );
+
+        if ( y >= clipRect.bottom )
+        {
+            return true;
+        }
+
+        if ( IsProportional( 0 ) )
+        {
+            return PrintProportional( viewportWidth, viewportHeight, clipRect, maxCharacterCount, text, x, y, colour );
+        }
+
+        // Add characters to the vertex buffer
+        const int characterWidth = GetCharacterWidth( );
+        const float scale = m_FontScale;
+        char currentChar;
+
+        // The count is checked first, so text that isn't terminated is never read past
+        while ( maxCharacterCount && ( currentChar = *( text++ ) ) != 0 && x < clipRect.right )
+        {
+            unsigned int character = ( unsigned char ) currentChar;
+            --maxCharacterCount;
+
+            // Multi-byte UTF-8 sequences are decoded into a single code point
+            if ( character >= 0x80 && m_UTF8 )
+            {
+                size_t length = DecodeUTF8( text - 1, maxCharacterCount + 1, &character );
+                text += length - 1;
+                maxCharacterCount -= length - 1;
+            }
+
+            if ( !AddCharacter( viewportWidth, viewportHeight, clipRect, 0, character, x, y, scale, colour ) )
+            {
+                m_NumDroppedCharacters += ( unsigned int )( 1 + CountCharacters( text, maxCharacterCount, m_UTF8 ) );
+                return false;
+            }
+
+            // Update current x position
+            x += characterWidth;
+        }
+
+        return true;
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextEncoder_c::Print
+        Encode some text, laid out according to 'format'. Colour is of form 0xAABBGGRR
+    ---------------------------------------------------------------------------------*/
+    bool TinyTextEncoder_c::Print( float viewportWidth, float viewportHeight, const TinyTextFormat_c & format, size_t maxCharacterCount, const char * text, int x, int y, unsigned int colour, int * width, int * height )
+    {
+        const bool measure = width || height;
+
+        if ( !m_WriteAddress )
+        {
+            if ( measure )
+            {
+                MeasureText( format, maxCharacterCount, text, width, height );
+            }
+
+            return false;
+        }
+
+        const TinyTextRect_s clipRect = GetClipRect( viewportWidth, viewportHeight, &format );
+
+        // Top-anchored text doesn't need laying out beyond the bottom of the clip
+        // rectangle, unless its size is wanted
+        int maxY = INT_MAX;
+        if ( ( format.anchor & TinyTextFormat_c::AnchorVerticalMask ) == TinyTextFormat_c::AnchorTop && !measure )
+        {
+            maxY = clipRect.bottom - y;
+        }
+
+        // Lay out the text, adding the characters to the vertex buffer as their
+        // positions become final. Characters that are clipped away never take up room
+        // in the buffer, however many of them there are
+        TextLayout_c layout( format, *this, GetFontIndex( format.font ), GetRunScale( format ) );
+        layout.SetOutput( this, viewportWidth, viewportHeight, clipRect, x, y, colour );
+        bool result = layout.Run( maxCharacterCount, text, maxY );
+        m_NumDroppedCharacters += ( unsigned int )( layout.GetDroppedCharacterCount( ) );
+
+        if ( measure )
+        {
+            // The layout stops once the buffer is full, so only then is the rest of the
+            // text measured separately
+            if ( !result )
+            {
+                MeasureText( format, maxCharacterCount, text, width, height );
+            }
+            else
+            {
+                if ( width )
+                {
+                    *width = layout.GetWidth( );
+                }
+
+                if ( height )
+                {
+                    *height = layout.GetHeight( );
+                }
+            }
+        }
+
+        return result;
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextEncoder_c::MeasureText
+        Measure the size that some text would occupy if it was printed with 'format'
+    ---------------------------------------------------------------------------------*/
+    void TinyTextEncoder_c::MeasureText( const TinyTextFormat_c & format, size_t maxCharacterCount, const char * text, int * width, int * height ) const
+    {
+        TextLayout_c layout( format, *this, GetFontIndex( format.font ), GetRunScale( format ) );
+        layout.Run( maxCharacterCount, text, INT_MAX );
+
+        if ( width )
+        {
+            *width = layout.GetWidth( );
+        }
+
+        if ( height )
+        {
+            *height = layout.GetHeight( );
+        }
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextEncoder_c::PrintProportional
+        Encodes unformatted text in a proportional font. The text is decoded a span at
+        a time, and the pen positions of each span are found at once
+    ---------------------------------------------------------------------------------*/
+    bool TinyTextEncoder_c::PrintProportional( float viewportWidth, float viewportHeight, const TinyTextRect_s & clipRect, size_t maxCharacterCount, const char * text, int x, int y, unsigned int colour )
+    {
+        unsigned int characters[ PenPositionSpan ];
+        int positions[ PenPositionSpan + 4 ];
+        const float scale = m_FontScale;
+        int previous = -1;
+
+        while ( x < clipRect.right )
+        {
+            size_t count;
+            const size_t spanLength = DecodeSpan( text, maxCharacterCount, m_UTF8, characters, &count );
+
+            if ( !count )
+            {
+                break;
+            }
+
+            text += spanLength;
+            maxCharacterCount -= spanLength;
+
+            GetPenPositions( 0, characters, count, previous, scale, positions );
+
+            for ( size_t i = 0; i < count; ++i )
+            {
+                const int characterX = x + positions[ i ];
+
+                // Text that runs off the right of the viewport can't come back into view
+                if ( characterX >= clipRect.right )
+                {
+                    return true;
+                }
+
+                if ( !AddCharacter( viewportWidth, viewportHeight, clipRect, 0, characters[ i ], characterX, y, scale, colour ) )
+                {
+                    m_NumDroppedCharacters += ( unsigned int )( ( count - i ) + CountCharacters( text, maxCharacterCount, m_UTF8 ) );
+                    return false;
+                }
+            }
+
+            x += positions[ count ];
+            previous = characters[ count - 1 ] != ' ' ? GetFontCharacter( characters[ count - 1 ] ) : -1;
+        }
+
+        return true;
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextEncoder_c::GetPenPositions
+        Finds the pen positions of characters of a proportional font. The step from
+        each character to the next (its advance, plus the kerning between the two) is
+        looked up first, then the steps are summed with a vectorised prefix sum.
+        Spaces are never kerned, as in formatted text, where they separate words
+    ---------------------------------------------------------------------------------*/
+    void TinyTextEncoder_c::GetPenPositions( unsigned int font, const unsigned int * characters, size_t count, int previous, float scale, int * positions ) const
+    {
+        const unsigned char * advances = m_Advances[ font ];
+        int advance = 0;
+
+        for ( size_t i = 0; i < count; ++i )
+        {
+            const unsigned int character = GetFontCharacter( characters[ i ] );
+            const bool space = ( characters[ i ] == ' ' );
+            positions[ i ] = previous >= 0 && !space ? advance + GetKerning( font, previous, character ) : advance;
+            advance = advances[ character ];
+            previous = space ? -1 : int( character );
+        }
+
+        positions[ count ] = advance;
+
+        for ( size_t i = count + 1; i & 3; ++i )
+        {
+            positions[ i ] = 0;
+        }
+
+        // Four steps at a time: two shifted adds sum each step into the lanes after it,
+        // then the total of the steps before them is added to all four. Positions are
+        // scaled from the unscaled totals, so rounding errors don't build up along the
+        // span. Kerning can make them negative, so they are rounded with a floor (a
+        // truncation, less one wherever that rounded up) rather than a truncation
+        const __m128 scales = _mm_set1_ps( scale );
+        const __m128 half = _mm_set1_ps( 0.5f );
+        __m128i total = _mm_setzero_si128( );
+
+        for ( size_t i = 0; i <= count; i += 4 )
+        {
+            __m128i sum = _mm_loadu_si128( ( const __m128i * )( positions + i ) );
+            sum = _mm_add_epi32( sum, _mm_slli_si128( sum, 4 ) );
+            sum = _mm_add_epi32( sum, _mm_slli_si128( sum, 8 ) );
+            sum = _mm_add_epi32( sum, total );
+            total = _mm_shuffle_epi32( sum, _MM_SHUFFLE( 3, 3, 3, 3 ) );
+
+            if ( scale != 1.0f )
+            {
+                const __m128 scaled = _mm_add_ps( _mm_mul_ps( _mm_cvtepi32_ps( sum ), scales ), half );
+                sum = _mm_cvttps_epi32( scaled );
+                sum = _mm_add_epi32( sum, _mm_castps_si128( _mm_cmpgt_ps( _mm_cvtepi32_ps( sum ), scaled ) ) );
+            }
+
+            _mm_storeu_si128( ( __m128i * )( positions + i ), sum );
+        }
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextEncoder_c::GetFontCharacter
+        The Windows-1252 character of the font that a character of the text is drawn
+        with - through the character map, or for code points beyond ASCII in UTF-8, as
+        'FindGlyph' finds it
+    ---------------------------------------------------------------------------------*/
+    unsigned char TinyTextEncoder_c::GetFontCharacter( unsigned int character ) const
+    {
+        if ( character < 0x80 || !m_UTF8 )
+        {
+            return m_CharacterMap[ character ];
+        }
+
+        unsigned char fontCharacter;
+        return TinyTextFontPack_c::GetWindows1252Character( character, &fontCharacter ) ? fontCharacter : '?';
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextEncoder_c::GetKerning
+        Returns the kerning of a pair of Windows-1252 characters - a search of the few
+        pairs that start with the first character
+    ---------------------------------------------------------------------------------*/
+    int TinyTextEncoder_c::GetKerning( unsigned int font, unsigned int first, unsigned int second ) const
+    {
+        const KerningPair_s * pairs = m_KerningPairs[ font ];
+
+        for ( unsigned int i = m_KerningStart[ font ][ first ], end = m_KerningStart[ font ][ first + 1 ]; i < end; ++i )
+        {
+            if ( pairs[ i ].second == second )
+            {
+                return pairs[ i ].amount;
+            }
+        }
+
+        return 0;
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextEncoder_c::AddCharacter
+        Adds a single character quad, which must be within a call to 'Begin'
+    ---------------------------------------------------------------------------------*/
+    bool TinyTextEncoder_c::AddCharacter( float viewportWidth, float viewportHeight, const TinyTextRect_s & clipRect, unsigned int font, unsigned int character, int x, int y, float scale, unsigned int colour )
+    {
+        // Look up the glyph through the character map. Every byte has an entry, so
+        // there is no need to validate the text first. Only the glyph cache, and code
+        // points beyond ASCII, take the slower path
+        const Glyph_s * glyph = ( character < 0x80 || !m_UTF8 ) && !m_GlyphCache ? &m_Glyphs[ font ][ character ] : FindGlyph( font, character );
+
+        // Blank characters only need to advance the position, which the caller does.
+        // Only those whose cell is inside the clip rectangle count as skipped, as the
+        // rest would have been culled anyway
+        if ( !glyph || !glyph->height )
+        {
+            if ( glyph )
+            {
+                const int left = x + ScaleMetric( glyph->xOffset, scale );
+                const int right = left + ( glyph->width ? ScaleMetric( glyph->width, scale ) : 1 );
+
+                if ( left < clipRect.right && right > clipRect.left && y < clipRect.bottom && y + GetScaledLineHeight( scale, font ) > clipRect.top )
+                {
+                    m_NumSkippedVertices += NumVerticesPerCharacter;
+                }
+            }
+
+            return true;
+        }
+
+        if ( scale != 1.0f )
+        {
+            return AddScaledCharacter( viewportWidth, viewportHeight, clipRect, *glyph, x, y, scale, colour );
+        }
+
+        // Extract character data
+        int u = glyph->u;
+        int v = glyph->v;
+        int width = glyph->width;
+        int height = glyph->height;
+        int xoffset = glyph->xOffset;
+        int yoffset = glyph->yOffset;
+
+        // Compute the rectangle covered by the character (in pixels)
+        int left = x + xoffset;
+        int top = y + yoffset;
+        int right = left + width;
+        int bottom = top + height;
+
+        // Characters that lie entirely outside the clip rectangle produce no geometry
+        if ( left >= clipRect.right || right <= clipRect.left || top >= clipRect.bottom || bottom <= clipRect.top )
+        {
+            return true;
+        }
+
+        // If we have reached capacity already, return false immediately
+        if ( ( m_NumVertices / NumVerticesPerCharacter ) == m_Capacity )
+        {
+            return false;
+        }
+
+        // Characters that straddle the clip rectangle are trimmed to it. Texels map 1:1
+        // onto pixels, so the texture coordinates are trimmed by the same amounts
+        if ( left < clipRect.left )
+        {
+            u += clipRect.left - left;
+            left = clipRect.left;
+        }
+
+        if ( top < clipRect.top )
+        {
+            v += clipRect.top - top;
+            top = clipRect.top;
+        }
+
+        if ( right > clipRect.right )
+        {
+            right = clipRect.right;
+        }
+
+        if ( bottom > clipRect.bottom )
+        {
+            bottom = clipRect.bottom;
+        }
+
+        WriteQuad( viewportWidth, viewportHeight, float( left ), float( top ), float( right ), float( bottom ), u, v, u + ( right - left ), v + ( bottom - top ), colour );
+
+        return true;
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextEncoder_c::AddScaledCharacter
+        Adds the quad of a glyph drawn at a scale other than 1. Texels no longer map
+        1:1 onto pixels, so it is trimmed to the clip rectangle by whole texels - up to
+        a texel's worth of pixels at the edge of the clip rectangle may be left
+        undrawn, but nothing is drawn outside it
+    ---------------------------------------------------------------------------------*/
+    bool TinyTextEncoder_c::AddScaledCharacter( float viewportWidth, float viewportHeight, const TinyTextRect_s & clipRect, const Glyph_s & glyph, int x, int y, float scale, unsigned int colour )
+    {
+        // Compute the rectangle covered by the character (in pixels)
+        float left = x + glyph.xOffset * scale;
+        float top = y + glyph.yOffset * scale;
+        float right = left + glyph.width * scale;
+        float bottom = top + glyph.height * scale;
+
+        // Characters that lie entirely outside the clip rectangle produce no geometry
+        if ( left >= clipRect.right || right <= clipRect.left || top >= clipRect.bottom || bottom <= clipRect.top )
+        {
+            return true;
+        }
+
+        if ( ( m_NumVertices / NumVerticesPerCharacter ) == m_Capacity )
+        {
+            return false;
+        }
+
+        int leftU = glyph.u;
+        int topV = glyph.v;
+        int rightU = leftU + glyph.width;
+        int bottomV = topV + glyph.height;
+
+        if ( left < clipRect.left )
+        {
+            int texels = int( ceil( ( clipRect.left - left ) / scale ) );
+            leftU += texels;
+            left += texels * scale;
+        }
+
+        if ( top < clipRect.top )
+        {
+            int texels = int( ceil( ( clipRect.top - top ) / scale ) );
+            topV += texels;
+            top += texels * scale;
+        }
+
+        if ( right > clipRect.right )
+        {
+            int texels = int( ceil( ( right - clipRect.right ) / scale ) );
+            rightU -= texels;
+            right -= texels * scale;
+        }
+
+        if ( bottom > clipRect.bottom )
+        {
+            int texels = int( ceil( ( bottom - clipRect.bottom ) / scale ) );
+            bottomV -= texels;
+            bottom -= texels * scale;
+        }
+
+        // Nothing is left of characters narrower than a texel's worth of the clip
+        // rectangle
+        if ( rightU > leftU && bottomV > topV )
+        {
+            WriteQuad( viewportWidth, viewportHeight, left, top, right, bottom, leftU, topV, rightU, bottomV, colour );
+        }
+
+        return true;
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextEncoder_c::WriteQuad
+        Writes the two triangles of a character, which must be within a call to 'Begin'
+        and have room in the buffer
+    ---------------------------------------------------------------------------------*/
+    void TinyTextEncoder_c::WriteQuad( float viewportWidth, float viewportHeight, float left, float top, float right, float bottom, int leftU, int topV, int rightU, int bottomV, unsigned int colour )
+    {
+        // Compute bottom-left and top-right vertices of the character
+        float bottomLeftX = ( ( 2 * left ) / viewportWidth ) - 1.0f;
+        float bottomLeftY = ( ( -2 * bottom ) / viewportHeight ) + 1.0f;
+        int bottomLeftU = leftU;
+        int bottomLeftV = bottomV;
+
+        float topRightX = ( ( 2 * right ) / viewportWidth ) - 1.0f;
+        float topRightY = ( ( -2 * top ) / viewportHeight ) + 1.0f;
+        int topRightU = rightU;
+        int topRightV = topV;
+
+        // Add triangle vertices for this character to the vertex buffer
+        m_WriteAddress[ Triangle0_Vertex0_Position_X ] = EncodePositionCoord(bottomLeftX);
+        m_WriteAddress[ Triangle0_Vertex0_Position_Y ] = EncodePositionCoord(bottomLeftY);
+        m_WriteAddress[ Triangle0_Vertex0_UV ] = EncodeUVCoords(bottomLeftU, bottomLeftV);
+        m_WriteAddress[ Triangle0_Vertex0_Colour ] = colour;
+
+        m_WriteAddress[ Triangle0_Vertex1_Position_X ] = EncodePositionCoord(bottomLeftX);
+        m_WriteAddress[ Triangle0_Vertex1_Position_Y ] = EncodePositionCoord(topRightY);
+        m_WriteAddress[ Triangle0_Vertex1_UV ] = EncodeUVCoords(bottomLeftU, topRightV);
+        m_WriteAddress[ Triangle0_Vertex1_Colour ] = colour;
+
+        m_WriteAddress[ Triangle0_Vertex2_Position_X ] = EncodePositionCoord(topRightX);
+        m_WriteAddress[ Triangle0_Vertex2_Position_Y ] = EncodePositionCoord(bottomLeftY);
+        m_WriteAddress[ Triangle0_Vertex2_UV ] = EncodeUVCoords(topRightU, bottomLeftV);
+        m_WriteAddress[ Triangle0_Vertex2_Colour ] = colour;
+
+        m_WriteAddress[ Triangle1_Vertex0_Position_X ] = EncodePositionCoord(topRightX);
+        m_WriteAddress[ Triangle1_Vertex0_Position_Y ] = EncodePositionCoord(topRightY);
+        m_WriteAddress[ Triangle1_Vertex0_UV ] = EncodeUVCoords(topRightU, topRightV);
+        m_WriteAddress[ Triangle1_Vertex0_Colour ] = colour;
+
+        m_WriteAddress[ Triangle1_Vertex1_Position_X ] = EncodePositionCoord(topRightX);
+        m_WriteAddress[ Triangle1_Vertex1_Position_Y ] = EncodePositionCoord(bottomLeftY);
+        m_WriteAddress[ Triangle1_Vertex1_UV ] = EncodeUVCoords(topRightU, bottomLeftV);
+        m_WriteAddress[ Triangle1_Vertex1_Colour ] = colour;
+
+        m_WriteAddress[ Triangle1_Vertex2_Position_X ] = EncodePositionCoord(bottomLeftX);
+        m_WriteAddress[ Triangle1_Vertex2_Position_Y ] = EncodePositionCoord(topRightY);
+        m_WriteAddress[ Triangle1_Vertex2_UV ] = EncodeUVCoords(bottomLeftU, topRightV);
+        m_WriteAddress[ Triangle1_Vertex2_Colour ] = colour;
+
+        // Update vertex buffer write position
+        m_WriteAddress += NumVertexElementsPerCharacter;
+
+        // Update vertex count
+        m_NumVertices += NumVerticesPerCharacter;
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextEncoder_c::GetFontBitmap
+        Returns the font texture, as the contents of a monochrome .bmp file
+    ---------------------------------------------------------------------------------*/
+    const unsigned char * TinyTextEncoder_c::GetFontBitmap( unsigned int * byteCount )
+    {
+        if ( byteCount )
+        {
+            *byteCount = TextTextureByteCount;
+        }
+
+        return TextTexture;
+    }
+//}
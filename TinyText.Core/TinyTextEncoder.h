@@ -0,0 +1,442 @@
+/*=================================================================================
+
+    PROJECT:        Tiny Text Library for DirectX 10
+
+    AUTHOR:         James Bird (http://www.jb101.co.uk/)
+
+    DESCRIPTION:    The platform-independent core of the text context, which lays
+                    out text and encodes it as vertices
+
+    USAGE:          - 'TinyTextContext_c' owns an encoder, and points it at its
+                      vertex buffer each time the buffer is mapped
+
+                    - The encoder has no dependency on Direct3D (or Windows), so
+                      it can also be driven on its own against a plain block of
+                      memory - for example by the benchmark tool
+
+                    - Call 'TinyTextEncoder_c::Begin' with a buffer that has room
+                      for 'GetCapacity' characters, 'Print' into it, then call
+                      'TinyTextEncoder_c::End'
+
+                    - Text uses the built-in font unless a font pack is selected
+                      with 'TinyTextEncoder_c::SetFont' (see 'TinyTextFontPack.h')
+
+                    - Up to 'MaxFonts' fonts can be selected at once with
+                      'TinyTextEncoder_c::SetFonts', and each run of text picks
+                      one with 'TinyTextFormat_c::font'. The fonts share a
+                      texture array, and the font of each character travels in
+                      the top bit of its two texture coordinates, so text in
+                      several fonts is still drawn with a single draw call
+
+                    - Proportional font packs (see 'TinyTextFontPack.h') space
+                      each character by its own advance and kerning. The pen
+                      positions of a run are found with a vectorised prefix sum
+                      of the advances, so proportional text isn't much slower
+                      to lay out than fixed-width text. Tab stops stay
+                      'tabSize' cells apart
+
+                    - Fonts with more characters than fit in a texture are drawn
+                      through a glyph cache instead, selected with
+                      'TinyTextEncoder_c::SetGlyphCache' (see
+                      'TinyTextGlyphCache.h')
+
+                    - 'TinyTextEncoder_c::SetFontScale' draws every character
+                      larger or smaller than the font. Distance field fonts stay
+                      sharp at any scale, so a single font pack serves every
+                      size of text
+
+                    - 'TinyTextFormat_c::scale' enlarges a single run of text by
+                      a whole number, which keeps point sampled fonts crisp.
+                      'TinyTextFormat_c::GetScaleForDPI' picks the scale that
+                      suits a monitor's DPI
+
+=================================================================================*/
+#pragma once
+
+/*---------------------------------------------------------------------------------
+    Includes
+---------------------------------------------------------------------------------*/
+#include <stddef.h>
+#include "TinyTextFontPack.h"
+#include "TinyTextGlyphCache.h"
+
+/*---------------------------------------------------------------------------------
+    TinyTextRect_s
+    A rectangle, in pixels. 'right' and 'bottom' are exclusive
+---------------------------------------------------------------------------------*/
+struct TinyTextRect_s
+{
+    int left;
+    int top;
+    int right;
+    int bottom;
+};
+
+/*---------------------------------------------------------------------------------
+    TinyTextFormat_c
+    Describes how 'TinyTextContext_c::Print' lays out a run of text
+---------------------------------------------------------------------------------*/
+class TinyTextFormat_c
+{
+public:
+
+    // Default number of characters between tab stops
+    static const int DefaultTabSize = 4;
+
+    // Where the text lies relative to the position passed to 'Print'. Combine one
+    // horizontal value with one vertical value. Each line is aligned individually
+    enum Anchor
+    {
+        AnchorLeft              = 0x0,
+        AnchorCentre            = 0x1,
+        AnchorRight             = 0x2,
+        AnchorHorizontalMask    = 0x3,
+
+        AnchorTop               = 0x0,
+        AnchorMiddle            = 0x4,
+        AnchorBottom            = 0x8,
+        AnchorVerticalMask      = 0xC
+    };
+
+    // Constructor - takes the wrap width (in pixels, zero disables wrapping), the
+    // number of characters between tab stops, the anchor and the scale
+    explicit TinyTextFormat_c( int wrapWidth = 0, int tabSize = DefaultTabSize, int anchor = AnchorLeft | AnchorTop, int scale = 1 );
+
+    // Lines longer than this (in pixels) are broken at the last space, or mid-word
+    // if a single word doesn't fit. Zero disables wrapping
+    int wrapWidth;
+
+    // Number of characters between tab stops
+    int tabSize;
+
+    // A combination of 'Anchor' values
+    int anchor;
+
+    // Every character is drawn this many times its size in the font, on top of the
+    // font scale, and is spaced accordingly. The wrap width and the position passed to
+    // 'Print' remain in pixels. Values below 1 are treated as 1
+    int scale;
+
+    // Returns the scale at which text looks as it would at 96 DPI (100%) on a monitor
+    // of the specified DPI - the nearest whole number, and never less than 1
+    static int GetScaleForDPI( unsigned int dpi );
+
+    // Index of the font that the text is printed with, among those selected with
+    // 'SetFonts'. Indices that aren't selected fall back to font 0
+    int font;
+
+    // Clips all text printed with this format to the specified rectangle (in pixels,
+    // relative to the viewport)
+    void SetClipRect( int left, int top, int right, int bottom );
+
+    // When set, characters are clipped to 'clipRect'. Characters are always clipped
+    // to the viewport itself
+    bool clip;
+    TinyTextRect_s clipRect;
+};
+
+/*---------------------------------------------------------------------------------
+    TinyTextEncoder_c
+    Lays out text and encodes it as vertices. For usage, see comments at the top of
+    this file
+---------------------------------------------------------------------------------*/
+class TinyTextEncoder_c
+{
+public:
+
+    // Width of each character of the built-in font (in pixels) - the font is
+    // fixed-width
+    static const int CharacterWidth = 8;
+
+    // Distance between the tops of consecutive lines of text in the built-in font
+    // (in pixels)
+    static const int LineHeight = 14;
+
+    // Size of the built-in font texture, in texels
+    static const int FontTextureWidth = 128;
+    static const int FontTextureHeight = 128;
+
+    // Maximum number of fonts that can be selected at once. The font of each
+    // character is stored in the top bit of its u and v texture coordinates
+    static const unsigned int MaxFonts = 4;
+
+    // Largest atlas (in texels) of a font that is selected along with others, which
+    // leaves the top bit of each texture coordinate free for the font
+    static const int MaxFontArraySize = 16384;
+
+    // Maximum number of kerning pairs kept for each font - the first pairs of its
+    // table whose characters are both in Windows-1252
+    static const unsigned int MaxKerningPairs = 2048;
+
+    // Each character is drawn as two triangles, and each vertex is four 32-bit
+    // values: x and y (as floats), uv (as two 16-bit texel coordinates) and colour
+    static const unsigned int NumVerticesPerCharacter = 6;
+    static const unsigned int NumVertexElementsPerCharacter = NumVerticesPerCharacter * 4;
+
+    // Character sets that the bytes passed to 'Print' can be interpreted as
+    enum CodePage
+    {
+        CodePageWindows1252,    // The character set of the font itself (the default)
+        CodePageLatin1,         // ISO 8859-1 - bytes 0x80-0x9F are control characters
+        CodePage437,            // The IBM PC character set - line drawing is approximated
+        CodePageUTF8            // Unicode - characters the font doesn't have are drawn as '?'
+    };
+
+    // Constructor - the encoder has no capacity until it has been initialised
+    TinyTextEncoder_c( );
+
+    // Destructor
+    ~TinyTextEncoder_c( );
+
+    // Allocates scratch space for the specified number of characters - returns 'true'
+    // on success or 'false' on failure
+    bool Initialise( size_t characterCapacity );
+
+    // Select the character set used to interpret the bytes passed to 'Print'
+    void SetCodePage( CodePage codePage );
+
+    // Set a custom mapping from each byte passed to 'Print' to a character of the font,
+    // which uses the Windows-1252 character set
+    void SetCharacterMap( const unsigned char characterMap[ 256 ] );
+
+    // The current mapping from each byte passed to 'Print' to a character of the
+    // font, and whether the text is UTF-8 (in which case the mapping is only used for
+    // ASCII)
+    const unsigned char * GetCharacterMap( ) const { return m_CharacterMap; }
+    bool IsUTF8( ) const { return m_UTF8; }
+
+    // Select the font that text is laid out with - a font pack, or NULL for the
+    // built-in font. Characters that the pack doesn't have are drawn as '?'. The
+    // glyphs are copied, so the pack needn't stay open. Call this between frames, as
+    // text already encoded refers to the previous font's texture
+    void SetFont( const TinyTextFontPack_c * font );
+
+    // Select several fonts at once - font packs, or NULL for the built-in font - to be
+    // picked between by 'TinyTextFormat_c::font'. Like 'SetFont', the glyphs are
+    // copied. Returns 'false' (and keeps the current fonts) if 'ValidateFonts' fails
+    bool SetFonts( const TinyTextFontPack_c * const * fonts, unsigned int fontCount );
+    unsigned int GetFontCount( ) const { return m_FontCount; }
+
+    // Returns 'true' if the fonts can be selected together: between 1 and 'MaxFonts'
+    // of them, every pack open, and either all distance fields or none. With more
+    // than one font, each atlas must be at most 'MaxFontArraySize' texels across
+    static bool ValidateFonts( const TinyTextFontPack_c * const * fonts, unsigned int fontCount );
+
+    // Creates the texture array of some fonts, which must pass 'ValidateFonts' - one
+    // slice for each font, one byte per texel and top row first. Each slice is as
+    // large as the largest atlas, and atlases are placed in the top-left corner of
+    // their slice. Returns NULL if there isn't enough memory; free with 'delete []'
+    static unsigned char * CreateFontArray( const TinyTextFontPack_c * const * fonts, unsigned int fontCount, int * width, int * height );
+
+    // Decodes the built-in font texture into 'FontTextureWidth * FontTextureHeight'
+    // bytes, top row first. Each is 255 where the texture is white, and 0 elsewhere
+    static void GetFontTexels( unsigned char * texels );
+
+    // Returns 'true' if one of the current fonts is proportional
+    bool IsProportional( unsigned int font = 0 ) const { return m_Proportional[ GetFontIndex( font ) ] && !m_GlyphCache; }
+
+    // Select a glyph cache to take glyphs from instead of the font, or NULL to go
+    // back to the font. Text drawn through the cache is laid out in fixed-width
+    // cells, even if its font is proportional. Like the font, change this between
+    // frames
+    void SetGlyphCache( TinyTextGlyphCache_c * glyphCache ) { m_GlyphCache = glyphCache; }
+    TinyTextGlyphCache_c * GetGlyphCache( ) const { return m_GlyphCache; }
+
+    // Scale the font - at 2.0, every character is drawn twice the size of the font,
+    // say. Meant for distance field fonts, which stay sharp at any size; other fonts
+    // are point sampled, so look blocky at scales that aren't whole numbers. Scales
+    // that aren't positive are ignored. Text already encoded keeps its size, so the
+    // scale can be changed between calls to 'Print'
+    void SetFontScale( float scale );
+    float GetFontScale( ) const { return m_FontScale; }
+
+    // Size of each character's cell in one of the current fonts, once scaled (in
+    // pixels). In a proportional font, this is the width of its widest character
+    int GetCharacterWidth( unsigned int font = 0 ) const { return GetScaledCharacterWidth( m_FontScale, font ); }
+    int GetLineHeight( unsigned int font = 0 ) const { return GetScaledLineHeight( m_FontScale, font ); }
+
+    // Retrieves the glyph of a Windows-1252 character in font 0, with its Unicode code
+    // point - so that the built-in font can be compiled into a pack
+    void GetFontGlyph( unsigned char character, TinyTextFontGlyph_s * glyph ) const;
+
+    // Starts encoding into 'vertices', which must have room for 'GetCapacity( )'
+    // characters. Resets all of the counts
+    void Begin( unsigned int * vertices );
+
+    // Stops encoding. The counts remain valid until the next call to 'Begin'
+    void End( );
+
+    // Returns 'true' between calls to 'Begin' and 'End'
+    bool IsEncoding( ) const { return m_WriteAddress != 0; }
+
+    // Encode some text, clipped to a viewport of the specified size - returns 'false'
+    // if not encoding or if there wasn't room for every character. 'colour' is
+    // expected to be in the form: 0xAABBGGRR
+    bool Print( float viewportWidth, float viewportHeight, size_t maxCharacterCount, const char * text, int x, int y, unsigned int colour );
+
+    // Encode some text, laid out according to 'format'. If 'width' or 'height' isn't
+    // NULL, it receives the size that 'MeasureText' would return, which the layout
+    // finds anyway - so text can be printed and its background sized without being
+    // laid out twice
+    bool Print( float viewportWidth, float viewportHeight, const TinyTextFormat_c & format, size_t maxCharacterCount, const char * text, int x, int y, unsigned int colour, int * width = 0, int * height = 0 );
+
+    // Measure the size (in pixels) that some text would occupy if it was printed with
+    // 'format'. Either pointer may be NULL
+    void MeasureText( const TinyTextFormat_c & format, size_t maxCharacterCount, const char * text, int * width, int * height ) const;
+
+    // Maximum number of characters that can be encoded between 'Begin' and 'End'
+    size_t GetCapacity( ) const { return m_Capacity; }
+
+    // Number of vertices written since 'Begin'
+    unsigned int GetNumVertices( ) const { return m_NumVertices; }
+
+    // Number of vertices saved by skipping blank characters since 'Begin'. Blanks
+    // outside the clip rectangle, which would have been culled anyway, don't count
+    unsigned int GetNumSkippedVertices( ) const { return m_NumSkippedVertices; }
+
+    // Number of characters that were not encoded because the buffer was full. In
+    // UTF-8, each code point counts as one character
+    unsigned int GetNumDroppedCharacters( ) const { return m_NumDroppedCharacters; }
+
+    // Returns the font texture, as the contents of a monochrome .bmp file
+    static const unsigned char * GetFontBitmap( unsigned int * byteCount );
+
+private:
+
+    // Deliberately not implemented - this object cannot be copied or assigned to
+    TinyTextEncoder_c( const TinyTextEncoder_c & );
+    TinyTextEncoder_c & operator = ( const TinyTextEncoder_c & );
+
+    // Lays out formatted text, and needs the pen positions of proportional fonts
+    friend class TextLayout_c;
+
+    // Encodes unformatted text in a proportional font, in the same way as 'Print'
+    bool PrintProportional( float viewportWidth, float viewportHeight, const TinyTextRect_s & clipRect, size_t maxCharacterCount, const char * text, int x, int y, unsigned int colour );
+
+    // Finds the pen position of each of 'count' characters (bytes of the text, or code
+    // points in UTF-8) in a proportional font, and the position after the last -
+    // 'count + 1' positions in all, scaled and relative to the pen position after
+    // 'previous'. 'previous' is the Windows-1252 character before the first, which it
+    // is kerned against, or -1 if there isn't one. 'positions' must have room for
+    // 'count + 1' rounded up to a multiple of 4
+    void GetPenPositions( unsigned int font, const unsigned int * characters, size_t count, int previous, float scale, int * positions ) const;
+
+    // The Windows-1252 character of the font that a character of the text is drawn
+    // with
+    unsigned char GetFontCharacter( unsigned int character ) const;
+
+    // Returns the kerning (in pixels, unscaled) of a pair of Windows-1252 characters
+    int GetKerning( unsigned int font, unsigned int first, unsigned int second ) const;
+
+    // Adds a single character quad in one of the current fonts, drawn at 'scale' and
+    // clipped to 'clipRect' - returns 'false' if the buffer is already full.
+    // 'character' is a byte of the text, or a code point in UTF-8
+    bool AddCharacter( float viewportWidth, float viewportHeight, const TinyTextRect_s & clipRect, unsigned int font, unsigned int character, int x, int y, float scale, unsigned int colour );
+
+    // Writes the vertices of a character quad, which must already be clipped. The
+    // rectangle is in pixels, and its texture coordinates in texels
+    void WriteQuad( float viewportWidth, float viewportHeight, float left, float top, float right, float bottom, int leftU, int topV, int rightU, int bottomV, unsigned int colour );
+
+    // Scales a size of the font to the nearest pixel
+    static int ScaleMetric( int size, float scale ) { return scale == 1.0f ? size : int( size * scale + 0.5f ); }
+
+    // Size of each character's cell in one of the current fonts, at the specified
+    // scale
+    int GetScaledCharacterWidth( float scale, unsigned int font ) const { return ScaleMetric( m_GlyphCache ? m_GlyphCache->GetCharacterWidth( ) : m_CharacterWidth[ GetFontIndex( font ) ], scale ); }
+    int GetScaledLineHeight( float scale, unsigned int font ) const { return ScaleMetric( m_GlyphCache ? m_GlyphCache->GetLineHeight( ) : m_LineHeight[ GetFontIndex( font ) ], scale ); }
+
+    // The font that a run of text is printed with - font 0 if 'font' isn't selected
+    unsigned int GetFontIndex( unsigned int font ) const { return font < m_FontCount ? font : 0; }
+
+    // The scale that a run of text printed with 'format' is drawn at
+    float GetRunScale( const TinyTextFormat_c & format ) const { return format.scale > 1 ? m_FontScale * format.scale : m_FontScale; }
+
+    // Fills in the glyphs and metrics of one of the current fonts
+    void LoadFont( unsigned int index, const TinyTextFontPack_c * font );
+
+    // Fills in the kerning pairs of one of the current fonts, from a proportional font
+    // pack (or none, for NULL)
+    void LoadKerning( unsigned int index, const TinyTextFontPack_c * font );
+
+    // Rebuilds 'm_Glyphs' from the character map and the fonts
+    void UpdateGlyphs( );
+
+    // The rectangle of a character in the font texture, and its position in the
+    // character's cell
+    struct Glyph_s
+    {
+        unsigned short u;
+        unsigned short v;
+        unsigned char width;
+        unsigned char height;   // Zero if the character has no visible pixels
+        signed char xOffset;
+        signed char yOffset;
+    };
+
+    // A kerning pair of a font, stored with the pairs of the same first character
+    struct KerningPair_s
+    {
+        unsigned char second;
+        signed char amount;
+    };
+
+    // Looks up the glyph of a character that 'm_Glyphs' doesn't cover - one from the
+    // glyph cache, or a code point beyond ASCII. Returns NULL if it can't be drawn
+    const Glyph_s * FindGlyph( unsigned int font, unsigned int character );
+
+    // Adds the quad of a glyph drawn at a scale other than 1, in the same way as
+    // 'AddCharacter'
+    bool AddScaledCharacter( float viewportWidth, float viewportHeight, const TinyTextRect_s & clipRect, const Glyph_s & glyph, int x, int y, float scale, unsigned int colour );
+
+    // The glyph for each byte that can be passed to 'Print' in each font, after
+    // translation through the current character map
+    Glyph_s m_Glyphs[ MaxFonts ][ 256 ];
+
+    // The current character map, and the glyph of each Windows-1252 character in
+    // each font. The font's index is already in the top bit of 'u' and 'v'
+    unsigned char m_CharacterMap[ 256 ];
+    Glyph_s m_FontGlyphs[ MaxFonts ][ 256 ];
+
+    // Number of fonts selected
+    unsigned int m_FontCount;
+
+    // Size of each character's cell in each font, and the scale it is drawn at
+    int m_CharacterWidth[ MaxFonts ];
+    int m_LineHeight[ MaxFonts ];
+    float m_FontScale;
+
+    // Whether each font is proportional, and if so the advance of each of its
+    // Windows-1252 characters. The kerning pairs whose first character is 'c' are
+    // 'm_KerningStart[ c ]' up to (but not including) 'm_KerningStart[ c + 1 ]'
+    bool m_Proportional[ MaxFonts ];
+    unsigned char m_Advances[ MaxFonts ][ 256 ];
+    unsigned short m_KerningStart[ MaxFonts ][ 257 ];
+    KerningPair_s m_KerningPairs[ MaxFonts ][ MaxKerningPairs ];
+
+    // The glyph cache (if any), and the last glyph looked up in it
+    TinyTextGlyphCache_c * m_GlyphCache;
+    Glyph_s m_CachedGlyph;
+
+    // Set when the text is UTF-8
+    bool m_UTF8;
+
+    // Total capacity
+    size_t m_Capacity;
+
+    // Scratch space used to lay out a run of text before it is encoded (one entry for
+    // each character of capacity). Characters wait here until their lines have been
+    // aligned, and are encoded in batches whenever it fills up
+    struct PlacedCharacter_s * m_PlacedCharacters;
+
+    // The current write position (while encoding)
+    unsigned int * m_WriteAddress;
+
+    // Number of vertices written
+    unsigned int m_NumVertices;
+
+    // Number of vertices saved by skipping blank characters
+    unsigned int m_NumSkippedVertices;
+
+    // Number of characters that didn't fit
+    unsigned int m_NumDroppedCharacters;
+};
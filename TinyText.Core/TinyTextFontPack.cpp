@@ -0,0 +1,392 @@
+/*=================================================================================
+
+    PROJECT:        Tiny Text Library for DirectX 10
+
+    AUTHOR:         James Bird (http://www.jb101.co.uk/)
+
+    DESCRIPTION:    Font packs. See 'TinyTextFontPack.h' for usage and the layout
+
+=================================================================================*/
+
+/*---------------------------------------------------------------------------------
+    Includes
+---------------------------------------------------------------------------------*/
+#include "TinyTextFontPack.h"
+#include <string.h>
+#if defined( _WIN32 )
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/*---------------------------------------------------------------------------------
+    Constants
+---------------------------------------------------------------------------------*/
+//namespace
+//{
+    // The first four bytes of a pack
+    const char          FontPackMagic[]         = { 'T', 'T', 'F', 'P' };
+
+    // Size of the header of the first packs, which ended at 'atlasOffset'
+    const size_t        FontPackHeaderV1ByteCount = offsetof( TinyTextFontPackHeader_s, flags );
+
+    // The Unicode code points of Windows-1252 characters 0x80-0x9F (the rest match
+    // ISO 8859-1, and so Unicode)
+    const unsigned short Windows1252CodePoints[] = { 0x20AC , 0x0081 , 0x201A , 0x0192 , 0x201E , 0x2026 , 0x2020 , 0x2021 , 0x02C6 , 0x2030 , 0x0160 , 0x2039 , 0x0152 , 0x008D , 0x017D , 0x008F , 0x0090 , 0x2018 , 0x2019 , 0x201C , 0x201D , 0x2022 , 0x2013 , 0x2014 , 0x02DC , 0x2122 , 0x0161 , 0x203A , 0x0153 , 0x009D , 0x017E , 0x0178 };
+//}
+
+//namespace
+//{
+    /*---------------------------------------------------------------------------------
+        TinyTextFontPack_c::TinyTextFontPack_c
+        Constructor
+    ---------------------------------------------------------------------------------*/
+    TinyTextFontPack_c::TinyTextFontPack_c( )
+    :   m_Data( 0 ),
+        m_ByteCount( 0 ),
+        m_Mapped( false ),
+        m_Header( 0 ),
+        m_Glyphs( 0 ),
+        m_Atlas( 0 ),
+        m_KerningPairs( 0 ),
+        m_Flags( 0 ),
+        m_KerningCount( 0 )
+    {
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextFontPack_c::~TinyTextFontPack_c
+        Destructor
+    ---------------------------------------------------------------------------------*/
+    TinyTextFontPack_c::~TinyTextFontPack_c( )
+    {
+        Close( );
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextFontPack_c::Open
+        Maps a pack file into memory, read-only. Only the header and glyph table are
+        touched here - the atlas isn't read until the font texture is created
+    ---------------------------------------------------------------------------------*/
+    bool TinyTextFontPack_c::Open( const char * fileName )
+    {
+        Close( );
+
+    #if defined( _WIN32 )
+        HANDLE file = CreateFileA( fileName, GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0 );
+        if ( file == INVALID_HANDLE_VALUE )
+        {
+            return false;
+        }
+
+        LARGE_INTEGER size;
+        HANDLE mapping = 0;
+
+        if ( GetFileSizeEx( file, &size ) && size.QuadPart > 0 && size.QuadPart <= 0x7FFFFFFF )
+        {
+            mapping = CreateFileMappingA( file, 0, PAGE_READONLY, 0, 0, 0 );
+        }
+
+        CloseHandle( file );
+
+        if ( !mapping )
+        {
+            return false;
+        }
+
+        // The view keeps the mapping alive once its handle is closed
+        const unsigned char * data = ( const unsigned char * ) MapViewOfFile( mapping, FILE_MAP_READ, 0, 0, 0 );
+        CloseHandle( mapping );
+
+        if ( !data )
+        {
+            return false;
+        }
+
+        size_t byteCount = size_t( size.QuadPart );
+    #else
+        int file = open( fileName, O_RDONLY );
+        if ( file < 0 )
+        {
+            return false;
+        }
+
+        struct stat status;
+        void * memory = MAP_FAILED;
+        size_t byteCount = 0;
+
+        if ( fstat( file, &status ) == 0 && status.st_size > 0 && status.st_size <= 0x7FFFFFFF )
+        {
+            byteCount = ( size_t ) status.st_size;
+            memory = mmap( 0, byteCount, PROT_READ, MAP_PRIVATE, file, 0 );
+        }
+
+        close( file );
+
+        if ( memory == MAP_FAILED )
+        {
+            return false;
+        }
+
+        const unsigned char * data = ( const unsigned char * ) memory;
+    #endif
+
+        m_Data = data;
+        m_ByteCount = byteCount;
+        m_Mapped = true;
+
+        if ( !Validate( ) )
+        {
+            Close( );
+            return false;
+        }
+
+        return true;
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextFontPack_c::OpenMemory
+        Uses a pack that is already in memory
+    ---------------------------------------------------------------------------------*/
+    bool TinyTextFontPack_c::OpenMemory( const void * data, size_t byteCount )
+    {
+        Close( );
+
+        if ( !data )
+        {
+            return false;
+        }
+
+        m_Data = ( const unsigned char * ) data;
+        m_ByteCount = byteCount;
+
+        if ( !Validate( ) )
+        {
+            Close( );
+            return false;
+        }
+
+        return true;
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextFontPack_c::Close
+        Unmaps the pack
+    ---------------------------------------------------------------------------------*/
+    void TinyTextFontPack_c::Close( )
+    {
+        if ( m_Mapped )
+        {
+        #if defined( _WIN32 )
+            UnmapViewOfFile( m_Data );
+        #else
+            munmap( ( void * ) m_Data, m_ByteCount );
+        #endif
+        }
+
+        m_Data = 0;
+        m_ByteCount = 0;
+        m_Mapped = false;
+        m_Header = 0;
+        m_Glyphs = 0;
+        m_Atlas = 0;
+        m_KerningPairs = 0;
+        m_Flags = 0;
+        m_KerningCount = 0;
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextFontPack_c::Validate
+        Checks the header, and that every glyph lies inside the atlas - so that a
+        damaged pack can't make the encoder (or a rasterizer) read outside it
+    ---------------------------------------------------------------------------------*/
+    bool TinyTextFontPack_c::Validate( )
+    {
+        if ( m_ByteCount < FontPackHeaderV1ByteCount || ( size_t( m_Data ) & 3 ) )
+        {
+            return false;
+        }
+
+        const TinyTextFontPackHeader_s * header = ( const TinyTextFontPackHeader_s * ) m_Data;
+
+        if ( memcmp( header->magic, FontPackMagic, sizeof( FontPackMagic ) ) != 0 || ( header->version != Version && header->version != DistanceFieldVersion ) )
+        {
+            return false;
+        }
+
+        const size_t byteCount = header->byteCount;
+        const size_t atlasByteCount = size_t( header->atlasWidth ) * header->atlasHeight;
+
+        bool valid = byteCount <= m_ByteCount
+                  && header->characterWidth > 0
+                  && header->lineHeight > 0
+                  && ( header->glyphOffset & 3 ) == 0
+                  && ( header->atlasOffset & 3 ) == 0
+                  && header->glyphOffset >= FontPackHeaderV1ByteCount
+                  && header->glyphOffset <= byteCount
+                  && header->glyphCount <= ( byteCount - header->glyphOffset ) / sizeof( TinyTextFontGlyph_s )
+                  && header->atlasOffset <= byteCount
+                  && atlasByteCount <= byteCount - header->atlasOffset;
+
+        if ( !valid )
+        {
+            return false;
+        }
+
+        const TinyTextFontGlyph_s * glyphs = ( const TinyTextFontGlyph_s * )( m_Data + header->glyphOffset );
+
+        for ( unsigned int i = 0; i < header->glyphCount; ++i )
+        {
+            const TinyTextFontGlyph_s & glyph = glyphs[ i ];
+
+            if ( ( i > 0 && glyph.codePoint <= glyphs[ i - 1 ].codePoint )
+              || glyph.u + glyph.width > header->atlasWidth
+              || glyph.v + glyph.height > header->atlasHeight )
+            {
+                return false;
+            }
+        }
+
+        // Packs written before the header had flags start their glyph table straight
+        // after 'atlasOffset'
+        unsigned int flags = 0;
+        unsigned int kerningCount = 0;
+        const TinyTextFontKerningPair_s * kerningPairs = 0;
+
+        if ( header->glyphOffset >= sizeof( TinyTextFontPackHeader_s ) )
+        {
+            flags = header->flags;
+            kerningCount = header->kerningCount;
+
+            if ( kerningCount )
+            {
+                if ( ( header->kerningOffset & 3 ) != 0 || header->kerningOffset > byteCount || kerningCount > ( byteCount - header->kerningOffset ) / sizeof( TinyTextFontKerningPair_s ) )
+                {
+                    return false;
+                }
+
+                kerningPairs = ( const TinyTextFontKerningPair_s * )( m_Data + header->kerningOffset );
+
+                for ( unsigned int i = 1; i < kerningCount; ++i )
+                {
+                    const TinyTextFontKerningPair_s & previous = kerningPairs[ i - 1 ];
+                    const TinyTextFontKerningPair_s & pair = kerningPairs[ i ];
+
+                    if ( pair.first < previous.first || ( pair.first == previous.first && pair.second <= previous.second ) )
+                    {
+                        return false;
+                    }
+                }
+            }
+        }
+
+        m_Header = header;
+        m_Glyphs = glyphs;
+        m_Atlas = m_Data + header->atlasOffset;
+        m_KerningPairs = kerningPairs;
+        m_Flags = flags;
+        m_KerningCount = kerningCount;
+
+        return true;
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextFontPack_c::FindGlyph
+        Returns the glyph of a code point - a binary search of the glyph table
+    ---------------------------------------------------------------------------------*/
+    const TinyTextFontGlyph_s * TinyTextFontPack_c::FindGlyph( unsigned int codePoint ) const
+    {
+        unsigned int first = 0;
+        unsigned int last = GetNumGlyphs( );
+
+        while ( first < last )
+        {
+            unsigned int middle = first + ( last - first ) / 2;
+
+            if ( m_Glyphs[ middle ].codePoint < codePoint )
+            {
+                first = middle + 1;
+            }
+            else
+            {
+                last = middle;
+            }
+        }
+
+        return ( first < GetNumGlyphs( ) && m_Glyphs[ first ].codePoint == codePoint ) ? &m_Glyphs[ first ] : 0;
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextFontPack_c::GetKerning
+        Returns the kerning of a pair of code points - a binary search of the kerning
+        table
+    ---------------------------------------------------------------------------------*/
+    int TinyTextFontPack_c::GetKerning( unsigned int first, unsigned int second ) const
+    {
+        unsigned int low = 0;
+        unsigned int high = m_KerningCount;
+
+        while ( low < high )
+        {
+            unsigned int middle = low + ( high - low ) / 2;
+            const TinyTextFontKerningPair_s & pair = m_KerningPairs[ middle ];
+
+            if ( pair.first < first || ( pair.first == first && pair.second < second ) )
+            {
+                low = middle + 1;
+            }
+            else
+            {
+                high = middle;
+            }
+        }
+
+        if ( low < m_KerningCount && m_KerningPairs[ low ].first == first && m_KerningPairs[ low ].second == second )
+        {
+            return m_KerningPairs[ low ].amount;
+        }
+
+        return 0;
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextFontPack_c::GetWindows1252CodePoint
+        Returns the Unicode code point of a Windows-1252 character
+    ---------------------------------------------------------------------------------*/
+    unsigned int TinyTextFontPack_c::GetWindows1252CodePoint( unsigned char character )
+    {
+        if ( character >= 0x80 && character < 0xA0 )
+        {
+            return Windows1252CodePoints[ character - 0x80 ];
+        }
+
+        return character;
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextFontPack_c::GetWindows1252Character
+        Finds the Windows-1252 character of a code point
+    ---------------------------------------------------------------------------------*/
+    bool TinyTextFontPack_c::GetWindows1252Character( unsigned int codePoint, unsigned char * character )
+    {
+        if ( codePoint < 0x80 || ( codePoint >= 0xA0 && codePoint < 0x100 ) )
+        {
+            *character = ( unsigned char ) codePoint;
+            return true;
+        }
+
+        for ( unsigned int i = 0; i < sizeof( Windows1252CodePoints ) / sizeof( Windows1252CodePoints[ 0 ] ); ++i )
+        {
+            if ( Windows1252CodePoints[ i ] == codePoint )
+            {
+                *character = ( unsigned char )( 0x80 + i );
+                return true;
+            }
+        }
+
+        return false;
+    }
+//}
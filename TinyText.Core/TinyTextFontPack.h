@@ -0,0 +1,233 @@
+/*=================================================================================
+
+    PROJECT:        Tiny Text Library for DirectX 10
+
+    AUTHOR:         James Bird (http://www.jb101.co.uk/)
+
+    DESCRIPTION:    Loads font packs - fonts compiled offline by the font compiler
+                    into a single file that needs no parsing at startup
+
+    USAGE:          - Compile a pack with 'TinyText.FontCompiler' (from a BMFont
+                      .fnt file, a TrueType font or the built-in font), then
+                      call 'TinyTextFontPack_c::Open' to memory-map it
+
+                    - Pass the pack to 'TinyTextContext_c::SetFont' (or the
+                      equivalent of the other contexts). The font texture is
+                      created straight from the mapped file, and the glyphs
+                      that 'Print' needs are copied out of it, so the pack can
+                      be closed once the font has been set
+
+                    - A pack is laid out as follows (all values little-endian,
+                      and every part starts on a 4 byte boundary):
+
+                        - A 'TinyTextFontPackHeader_s', starting with the four
+                          characters 'TTFP'
+
+                        - 'glyphCount' 'TinyTextFontGlyph_s', sorted by code
+                          point
+
+                        - The atlas - one byte per texel, top row first, with no
+                          padding between rows. Texels are 255 where the font is
+                          drawn and 0 elsewhere (like the built-in font, where
+                          only white texels are kept)
+
+                        - 'kerningCount' 'TinyTextFontKerningPair_s' (if any),
+                          sorted by the first code point and then the second
+
+                    - Packs compiled with '--distance-field' hold a signed
+                      distance field instead. Each texel is the distance from
+                      its centre to the nearest edge of the glyph, mapped so
+                      that the edge is at 0.5 (inside is above, outside below),
+                      and each glyph is padded by the distance covered. The
+                      atlas is sampled bilinearly and drawn where it is at
+                      least 0.5, so one atlas serves text of any size (see
+                      'TinyTextEncoder_c::SetFontScale')
+
+                    - Characters are laid out in cells of 'characterWidth' by
+                      'lineHeight' pixels, and each glyph is positioned within
+                      its cell by its offsets
+
+                    - Packs compiled with '--proportional' have 'FlagProportional'
+                      set. Each character is then as wide as its glyph's
+                      advance, adjusted by the kerning pair (if any) of it and
+                      the character that follows it
+
+                    - The version only changes if existing fields change. New
+                      fields and tables are added at the end, so newer packs
+                      still load into older libraries. Distance field packs have
+                      a version of their own, as the atlas means something else -
+                      libraries that can't draw them reject them
+
+=================================================================================*/
+#pragma once
+
+/*---------------------------------------------------------------------------------
+    Includes
+---------------------------------------------------------------------------------*/
+#include <stddef.h>
+
+/*---------------------------------------------------------------------------------
+    TinyTextFontPackHeader_s
+    The header at the start of a font pack
+---------------------------------------------------------------------------------*/
+struct TinyTextFontPackHeader_s
+{
+    char magic[ 4 ];
+    unsigned int version;
+    unsigned int byteCount;             // Size of the whole pack, in bytes
+
+    // Size of the atlas, in texels
+    unsigned short atlasWidth;
+    unsigned short atlasHeight;
+
+    // Size of each character's cell, in pixels
+    unsigned short characterWidth;
+    unsigned short lineHeight;
+
+    // The glyph table, and the offset (from the start of the pack) of the atlas
+    unsigned int glyphCount;
+    unsigned int glyphOffset;
+    unsigned int atlasOffset;
+
+    // Added after the first packs were written, so only present if the glyph table
+    // starts after them - see 'TinyTextFontPack_c::GetFlags'. A combination of
+    // 'TinyTextFontPack_c::Flags', and the kerning table
+    unsigned int flags;
+    unsigned int kerningCount;
+    unsigned int kerningOffset;
+};
+
+/*---------------------------------------------------------------------------------
+    TinyTextFontGlyph_s
+    A character of a font pack
+---------------------------------------------------------------------------------*/
+struct TinyTextFontGlyph_s
+{
+    // The Unicode code point of the character
+    unsigned int codePoint;
+
+    // The top-left corner of the glyph in the atlas, and its size (in texels). The
+    // height is zero if the glyph has no visible texels
+    unsigned short u;
+    unsigned short v;
+    unsigned char width;
+    unsigned char height;
+
+    // Position of the glyph relative to the top-left corner of its cell (in pixels)
+    signed char xOffset;
+    signed char yOffset;
+
+    // Distance (in pixels) from this character to the next in a proportional font
+    unsigned char advance;
+    unsigned char reserved[ 3 ];
+};
+
+/*---------------------------------------------------------------------------------
+    TinyTextFontKerningPair_s
+    An adjustment to the distance between two characters of a proportional font
+---------------------------------------------------------------------------------*/
+struct TinyTextFontKerningPair_s
+{
+    // The Unicode code points of the characters, in the order they are printed
+    unsigned int first;
+    unsigned int second;
+
+    // Added to the advance of the first character (in pixels) - usually negative
+    int amount;
+};
+
+/*---------------------------------------------------------------------------------
+    TinyTextFontPack_c
+    A font pack, mapped into memory. For usage, see comments at the top of this file
+---------------------------------------------------------------------------------*/
+class TinyTextFontPack_c
+{
+public:
+
+    // Version of the layout of a pack, and of a pack whose atlas is a distance field
+    static const unsigned int Version = 1;
+    static const unsigned int DistanceFieldVersion = 2;
+
+    // Flags of a pack
+    enum Flags
+    {
+        FlagProportional        = 0x1   // Characters are spaced by their advances
+    };
+
+    // Constructor
+    TinyTextFontPack_c( );
+
+    // Destructor - unmaps the pack
+    ~TinyTextFontPack_c( );
+
+    // Maps a pack file into memory - returns 'false' if it can't be read, or isn't a
+    // valid pack of a supported version
+    bool Open( const char * fileName );
+
+    // Uses a pack that is already in memory (embedded in the executable, say) without
+    // copying it. The memory must remain valid until the pack is closed
+    bool OpenMemory( const void * data, size_t byteCount );
+
+    // Unmaps the pack
+    void Close( );
+
+    // Returns 'true' while a pack is open
+    bool IsOpen( ) const { return m_Header != 0; }
+
+    // The contents of the pack. Only valid while it is open
+    const TinyTextFontPackHeader_s * GetHeader( ) const { return m_Header; }
+    const TinyTextFontGlyph_s * GetGlyphs( ) const { return m_Glyphs; }
+    unsigned int GetNumGlyphs( ) const { return m_Header ? m_Header->glyphCount : 0; }
+    const unsigned char * GetAtlas( ) const { return m_Atlas; }
+
+    // Returns 'true' if the atlas is a distance field
+    bool IsDistanceField( ) const { return m_Header && m_Header->version == DistanceFieldVersion; }
+
+    // The pack's flags - zero for packs written before the header had them
+    unsigned int GetFlags( ) const { return m_Flags; }
+    bool IsProportional( ) const { return ( m_Flags & FlagProportional ) != 0; }
+
+    // The kerning table (empty for packs without one). Only valid while the pack is
+    // open
+    const TinyTextFontKerningPair_s * GetKerningPairs( ) const { return m_KerningPairs; }
+    unsigned int GetNumKerningPairs( ) const { return m_KerningCount; }
+
+    // Returns the kerning of a pair of code points, or zero if the pack hasn't got it
+    int GetKerning( unsigned int first, unsigned int second ) const;
+
+    // Returns the glyph of a code point, or NULL if the pack doesn't have one
+    const TinyTextFontGlyph_s * FindGlyph( unsigned int codePoint ) const;
+
+    // Returns the Unicode code point of a Windows-1252 character. The five bytes
+    // that Windows-1252 leaves undefined map to the C1 control characters
+    static unsigned int GetWindows1252CodePoint( unsigned char character );
+
+    // Finds the Windows-1252 character of a code point - returns 'false' if it
+    // hasn't got one
+    static bool GetWindows1252Character( unsigned int codePoint, unsigned char * character );
+
+private:
+
+    // Deliberately not implemented - this object cannot be copied or assigned to
+    TinyTextFontPack_c( const TinyTextFontPack_c & );
+    TinyTextFontPack_c & operator = ( const TinyTextFontPack_c & );
+
+    // Checks that the pack in 'm_Data' is complete and consistent, and finds its
+    // parts - returns 'false' if it isn't
+    bool Validate( );
+
+    // The pack, and its size. 'm_Mapped' is set if it was mapped by 'Open'
+    const unsigned char * m_Data;
+    size_t m_ByteCount;
+    bool m_Mapped;
+
+    // The parts of the pack (NULL if it isn't open)
+    const TinyTextFontPackHeader_s * m_Header;
+    const TinyTextFontGlyph_s * m_Glyphs;
+    const unsigned char * m_Atlas;
+    const TinyTextFontKerningPair_s * m_KerningPairs;
+
+    // The fields of the header that older packs don't have, or zero
+    unsigned int m_Flags;
+    unsigned int m_KerningCount;
+};
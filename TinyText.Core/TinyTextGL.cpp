@@ -0,0 +1,1024 @@
+/*=================================================================================
+
+    PROJECT:        Tiny Text Library for DirectX 10
+
+    AUTHOR:         James Bird (http://www.jb101.co.uk/)
+
+    DESCRIPTION:    The OpenGL text context. See 'TinyTextGL.h' for usage
+
+=================================================================================*/
+
+/*---------------------------------------------------------------------------------
+    Includes
+---------------------------------------------------------------------------------*/
+#include "TinyTextGL.h"
+#include <stddef.h>
+#include <string.h>
+#include <new>
+
+/*---------------------------------------------------------------------------------
+    OpenGL declarations - only those used here, so that no OpenGL headers or
+    loader library are needed
+---------------------------------------------------------------------------------*/
+#if defined( _WIN32 )
+#define TINYTEXT_GLAPI __stdcall
+#else
+#define TINYTEXT_GLAPI
+#endif
+
+typedef unsigned int GLenum_t;
+typedef unsigned int GLuint_t;
+typedef int GLint_t;
+typedef int GLsizei_t;
+typedef unsigned char GLboolean_t;
+typedef unsigned int GLbitfield_t;
+typedef ptrdiff_t GLintptr_t;
+typedef ptrdiff_t GLsizeiptr_t;
+typedef unsigned long long GLuint64_t;
+typedef void * GLsync_t;
+
+enum GLConstants
+{
+    GL_NO_ERROR_                    = 0,
+    GL_TRIANGLES_                   = 0x0004,
+    GL_CULL_FACE_                   = 0x0B44,
+    GL_DEPTH_TEST_                  = 0x0B71,
+    GL_STENCIL_TEST_                = 0x0B90,
+    GL_BLEND_                       = 0x0BE2,
+    GL_SCISSOR_TEST_                = 0x0C11,
+    GL_UNPACK_ALIGNMENT_            = 0x0CF5,
+    GL_UNSIGNED_BYTE_               = 0x1401,
+    GL_UNSIGNED_SHORT_              = 0x1403,
+    GL_FLOAT_                       = 0x1406,
+    GL_RED_                         = 0x1903,
+    GL_VERSION_                     = 0x1F02,
+    GL_NEAREST_                     = 0x2600,
+    GL_LINEAR_                      = 0x2601,
+    GL_TEXTURE_MAG_FILTER_          = 0x2800,
+    GL_TEXTURE_MIN_FILTER_          = 0x2801,
+    GL_TEXTURE_WRAP_S_              = 0x2802,
+    GL_TEXTURE_WRAP_T_              = 0x2803,
+    GL_CLAMP_TO_EDGE_               = 0x812F,
+    GL_R8_                          = 0x8229,
+    GL_NUM_EXTENSIONS_              = 0x821D,
+    GL_TEXTURE0_                    = 0x84C0,
+    GL_ACTIVE_TEXTURE_              = 0x84E0,
+    GL_ARRAY_BUFFER_                = 0x8892,
+    GL_ARRAY_BUFFER_BINDING_        = 0x8894,
+    GL_STREAM_DRAW_                 = 0x88E0,
+    GL_SAMPLER_BINDING_             = 0x8919,
+    GL_FRAGMENT_SHADER_             = 0x8B30,
+    GL_VERTEX_SHADER_               = 0x8B31,
+    GL_COMPILE_STATUS_              = 0x8B81,
+    GL_LINK_STATUS_                 = 0x8B82,
+    GL_CURRENT_PROGRAM_             = 0x8B8D,
+    GL_TEXTURE_2D_ARRAY_            = 0x8C1A,
+    GL_TEXTURE_BINDING_2D_ARRAY_    = 0x8C1D,
+    GL_VERTEX_ARRAY_BINDING_        = 0x85B5,
+    GL_EXTENSIONS_                  = 0x1F03,
+    GL_MAP_WRITE_BIT_               = 0x0002,
+    GL_MAP_PERSISTENT_BIT_          = 0x0040,
+    GL_MAP_COHERENT_BIT_            = 0x0080,
+    GL_SYNC_GPU_COMMANDS_COMPLETE_  = 0x9117,
+    GL_SYNC_FLUSH_COMMANDS_BIT_     = 0x0001,
+    GL_ALREADY_SIGNALED_            = 0x911A,
+    GL_TIMEOUT_EXPIRED_             = 0x911B,
+    GL_CONDITION_SATISFIED_         = 0x911C
+};
+
+/*---------------------------------------------------------------------------------
+    GLFunctions_s
+    The OpenGL functions used by the context
+---------------------------------------------------------------------------------*/
+struct GLFunctions_s
+{
+    void ( TINYTEXT_GLAPI * ActiveTexture )( GLenum_t texture );
+    void ( TINYTEXT_GLAPI * AttachShader )( GLuint_t program, GLuint_t shader );
+    void ( TINYTEXT_GLAPI * BindBuffer )( GLenum_t target, GLuint_t buffer );
+    void ( TINYTEXT_GLAPI * BindSampler )( GLuint_t unit, GLuint_t sampler );
+    void ( TINYTEXT_GLAPI * BindTexture )( GLenum_t target, GLuint_t texture );
+    void ( TINYTEXT_GLAPI * BindVertexArray )( GLuint_t array );
+    void ( TINYTEXT_GLAPI * BufferData )( GLenum_t target, GLsizeiptr_t size, const void * data, GLenum_t usage );
+    void ( TINYTEXT_GLAPI * BufferStorage )( GLenum_t target, GLsizeiptr_t size, const void * data, GLbitfield_t flags );
+    void ( TINYTEXT_GLAPI * BufferSubData )( GLenum_t target, GLintptr_t offset, GLsizeiptr_t size, const void * data );
+    GLenum_t ( TINYTEXT_GLAPI * ClientWaitSync )( GLsync_t sync, GLbitfield_t flags, GLuint64_t timeout );
+    void ( TINYTEXT_GLAPI * CompileShader )( GLuint_t shader );
+    GLuint_t ( TINYTEXT_GLAPI * CreateProgram )( );
+    GLuint_t ( TINYTEXT_GLAPI * CreateShader )( GLenum_t type );
+    void ( TINYTEXT_GLAPI * DeleteBuffers )( GLsizei_t n, const GLuint_t * buffers );
+    void ( TINYTEXT_GLAPI * DeleteProgram )( GLuint_t program );
+    void ( TINYTEXT_GLAPI * DeleteSamplers )( GLsizei_t n, const GLuint_t * samplers );
+    void ( TINYTEXT_GLAPI * DeleteShader )( GLuint_t shader );
+    void ( TINYTEXT_GLAPI * DeleteSync )( GLsync_t sync );
+    void ( TINYTEXT_GLAPI * DeleteTextures )( GLsizei_t n, const GLuint_t * textures );
+    void ( TINYTEXT_GLAPI * DeleteVertexArrays )( GLsizei_t n, const GLuint_t * arrays );
+    void ( TINYTEXT_GLAPI * Disable )( GLenum_t capability );
+    void ( TINYTEXT_GLAPI * DrawArrays )( GLenum_t mode, GLint_t first, GLsizei_t count );
+    void ( TINYTEXT_GLAPI * Enable )( GLenum_t capability );
+    void ( TINYTEXT_GLAPI * EnableVertexAttribArray )( GLuint_t index );
+    GLsync_t ( TINYTEXT_GLAPI * FenceSync )( GLenum_t condition, GLbitfield_t flags );
+    void ( TINYTEXT_GLAPI * GenBuffers )( GLsizei_t n, GLuint_t * buffers );
+    void ( TINYTEXT_GLAPI * GenSamplers )( GLsizei_t n, GLuint_t * samplers );
+    void ( TINYTEXT_GLAPI * GenTextures )( GLsizei_t n, GLuint_t * textures );
+    void ( TINYTEXT_GLAPI * GenVertexArrays )( GLsizei_t n, GLuint_t * arrays );
+    GLenum_t ( TINYTEXT_GLAPI * GetError )( );
+    void ( TINYTEXT_GLAPI * GetIntegerv )( GLenum_t name, GLint_t * data );
+    void ( TINYTEXT_GLAPI * GetProgramiv )( GLuint_t program, GLenum_t name, GLint_t * params );
+    void ( TINYTEXT_GLAPI * GetShaderiv )( GLuint_t shader, GLenum_t name, GLint_t * params );
+    const unsigned char * ( TINYTEXT_GLAPI * GetStringi )( GLenum_t name, GLuint_t index );
+    GLint_t ( TINYTEXT_GLAPI * GetUniformLocation )( GLuint_t program, const char * name );
+    GLboolean_t ( TINYTEXT_GLAPI * IsEnabled )( GLenum_t capability );
+    void ( TINYTEXT_GLAPI * LinkProgram )( GLuint_t program );
+    void * ( TINYTEXT_GLAPI * MapBufferRange )( GLenum_t target, GLintptr_t offset, GLsizeiptr_t length, GLbitfield_t access );
+    void ( TINYTEXT_GLAPI * PixelStorei )( GLenum_t name, GLint_t param );
+    void ( TINYTEXT_GLAPI * SamplerParameteri )( GLuint_t sampler, GLenum_t name, GLint_t param );
+    void ( TINYTEXT_GLAPI * ShaderSource )( GLuint_t shader, GLsizei_t count, const char * const * strings, const GLint_t * lengths );
+    void ( TINYTEXT_GLAPI * TexImage3D )( GLenum_t target, GLint_t level, GLint_t internalFormat, GLsizei_t width, GLsizei_t height, GLsizei_t depth, GLint_t border, GLenum_t format, GLenum_t type, const void * pixels );
+    void ( TINYTEXT_GLAPI * TexParameteri )( GLenum_t target, GLenum_t name, GLint_t param );
+    void ( TINYTEXT_GLAPI * TexSubImage3D )( GLenum_t target, GLint_t level, GLint_t x, GLint_t y, GLint_t z, GLsizei_t width, GLsizei_t height, GLsizei_t depth, GLenum_t format, GLenum_t type, const void * pixels );
+    void ( TINYTEXT_GLAPI * Uniform1i )( GLint_t location, GLint_t value );
+    void ( TINYTEXT_GLAPI * UseProgram )( GLuint_t program );
+    void ( TINYTEXT_GLAPI * VertexAttribIPointer )( GLuint_t index, GLint_t size, GLenum_t type, GLsizei_t stride, const void * pointer );
+    void ( TINYTEXT_GLAPI * VertexAttribPointer )( GLuint_t index, GLint_t size, GLenum_t type, GLboolean_t normalized, GLsizei_t stride, const void * pointer );
+};
+
+/*---------------------------------------------------------------------------------
+    Constants
+---------------------------------------------------------------------------------*/
+//namespace
+//{
+    // The shaders, in GLSL. These match 'Shaders' in 'TinyText.cpp' - texture
+    // coordinates are in texels, with the top bit of each selecting the layer of the
+    // font array, the font is point sampled, and any texel that isn't white is
+    // discarded. Distance field fonts are filtered, and kept wherever they are at
+    // least 0.5
+    const char          VertexShaderGL[]        = "#version 330 core\n layout( location = 0 ) in vec2 position; layout( location = 1 ) in uvec2 texCoord; layout( location = 2 ) in vec4 colour; out vec3 fontCoord; out vec4 vertexColour; void main( ) { gl_Position = vec4( position, 0.0, 1.0 ); fontCoord = vec3( texCoord & 0x7FFFu, ( texCoord.x >> 15 ) | ( ( texCoord.y >> 15 ) << 1 ) ); vertexColour = colour; }";
+    const char          FragmentShaderGL[]      = "#version 330 core\n uniform sampler2DArray font; in vec3 fontCoord; in vec4 vertexColour; out vec4 fragColour; void main( ) { float fontValue = textureLod( font, vec3( fontCoord.xy / vec2( textureSize( font, 0 ).xy ), fontCoord.z ), 0.0 ).r; if ( fontValue < 1.0 ) discard; fragColour = fontValue * vertexColour; }";
+    const char          DistanceFieldShaderGL[] = "#version 330 core\n uniform sampler2DArray font; in vec3 fontCoord; in vec4 vertexColour; out vec4 fragColour; void main( ) { float fieldValue = textureLod( font, vec3( fontCoord.xy / vec2( textureSize( font, 0 ).xy ), fontCoord.z ), 0.0 ).r; if ( fieldValue < 0.5 ) discard; fragColour = vertexColour; }";
+
+    // Bytes of each vertex
+    const int           VertexStrideGL          = ( TinyTextEncoder_c::NumVertexElementsPerCharacter / TinyTextEncoder_c::NumVerticesPerCharacter ) * 4;
+
+    // How long to wait for a fence before checking again, in nanoseconds
+    const GLuint64_t    FenceTimeout            = 1000000;
+//}
+
+/*---------------------------------------------------------------------------------
+    Private Implementation
+---------------------------------------------------------------------------------*/
+//namespace
+//{
+    /*---------------------------------------------------------------------------------
+        PreviousStateGL_c
+        The OpenGL state changed by 'Render', which it saves and restores
+    ---------------------------------------------------------------------------------*/
+    class PreviousStateGL_c
+    {
+    public:
+
+        void Capture( const GLFunctions_s & gl )
+        {
+            gl.GetIntegerv( GL_CURRENT_PROGRAM_, &program );
+            gl.GetIntegerv( GL_VERTEX_ARRAY_BINDING_, &vertexArray );
+            gl.GetIntegerv( GL_ARRAY_BUFFER_BINDING_, &arrayBuffer );
+            gl.GetIntegerv( GL_ACTIVE_TEXTURE_, &activeTexture );
+
+            gl.ActiveTexture( GL_TEXTURE0_ );
+            gl.GetIntegerv( GL_TEXTURE_BINDING_2D_ARRAY_, &texture );
+            gl.GetIntegerv( GL_SAMPLER_BINDING_, &sampler );
+
+            for ( int i = 0; i < NumCapabilities; ++i )
+            {
+                enabled[ i ] = gl.IsEnabled( Capabilities[ i ] );
+            }
+        }
+
+        void Restore( const GLFunctions_s & gl )
+        {
+            for ( int i = 0; i < NumCapabilities; ++i )
+            {
+                if ( enabled[ i ] )
+                {
+                    gl.Enable( Capabilities[ i ] );
+                }
+            }
+
+            gl.BindSampler( 0, GLuint_t( sampler ) );
+            gl.BindTexture( GL_TEXTURE_2D_ARRAY_, GLuint_t( texture ) );
+            gl.ActiveTexture( GLenum_t( activeTexture ) );
+            gl.BindBuffer( GL_ARRAY_BUFFER_, GLuint_t( arrayBuffer ) );
+            gl.BindVertexArray( GLuint_t( vertexArray ) );
+            gl.UseProgram( GLuint_t( program ) );
+        }
+
+        // The capabilities that 'Render' disables
+        static const int NumCapabilities = 5;
+        static const GLenum_t Capabilities[ NumCapabilities ];
+
+    private:
+
+        GLint_t program;
+        GLint_t vertexArray;
+        GLint_t arrayBuffer;
+        GLint_t activeTexture;
+        GLint_t texture;
+        GLint_t sampler;
+        GLboolean_t enabled[ NumCapabilities ];
+    };
+
+    const GLenum_t PreviousStateGL_c::Capabilities[ NumCapabilities ] = { GL_BLEND_, GL_CULL_FACE_, GL_DEPTH_TEST_, GL_STENCIL_TEST_, GL_SCISSOR_TEST_ };
+
+    /*---------------------------------------------------------------------------------
+        LoadGLFunction
+        Looks up a single OpenGL function - returns 'false' if it isn't available
+    ---------------------------------------------------------------------------------*/
+    template < typename Function_t >
+    bool LoadGLFunction( TinyTextContextGL_c::GetProcAddress_t getProcAddress, const char * name, Function_t * function )
+    {
+        *function = ( Function_t ) getProcAddress( name );
+        return *function != 0;
+    }
+
+    /*---------------------------------------------------------------------------------
+        LoadGLFunctions
+        Looks up all the OpenGL functions used by the context. 'glBufferStorage' is
+        optional, and left NULL if it isn't available
+    ---------------------------------------------------------------------------------*/
+    bool LoadGLFunctions( TinyTextContextGL_c::GetProcAddress_t getProcAddress, GLFunctions_s * gl )
+    {
+        LoadGLFunction( getProcAddress, "glBufferStorage", &gl->BufferStorage );
+
+        return LoadGLFunction( getProcAddress, "glActiveTexture", &gl->ActiveTexture )
+            && LoadGLFunction( getProcAddress, "glAttachShader", &gl->AttachShader )
+            && LoadGLFunction( getProcAddress, "glBindBuffer", &gl->BindBuffer )
+            && LoadGLFunction( getProcAddress, "glBindSampler", &gl->BindSampler )
+            && LoadGLFunction( getProcAddress, "glBindTexture", &gl->BindTexture )
+            && LoadGLFunction( getProcAddress, "glBindVertexArray", &gl->BindVertexArray )
+            && LoadGLFunction( getProcAddress, "glBufferData", &gl->BufferData )
+            && LoadGLFunction( getProcAddress, "glBufferSubData", &gl->BufferSubData )
+            && LoadGLFunction( getProcAddress, "glClientWaitSync", &gl->ClientWaitSync )
+            && LoadGLFunction( getProcAddress, "glCompileShader", &gl->CompileShader )
+            && LoadGLFunction( getProcAddress, "glCreateProgram", &gl->CreateProgram )
+            && LoadGLFunction( getProcAddress, "glCreateShader", &gl->CreateShader )
+            && LoadGLFunction( getProcAddress, "glDeleteBuffers", &gl->DeleteBuffers )
+            && LoadGLFunction( getProcAddress, "glDeleteProgram", &gl->DeleteProgram )
+            && LoadGLFunction( getProcAddress, "glDeleteSamplers", &gl->DeleteSamplers )
+            && LoadGLFunction( getProcAddress, "glDeleteShader", &gl->DeleteShader )
+            && LoadGLFunction( getProcAddress, "glDeleteSync", &gl->DeleteSync )
+            && LoadGLFunction( getProcAddress, "glDeleteTextures", &gl->DeleteTextures )
+            && LoadGLFunction( getProcAddress, "glDeleteVertexArrays", &gl->DeleteVertexArrays )
+            && LoadGLFunction( getProcAddress, "glDisable", &gl->Disable )
+            && LoadGLFunction( getProcAddress, "glDrawArrays", &gl->DrawArrays )
+            && LoadGLFunction( getProcAddress, "glEnable", &gl->Enable )
+            && LoadGLFunction( getProcAddress, "glEnableVertexAttribArray", &gl->EnableVertexAttribArray )
+            && LoadGLFunction( getProcAddress, "glFenceSync", &gl->FenceSync )
+            && LoadGLFunction( getProcAddress, "glGenBuffers", &gl->GenBuffers )
+            && LoadGLFunction( getProcAddress, "glGenSamplers", &gl->GenSamplers )
+            && LoadGLFunction( getProcAddress, "glGenTextures", &gl->GenTextures )
+            && LoadGLFunction( getProcAddress, "glGenVertexArrays", &gl->GenVertexArrays )
+            && LoadGLFunction( getProcAddress, "glGetError", &gl->GetError )
+            && LoadGLFunction( getProcAddress, "glGetIntegerv", &gl->GetIntegerv )
+            && LoadGLFunction( getProcAddress, "glGetProgramiv", &gl->GetProgramiv )
+            && LoadGLFunction( getProcAddress, "glGetShaderiv", &gl->GetShaderiv )
+            && LoadGLFunction( getProcAddress, "glGetStringi", &gl->GetStringi )
+            && LoadGLFunction( getProcAddress, "glGetUniformLocation", &gl->GetUniformLocation )
+            && LoadGLFunction( getProcAddress, "glIsEnabled", &gl->IsEnabled )
+            && LoadGLFunction( getProcAddress, "glLinkProgram", &gl->LinkProgram )
+            && LoadGLFunction( getProcAddress, "glMapBufferRange", &gl->MapBufferRange )
+            && LoadGLFunction( getProcAddress, "glPixelStorei", &gl->PixelStorei )
+            && LoadGLFunction( getProcAddress, "glSamplerParameteri", &gl->SamplerParameteri )
+            && LoadGLFunction( getProcAddress, "glShaderSource", &gl->ShaderSource )
+            && LoadGLFunction( getProcAddress, "glTexImage3D", &gl->TexImage3D )
+            && LoadGLFunction( getProcAddress, "glTexParameteri", &gl->TexParameteri )
+            && LoadGLFunction( getProcAddress, "glTexSubImage3D", &gl->TexSubImage3D )
+            && LoadGLFunction( getProcAddress, "glUniform1i", &gl->Uniform1i )
+            && LoadGLFunction( getProcAddress, "glUseProgram", &gl->UseProgram )
+            && LoadGLFunction( getProcAddress, "glVertexAttribIPointer", &gl->VertexAttribIPointer )
+            && LoadGLFunction( getProcAddress, "glVertexAttribPointer", &gl->VertexAttribPointer );
+    }
+
+    /*---------------------------------------------------------------------------------
+        SupportsBufferStorage
+        Returns 'true' if persistently mapped buffers can be created
+    ---------------------------------------------------------------------------------*/
+    bool SupportsBufferStorage( const GLFunctions_s & gl )
+    {
+        if ( !gl.BufferStorage )
+        {
+            return false;
+        }
+
+        GLint_t numExtensions = 0;
+        gl.GetIntegerv( GL_NUM_EXTENSIONS_, &numExtensions );
+
+        for ( GLint_t i = 0; i < numExtensions; ++i )
+        {
+            const char * extension = ( const char * ) gl.GetStringi( GL_EXTENSIONS_, GLuint_t( i ) );
+            if ( extension && strcmp( extension, "GL_ARB_buffer_storage" ) == 0 )
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    /*---------------------------------------------------------------------------------
+        CompileShaderGL
+        Compiles a single shader - returns 0 on failure
+    ---------------------------------------------------------------------------------*/
+    GLuint_t CompileShaderGL( const GLFunctions_s & gl, GLenum_t type, const char * source )
+    {
+        GLuint_t shader = gl.CreateShader( type );
+        if ( !shader )
+        {
+            return 0;
+        }
+
+        gl.ShaderSource( shader, 1, &source, 0 );
+        gl.CompileShader( shader );
+
+        GLint_t compiled = 0;
+        gl.GetShaderiv( shader, GL_COMPILE_STATUS_, &compiled );
+
+        if ( !compiled )
+        {
+            gl.DeleteShader( shader );
+            return 0;
+        }
+
+        return shader;
+    }
+
+    /*---------------------------------------------------------------------------------
+        CreateProgramGL
+        Compiles and links the font shaders, with the specified fragment shader, and
+        points the program's sampler at texture unit 0 - returns 0 on failure
+    ---------------------------------------------------------------------------------*/
+    GLuint_t CreateProgramGL( const GLFunctions_s & gl, const char * fragmentSource )
+    {
+        GLuint_t vertexShader = CompileShaderGL( gl, GL_VERTEX_SHADER_, VertexShaderGL );
+        GLuint_t fragmentShader = CompileShaderGL( gl, GL_FRAGMENT_SHADER_, fragmentSource );
+        GLuint_t program = ( vertexShader && fragmentShader ) ? gl.CreateProgram( ) : 0;
+
+        if ( program )
+        {
+            gl.AttachShader( program, vertexShader );
+            gl.AttachShader( program, fragmentShader );
+            gl.LinkProgram( program );
+
+            GLint_t linked = 0;
+            gl.GetProgramiv( program, GL_LINK_STATUS_, &linked );
+
+            if ( !linked )
+            {
+                gl.DeleteProgram( program );
+                program = 0;
+            }
+        }
+
+        if ( program )
+        {
+            GLint_t previousProgram = 0;
+            gl.GetIntegerv( GL_CURRENT_PROGRAM_, &previousProgram );
+            gl.UseProgram( program );
+            gl.Uniform1i( gl.GetUniformLocation( program, "font" ), 0 );
+            gl.UseProgram( GLuint_t( previousProgram ) );
+        }
+
+        // The program keeps the shaders alive for as long as it needs them
+        if ( vertexShader ) gl.DeleteShader( vertexShader );
+        if ( fragmentShader ) gl.DeleteShader( fragmentShader );
+
+        return program;
+    }
+
+    /*---------------------------------------------------------------------------------
+        UploadFontTextureGL
+        Creates a single channel texture array from one byte per texel, first row of
+        the first layer first
+    ---------------------------------------------------------------------------------*/
+    GLuint_t UploadFontTextureGL( const GLFunctions_s & gl, int width, int height, int layerCount, const unsigned char * texels )
+    {
+        GLuint_t texture = 0;
+        gl.GenTextures( 1, &texture );
+        if ( !texture )
+        {
+            return 0;
+        }
+
+        GLint_t previousTexture = 0;
+        GLint_t previousAlignment = 0;
+        gl.GetIntegerv( GL_TEXTURE_BINDING_2D_ARRAY_, &previousTexture );
+        gl.GetIntegerv( GL_UNPACK_ALIGNMENT_, &previousAlignment );
+
+        gl.BindTexture( GL_TEXTURE_2D_ARRAY_, texture );
+        gl.PixelStorei( GL_UNPACK_ALIGNMENT_, 1 );
+        gl.TexImage3D( GL_TEXTURE_2D_ARRAY_, 0, GL_R8_, width, height, layerCount, 0, GL_RED_, GL_UNSIGNED_BYTE_, texels );
+        gl.TexParameteri( GL_TEXTURE_2D_ARRAY_, GL_TEXTURE_MIN_FILTER_, GL_NEAREST_ );
+        gl.TexParameteri( GL_TEXTURE_2D_ARRAY_, GL_TEXTURE_MAG_FILTER_, GL_NEAREST_ );
+
+        gl.PixelStorei( GL_UNPACK_ALIGNMENT_, previousAlignment );
+        gl.BindTexture( GL_TEXTURE_2D_ARRAY_, GLuint_t( previousTexture ) );
+
+        return texture;
+    }
+
+    /*---------------------------------------------------------------------------------
+        CreateFontTextureGL
+        Creates the font texture array, as a single channel that is 1.0 where the font
+        bitmap is white - one layer for each font, which is a font pack or NULL for the
+        built-in font
+    ---------------------------------------------------------------------------------*/
+    GLuint_t CreateFontTextureGL( const GLFunctions_s & gl, const TinyTextFontPack_c * const * fonts, unsigned int fontCount )
+    {
+        if ( fontCount == 1 && fonts[ 0 ] )
+        {
+            // The atlas is stored top row first, one byte per texel, so it can be
+            // uploaded as it is
+            return UploadFontTextureGL( gl, fonts[ 0 ]->GetHeader( )->atlasWidth, fonts[ 0 ]->GetHeader( )->atlasHeight, 1, fonts[ 0 ]->GetAtlas( ) );
+        }
+
+        // The first row of an OpenGL texture is at a texture coordinate of zero, which
+        // Direct3D treats as the top, so the array is uploaded top row first too
+        int width;
+        int height;
+        unsigned char * texels = TinyTextEncoder_c::CreateFontArray( fonts, fontCount, &width, &height );
+
+        if ( !texels )
+        {
+            return 0;
+        }
+
+        GLuint_t texture = UploadFontTextureGL( gl, width, height, int( fontCount ), texels );
+        delete [] texels;
+
+        return texture;
+    }
+
+    /*---------------------------------------------------------------------------------
+        UploadGlyphCacheGL
+        Uploads the rows of a glyph cache that have changed into its texture (an array
+        of one layer), which must be bound, in a single update
+    ---------------------------------------------------------------------------------*/
+    void UploadGlyphCacheGL( const GLFunctions_s & gl, TinyTextGlyphCache_c & glyphCache )
+    {
+        int firstRow;
+        int rowCount;
+
+        if ( !glyphCache.GetDirtyRows( &firstRow, &rowCount ) )
+        {
+            return;
+        }
+
+        const int width = glyphCache.GetTextureWidth( );
+
+        GLint_t previousAlignment = 0;
+        gl.GetIntegerv( GL_UNPACK_ALIGNMENT_, &previousAlignment );
+
+        gl.PixelStorei( GL_UNPACK_ALIGNMENT_, 1 );
+        gl.TexSubImage3D( GL_TEXTURE_2D_ARRAY_, 0, 0, firstRow, 0, width, rowCount, 1, GL_RED_, GL_UNSIGNED_BYTE_, glyphCache.GetTexels( ) + firstRow * width );
+        gl.PixelStorei( GL_UNPACK_ALIGNMENT_, previousAlignment );
+
+        glyphCache.ClearDirtyRows( );
+    }
+
+    /*---------------------------------------------------------------------------------
+        CreateSamplerGL
+        Creates the sampler used for the font texture - point sampling, or 'GL_LINEAR_'
+        for distance field fonts. A sampler object is used so that it overrides any the
+        application has bound to texture unit 0
+    ---------------------------------------------------------------------------------*/
+    GLuint_t CreateSamplerGL( const GLFunctions_s & gl, GLint_t filter )
+    {
+        GLuint_t sampler = 0;
+        gl.GenSamplers( 1, &sampler );
+        if ( !sampler )
+        {
+            return 0;
+        }
+
+        gl.SamplerParameteri( sampler, GL_TEXTURE_MIN_FILTER_, filter );
+        gl.SamplerParameteri( sampler, GL_TEXTURE_MAG_FILTER_, filter );
+        gl.SamplerParameteri( sampler, GL_TEXTURE_WRAP_S_, GL_CLAMP_TO_EDGE_ );
+        gl.SamplerParameteri( sampler, GL_TEXTURE_WRAP_T_, GL_CLAMP_TO_EDGE_ );
+
+        return sampler;
+    }
+//}
+
+//namespace
+//{
+    /*---------------------------------------------------------------------------------
+        TinyTextContextGL_c::TinyTextContextGL_c
+        Constructor
+    ---------------------------------------------------------------------------------*/
+    TinyTextContextGL_c::TinyTextContextGL_c( GetProcAddress_t getProcAddress, size_t characterCapacity, bool * result )
+    :   m_GL( 0 ),
+        m_Program( 0 ),
+        m_VertexArray( 0 ),
+        m_VertexBuffer( 0 ),
+        m_Texture( 0 ),
+        m_Sampler( 0 ),
+        m_DistanceFieldProgram( 0 ),
+        m_DistanceFieldSampler( 0 ),
+        m_DistanceField( false ),
+        m_GlyphCacheTexture( 0 ),
+        m_MappedVertices( 0 ),
+        m_SystemVertices( 0 ),
+        m_RingIndex( 0 )
+    {
+        memset( m_Fences, 0, sizeof( m_Fences ) );
+
+        bool succeeded = Initialise( getProcAddress, characterCapacity );
+
+        if ( result )
+        {
+            *result = succeeded;
+        }
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextContextGL_c::~TinyTextContextGL_c
+        Destructor
+    ---------------------------------------------------------------------------------*/
+    TinyTextContextGL_c::~TinyTextContextGL_c( )
+    {
+        Release( );
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextContextGL_c::Initialise
+        Initialises this object
+    ---------------------------------------------------------------------------------*/
+    bool TinyTextContextGL_c::Initialise( GetProcAddress_t getProcAddress, size_t characterCapacity )
+    {
+        // Validate arguments
+        if ( !getProcAddress || !characterCapacity )
+        {
+            return false;
+        }
+
+        m_GL = new ( std::nothrow ) GLFunctions_s;
+        if ( !m_GL || !LoadGLFunctions( getProcAddress, m_GL ) )
+        {
+            Release( );
+            return false;
+        }
+
+        const GLFunctions_s & gl = *m_GL;
+
+        // Create the shader programs, for bitmap and distance field fonts
+        m_Program = CreateProgramGL( gl, FragmentShaderGL );
+        m_DistanceFieldProgram = CreateProgramGL( gl, DistanceFieldShaderGL );
+
+        if ( !m_Program || !m_DistanceFieldProgram )
+        {
+            Release( );
+            return false;
+        }
+
+        // Create the font texture and samplers
+        const TinyTextFontPack_c * builtInFont = 0;
+
+        m_Texture = CreateFontTextureGL( gl, &builtInFont, 1 );
+        m_Sampler = CreateSamplerGL( gl, GL_NEAREST_ );
+        m_DistanceFieldSampler = CreateSamplerGL( gl, GL_LINEAR_ );
+
+        if ( !m_Texture || !m_Sampler || !m_DistanceFieldSampler )
+        {
+            Release( );
+            return false;
+        }
+
+        // Create the vertex buffer, with room for every frame of the ring
+        const size_t frameByteCount = characterCapacity * TinyTextEncoder_c::NumVertexElementsPerCharacter * sizeof( unsigned int );
+        const size_t ringByteCount = frameByteCount * RingLength;
+
+        GLint_t previousVertexArray = 0;
+        GLint_t previousArrayBuffer = 0;
+        gl.GetIntegerv( GL_VERTEX_ARRAY_BINDING_, &previousVertexArray );
+        gl.GetIntegerv( GL_ARRAY_BUFFER_BINDING_, &previousArrayBuffer );
+
+        gl.GenVertexArrays( 1, &m_VertexArray );
+        gl.GenBuffers( 1, &m_VertexBuffer );
+
+        if ( m_VertexArray && m_VertexBuffer )
+        {
+            gl.BindVertexArray( m_VertexArray );
+            gl.BindBuffer( GL_ARRAY_BUFFER_, m_VertexBuffer );
+
+            if ( SupportsBufferStorage( gl ) )
+            {
+                const GLbitfield_t flags = GL_MAP_WRITE_BIT_ | GL_MAP_PERSISTENT_BIT_ | GL_MAP_COHERENT_BIT_;
+
+                gl.BufferStorage( GL_ARRAY_BUFFER_, GLsizeiptr_t( ringByteCount ), 0, flags );
+                m_MappedVertices = ( unsigned int * ) gl.MapBufferRange( GL_ARRAY_BUFFER_, 0, GLsizeiptr_t( ringByteCount ), flags );
+            }
+
+            if ( !m_MappedVertices )
+            {
+                gl.BufferData( GL_ARRAY_BUFFER_, GLsizeiptr_t( ringByteCount ), 0, GL_STREAM_DRAW_ );
+                m_SystemVertices = new ( std::nothrow ) unsigned int[ characterCapacity * TinyTextEncoder_c::NumVertexElementsPerCharacter ];
+            }
+
+            // Position (2 floats), texture coordinates (2 unsigned shorts, read as
+            // integers) and colour (4 normalised bytes, red first)
+            gl.VertexAttribPointer( 0, 2, GL_FLOAT_, 0, VertexStrideGL, ( const void * ) 0 );
+            gl.VertexAttribIPointer( 1, 2, GL_UNSIGNED_SHORT_, VertexStrideGL, ( const void * ) 8 );
+            gl.VertexAttribPointer( 2, 4, GL_UNSIGNED_BYTE_, 1, VertexStrideGL, ( const void * ) 12 );
+            gl.EnableVertexAttribArray( 0 );
+            gl.EnableVertexAttribArray( 1 );
+            gl.EnableVertexAttribArray( 2 );
+        }
+
+        gl.BindBuffer( GL_ARRAY_BUFFER_, GLuint_t( previousArrayBuffer ) );
+        gl.BindVertexArray( GLuint_t( previousVertexArray ) );
+
+        if ( ( !m_MappedVertices && !m_SystemVertices ) || gl.GetError( ) != GL_NO_ERROR_ )
+        {
+            Release( );
+            return false;
+        }
+
+        // Create the encoder
+        if ( !m_Encoder.Initialise( characterCapacity ) )
+        {
+            Release( );
+            return false;
+        }
+
+        return true;
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextContextGL_c::Release
+        Releases all OpenGL objects
+    ---------------------------------------------------------------------------------*/
+    void TinyTextContextGL_c::Release( )
+    {
+        if ( m_Encoder.IsEncoding( ) )
+        {
+            m_Encoder.End( );
+        }
+
+        if ( m_GL )
+        {
+            const GLFunctions_s & gl = *m_GL;
+
+            for ( unsigned int i = 0; i < RingLength; ++i )
+            {
+                if ( m_Fences[ i ] )
+                {
+                    gl.DeleteSync( m_Fences[ i ] );
+                    m_Fences[ i ] = 0;
+                }
+            }
+
+            // Deleting the buffer also unmaps it
+            if ( m_VertexBuffer ) gl.DeleteBuffers( 1, &m_VertexBuffer );
+            if ( m_VertexArray ) gl.DeleteVertexArrays( 1, &m_VertexArray );
+            if ( m_Sampler ) gl.DeleteSamplers( 1, &m_Sampler );
+            if ( m_DistanceFieldSampler ) gl.DeleteSamplers( 1, &m_DistanceFieldSampler );
+            if ( m_Texture ) gl.DeleteTextures( 1, &m_Texture );
+            if ( m_GlyphCacheTexture ) gl.DeleteTextures( 1, &m_GlyphCacheTexture );
+            if ( m_Program ) gl.DeleteProgram( m_Program );
+            if ( m_DistanceFieldProgram ) gl.DeleteProgram( m_DistanceFieldProgram );
+        }
+
+        delete m_GL;
+        delete [] m_SystemVertices;
+
+        m_GL = 0;
+        m_Program = 0;
+        m_VertexArray = 0;
+        m_VertexBuffer = 0;
+        m_Texture = 0;
+        m_GlyphCacheTexture = 0;
+        m_Sampler = 0;
+        m_DistanceFieldProgram = 0;
+        m_DistanceFieldSampler = 0;
+        m_MappedVertices = 0;
+        m_SystemVertices = 0;
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextContextGL_c::SetCodePage
+        Select the character set used to interpret the bytes passed to 'Print'
+    ---------------------------------------------------------------------------------*/
+    void TinyTextContextGL_c::SetCodePage( TinyTextEncoder_c::CodePage codePage )
+    {
+        m_Encoder.SetCodePage( codePage );
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextContextGL_c::SetCharacterMap
+        Set a custom mapping from each byte passed to 'Print' to a character of the font
+    ---------------------------------------------------------------------------------*/
+    void TinyTextContextGL_c::SetCharacterMap( const unsigned char characterMap[ 256 ] )
+    {
+        m_Encoder.SetCharacterMap( characterMap );
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextContextGL_c::SetFont
+        Select the font that text is printed with - a font pack, or NULL for the
+        built-in font
+    ---------------------------------------------------------------------------------*/
+    bool TinyTextContextGL_c::SetFont( const TinyTextFontPack_c * font )
+    {
+        return SetFonts( &font, 1 );
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextContextGL_c::SetFonts
+        Select several fonts at once, to be picked between by each run of text
+    ---------------------------------------------------------------------------------*/
+    bool TinyTextContextGL_c::SetFonts( const TinyTextFontPack_c * const * fonts, unsigned int fontCount )
+    {
+        if ( !m_GL || m_Encoder.IsEncoding( ) || !TinyTextEncoder_c::ValidateFonts( fonts, fontCount ) )
+        {
+            return false;
+        }
+
+        const GLFunctions_s & gl = *m_GL;
+
+        GLuint_t texture = CreateFontTextureGL( gl, fonts, fontCount );
+        if ( !texture )
+        {
+            return false;
+        }
+
+        gl.DeleteTextures( 1, &m_Texture );
+        m_Texture = texture;
+        m_DistanceField = fonts[ 0 ] && fonts[ 0 ]->IsDistanceField( );
+
+        m_Encoder.SetFonts( fonts, fontCount );
+
+        return true;
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextContextGL_c::SetGlyphCache
+        Select a glyph cache to take glyphs from instead of the font, or NULL to go
+        back to the font
+    ---------------------------------------------------------------------------------*/
+    bool TinyTextContextGL_c::SetGlyphCache( TinyTextGlyphCache_c * glyphCache )
+    {
+        if ( !m_GL || m_Encoder.IsEncoding( ) || ( glyphCache && !glyphCache->GetTexels( ) ) )
+        {
+            return false;
+        }
+
+        const GLFunctions_s & gl = *m_GL;
+        GLuint_t texture = 0;
+
+        if ( glyphCache )
+        {
+            texture = UploadFontTextureGL( gl, glyphCache->GetTextureWidth( ), glyphCache->GetTextureHeight( ), 1, glyphCache->GetTexels( ) );
+            if ( !texture )
+            {
+                return false;
+            }
+
+            glyphCache->ClearDirtyRows( );
+        }
+
+        if ( m_GlyphCacheTexture )
+        {
+            gl.DeleteTextures( 1, &m_GlyphCacheTexture );
+        }
+
+        m_GlyphCacheTexture = texture;
+
+        m_Encoder.SetGlyphCache( glyphCache );
+
+        return true;
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextContextGL_c::SetFontScale
+        Scale every character of the font
+    ---------------------------------------------------------------------------------*/
+    void TinyTextContextGL_c::SetFontScale( float scale )
+    {
+        m_Encoder.SetFontScale( scale );
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextContextGL_c::Print
+        Print some text to the context. Colour is of form 0xAABBGGRR
+    ---------------------------------------------------------------------------------*/
+    bool TinyTextContextGL_c::Print( int viewportWidth, int viewportHeight, const char * text, int x, int y, unsigned int colour )
+    {
+        return Print( viewportWidth, viewportHeight, 0xffffffff, text, x, y, colour );
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextContextGL_c::Print
+        Print some text to the context. Colour is of form 0xAABBGGRR
+    ---------------------------------------------------------------------------------*/
+    bool TinyTextContextGL_c::Print( int viewportWidth, int viewportHeight, size_t maxCharacterCount, const char * text, int x, int y, unsigned int colour )
+    {
+        if ( !BeginFrame( ) )
+        {
+            return false;
+        }
+
+        return m_Encoder.Print( float( viewportWidth ), float( viewportHeight ), maxCharacterCount, text, x, y, colour );
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextContextGL_c::Print
+        Print some text to the context, laid out according to 'format'. Colour is of
+        form 0xAABBGGRR
+    ---------------------------------------------------------------------------------*/
+    bool TinyTextContextGL_c::Print( int viewportWidth, int viewportHeight, const TinyTextFormat_c & format, const char * text, int x, int y, unsigned int colour, int * width, int * height )
+    {
+        return Print( viewportWidth, viewportHeight, format, 0xffffffff, text, x, y, colour, width, height );
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextContextGL_c::Print
+        Print some text to the context, laid out according to 'format'. Colour is of
+        form 0xAABBGGRR
+    ---------------------------------------------------------------------------------*/
+    bool TinyTextContextGL_c::Print( int viewportWidth, int viewportHeight, const TinyTextFormat_c & format, size_t maxCharacterCount, const char * text, int x, int y, unsigned int colour, int * width, int * height )
+    {
+        if ( !BeginFrame( ) )
+        {
+            if ( width || height )
+            {
+                m_Encoder.MeasureText( format, maxCharacterCount, text, width, height );
+            }
+
+            return false;
+        }
+
+        return m_Encoder.Print( float( viewportWidth ), float( viewportHeight ), format, maxCharacterCount, text, x, y, colour, width, height );
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextContextGL_c::MeasureText
+        Measure the size that some text would occupy if it was printed with 'format'
+    ---------------------------------------------------------------------------------*/
+    void TinyTextContextGL_c::MeasureText( const TinyTextFormat_c & format, const char * text, int * width, int * height ) const
+    {
+        MeasureText( format, 0xffffffff, text, width, height );
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextContextGL_c::MeasureText
+        Measure the size that some text would occupy if it was printed with 'format'
+    ---------------------------------------------------------------------------------*/
+    void TinyTextContextGL_c::MeasureText( const TinyTextFormat_c & format, size_t maxCharacterCount, const char * text, int * width, int * height ) const
+    {
+        m_Encoder.MeasureText( format, maxCharacterCount, text, width, height );
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextContextGL_c::Render
+        Render the context into the bound framebuffer
+    ---------------------------------------------------------------------------------*/
+    bool TinyTextContextGL_c::Render( bool maintainState )
+    {
+        bool result = RenderVertexBuffer( maintainState );
+
+        // Move on to the next part of the ring, whether or not anything was drawn
+        m_RingIndex = ( m_RingIndex + 1 ) % RingLength;
+
+        if ( m_Encoder.GetGlyphCache( ) )
+        {
+            m_Encoder.GetGlyphCache( )->EndFrame( );
+        }
+
+        return result;
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextContextGL_c::BeginFrame
+        Starts encoding into this frame's part of the vertex buffer, once the GPU has
+        finished drawing what was last encoded there
+    ---------------------------------------------------------------------------------*/
+    bool TinyTextContextGL_c::BeginFrame( )
+    {
+        // If we haven't got a vertex buffer, then we cannot continue
+        if ( !m_VertexBuffer ) return false;
+
+        if ( !m_Encoder.IsEncoding( ) )
+        {
+            if ( m_MappedVertices )
+            {
+                // Wait for the fence placed when this part of the ring was last drawn.
+                // With 'RingLength' frames in flight this is normally already signalled
+                GLsync_t & fence = m_Fences[ m_RingIndex ];
+
+                if ( fence )
+                {
+                    GLenum_t status;
+                    do
+                    {
+                        status = m_GL->ClientWaitSync( fence, GL_SYNC_FLUSH_COMMANDS_BIT_, FenceTimeout );
+                    }
+                    while ( status == GL_TIMEOUT_EXPIRED_ );
+
+                    m_GL->DeleteSync( fence );
+                    fence = 0;
+
+                    if ( status != GL_ALREADY_SIGNALED_ && status != GL_CONDITION_SATISFIED_ )
+                    {
+                        return false;
+                    }
+                }
+
+                m_Encoder.Begin( m_MappedVertices + m_RingIndex * m_Encoder.GetCapacity( ) * TinyTextEncoder_c::NumVertexElementsPerCharacter );
+            }
+            else
+            {
+                m_Encoder.Begin( m_SystemVertices );
+            }
+        }
+
+        return true;
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextContextGL_c::RenderVertexBuffer
+        Draws this frame's part of the vertex buffer
+    ---------------------------------------------------------------------------------*/
+    bool TinyTextContextGL_c::RenderVertexBuffer( bool maintainState )
+    {
+        // If we haven't got a vertex buffer, then we cannot continue
+        if ( !m_VertexBuffer ) return false;
+
+        // Nothing was printed this frame
+        if ( !m_Encoder.IsEncoding( ) ) return true;
+
+        m_Encoder.End( );
+
+        const unsigned int numVertices = m_Encoder.GetNumVertices( );
+        if ( !numVertices ) return true;
+
+        const GLFunctions_s & gl = *m_GL;
+
+        // Save previous state
+        PreviousStateGL_c state;
+        if ( maintainState )
+        {
+            state.Capture( gl );
+        }
+
+        // The first vertex of this frame's part of the ring
+        const unsigned int firstVertex = m_RingIndex * m_Encoder.GetCapacity( ) * TinyTextEncoder_c::NumVerticesPerCharacter;
+
+        // Without a persistent mapping, copy the frame into its part of the ring
+        if ( !m_MappedVertices )
+        {
+            gl.BindBuffer( GL_ARRAY_BUFFER_, m_VertexBuffer );
+            gl.BufferSubData( GL_ARRAY_BUFFER_, GLintptr_t( firstVertex ) * VertexStrideGL, GLsizeiptr_t( numVertices ) * VertexStrideGL, m_SystemVertices );
+        }
+
+        // Setup render state
+        for ( int i = 0; i < PreviousStateGL_c::NumCapabilities; ++i )
+        {
+            gl.Disable( PreviousStateGL_c::Capabilities[ i ] );
+        }
+
+        // Distance field fonts have a program and sampler of their own
+        const TinyTextGlyphCache_c * glyphCache = m_Encoder.GetGlyphCache( );
+        const bool distanceField = glyphCache ? glyphCache->IsDistanceField( ) : m_DistanceField;
+
+        gl.UseProgram( distanceField ? m_DistanceFieldProgram : m_Program );
+        gl.BindVertexArray( m_VertexArray );
+        gl.ActiveTexture( GL_TEXTURE0_ );
+        gl.BindSampler( 0, distanceField ? m_DistanceFieldSampler : m_Sampler );
+
+        // Upload the glyphs copied into the glyph cache this frame
+        if ( m_Encoder.GetGlyphCache( ) )
+        {
+            gl.BindTexture( GL_TEXTURE_2D_ARRAY_, m_GlyphCacheTexture );
+            UploadGlyphCacheGL( gl, *m_Encoder.GetGlyphCache( ) );
+        }
+        else
+        {
+            gl.BindTexture( GL_TEXTURE_2D_ARRAY_, m_Texture );
+        }
+
+        // Render the font, then fence this part of the ring so that it isn't
+        // overwritten until the GPU has finished with it
+        gl.DrawArrays( GL_TRIANGLES_, GLint_t( firstVertex ), GLsizei_t( numVertices ) );
+
+        if ( m_MappedVertices )
+        {
+            m_Fences[ m_RingIndex ] = gl.FenceSync( GL_SYNC_GPU_COMMANDS_COMPLETE_, 0 );
+        }
+
+        // Restore previous render state
+        if ( maintainState )
+        {
+            state.Restore( gl );
+        }
+
+        return true;
+    }
+//}
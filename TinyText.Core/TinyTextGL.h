@@ -0,0 +1,208 @@
+/*=================================================================================
+
+    PROJECT:        Tiny Text Library for DirectX 10
+
+    AUTHOR:         James Bird (http://www.jb101.co.uk/)
+
+    DESCRIPTION:    An OpenGL 3.3 text context, for platforms without Direct3D
+
+    USAGE:          - Make an OpenGL 3.3 (or later) core or compatibility context
+                      current, then construct a 'TinyTextContextGL_c' with a
+                      function that returns the address of each OpenGL function
+                      and a maximum character capacity. Keep the context
+                      current whenever the text context is used
+
+                        - 'eglGetProcAddress' and 'glXGetProcAddress' can be
+                          passed directly. 'wglGetProcAddress' doesn't return
+                          the OpenGL 1.1 functions, so on Windows pass a function
+                          that falls back to 'GetProcAddress' on 'opengl32.dll'
+
+                    - 'Print' and 'Render' work as they do for
+                      'TinyTextContext_c', except that 'Print' takes the size of
+                      the viewport in pixels. 'Render' draws into the bound
+                      framebuffer, using the current viewport
+
+                    - Where 'ARB_buffer_storage' is supported (it is core from
+                      OpenGL 4.4), the vertex buffer holds 'RingLength' frames
+                      and is mapped once, persistently and coherently, for the
+                      life of the context. 'Print' encodes straight into this
+                      frame's part of the ring, and 'Render' draws it and places
+                      a fence, which is waited on before that part is reused.
+                      Nothing is mapped or unmapped from one frame to the next
+
+                    - Without 'ARB_buffer_storage', text is encoded into system
+                      memory and copied into the ring by 'Render'
+
+                    - With a glyph cache selected, 'Render' uploads the rows of
+                      the cache that changed during the frame with a single
+                      'glTexSubImage3D' before drawing
+
+                    - Fonts are held in a 2D array texture, with one layer for
+                      each font selected with 'TinyTextContextGL_c::SetFonts'
+
+                    - Distance field font packs are drawn with a program and a
+                      filtering sampler of their own, both created along with
+                      the context
+
+                    - 'Render' uses texture unit 0. By default it saves and
+                      restores the state that it changes, which can be skipped
+                      with the optional 'bool' argument
+
+                    - During your application shutdown, delete the text context
+                      while its OpenGL context is still current
+
+=================================================================================*/
+#pragma once
+
+/*---------------------------------------------------------------------------------
+    Includes
+---------------------------------------------------------------------------------*/
+#include "TinyTextEncoder.h"
+
+/*---------------------------------------------------------------------------------
+    TinyTextContextGL_c
+    The OpenGL text context. For usage, see comments at the top of this file
+---------------------------------------------------------------------------------*/
+class TinyTextContextGL_c
+{
+public:
+
+    // Returns the address of an OpenGL function (given its full name, such as
+    // "glDrawArrays"), or NULL if it isn't available
+    typedef void * ( * GetProcAddress_t )( const char * name );
+
+    // Number of frames that the vertex buffer holds
+    static const unsigned int RingLength = 3;
+
+    // Constructor - takes the function used to look up OpenGL functions and the
+    // capacity of this context (in characters). Also takes an optional pointer to a
+    // boolean that will receive the result of this operation.
+    explicit TinyTextContextGL_c( GetProcAddress_t getProcAddress, size_t characterCapacity, bool * result = NULL );
+
+    // Destructor - releases all OpenGL objects
+    ~TinyTextContextGL_c( );
+
+    // Default text colour = opaque white
+    static const unsigned int DefaultColour = 0xffffffff;
+
+    // Width of each character of the built-in font (in pixels) - the font is
+    // fixed-width
+    static const int CharacterWidth = TinyTextEncoder_c::CharacterWidth;
+
+    // Distance between the tops of consecutive lines of text in the built-in font
+    // (in pixels)
+    static const int LineHeight = TinyTextEncoder_c::LineHeight;
+
+    // Select the character set used to interpret the bytes passed to 'Print'
+    void SetCodePage( TinyTextEncoder_c::CodePage codePage );
+
+    // Set a custom mapping from each byte passed to 'Print' to a character of the font,
+    // which uses the Windows-1252 character set
+    void SetCharacterMap( const unsigned char characterMap[ 256 ] );
+
+    // Select the font that text is printed with - a font pack, or NULL for the
+    // built-in font. Works as 'TinyTextContext_c::SetFont' does
+    bool SetFont( const TinyTextFontPack_c * font );
+
+    // Select several fonts at once, to be picked between by 'TinyTextFormat_c::font'.
+    // Works as 'TinyTextContext_c::SetFonts' does
+    bool SetFonts( const TinyTextFontPack_c * const * fonts, unsigned int fontCount );
+
+    // Select a glyph cache to take glyphs from instead of the font, or NULL to go
+    // back to the font. Works as 'TinyTextContext_c::SetGlyphCache' does
+    bool SetGlyphCache( TinyTextGlyphCache_c * glyphCache );
+
+    // Scale the font - see 'TinyTextEncoder_c::SetFontScale'
+    void SetFontScale( float scale );
+    float GetFontScale( ) const { return m_Encoder.GetFontScale( ); }
+
+    // Size of each character's cell in one of the current fonts, once scaled (in
+    // pixels)
+    int GetCharacterWidth( unsigned int font = 0 ) const { return m_Encoder.GetCharacterWidth( font ); }
+    int GetLineHeight( unsigned int font = 0 ) const { return m_Encoder.GetLineHeight( font ); }
+
+    // Whether one of the current fonts lays characters out by their own advances
+    bool IsProportional( unsigned int font = 0 ) const { return m_Encoder.IsProportional( font ); }
+
+    // Print some text to the context - returns 'true' on success or 'false' on failure.
+    // 'colour' is expected to be in the form: 0xAABBGGRR.
+    bool Print( int viewportWidth, int viewportHeight, const char * text, int x, int y, unsigned int colour = DefaultColour );
+    bool Print( int viewportWidth, int viewportHeight, size_t maxCharacterCount, const char * text, int x, int y, unsigned int colour = DefaultColour );
+
+    // Print some text to the context, laid out according to 'format'. If 'width' or
+    // 'height' isn't NULL, it receives the size of the text, as 'MeasureText' would
+    // return it
+    bool Print( int viewportWidth, int viewportHeight, const TinyTextFormat_c & format, const char * text, int x, int y, unsigned int colour = DefaultColour, int * width = 0, int * height = 0 );
+    bool Print( int viewportWidth, int viewportHeight, const TinyTextFormat_c & format, size_t maxCharacterCount, const char * text, int x, int y, unsigned int colour = DefaultColour, int * width = 0, int * height = 0 );
+
+    // Measure the size (in pixels) that some text would occupy if it was printed with
+    // 'format'. The width is that of the widest line; either pointer may be NULL
+    void MeasureText( const TinyTextFormat_c & format, const char * text, int * width, int * height ) const;
+    void MeasureText( const TinyTextFormat_c & format, size_t maxCharacterCount, const char * text, int * width, int * height ) const;
+
+    // Render the context into the bound framebuffer - returns 'true' on success or
+    // 'false' on failure
+    bool Render( bool maintainState = true );
+
+    // Returns 'true' if the vertex buffer is persistently mapped, or 'false' if text
+    // is copied into it by 'Render'
+    bool IsPersistentlyMapped( ) const { return m_MappedVertices != 0; }
+
+    // Returns the number of vertices that characters with no visible pixels (such as
+    // spaces) would have added to the current frame, had they not been skipped
+    unsigned int GetNumSkippedVertices( ) const { return m_Encoder.GetNumSkippedVertices( ); }
+
+private:
+
+    // Deliberately not implemented - this object cannot be copied or assigned to
+    TinyTextContextGL_c( const TinyTextContextGL_c & );
+    TinyTextContextGL_c & operator = ( const TinyTextContextGL_c & );
+
+    // Initialises the context
+    bool Initialise( GetProcAddress_t getProcAddress, size_t characterCapacity );
+
+    // Releases all OpenGL objects
+    void Release( );
+
+    // Starts encoding into this frame's part of the vertex buffer (if encoding hasn't
+    // already started), once the GPU has finished with it
+    bool BeginFrame( );
+
+    // Draws this frame's part of the vertex buffer - returns 'true' on success or
+    // 'false' on failure
+    bool RenderVertexBuffer( bool maintainState );
+
+    // The OpenGL functions used by the context
+    struct GLFunctions_s * m_GL;
+
+    // The shader program, which reproduces 'Shaders' of 'TinyText.cpp'
+    unsigned int m_Program;
+
+    // The vertex array, vertex buffer, font texture array and sampler
+    unsigned int m_VertexArray;
+    unsigned int m_VertexBuffer;
+    unsigned int m_Texture;
+    unsigned int m_Sampler;
+
+    // The shader program and sampler for distance field fonts, and whether the font
+    // is one
+    unsigned int m_DistanceFieldProgram;
+    unsigned int m_DistanceFieldSampler;
+    bool m_DistanceField;
+
+    // The texture of the glyph cache (if one is selected)
+    unsigned int m_GlyphCacheTexture;
+
+    // The persistent mapping of the whole vertex buffer, or NULL if text is encoded
+    // into 'm_SystemVertices' instead
+    unsigned int * m_MappedVertices;
+    unsigned int * m_SystemVertices;
+
+    // The part of the ring being encoded, and a fence for each part that is placed
+    // after it is drawn (or NULL)
+    unsigned int m_RingIndex;
+    void * m_Fences[ RingLength ];
+
+    // Lays out text and encodes it into the vertex buffer
+    TinyTextEncoder_c m_Encoder;
+};
@@ -0,0 +1,464 @@
+/*=================================================================================
+
+    PROJECT:        Tiny Text Library for DirectX 10
+
+    AUTHOR:         James Bird (http://www.jb101.co.uk/)
+
+    DESCRIPTION:    The glyph cache. See 'TinyTextGlyphCache.h' for usage
+
+=================================================================================*/
+
+/*---------------------------------------------------------------------------------
+    Includes
+---------------------------------------------------------------------------------*/
+#include "TinyTextGlyphCache.h"
+#include <string.h>
+#include <new>
+
+/*---------------------------------------------------------------------------------
+    Constants
+---------------------------------------------------------------------------------*/
+//namespace
+//{
+    // Marks an unused entry of the glyph tables (no character has this code point)
+    const unsigned int  EmptyCodePoint          = 0xFFFFFFFF;
+
+    // Blank texels to the right of and below each glyph
+    const int           GlyphGutter             = 1;
+
+    // Largest texture the cache will use (in texels) - the limit of Direct3D 10
+    const int           MaxGlyphCacheTextureSize = 8192;
+
+    // Texels of the pages for each entry of the glyph table. The table is kept no more
+    // than half full, so a cache full of 8x8 glyphs evicts pages before the table fills
+    const int           TexelsPerGlyphEntry     = 64;
+    const unsigned int  MinGlyphEntryCapacity   = 256;
+//}
+
+//namespace
+//{
+    /*---------------------------------------------------------------------------------
+        TinyTextGlyphCache_c::TinyTextGlyphCache_c
+        Constructor
+    ---------------------------------------------------------------------------------*/
+    TinyTextGlyphCache_c::TinyTextGlyphCache_c( )
+    :   m_Font( 0 ),
+        m_PageSize( 0 ),
+        m_PageCount( 0 ),
+        m_Pages( 0 ),
+        m_FillPage( 0 ),
+        m_Texels( 0 ),
+        m_DirtyTop( 0 ),
+        m_DirtyBottom( 0 ),
+        m_Entries( 0 ),
+        m_SpareEntries( 0 ),
+        m_EntryCapacity( 0 ),
+        m_EntryCount( 0 ),
+        m_EntryShift( 0 ),
+        m_Frame( 1 ),
+        m_NumCopiedGlyphs( 0 ),
+        m_NumMissingGlyphs( 0 ),
+        m_NumEvictedPages( 0 )
+    {
+        for ( unsigned int i = 0; i < AsciiCount; ++i )
+        {
+            m_AsciiEntries[ i ].glyph.codePoint = EmptyCodePoint;
+        }
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextGlyphCache_c::~TinyTextGlyphCache_c
+        Destructor
+    ---------------------------------------------------------------------------------*/
+    TinyTextGlyphCache_c::~TinyTextGlyphCache_c( )
+    {
+        Release( );
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextGlyphCache_c::Initialise
+        Allocates the pages and glyph tables. The cache starts empty - glyphs are
+        only copied in as they are printed
+    ---------------------------------------------------------------------------------*/
+    bool TinyTextGlyphCache_c::Initialise( const TinyTextFontPack_c * font, int pageSize, int pageCount )
+    {
+        Release( );
+
+        if ( !font || !font->IsOpen( ) || pageSize <= GlyphGutter || pageCount <= 0 || pageSize > MaxGlyphCacheTextureSize || pageCount > MaxGlyphCacheTextureSize / pageSize )
+        {
+            return false;
+        }
+
+        // Size the glyph table to a power of two, so that a hash can index it with a
+        // shift
+        const size_t texelCount = size_t( pageSize ) * pageSize * pageCount;
+
+        m_EntryCapacity = MinGlyphEntryCapacity;
+        m_EntryShift = 24;
+
+        while ( m_EntryCapacity < 2 * texelCount / TexelsPerGlyphEntry )
+        {
+            m_EntryCapacity *= 2;
+            --m_EntryShift;
+        }
+
+        m_Pages = new ( std::nothrow ) CachePage_s[ pageCount ];
+        m_Texels = new ( std::nothrow ) unsigned char[ texelCount ];
+        m_Entries = new ( std::nothrow ) GlyphCacheEntry_s[ m_EntryCapacity ];
+        m_SpareEntries = new ( std::nothrow ) GlyphCacheEntry_s[ m_EntryCapacity ];
+
+        if ( !m_Pages || !m_Texels || !m_Entries || !m_SpareEntries )
+        {
+            Release( );
+            return false;
+        }
+
+        memset( m_Pages, 0, sizeof( CachePage_s ) * pageCount );
+        memset( m_Texels, 0, texelCount );
+
+        for ( unsigned int i = 0; i < m_EntryCapacity; ++i )
+        {
+            m_Entries[ i ].glyph.codePoint = EmptyCodePoint;
+        }
+
+        m_Font = font;
+        m_PageSize = pageSize;
+        m_PageCount = pageCount;
+
+        return true;
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextGlyphCache_c::Release
+        Releases everything, leaving the cache empty
+    ---------------------------------------------------------------------------------*/
+    void TinyTextGlyphCache_c::Release( )
+    {
+        delete [] m_Pages;
+        delete [] m_Texels;
+        delete [] m_Entries;
+        delete [] m_SpareEntries;
+
+        m_Font = 0;
+        m_PageSize = 0;
+        m_PageCount = 0;
+        m_Pages = 0;
+        m_FillPage = 0;
+        m_Texels = 0;
+        m_DirtyTop = 0;
+        m_DirtyBottom = 0;
+        m_Entries = 0;
+        m_SpareEntries = 0;
+        m_EntryCapacity = 0;
+        m_EntryCount = 0;
+
+        for ( unsigned int i = 0; i < AsciiCount; ++i )
+        {
+            m_AsciiEntries[ i ].glyph.codePoint = EmptyCodePoint;
+        }
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextGlyphCache_c::FindUncachedGlyph
+        Looks up a glyph in the hash table. A glyph that isn't there is copied out of
+        the font pack into a page, evicting a page if there's no room
+    ---------------------------------------------------------------------------------*/
+    const TinyTextFontGlyph_s * TinyTextGlyphCache_c::FindUncachedGlyph( unsigned int codePoint )
+    {
+        if ( !m_Font )
+        {
+            return 0;
+        }
+
+        const unsigned int mask = m_EntryCapacity - 1;
+
+        for ( unsigned int i = ( codePoint * 2654435761u ) >> m_EntryShift; m_Entries[ i ].glyph.codePoint != EmptyCodePoint; i = ( i + 1 ) & mask )
+        {
+            if ( m_Entries[ i ].glyph.codePoint == codePoint )
+            {
+                m_Pages[ m_Entries[ i ].page ].lastUsedFrame = m_Frame;
+                return &m_Entries[ i ].glyph;
+            }
+        }
+
+        // The glyph isn't cached. Characters that the pack doesn't have use its '?'
+        // glyph (or nothing, if it hasn't got that either)
+        const TinyTextFontGlyph_s * source = m_Font->FindGlyph( codePoint );
+
+        if ( !source )
+        {
+            source = m_Font->FindGlyph( '?' );
+        }
+
+        GlyphCacheEntry_s entry;
+        memset( &entry, 0, sizeof( entry ) );
+
+        if ( source )
+        {
+            entry.glyph = *source;
+        }
+
+        entry.glyph.codePoint = codePoint;
+
+        // Keep the table no more than half full
+        unsigned int evictedPage;
+
+        while ( ( m_EntryCount + 1 ) * 2 > m_EntryCapacity && EvictPage( &evictedPage ) )
+        {
+        }
+
+        int u;
+        int v;
+
+        if ( ( m_EntryCount + 1 ) * 2 > m_EntryCapacity || !AllocateGlyph( entry.glyph.width, entry.glyph.height, &entry.page, &u, &v ) )
+        {
+            ++m_NumMissingGlyphs;
+            return 0;
+        }
+
+        // Copy the glyph in, with its gutter
+        if ( entry.glyph.height && entry.glyph.width )
+        {
+            const TinyTextFontPackHeader_s * header = m_Font->GetHeader( );
+            const unsigned char * sourceRow = m_Font->GetAtlas( ) + size_t( source->v ) * header->atlasWidth + source->u;
+            unsigned char * destRow = m_Texels + size_t( v ) * m_PageSize + u;
+
+            for ( int row = 0; row < entry.glyph.height + GlyphGutter; ++row )
+            {
+                if ( row < entry.glyph.height )
+                {
+                    memcpy( destRow, sourceRow, entry.glyph.width );
+                    memset( destRow + entry.glyph.width, 0, GlyphGutter );
+                }
+                else
+                {
+                    memset( destRow, 0, entry.glyph.width + GlyphGutter );
+                }
+
+                sourceRow += header->atlasWidth;
+                destRow += m_PageSize;
+            }
+
+            if ( m_DirtyTop >= m_DirtyBottom )
+            {
+                m_DirtyTop = v;
+                m_DirtyBottom = v;
+            }
+
+            m_DirtyTop = v < m_DirtyTop ? v : m_DirtyTop;
+            m_DirtyBottom = v + entry.glyph.height + GlyphGutter > m_DirtyBottom ? v + entry.glyph.height + GlyphGutter : m_DirtyBottom;
+
+            ++m_NumCopiedGlyphs;
+        }
+
+        entry.glyph.u = ( unsigned short ) u;
+        entry.glyph.v = ( unsigned short ) v;
+
+        m_Pages[ entry.page ].lastUsedFrame = m_Frame;
+        ++m_EntryCount;
+
+        if ( codePoint < AsciiCount )
+        {
+            m_AsciiEntries[ codePoint ] = entry;
+        }
+
+        return &InsertEntry( m_Entries, entry )->glyph;
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextGlyphCache_c::AllocateGlyph
+        Finds room for a glyph on the shelves of the page being filled, moving on to an
+        empty page (or evicting one) when it is full. Glyphs without texels take no
+        room, but still belong to a page so that they are evicted along with it
+    ---------------------------------------------------------------------------------*/
+    bool TinyTextGlyphCache_c::AllocateGlyph( int width, int height, unsigned int * page, int * u, int * v )
+    {
+        if ( !width || !height )
+        {
+            *page = m_FillPage;
+            *u = 0;
+            *v = 0;
+            return true;
+        }
+
+        width += GlyphGutter;
+        height += GlyphGutter;
+
+        if ( width > m_PageSize || height > m_PageSize )
+        {
+            return false;
+        }
+
+        for ( ;; )
+        {
+            CachePage_s & fillPage = m_Pages[ m_FillPage ];
+
+            if ( fillPage.shelfX + width > m_PageSize )
+            {
+                fillPage.shelfX = 0;
+                fillPage.shelfY += fillPage.shelfHeight;
+                fillPage.shelfHeight = 0;
+            }
+
+            if ( fillPage.shelfY + height <= m_PageSize )
+            {
+                *page = m_FillPage;
+                *u = fillPage.shelfX;
+                *v = int( m_FillPage ) * m_PageSize + fillPage.shelfY;
+
+                fillPage.shelfX += width;
+                fillPage.shelfHeight = height > fillPage.shelfHeight ? height : fillPage.shelfHeight;
+                return true;
+            }
+
+            // The page is full
+            unsigned int nextPage = 0;
+
+            while ( nextPage < m_PageCount && m_Pages[ nextPage ].lastUsedFrame != 0 )
+            {
+                ++nextPage;
+            }
+
+            if ( nextPage == m_PageCount && !EvictPage( &nextPage ) )
+            {
+                return false;
+            }
+
+            m_FillPage = nextPage;
+        }
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextGlyphCache_c::EvictPage
+        Empties the page used least recently, and rebuilds the glyph table without its
+        glyphs. Pages used in this frame are left alone, as vertices already encoded
+        refer to them
+    ---------------------------------------------------------------------------------*/
+    bool TinyTextGlyphCache_c::EvictPage( unsigned int * page )
+    {
+        unsigned int oldestPage = m_PageCount;
+
+        for ( unsigned int i = 0; i < m_PageCount; ++i )
+        {
+            const unsigned int lastUsedFrame = m_Pages[ i ].lastUsedFrame;
+
+            if ( lastUsedFrame != 0 && lastUsedFrame != m_Frame && ( oldestPage == m_PageCount || lastUsedFrame < m_Pages[ oldestPage ].lastUsedFrame ) )
+            {
+                oldestPage = i;
+            }
+        }
+
+        if ( oldestPage == m_PageCount )
+        {
+            return false;
+        }
+
+        for ( unsigned int i = 0; i < m_EntryCapacity; ++i )
+        {
+            m_SpareEntries[ i ].glyph.codePoint = EmptyCodePoint;
+        }
+
+        m_EntryCount = 0;
+
+        for ( unsigned int i = 0; i < m_EntryCapacity; ++i )
+        {
+            if ( m_Entries[ i ].glyph.codePoint != EmptyCodePoint && m_Entries[ i ].page != oldestPage )
+            {
+                InsertEntry( m_SpareEntries, m_Entries[ i ] );
+                ++m_EntryCount;
+            }
+        }
+
+        GlyphCacheEntry_s * entries = m_Entries;
+        m_Entries = m_SpareEntries;
+        m_SpareEntries = entries;
+
+        for ( unsigned int i = 0; i < AsciiCount; ++i )
+        {
+            if ( m_AsciiEntries[ i ].page == oldestPage )
+            {
+                m_AsciiEntries[ i ].glyph.codePoint = EmptyCodePoint;
+            }
+        }
+
+        memset( &m_Pages[ oldestPage ], 0, sizeof( CachePage_s ) );
+        ++m_NumEvictedPages;
+
+        *page = oldestPage;
+        return true;
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextGlyphCache_c::InsertEntry
+        Inserts an entry at the first free slot from its hash
+    ---------------------------------------------------------------------------------*/
+    TinyTextGlyphCache_c::GlyphCacheEntry_s * TinyTextGlyphCache_c::InsertEntry( GlyphCacheEntry_s * table, const GlyphCacheEntry_s & entry )
+    {
+        const unsigned int mask = m_EntryCapacity - 1;
+        unsigned int i = ( entry.glyph.codePoint * 2654435761u ) >> m_EntryShift;
+
+        while ( table[ i ].glyph.codePoint != EmptyCodePoint )
+        {
+            i = ( i + 1 ) & mask;
+        }
+
+        table[ i ] = entry;
+        return &table[ i ];
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextGlyphCache_c::EndFrame
+        Ends a frame - the pages used in it can be evicted from the next frame on
+    ---------------------------------------------------------------------------------*/
+    void TinyTextGlyphCache_c::EndFrame( )
+    {
+        ++m_Frame;
+
+        m_NumCopiedGlyphs = 0;
+        m_NumMissingGlyphs = 0;
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextGlyphCache_c::GetCharacterWidth
+        Returns the width of each character's cell in the font
+    ---------------------------------------------------------------------------------*/
+    int TinyTextGlyphCache_c::GetCharacterWidth( ) const
+    {
+        return m_Font ? m_Font->GetHeader( )->characterWidth : 0;
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextGlyphCache_c::GetLineHeight
+        Returns the distance between the tops of consecutive lines in the font
+    ---------------------------------------------------------------------------------*/
+    int TinyTextGlyphCache_c::GetLineHeight( ) const
+    {
+        return m_Font ? m_Font->GetHeader( )->lineHeight : 0;
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextGlyphCache_c::GetDirtyRows
+        Returns the rows of the texture that have changed
+    ---------------------------------------------------------------------------------*/
+    bool TinyTextGlyphCache_c::GetDirtyRows( int * firstRow, int * rowCount ) const
+    {
+        if ( m_DirtyTop >= m_DirtyBottom )
+        {
+            return false;
+        }
+
+        *firstRow = m_DirtyTop;
+        *rowCount = m_DirtyBottom - m_DirtyTop;
+        return true;
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextGlyphCache_c::ClearDirtyRows
+        Forgets the changed rows, once they have been uploaded
+    ---------------------------------------------------------------------------------*/
+    void TinyTextGlyphCache_c::ClearDirtyRows( )
+    {
+        m_DirtyTop = 0;
+        m_DirtyBottom = 0;
+    }
+//}
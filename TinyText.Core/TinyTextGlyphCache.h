@@ -0,0 +1,195 @@
+/*=================================================================================
+
+    PROJECT:        Tiny Text Library for DirectX 10
+
+    AUTHOR:         James Bird (http://www.jb101.co.uk/)
+
+    DESCRIPTION:    A cache of glyphs from a font pack, for fonts with far more
+                    characters than fit in a texture (CJK, for example)
+
+    USAGE:          - Compile a font pack with the characters you need (see
+                      'TinyTextFontPack.h'), open it, and initialise a
+                      'TinyTextGlyphCache_c' with it. The pack must stay open
+                      while the cache uses it
+
+                    - Pass the cache to 'TinyTextContext_c::SetGlyphCache' (or
+                      the equivalent of the OpenGL context), and select
+                      'CodePageUTF8' so that 'Print' takes UTF-8 text
+
+                    - The font texture is replaced by the cache's texture,
+                      which is divided into pages. A glyph is copied out of the
+                      pack into a page the first time it is printed, and is then
+                      reused for as long as it stays in the cache. Only the
+                      parts of the pack's atlas that are printed are ever read
+
+                    - When there is no room for a glyph, the page used least
+                      recently is emptied and reused. Pages used in the current
+                      frame are never evicted, as text already encoded refers
+                      to them - if every page is in use, characters that don't
+                      fit are left out and counted by 'GetNumMissingGlyphs'
+
+                    - Rows of the texture that change are collected over the
+                      frame, and the context uploads them in one go before
+                      drawing. Once the glyphs of a frame are cached, nothing
+                      is copied or uploaded until the text changes
+
+                    - ASCII characters are looked up in a small table of their
+                      own, without hashing
+
+=================================================================================*/
+#pragma once
+
+/*---------------------------------------------------------------------------------
+    Includes
+---------------------------------------------------------------------------------*/
+#include "TinyTextFontPack.h"
+
+/*---------------------------------------------------------------------------------
+    TinyTextGlyphCache_c
+    Caches glyphs from a font pack in pages of a texture. For usage, see comments at
+    the top of this file
+---------------------------------------------------------------------------------*/
+class TinyTextGlyphCache_c
+{
+public:
+
+    // Default size of each page (in texels - pages are square), and number of pages
+    static const int DefaultPageSize = 256;
+    static const int DefaultPageCount = 4;
+
+    // Constructor - the cache is empty until it has been initialised
+    TinyTextGlyphCache_c( );
+
+    // Destructor
+    ~TinyTextGlyphCache_c( );
+
+    // Allocates the pages and glyph table, for glyphs taken from 'font' - returns
+    // 'true' on success or 'false' on failure. The texture is 'pageSize' texels wide,
+    // with the pages stacked one above another
+    bool Initialise( const TinyTextFontPack_c * font, int pageSize = DefaultPageSize, int pageCount = DefaultPageCount );
+
+    // Returns the glyph of a code point, with its position in the cache's texture,
+    // copying it into a page first if it isn't cached. Characters that the pack
+    // doesn't have use its '?' glyph. Returns NULL if there was no room for the glyph
+    const TinyTextFontGlyph_s * FindGlyph( unsigned int codePoint )
+    {
+        if ( codePoint < AsciiCount && m_AsciiEntries[ codePoint ].glyph.codePoint == codePoint )
+        {
+            m_Pages[ m_AsciiEntries[ codePoint ].page ].lastUsedFrame = m_Frame;
+            return &m_AsciiEntries[ codePoint ].glyph;
+        }
+
+        return FindUncachedGlyph( codePoint );
+    }
+
+    // Ends a frame, once its text has been drawn. Pages used in the frame become
+    // candidates for eviction
+    void EndFrame( );
+
+    // Size of each character's cell in the cache's font (in pixels)
+    int GetCharacterWidth( ) const;
+    int GetLineHeight( ) const;
+
+    // Returns 'true' if the cache's font is a distance field, which the cache's
+    // texture then is too
+    bool IsDistanceField( ) const { return m_Font && m_Font->IsDistanceField( ); }
+
+    // The cache's texture - one byte per texel, top row first - and its size
+    const unsigned char * GetTexels( ) const { return m_Texels; }
+    int GetTextureWidth( ) const { return m_PageSize; }
+    int GetTextureHeight( ) const { return m_PageSize * m_PageCount; }
+
+    // Returns the rows of the texture that have changed since 'ClearDirtyRows' was
+    // last called, or 'false' if there are none
+    bool GetDirtyRows( int * firstRow, int * rowCount ) const;
+
+    // Called once the changed rows have been uploaded
+    void ClearDirtyRows( );
+
+    // Number of glyphs in the cache
+    unsigned int GetNumCachedGlyphs( ) const { return m_EntryCount; }
+
+    // Number of glyphs copied into the cache, and of characters left out because
+    // there was no room for them, since the last call to 'EndFrame'
+    unsigned int GetNumCopiedGlyphs( ) const { return m_NumCopiedGlyphs; }
+    unsigned int GetNumMissingGlyphs( ) const { return m_NumMissingGlyphs; }
+
+    // Number of pages evicted since the cache was initialised
+    unsigned int GetNumEvictedPages( ) const { return m_NumEvictedPages; }
+
+private:
+
+    // Deliberately not implemented - this object cannot be copied or assigned to
+    TinyTextGlyphCache_c( const TinyTextGlyphCache_c & );
+    TinyTextGlyphCache_c & operator = ( const TinyTextGlyphCache_c & );
+
+    // Code points that have an entry in 'm_AsciiEntries'
+    static const unsigned int AsciiCount = 128;
+
+    // A cached glyph, with the page that it belongs to
+    struct GlyphCacheEntry_s
+    {
+        TinyTextFontGlyph_s glyph;
+        unsigned int page;
+    };
+
+    // A page, and the shelf of it being filled. 'lastUsedFrame' is zero while the
+    // page is empty
+    struct CachePage_s
+    {
+        unsigned int lastUsedFrame;
+        int shelfX;
+        int shelfY;
+        int shelfHeight;
+    };
+
+    // Looks up a glyph in the hash table, adding it if it isn't there
+    const TinyTextFontGlyph_s * FindUncachedGlyph( unsigned int codePoint );
+
+    // Finds room for a glyph of the specified size (in texels) - returns 'false' if
+    // there is none
+    bool AllocateGlyph( int width, int height, unsigned int * page, int * u, int * v );
+
+    // Empties the page used least recently, other than in this frame - returns
+    // 'false' if there is no such page
+    bool EvictPage( unsigned int * page );
+
+    // Inserts an entry into a hash table, which must have room for it
+    GlyphCacheEntry_s * InsertEntry( GlyphCacheEntry_s * table, const GlyphCacheEntry_s & entry );
+
+    // Releases everything
+    void Release( );
+
+    // The font that glyphs are copied from
+    const TinyTextFontPack_c * m_Font;
+
+    // The pages, and the one being filled
+    int m_PageSize;
+    unsigned int m_PageCount;
+    CachePage_s * m_Pages;
+    unsigned int m_FillPage;
+
+    // The texture, and the rows of it that have changed
+    unsigned char * m_Texels;
+    int m_DirtyTop;
+    int m_DirtyBottom;
+
+    // The glyph table (open addressing, so that a lookup usually touches a single
+    // cache line), and a spare table of the same size that it is rebuilt into when
+    // a page is evicted. The ASCII characters are also kept in a table of their own
+    GlyphCacheEntry_s * m_Entries;
+    GlyphCacheEntry_s * m_SpareEntries;
+    unsigned int m_EntryCapacity;
+    unsigned int m_EntryCount;
+    unsigned int m_EntryShift;
+
+    GlyphCacheEntry_s m_AsciiEntries[ AsciiCount ];
+
+    // The current frame
+    unsigned int m_Frame;
+
+    // Counts for 'GetNumCopiedGlyphs', 'GetNumMissingGlyphs' and 'GetNumEvictedPages'
+    unsigned int m_NumCopiedGlyphs;
+    unsigned int m_NumMissingGlyphs;
+    unsigned int m_NumEvictedPages;
+};
@@ -0,0 +1,348 @@
+/*=================================================================================
+
+    PROJECT:        Tiny Text Library for DirectX 10
+
+    AUTHOR:         James Bird (http://www.jb101.co.uk/)
+
+    DESCRIPTION:    The CPU text overlay. See 'TinyTextOverlay.h' for usage
+
+=================================================================================*/
+
+/*---------------------------------------------------------------------------------
+    Includes
+---------------------------------------------------------------------------------*/
+#include "TinyTextOverlay.h"
+#include <math.h>
+#include <string.h>
+#include <new>
+
+/*---------------------------------------------------------------------------------
+    Constants
+---------------------------------------------------------------------------------*/
+//namespace
+//{
+    // The elements of a character's vertices that are read - see
+    // 'RasterizerVertexElements' in 'TinyTextRasterizer.cpp'
+    enum OverlayVertexElements
+    {
+        BottomLeft_Position_X   = 0,
+        BottomLeft_Position_Y   = 1,
+        BottomLeft_UV           = 2,
+        Colour                  = 3,
+        TopRight_Position_X     = 12,
+        TopRight_Position_Y     = 13,
+        TopRight_UV             = 14
+    };
+//}
+
+/*---------------------------------------------------------------------------------
+    Private Implementation
+---------------------------------------------------------------------------------*/
+//namespace
+//{
+    /*---------------------------------------------------------------------------------
+        GetCoveredPixel
+        Decodes a position coordinate from the vertex stream, and returns the first
+        pixel whose centre is at or after it - the same rule, and the same arithmetic,
+        as the rasterizer. 'direction' is -1 for y, which points down the overlay
+    ---------------------------------------------------------------------------------*/
+    int GetCoveredPixel( unsigned int element, float direction, int size )
+    {
+        float coord;
+        memcpy( &coord, &element, sizeof( coord ) );
+        return int( ceil( ( 1.0f + direction * coord ) * 0.5f * size - 0.5f ) );
+    }
+
+    /*---------------------------------------------------------------------------------
+        HashCharacter
+        Returns a hash of everything that affects how a character is drawn
+    ---------------------------------------------------------------------------------*/
+    unsigned int HashCharacter( const unsigned int * character )
+    {
+        const int elements[] = { BottomLeft_Position_X, BottomLeft_Position_Y, BottomLeft_UV, Colour, TopRight_Position_X, TopRight_Position_Y, TopRight_UV };
+
+        unsigned int hash = 2166136261u;
+        for ( int i = 0; i < int( sizeof( elements ) / sizeof( elements[ 0 ] ) ); ++i )
+        {
+            hash = ( hash ^ character[ elements[ i ] ] ) * 16777619u;
+        }
+
+        // Mix the bits, so that sums of hashes (see 'HashCells') don't collide easily
+        hash ^= hash >> 16;
+        hash *= 0x85EBCA6B;
+        hash ^= hash >> 13;
+        hash *= 0xC2B2AE35;
+        hash ^= hash >> 16;
+
+        return hash;
+    }
+//}
+
+//namespace
+//{
+    /*---------------------------------------------------------------------------------
+        TinyTextOverlay_c::TinyTextOverlay_c
+        Constructor
+    ---------------------------------------------------------------------------------*/
+    TinyTextOverlay_c::TinyTextOverlay_c( )
+    :   m_Pixels( 0 ),
+        m_Width( 0 ),
+        m_Height( 0 ),
+        m_CellHashes( 0 ),
+        m_NewCellHashes( 0 ),
+        m_NumCellsX( 0 ),
+        m_NumCellsY( 0 ),
+        m_NumDirtyRects( 0 ),
+        m_NumDirtyPixels( 0 ),
+        m_Overflow( false ),
+        m_Invalid( false )
+    {
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextOverlay_c::~TinyTextOverlay_c
+        Destructor
+    ---------------------------------------------------------------------------------*/
+    TinyTextOverlay_c::~TinyTextOverlay_c( )
+    {
+        Release( );
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextOverlay_c::Initialise
+        Allocates a clear overlay
+    ---------------------------------------------------------------------------------*/
+    bool TinyTextOverlay_c::Initialise( int width, int height )
+    {
+        Release( );
+
+        if ( width <= 0 || height <= 0 )
+        {
+            return false;
+        }
+
+        const int numCellsX = ( ( width - 1 ) >> CellShiftX ) + 1;
+        const int numCellsY = ( ( height - 1 ) >> CellShiftY ) + 1;
+
+        m_Pixels = new ( std::nothrow ) unsigned char[ size_t( width ) * height * 4 ];
+        m_CellHashes = new ( std::nothrow ) unsigned int[ numCellsX * numCellsY ];
+        m_NewCellHashes = new ( std::nothrow ) unsigned int[ numCellsX * numCellsY ];
+
+        if ( !m_Pixels || !m_CellHashes || !m_NewCellHashes )
+        {
+            Release( );
+            return false;
+        }
+
+        // An empty cell hashes to zero, which matches the clear overlay
+        memset( m_Pixels, 0, size_t( width ) * height * 4 );
+        memset( m_CellHashes, 0, numCellsX * numCellsY * sizeof( unsigned int ) );
+
+        m_Width = width;
+        m_Height = height;
+        m_NumCellsX = numCellsX;
+        m_NumCellsY = numCellsY;
+
+        return true;
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextOverlay_c::Release
+        Releases the pixels and cells
+    ---------------------------------------------------------------------------------*/
+    void TinyTextOverlay_c::Release( )
+    {
+        delete [] m_Pixels;
+        delete [] m_CellHashes;
+        delete [] m_NewCellHashes;
+
+        m_Pixels = 0;
+        m_CellHashes = 0;
+        m_NewCellHashes = 0;
+        m_Width = 0;
+        m_Height = 0;
+        m_NumCellsX = 0;
+        m_NumCellsY = 0;
+        m_NumDirtyRects = 0;
+        m_NumDirtyPixels = 0;
+        m_Invalid = false;
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextOverlay_c::Invalidate
+        Makes the next update redraw the whole overlay
+    ---------------------------------------------------------------------------------*/
+    void TinyTextOverlay_c::Invalidate( )
+    {
+        m_Invalid = true;
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextOverlay_c::Update
+        Finds the cells that changed since the last frame, and redraws them
+    ---------------------------------------------------------------------------------*/
+    void TinyTextOverlay_c::Update( const unsigned int * vertices, unsigned int vertexCount )
+    {
+        m_NumDirtyRects = 0;
+        m_NumDirtyPixels = 0;
+        m_Overflow = false;
+
+        if ( !m_Pixels )
+        {
+            return;
+        }
+
+        HashCells( vertices, vertexCount, m_NewCellHashes );
+
+        // Collect runs of changed cells along each row into rectangles
+        for ( int y = 0; y < m_NumCellsY; ++y )
+        {
+            const unsigned int * oldHashes = m_CellHashes + y * m_NumCellsX;
+            const unsigned int * newHashes = m_NewCellHashes + y * m_NumCellsX;
+
+            int x = 0;
+            while ( x < m_NumCellsX )
+            {
+                if ( !m_Invalid && oldHashes[ x ] == newHashes[ x ] )
+                {
+                    ++x;
+                    continue;
+                }
+
+                int left = x;
+                while ( x < m_NumCellsX && ( m_Invalid || oldHashes[ x ] != newHashes[ x ] ) )
+                {
+                    ++x;
+                }
+
+                AddDirtyCells( left, x, y );
+            }
+        }
+
+        unsigned int * hashes = m_CellHashes;
+        m_CellHashes = m_NewCellHashes;
+        m_NewCellHashes = hashes;
+        m_Invalid = false;
+
+        // Clear and redraw each rectangle, converting it to pixels on the way
+        for ( unsigned int i = 0; i < m_NumDirtyRects; ++i )
+        {
+            TinyTextRect_s & rect = m_DirtyRects[ i ];
+
+            rect.left <<= CellShiftX;
+            rect.top <<= CellShiftY;
+            rect.right = ( rect.right << CellShiftX ) < m_Width ? ( rect.right << CellShiftX ) : m_Width;
+            rect.bottom = ( rect.bottom << CellShiftY ) < m_Height ? ( rect.bottom << CellShiftY ) : m_Height;
+
+            for ( int y = rect.top; y < rect.bottom; ++y )
+            {
+                memset( m_Pixels + ( y * m_Width + rect.left ) * 4, 0, ( rect.right - rect.left ) * 4 );
+            }
+
+            m_Rasterizer.Draw( vertices, vertexCount, m_Pixels, m_Width, m_Height, GetPitch( ), &rect );
+            m_NumDirtyPixels += ( rect.right - rect.left ) * ( rect.bottom - rect.top );
+        }
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextOverlay_c::HashCells
+        Sums the hashes of the characters that overlap each cell. Sums don't depend on
+        the order that characters are printed in, so only real changes are detected
+    ---------------------------------------------------------------------------------*/
+    void TinyTextOverlay_c::HashCells( const unsigned int * vertices, unsigned int vertexCount, unsigned int * cellHashes ) const
+    {
+        memset( cellHashes, 0, m_NumCellsX * m_NumCellsY * sizeof( unsigned int ) );
+
+        const unsigned int characterCount = vertexCount / TinyTextEncoder_c::NumVerticesPerCharacter;
+
+        for ( unsigned int i = 0; i < characterCount; ++i )
+        {
+            const unsigned int * character = vertices + i * TinyTextEncoder_c::NumVertexElementsPerCharacter;
+
+            // The pixels covered by the character, clipped to the overlay
+            int left = GetCoveredPixel( character[ BottomLeft_Position_X ], 1.0f, m_Width );
+            int right = GetCoveredPixel( character[ TopRight_Position_X ], 1.0f, m_Width );
+            int top = GetCoveredPixel( character[ TopRight_Position_Y ], -1.0f, m_Height );
+            int bottom = GetCoveredPixel( character[ BottomLeft_Position_Y ], -1.0f, m_Height );
+
+            left = left < 0 ? 0 : left;
+            top = top < 0 ? 0 : top;
+            right = right > m_Width ? m_Width : right;
+            bottom = bottom > m_Height ? m_Height : bottom;
+
+            if ( right <= left || bottom <= top )
+            {
+                continue;
+            }
+
+            const unsigned int hash = HashCharacter( character );
+
+            for ( int y = top >> CellShiftY; y <= ( bottom - 1 ) >> CellShiftY; ++y )
+            {
+                for ( int x = left >> CellShiftX; x <= ( right - 1 ) >> CellShiftX; ++x )
+                {
+                    cellHashes[ y * m_NumCellsX + x ] += hash;
+                }
+            }
+        }
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextOverlay_c::AddDirtyCells
+        Adds a run of changed cells to the dirty rectangles - extending a rectangle
+        that covers the same columns of the row above, if there is one
+    ---------------------------------------------------------------------------------*/
+    void TinyTextOverlay_c::AddDirtyCells( int left, int right, int row )
+    {
+        if ( m_Overflow )
+        {
+            TinyTextRect_s & bounds = m_DirtyRects[ 0 ];
+
+            if ( left < bounds.left ) bounds.left = left;
+            if ( right > bounds.right ) bounds.right = right;
+            bounds.bottom = row + 1;
+            return;
+        }
+
+        for ( unsigned int i = 0; i < m_NumDirtyRects; ++i )
+        {
+            TinyTextRect_s & rect = m_DirtyRects[ i ];
+
+            if ( rect.left == left && rect.right == right && rect.bottom == row )
+            {
+                rect.bottom = row + 1;
+                return;
+            }
+        }
+
+        if ( m_NumDirtyRects < MaxDirtyRects )
+        {
+            TinyTextRect_s & rect = m_DirtyRects[ m_NumDirtyRects++ ];
+
+            rect.left = left;
+            rect.top = row;
+            rect.right = right;
+            rect.bottom = row + 1;
+            return;
+        }
+
+        // Too many rectangles - replace them with one that encloses them all
+        TinyTextRect_s bounds = m_DirtyRects[ 0 ];
+
+        for ( unsigned int i = 1; i < m_NumDirtyRects; ++i )
+        {
+            const TinyTextRect_s & rect = m_DirtyRects[ i ];
+
+            if ( rect.left < bounds.left ) bounds.left = rect.left;
+            if ( rect.top < bounds.top ) bounds.top = rect.top;
+            if ( rect.right > bounds.right ) bounds.right = rect.right;
+            if ( rect.bottom > bounds.bottom ) bounds.bottom = rect.bottom;
+        }
+
+        m_DirtyRects[ 0 ] = bounds;
+        m_NumDirtyRects = 1;
+        m_Overflow = true;
+
+        AddDirtyCells( left, right, row );
+    }
+//}
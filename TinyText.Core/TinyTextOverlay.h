@@ -0,0 +1,124 @@
+/*=================================================================================
+
+    PROJECT:        Tiny Text Library for DirectX 10
+
+    AUTHOR:         James Bird (http://www.jb101.co.uk/)
+
+    DESCRIPTION:    A text overlay rendered on the CPU, which only redraws the parts
+                    that change from one frame to the next
+
+    USAGE:          - Encode each frame of text with 'TinyTextEncoder_c', using the
+                      size of the overlay as the viewport, then pass the vertices
+                      to 'TinyTextOverlay_c::Update'
+
+                    - The overlay is an RGBA image (see 'TinyTextRasterizer.h').
+                      Pixels without text are zero, so the overlay can be
+                      composited with its alpha
+
+                    - The overlay is divided into cells, and each cell keeps a
+                      hash of the characters that overlap it. 'Update' compares
+                      these with the previous frame's, clears and redraws only
+                      the cells that differ, and reports them as a list of
+                      rectangles - so that whatever consumes the overlay (a
+                      compositor or video encoder, say) can also limit itself to
+                      the parts that changed
+
+                    - Like the blitter, the overlay draws the built-in font only
+
+=================================================================================*/
+#pragma once
+
+/*---------------------------------------------------------------------------------
+    Includes
+---------------------------------------------------------------------------------*/
+#include "TinyTextRasterizer.h"
+
+/*---------------------------------------------------------------------------------
+    TinyTextOverlay_c
+    An RGBA text overlay with dirty-rectangle tracking. For usage, see comments at
+    the top of this file
+---------------------------------------------------------------------------------*/
+class TinyTextOverlay_c
+{
+public:
+
+    // Changes are tracked in cells of 1 << 'CellShiftX' by 1 << 'CellShiftY' pixels
+    static const int CellShiftX = 5;
+    static const int CellShiftY = 4;
+
+    // Maximum number of rectangles reported by 'Update'. If more cells than this
+    // changed, a single rectangle enclosing them all is reported instead
+    static const unsigned int MaxDirtyRects = 64;
+
+    // Constructor - the overlay has no pixels until it has been initialised
+    TinyTextOverlay_c( );
+
+    // Destructor
+    ~TinyTextOverlay_c( );
+
+    // Allocates a clear overlay of the specified size (in pixels) - returns 'true' on
+    // success or 'false' on failure
+    bool Initialise( int width, int height );
+
+    // Brings the overlay up to date with a frame of text. 'vertexCount' vertices, as
+    // written by 'TinyTextEncoder_c' with a viewport the size of the overlay, replace
+    // those of the previous call
+    void Update( const unsigned int * vertices, unsigned int vertexCount );
+
+    // Makes the next call to 'Update' redraw the whole overlay
+    void Invalidate( );
+
+    // The overlay's pixels - four bytes each (red, green, blue and alpha), with
+    // 'GetPitch' bytes between rows
+    const unsigned char * GetPixels( ) const { return m_Pixels; }
+    int GetWidth( ) const { return m_Width; }
+    int GetHeight( ) const { return m_Height; }
+    int GetPitch( ) const { return m_Width * 4; }
+
+    // The rectangles redrawn by the last call to 'Update' (in pixels), which don't
+    // overlap. None are reported if nothing changed
+    unsigned int GetNumDirtyRects( ) const { return m_NumDirtyRects; }
+    const TinyTextRect_s * GetDirtyRects( ) const { return m_DirtyRects; }
+
+    // Number of pixels redrawn by the last call to 'Update'
+    unsigned int GetNumDirtyPixels( ) const { return m_NumDirtyPixels; }
+
+private:
+
+    // Deliberately not implemented - this object cannot be copied or assigned to
+    TinyTextOverlay_c( const TinyTextOverlay_c & );
+    TinyTextOverlay_c & operator = ( const TinyTextOverlay_c & );
+
+    // Releases the pixels and cells
+    void Release( );
+
+    // Computes the hash of each cell for a frame of text
+    void HashCells( const unsigned int * vertices, unsigned int vertexCount, unsigned int * cellHashes ) const;
+
+    // Adds a run of changed cells (in cells) to the dirty rectangles
+    void AddDirtyCells( int left, int right, int row );
+
+    // Draws the text
+    TinyTextRasterizer_c m_Rasterizer;
+
+    // The overlay
+    unsigned char * m_Pixels;
+    int m_Width;
+    int m_Height;
+
+    // The hash of each cell for the last frame, and scratch space for the next
+    unsigned int * m_CellHashes;
+    unsigned int * m_NewCellHashes;
+    int m_NumCellsX;
+    int m_NumCellsY;
+
+    // The rectangles redrawn by the last update, in cells until they are redrawn.
+    // 'm_Overflow' is set if they have been merged into one
+    TinyTextRect_s m_DirtyRects[ MaxDirtyRects ];
+    unsigned int m_NumDirtyRects;
+    unsigned int m_NumDirtyPixels;
+    bool m_Overflow;
+
+    // Set by 'Invalidate'
+    bool m_Invalid;
+};
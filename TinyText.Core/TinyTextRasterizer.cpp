@@ -0,0 +1,310 @@
+/*=================================================================================
+
+    PROJECT:        Tiny Text Library for DirectX 10
+
+    AUTHOR:         James Bird (http://www.jb101.co.uk/)
+
+    DESCRIPTION:    The reference rasterizer. See 'TinyTextRasterizer.h' for usage
+
+=================================================================================*/
+
+/*---------------------------------------------------------------------------------
+    Includes
+---------------------------------------------------------------------------------*/
+#include "TinyTextRasterizer.h"
+#include <math.h>
+#include <string.h>
+
+/*---------------------------------------------------------------------------------
+    Constants
+---------------------------------------------------------------------------------*/
+//namespace
+//{
+    // The elements of a character's vertices that 'Draw' reads. The encoder writes
+    // each character as an axis-aligned quad, so its first vertex is the bottom-left
+    // corner and its fourth is the top-right corner - see 'VertexStreamElements' in
+    // 'TinyTextEncoder.cpp'
+    enum RasterizerVertexElements
+    {
+        BottomLeft_Position_X   = 0,
+        BottomLeft_Position_Y   = 1,
+        BottomLeft_UV           = 2,
+        Colour                  = 3,
+        TopRight_Position_X     = 12,
+        TopRight_Position_Y     = 13,
+        TopRight_UV             = 14
+    };
+//}
+
+/*---------------------------------------------------------------------------------
+    Private Implementation
+---------------------------------------------------------------------------------*/
+//namespace
+//{
+    /*---------------------------------------------------------------------------------
+        DecodePositionCoord
+        Decodes a position coordinate from the vertex stream
+    ---------------------------------------------------------------------------------*/
+    float DecodePositionCoord( unsigned int element )
+    {
+        float result;
+        memcpy( &result, &element, sizeof( result ) );
+        return result;
+    }
+
+    /*---------------------------------------------------------------------------------
+        GetFirstCoveredPixel
+        Returns the first pixel whose centre is at or after an edge - which is how
+        the top-left fill rule treats the left and top edges, and (as the first pixel
+        not covered) the right and bottom edges
+    ---------------------------------------------------------------------------------*/
+    int GetFirstCoveredPixel( float edge )
+    {
+        return int( ceil( edge - 0.5f ) );
+    }
+//}
+
+//namespace
+//{
+    /*---------------------------------------------------------------------------------
+        TinyTextRasterizer_c::TinyTextRasterizer_c
+        Constructor - decodes the font texture from its monochrome bitmap
+    ---------------------------------------------------------------------------------*/
+    TinyTextRasterizer_c::TinyTextRasterizer_c( )
+    :   m_Atlas( m_Font ),
+        m_AtlasWidth( FontTextureWidth ),
+        m_AtlasHeight( FontTextureHeight ),
+        m_SliceCount( 1 ),
+        m_FontArray( 0 ),
+        m_DistanceField( false )
+    {
+        TinyTextEncoder_c::GetFontTexels( m_Font );
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextRasterizer_c::~TinyTextRasterizer_c
+        Destructor
+    ---------------------------------------------------------------------------------*/
+    TinyTextRasterizer_c::~TinyTextRasterizer_c( )
+    {
+        ReleaseFontArray( );
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextRasterizer_c::ReleaseFontArray
+        Frees the texture array of 'SetFonts'
+    ---------------------------------------------------------------------------------*/
+    void TinyTextRasterizer_c::ReleaseFontArray( )
+    {
+        delete [] m_FontArray;
+        m_FontArray = 0;
+        m_SliceCount = 1;
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextRasterizer_c::SetFont
+        Draw with the atlas of a font pack, or the built-in font
+    ---------------------------------------------------------------------------------*/
+    void TinyTextRasterizer_c::SetFont( const TinyTextFontPack_c * font )
+    {
+        ReleaseFontArray( );
+
+        if ( font && font->IsOpen( ) )
+        {
+            m_Atlas = font->GetAtlas( );
+            m_AtlasWidth = font->GetHeader( )->atlasWidth;
+            m_AtlasHeight = font->GetHeader( )->atlasHeight;
+            m_DistanceField = font->IsDistanceField( );
+        }
+        else
+        {
+            m_Atlas = m_Font;
+            m_AtlasWidth = FontTextureWidth;
+            m_AtlasHeight = FontTextureHeight;
+            m_DistanceField = false;
+        }
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextRasterizer_c::SetFonts
+        Draw with the texture array of several fonts
+    ---------------------------------------------------------------------------------*/
+    bool TinyTextRasterizer_c::SetFonts( const TinyTextFontPack_c * const * fonts, unsigned int fontCount )
+    {
+        if ( !TinyTextEncoder_c::ValidateFonts( fonts, fontCount ) )
+        {
+            return false;
+        }
+
+        int width;
+        int height;
+        unsigned char * fontArray = TinyTextEncoder_c::CreateFontArray( fonts, fontCount, &width, &height );
+
+        if ( !fontArray )
+        {
+            return false;
+        }
+
+        ReleaseFontArray( );
+
+        m_FontArray = fontArray;
+        m_Atlas = fontArray;
+        m_AtlasWidth = width;
+        m_AtlasHeight = height;
+        m_SliceCount = fontCount;
+        m_DistanceField = fonts[ 0 ] && fonts[ 0 ]->IsDistanceField( );
+
+        return true;
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextRasterizer_c::SetGlyphCache
+        Draw with the texture of a glyph cache
+    ---------------------------------------------------------------------------------*/
+    void TinyTextRasterizer_c::SetGlyphCache( const TinyTextGlyphCache_c * glyphCache )
+    {
+        ReleaseFontArray( );
+
+        m_Atlas = glyphCache->GetTexels( );
+        m_AtlasWidth = glyphCache->GetTextureWidth( );
+        m_AtlasHeight = glyphCache->GetTextureHeight( );
+        m_DistanceField = glyphCache->IsDistanceField( );
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextRasterizer_c::Draw
+        Draws encoded text into an RGBA image
+    ---------------------------------------------------------------------------------*/
+    void TinyTextRasterizer_c::Draw( const unsigned int * vertices, unsigned int vertexCount, unsigned char * pixels, int width, int height, int pitch, const TinyTextRect_s * clipRect ) const
+    {
+        const unsigned int characterCount = vertexCount / TinyTextEncoder_c::NumVerticesPerCharacter;
+
+        // The pixels that may be written
+        int clipLeft = 0;
+        int clipTop = 0;
+        int clipRight = width;
+        int clipBottom = height;
+
+        if ( clipRect )
+        {
+            if ( clipRect->left > clipLeft ) clipLeft = clipRect->left;
+            if ( clipRect->top > clipTop ) clipTop = clipRect->top;
+            if ( clipRect->right < clipRight ) clipRight = clipRect->right;
+            if ( clipRect->bottom < clipBottom ) clipBottom = clipRect->bottom;
+        }
+
+        for ( unsigned int i = 0; i < characterCount; ++i )
+        {
+            const unsigned int * character = vertices + i * TinyTextEncoder_c::NumVertexElementsPerCharacter;
+
+            // Viewport transform - from clip space to pixels, with y pointing down
+            float left = ( DecodePositionCoord( character[ BottomLeft_Position_X ] ) + 1.0f ) * 0.5f * width;
+            float bottom = ( 1.0f - DecodePositionCoord( character[ BottomLeft_Position_Y ] ) ) * 0.5f * height;
+            float right = ( DecodePositionCoord( character[ TopRight_Position_X ] ) + 1.0f ) * 0.5f * width;
+            float top = ( 1.0f - DecodePositionCoord( character[ TopRight_Position_Y ] ) ) * 0.5f * height;
+
+            // Texture coordinates, in texels. The top bit of each selects the slice of
+            // the texture array, which is clamped to the slices there are, as the GPU
+            // does
+            float leftU = float( character[ BottomLeft_UV ] & 0x7FFF );
+            float bottomV = float( ( character[ BottomLeft_UV ] >> 16 ) & 0x7FFF );
+            float rightU = float( character[ TopRight_UV ] & 0x7FFF );
+            float topV = float( ( character[ TopRight_UV ] >> 16 ) & 0x7FFF );
+
+            unsigned int sliceIndex = ( ( character[ BottomLeft_UV ] >> 15 ) & 1 ) | ( ( character[ BottomLeft_UV ] >> 30 ) & 2 );
+            sliceIndex = sliceIndex < m_SliceCount ? sliceIndex : m_SliceCount - 1;
+
+            const unsigned char * slice = m_Atlas + size_t( sliceIndex ) * m_AtlasWidth * m_AtlasHeight;
+
+            if ( right <= left || bottom <= top )
+            {
+                continue;
+            }
+
+            // The pixels whose centres are covered, clipped
+            int x0 = GetFirstCoveredPixel( left );
+            int x1 = GetFirstCoveredPixel( right );
+            int y0 = GetFirstCoveredPixel( top );
+            int y1 = GetFirstCoveredPixel( bottom );
+
+            x0 = x0 < clipLeft ? clipLeft : x0;
+            y0 = y0 < clipTop ? clipTop : y0;
+            x1 = x1 > clipRight ? clipRight : x1;
+            y1 = y1 > clipBottom ? clipBottom : y1;
+
+            // Texture coordinates change linearly across the quad
+            float uPerPixel = ( rightU - leftU ) / ( right - left );
+            float vPerPixel = ( bottomV - topV ) / ( bottom - top );
+
+            unsigned int colour = character[ Colour ];
+            unsigned char red = ( unsigned char )( colour );
+            unsigned char green = ( unsigned char )( colour >> 8 );
+            unsigned char blue = ( unsigned char )( colour >> 16 );
+            unsigned char alpha = ( unsigned char )( colour >> 24 );
+
+            for ( int y = y0; y < y1; ++y )
+            {
+                float v = topV + ( y + 0.5f - top ) * vPerPixel;
+                unsigned char * pixel = pixels + y * pitch + x0 * 4;
+
+                for ( int x = x0; x < x1; ++x, pixel += 4 )
+                {
+                    if ( !IsDrawn( slice, leftU + ( x + 0.5f - left ) * uPerPixel, v ) )
+                    {
+                        continue;
+                    }
+
+                    pixel[ 0 ] = red;
+                    pixel[ 1 ] = green;
+                    pixel[ 2 ] = blue;
+                    pixel[ 3 ] = alpha;
+                }
+            }
+        }
+    }
+
+    /*---------------------------------------------------------------------------------
+        TinyTextRasterizer_c::IsDrawn
+        Samples a slice of the font texture as the pixel shader does
+    ---------------------------------------------------------------------------------*/
+    bool TinyTextRasterizer_c::IsDrawn( const unsigned char * slice, float u, float v ) const
+    {
+        if ( !m_DistanceField )
+        {
+            // Point sampling takes the texel that contains the coordinate, and texels
+            // that aren't white are discarded
+            int texelU = int( floor( u ) );
+            int texelV = int( floor( v ) );
+
+            return texelU >= 0 && texelU < m_AtlasWidth && texelV >= 0 && texelV < m_AtlasHeight && slice[ texelV * m_AtlasWidth + texelU ] == 0xFF;
+        }
+
+        // Bilinear sampling blends the four texels whose centres surround the
+        // coordinate, clamping at the edges of the texture
+        float s = u - 0.5f;
+        float t = v - 0.5f;
+        float s0 = floor( s );
+        float t0 = floor( t );
+        float fractionS = s - s0;
+        float fractionT = t - t0;
+
+        int texelU[ 2 ] = { int( s0 ), int( s0 ) + 1 };
+        int texelV[ 2 ] = { int( t0 ), int( t0 ) + 1 };
+
+        for ( int i = 0; i < 2; ++i )
+        {
+            texelU[ i ] = texelU[ i ] < 0 ? 0 : ( texelU[ i ] >= m_AtlasWidth ? m_AtlasWidth - 1 : texelU[ i ] );
+            texelV[ i ] = texelV[ i ] < 0 ? 0 : ( texelV[ i ] >= m_AtlasHeight ? m_AtlasHeight - 1 : texelV[ i ] );
+        }
+
+        const unsigned char * topRow = slice + texelV[ 0 ] * m_AtlasWidth;
+        const unsigned char * bottomRow = slice + texelV[ 1 ] * m_AtlasWidth;
+
+        float topValue = topRow[ texelU[ 0 ] ] + ( topRow[ texelU[ 1 ] ] - topRow[ texelU[ 0 ] ] ) * fractionS;
+        float bottomValue = bottomRow[ texelU[ 0 ] ] + ( bottomRow[ texelU[ 1 ] ] - bottomRow[ texelU[ 0 ] ] ) * fractionS;
+        float value = topValue + ( bottomValue - topValue ) * fractionT;
+
+        // Distances below 0.5 (outside the glyph) are discarded
+        return value >= 0.5f * 255.0f;
+    }
+//}
@@ -0,0 +1,121 @@
+/*=================================================================================
+
+    PROJECT:        Tiny Text Library for DirectX 10
+
+    AUTHOR:         James Bird (http://www.jb101.co.uk/)
+
+    DESCRIPTION:    A reference rasterizer that draws the encoder's vertices on the
+                    CPU, producing the same pixels as 'TinyTextContext_c::Render'
+
+    USAGE:          - Encode text with 'TinyTextEncoder_c' into a plain block of
+                      memory, then pass the vertices to
+                      'TinyTextRasterizer_c::Draw' along with an RGBA image the
+                      size of the viewport
+
+                    - Neither the encoder nor the rasterizer needs Direct3D (or
+                      Windows), so rendering can be checked pixel-for-pixel
+                      against golden images on any platform
+
+                    - 'Draw' follows the pipeline that 'Render' sets up: the
+                      positions are in clip space and are mapped onto the image
+                      as the viewport transform would, pixels are covered when
+                      their centres lie inside a character (using the top-left
+                      fill rule), the font is point sampled, texels below 1.0
+                      are discarded as in 'PSMain', and the vertex colour is
+                      written without blending
+
+                    - To check text printed with a font pack, pass the same
+                      pack to 'TinyTextRasterizer_c::SetFont'. For text printed
+                      through a glyph cache, pass the cache to
+                      'TinyTextRasterizer_c::SetGlyphCache' before it is evicted
+                      from
+
+                    - For text printed in several fonts, pass the same fonts to
+                      'TinyTextRasterizer_c::SetFonts'. They are copied into a
+                      texture array laid out as the contexts lay theirs out, and
+                      each character is drawn from the slice that its texture
+                      coordinates select
+
+                    - Distance field fonts are sampled bilinearly, clamped to
+                      the edges of the texture, and pixels below 0.5 are
+                      discarded as in 'PSMainDistanceField'. GPUs filter with
+                      less precision than this, so pixels that sample the field
+                      right at the edge of a glyph may differ
+
+=================================================================================*/
+#pragma once
+
+/*---------------------------------------------------------------------------------
+    Includes
+---------------------------------------------------------------------------------*/
+#include "TinyTextEncoder.h"
+
+/*---------------------------------------------------------------------------------
+    TinyTextRasterizer_c
+    Draws encoded text into an image on the CPU. For usage, see comments at the top
+    of this file
+---------------------------------------------------------------------------------*/
+class TinyTextRasterizer_c
+{
+public:
+
+    // Constructor - decodes the font texture
+    TinyTextRasterizer_c( );
+
+    // Destructor - frees the texture array of 'SetFonts' (if any)
+    ~TinyTextRasterizer_c( );
+
+    // Draws 'vertexCount' vertices, as written by 'TinyTextEncoder_c', into an image
+    // of 'width' by 'height' pixels with 'pitch' bytes between rows. Each pixel is
+    // four bytes: red, green, blue and alpha. If 'clipRect' is set, only the pixels
+    // inside it are written
+    void Draw( const unsigned int * vertices, unsigned int vertexCount, unsigned char * pixels, int width, int height, int pitch, const TinyTextRect_s * clipRect = 0 ) const;
+
+    // Draw with the atlas of a font pack, or the built-in font if 'font' is NULL.
+    // The atlas isn't copied, so the pack must stay open while it is used
+    void SetFont( const TinyTextFontPack_c * font );
+
+    // Draw with several fonts, as selected with 'TinyTextEncoder_c::SetFonts'.
+    // Unlike 'SetFont', the atlases are copied. Returns 'false' (and keeps the current
+    // font) if the fonts can't be selected together or there isn't enough memory
+    bool SetFonts( const TinyTextFontPack_c * const * fonts, unsigned int fontCount );
+
+    // Draw with the texture of a glyph cache. Like a font pack, the texture isn't
+    // copied, so the cache must outlive the rasterizer or be replaced first
+    void SetGlyphCache( const TinyTextGlyphCache_c * glyphCache );
+
+    // Size of the built-in font texture, in texels
+    static const int FontTextureWidth = TinyTextEncoder_c::FontTextureWidth;
+    static const int FontTextureHeight = TinyTextEncoder_c::FontTextureHeight;
+
+private:
+
+    // Deliberately not implemented - this object cannot be copied or assigned to
+    TinyTextRasterizer_c( const TinyTextRasterizer_c & );
+    TinyTextRasterizer_c & operator = ( const TinyTextRasterizer_c & );
+
+    // Returns 'true' if a slice of the font texture at the specified point (in
+    // texels) is drawn
+    bool IsDrawn( const unsigned char * slice, float u, float v ) const;
+
+    // Frees the texture array of 'SetFonts'
+    void ReleaseFontArray( );
+
+    // The built-in font texture, top row first - one byte per texel, which is 255
+    // where the texture is white (the only value that 'PSMain' keeps) and 0
+    // elsewhere, as in the atlas of a font pack
+    unsigned char m_Font[ FontTextureWidth * FontTextureHeight ];
+
+    // The font texture being drawn with, the size of each of its slices, and the
+    // number of slices
+    const unsigned char * m_Atlas;
+    int m_AtlasWidth;
+    int m_AtlasHeight;
+    unsigned int m_SliceCount;
+
+    // The texture array created by 'SetFonts', or NULL
+    unsigned char * m_FontArray;
+
+    // Set if the texture is a distance field
+    bool m_DistanceField;
+};
@@ -0,0 +1,1316 @@
+/*=================================================================================
+
+    PROJECT:        Tiny Text Library for DirectX 10
+
+    DESCRIPTION:    Compiles fonts into font packs (see 'TinyTextFontPack.h'), so
+                    that the library can load them without parsing anything
+
+    USAGE:          TinyText.FontCompiler <source> [options] <output file>
+
+                    - The source is one of:
+
+                        - '--bmfont <file.fnt>': a font exported by AngelCode
+                          BMFont in its text format, with its pages saved as
+                          uncompressed .tga files
+
+                        - '--builtin': the library's built-in font, which draws
+                          exactly as it does without a pack
+
+                        - '--truetype <face name>' (Windows only): an installed
+                          font, or the font in '--font-file <file.ttf>',
+                          rendered by GDI at '--size <pixels>' (16 by default)
+
+                    - '--range <first>-<last>' selects the code points taken from
+                      a TrueType font, and may be repeated. By default, these
+                      are the printable characters of Windows-1252
+
+                    - Texels are kept where the source is at least
+                      '--threshold <value>' (128 by default, out of 255), as
+                      the shaders draw only the texels that are fully on
+
+                    - '--distance-field <spread>' compiles a distance field pack
+                      instead (see 'TinyTextFontPack.h'), which can be drawn at
+                      any size. The field is generated from the kept texels,
+                      and covers 'spread' texels either side of each edge, so
+                      each glyph grows by that much on every side. Compile the
+                      source at the largest size it is needed at - the field
+                      stays sharp when shrunk, and rounds off corners when
+                      enlarged
+
+                    - Glyphs are packed into shelves, tallest first, with a one
+                      texel gutter, in the smallest power-of-two atlas that
+                      holds them. The pack is checked by loading it before the
+                      compiler exits
+
+                    - Each character's cell is as wide as the widest advance of
+                      the font, and as tall as its line height
+
+                    - '--proportional' compiles a proportional pack, where each
+                      character is as wide as its own advance. The font's
+                      kerning pairs (BMFont 'kerning' lines, or those that GDI
+                      returns for a TrueType font) are kept, for the characters
+                      that are in the pack
+
+=================================================================================*/
+
+/*---------------------------------------------------------------------------------
+    Includes
+---------------------------------------------------------------------------------*/
+#include "../TinyText.Core/TinyTextEncoder.h"
+#include "../TinyText.Core/TinyTextFontPack.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#if defined( _WIN32 )
+#include <windows.h>
+#endif
+
+/*---------------------------------------------------------------------------------
+    Constants
+---------------------------------------------------------------------------------*/
+//namespace
+//{
+    // Texels at or above this value are kept, unless overridden on the command line
+    const int           DefaultThreshold        = 128;
+
+    // Size (in pixels) that TrueType fonts are rendered at, unless overridden
+    const int           DefaultTrueTypeSize     = 16;
+
+    // Space left between glyphs in the atlas, in texels
+    const int           AtlasGutter             = 1;
+
+    // Largest spread of a distance field, in texels
+    const int           MaxDistanceFieldSpread  = 32;
+
+    // Largest kerning (in pixels, either way) that the encoder keeps
+    const int           MaxKerningAmount        = 127;
+
+    // Largest atlas that will be tried - the largest texture that every Direct3D 11
+    // device supports
+    const int           MaxAtlasSize            = 16384;
+
+    // Limits on the command line and on BMFont files
+    const int           MaxRanges               = 64;
+    const int           MaxPages                = 16;
+    const size_t        MaxPathLength           = 1024;
+
+    // Size of the header of a .tga file
+    const size_t        TgaHeaderByteCount      = 18;
+//}
+
+/*---------------------------------------------------------------------------------
+    Private Implementation
+---------------------------------------------------------------------------------*/
+//namespace
+//{
+    /*---------------------------------------------------------------------------------
+        SourceGlyph_s
+        A glyph read from the source font, before it is packed
+    ---------------------------------------------------------------------------------*/
+    struct SourceGlyph_s
+    {
+        unsigned int codePoint;
+        int width;
+        int height;
+        int xOffset;
+        int yOffset;
+        int advance;
+        unsigned char * texels;     // 'width' * 'height', top row first - 255 or 0
+        int u;                      // Position in the atlas, once packed
+        int v;
+    };
+
+    /*---------------------------------------------------------------------------------
+        SourceFont_s
+        The glyphs read from the source font
+    ---------------------------------------------------------------------------------*/
+    struct SourceFont_s
+    {
+        SourceGlyph_s * glyphs;
+        unsigned int glyphCount;
+        unsigned int glyphCapacity;
+        TinyTextFontKerningPair_s * kerningPairs;
+        unsigned int kerningCount;
+        unsigned int kerningCapacity;
+        int lineHeight;
+    };
+
+    /*---------------------------------------------------------------------------------
+        CodePointRange_s
+        A range of code points, inclusive
+    ---------------------------------------------------------------------------------*/
+    struct CodePointRange_s
+    {
+        unsigned int first;
+        unsigned int last;
+    };
+
+    /*---------------------------------------------------------------------------------
+        TgaImage_s
+        A page of a BMFont font, top row first
+    ---------------------------------------------------------------------------------*/
+    struct TgaImage_s
+    {
+        int width;
+        int height;
+        int bytesPerPixel;          // 1 (grey), 3 (blue, green, red) or 4 (and alpha)
+        unsigned char * pixels;
+    };
+
+    /*---------------------------------------------------------------------------------
+        AddSourceGlyph
+        Adds a glyph to a font, with room for its texels - returns NULL if out of
+        memory
+    ---------------------------------------------------------------------------------*/
+    SourceGlyph_s * AddSourceGlyph( SourceFont_s * font, unsigned int codePoint, int width, int height )
+    {
+        if ( font->glyphCount == font->glyphCapacity )
+        {
+            unsigned int capacity = font->glyphCapacity ? font->glyphCapacity * 2 : 256;
+            SourceGlyph_s * glyphs = ( SourceGlyph_s * ) realloc( font->glyphs, capacity * sizeof( SourceGlyph_s ) );
+            if ( !glyphs )
+            {
+                return 0;
+            }
+
+            font->glyphs = glyphs;
+            font->glyphCapacity = capacity;
+        }
+
+        unsigned char * texels = 0;
+        if ( width > 0 && height > 0 )
+        {
+            texels = ( unsigned char * ) calloc( size_t( width ) * height, 1 );
+            if ( !texels )
+            {
+                return 0;
+            }
+        }
+
+        SourceGlyph_s * glyph = &font->glyphs[ font->glyphCount++ ];
+        memset( glyph, 0, sizeof( SourceGlyph_s ) );
+        glyph->codePoint = codePoint;
+        glyph->width = width;
+        glyph->height = height;
+        glyph->texels = texels;
+
+        return glyph;
+    }
+
+    /*---------------------------------------------------------------------------------
+        AddSourceKerningPair
+        Adds a kerning pair to a font - returns 'false' if out of memory
+    ---------------------------------------------------------------------------------*/
+    bool AddSourceKerningPair( SourceFont_s * font, unsigned int first, unsigned int second, int amount )
+    {
+        if ( font->kerningCount == font->kerningCapacity )
+        {
+            unsigned int capacity = font->kerningCapacity ? font->kerningCapacity * 2 : 256;
+            TinyTextFontKerningPair_s * pairs = ( TinyTextFontKerningPair_s * ) realloc( font->kerningPairs, capacity * sizeof( TinyTextFontKerningPair_s ) );
+            if ( !pairs )
+            {
+                return false;
+            }
+
+            font->kerningPairs = pairs;
+            font->kerningCapacity = capacity;
+        }
+
+        TinyTextFontKerningPair_s & pair = font->kerningPairs[ font->kerningCount++ ];
+        pair.first = first;
+        pair.second = second;
+        pair.amount = amount;
+
+        return true;
+    }
+
+    /*---------------------------------------------------------------------------------
+        FreeSourceFont
+        Frees the glyphs and kerning pairs of a font
+    ---------------------------------------------------------------------------------*/
+    void FreeSourceFont( SourceFont_s * font )
+    {
+        for ( unsigned int i = 0; i < font->glyphCount; ++i )
+        {
+            free( font->glyphs[ i ].texels );
+        }
+
+        free( font->glyphs );
+        free( font->kerningPairs );
+        memset( font, 0, sizeof( SourceFont_s ) );
+    }
+
+    /*---------------------------------------------------------------------------------
+        ReadWholeFile
+        Reads a file into memory, followed by a terminating zero. The caller must free
+        the contents
+    ---------------------------------------------------------------------------------*/
+    unsigned char * ReadWholeFile( const char * fileName, size_t * byteCount )
+    {
+        FILE * file = fopen( fileName, "rb" );
+        if ( !file )
+        {
+            return 0;
+        }
+
+        unsigned char * data = 0;
+        long size = 0;
+
+        if ( fseek( file, 0, SEEK_END ) == 0 && ( size = ftell( file ) ) >= 0 && fseek( file, 0, SEEK_SET ) == 0 )
+        {
+            data = ( unsigned char * ) malloc( size_t( size ) + 1 );
+        }
+
+        if ( data && fread( data, 1, size_t( size ), file ) != size_t( size ) )
+        {
+            free( data );
+            data = 0;
+        }
+
+        fclose( file );
+
+        if ( data )
+        {
+            data[ size ] = 0;
+            *byteCount = size_t( size );
+        }
+
+        return data;
+    }
+
+    /*---------------------------------------------------------------------------------
+        LoadTga
+        Loads an uncompressed true-colour or greyscale .tga file
+    ---------------------------------------------------------------------------------*/
+    bool LoadTga( const char * fileName, TgaImage_s * image )
+    {
+        size_t byteCount;
+        unsigned char * data = ReadWholeFile( fileName, &byteCount );
+        if ( !data )
+        {
+            fprintf( stderr, "%s: couldn't read file\n", fileName );
+            return false;
+        }
+
+        bool valid = byteCount >= TgaHeaderByteCount;
+
+        int imageType = valid ? data[ 2 ] : 0;
+        int width = valid ? data[ 12 ] | ( data[ 13 ] << 8 ) : 0;
+        int height = valid ? data[ 14 ] | ( data[ 15 ] << 8 ) : 0;
+        int bitsPerPixel = valid ? data[ 16 ] : 0;
+        bool topFirst = valid && ( data[ 17 ] & 0x20 ) != 0;
+        size_t pixelOffset = valid ? TgaHeaderByteCount + data[ 0 ] : 0;
+
+        valid = valid
+             && data[ 1 ] == 0
+             && ( ( imageType == 2 && ( bitsPerPixel == 24 || bitsPerPixel == 32 ) ) || ( imageType == 3 && bitsPerPixel == 8 ) )
+             && width > 0
+             && height > 0
+             && pixelOffset + size_t( width ) * height * ( bitsPerPixel / 8 ) <= byteCount;
+
+        if ( !valid )
+        {
+            fprintf( stderr, "%s: only uncompressed 8, 24 and 32 bit .tga files are supported\n", fileName );
+            free( data );
+            return false;
+        }
+
+        const int bytesPerPixel = bitsPerPixel / 8;
+        const size_t rowByteCount = size_t( width ) * bytesPerPixel;
+
+        image->pixels = ( unsigned char * ) malloc( rowByteCount * height );
+        if ( !image->pixels )
+        {
+            free( data );
+            return false;
+        }
+
+        for ( int y = 0; y < height; ++y )
+        {
+            const unsigned char * row = data + pixelOffset + ( topFirst ? y : height - 1 - y ) * rowByteCount;
+            memcpy( image->pixels + y * rowByteCount, row, rowByteCount );
+        }
+
+        image->width = width;
+        image->height = height;
+        image->bytesPerPixel = bytesPerPixel;
+
+        free( data );
+        return true;
+    }
+
+    /*---------------------------------------------------------------------------------
+        GetTgaValue
+        Returns the value of a texel of a BMFont page, from the channel that the
+        glyph is stored in ('chnl' - 1 blue, 2 green, 4 red, 8 alpha, 15 all)
+    ---------------------------------------------------------------------------------*/
+    int GetTgaValue( const TgaImage_s & image, int x, int y, int channel )
+    {
+        if ( x < 0 || y < 0 || x >= image.width || y >= image.height )
+        {
+            return 0;
+        }
+
+        const unsigned char * pixel = image.pixels + ( size_t( y ) * image.width + x ) * image.bytesPerPixel;
+
+        if ( image.bytesPerPixel == 1 )
+        {
+            return pixel[ 0 ];
+        }
+
+        switch ( channel )
+        {
+        case 1:     return pixel[ 0 ];
+        case 2:     return pixel[ 1 ];
+        case 4:     return pixel[ 2 ];
+        default:    return image.bytesPerPixel == 4 ? pixel[ 3 ] : pixel[ 2 ];
+        }
+    }
+
+    /*---------------------------------------------------------------------------------
+        GetFntValue
+        Reads the integer value of a 'key=value' pair from a line of a BMFont file -
+        returns 'false' if the line doesn't have the key
+    ---------------------------------------------------------------------------------*/
+    bool GetFntValue( const char * line, const char * lineEnd, const char * key, int * value )
+    {
+        const size_t keyLength = strlen( key );
+
+        for ( const char * c = line; c + keyLength < lineEnd; ++c )
+        {
+            if ( ( c == line || c[ -1 ] == ' ' || c[ -1 ] == '\t' ) && strncmp( c, key, keyLength ) == 0 && c[ keyLength ] == '=' )
+            {
+                *value = atoi( c + keyLength + 1 );
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    /*---------------------------------------------------------------------------------
+        GetFntString
+        Reads the quoted string value of a 'key="value"' pair from a line of a BMFont
+        file - returns 'false' if the line doesn't have the key
+    ---------------------------------------------------------------------------------*/
+    bool GetFntString( const char * line, const char * lineEnd, const char * key, char * value, size_t valueSize )
+    {
+        const size_t keyLength = strlen( key );
+
+        for ( const char * c = line; c + keyLength + 1 < lineEnd; ++c )
+        {
+            if ( ( c == line || c[ -1 ] == ' ' || c[ -1 ] == '\t' ) && strncmp( c, key, keyLength ) == 0 && c[ keyLength ] == '=' && c[ keyLength + 1 ] == '"' )
+            {
+                const char * first = c + keyLength + 2;
+                const char * last = first;
+                while ( last < lineEnd && *last != '"' )
+                {
+                    ++last;
+                }
+
+                if ( last == lineEnd || size_t( last - first ) >= valueSize )
+                {
+                    return false;
+                }
+
+                memcpy( value, first, last - first );
+                value[ last - first ] = '\0';
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    /*---------------------------------------------------------------------------------
+        LoadBMFont
+        Reads a BMFont text file, and the pages that it refers to
+    ---------------------------------------------------------------------------------*/
+    bool LoadBMFont( const char * fileName, int threshold, SourceFont_s * font )
+    {
+        size_t byteCount;
+        char * text = ( char * ) ReadWholeFile( fileName, &byteCount );
+        if ( !text )
+        {
+            fprintf( stderr, "%s: couldn't read file\n", fileName );
+            return false;
+        }
+
+        // Pages are named relative to the .fnt file
+        size_t directoryLength = 0;
+        for ( const char * c = fileName; *c; ++c )
+        {
+            if ( *c == '/' || *c == '\\' )
+            {
+                directoryLength = c + 1 - fileName;
+            }
+        }
+
+        TgaImage_s pages[ MaxPages ];
+        memset( pages, 0, sizeof( pages ) );
+
+        bool result = true;
+        const char * textEnd = text + byteCount;
+
+        for ( const char * line = text; result && line < textEnd; )
+        {
+            const char * lineEnd = line;
+            while ( lineEnd < textEnd && *lineEnd != '\n' )
+            {
+                ++lineEnd;
+            }
+
+            int value;
+
+            if ( strncmp( line, "common ", 7 ) == 0 )
+            {
+                result = GetFntValue( line, lineEnd, "lineHeight", &font->lineHeight );
+            }
+            else if ( strncmp( line, "page ", 5 ) == 0 )
+            {
+                char pageName[ MaxPathLength ];
+                char path[ MaxPathLength ];
+                int id = -1;
+
+                result = GetFntValue( line, lineEnd, "id", &id )
+                      && id >= 0 && id < MaxPages
+                      && GetFntString( line, lineEnd, "file", pageName, sizeof( pageName ) )
+                      && directoryLength + strlen( pageName ) < sizeof( path );
+
+                if ( result )
+                {
+                    memcpy( path, fileName, directoryLength );
+                    strcpy( path + directoryLength, pageName );
+                    result = LoadTga( path, &pages[ id ] );
+                }
+            }
+            else if ( strncmp( line, "char ", 5 ) == 0 && GetFntValue( line, lineEnd, "id", &value ) )
+            {
+                int x = 0, y = 0, width = 0, height = 0, xOffset = 0, yOffset = 0, advance = 0, page = 0, channel = 15;
+
+                GetFntValue( line, lineEnd, "x", &x );
+                GetFntValue( line, lineEnd, "y", &y );
+                GetFntValue( line, lineEnd, "width", &width );
+                GetFntValue( line, lineEnd, "height", &height );
+                GetFntValue( line, lineEnd, "xoffset", &xOffset );
+                GetFntValue( line, lineEnd, "yoffset", &yOffset );
+                GetFntValue( line, lineEnd, "xadvance", &advance );
+                GetFntValue( line, lineEnd, "page", &page );
+                GetFntValue( line, lineEnd, "chnl", &channel );
+
+                result = value >= 0 && width >= 0 && height >= 0 && page >= 0 && page < MaxPages && pages[ page ].pixels;
+
+                SourceGlyph_s * glyph = result ? AddSourceGlyph( font, ( unsigned int ) value, width, height ) : 0;
+                result = glyph != 0;
+
+                if ( result )
+                {
+                    glyph->xOffset = xOffset;
+                    glyph->yOffset = yOffset;
+                    glyph->advance = advance;
+
+                    for ( int j = 0; j < height; ++j )
+                    {
+                        for ( int i = 0; i < width; ++i )
+                        {
+                            glyph->texels[ j * width + i ] = GetTgaValue( pages[ page ], x + i, y + j, channel ) >= threshold ? 0xFF : 0;
+                        }
+                    }
+                }
+            }
+            else if ( strncmp( line, "kerning ", 8 ) == 0 )
+            {
+                int first = -1, second = -1, amount = 0;
+
+                GetFntValue( line, lineEnd, "first", &first );
+                GetFntValue( line, lineEnd, "second", &second );
+                GetFntValue( line, lineEnd, "amount", &amount );
+
+                result = first >= 0 && second >= 0 && AddSourceKerningPair( font, ( unsigned int ) first, ( unsigned int ) second, amount );
+            }
+
+            line = lineEnd + 1;
+        }
+
+        for ( int i = 0; i < MaxPages; ++i )
+        {
+            free( pages[ i ].pixels );
+        }
+
+        free( text );
+
+        if ( !result || font->lineHeight <= 0 )
+        {
+            fprintf( stderr, "%s: not a valid BMFont text file\n", fileName );
+            return false;
+        }
+
+        return true;
+    }
+
+    /*---------------------------------------------------------------------------------
+        LoadBuiltinFont
+        Reads the built-in font, through the encoder
+    ---------------------------------------------------------------------------------*/
+    bool LoadBuiltinFont( SourceFont_s * font )
+    {
+        const int textureSize = 128;
+
+        unsigned int byteCount;
+        const unsigned char * bitmap = TinyTextEncoder_c::GetFontBitmap( &byteCount );
+
+        // The bitmap is stored bottom-up, one bit per texel with rows padded to 4 bytes.
+        // Only the texels whose red channel is 1.0 are drawn
+        const unsigned char * pixels = bitmap + ( bitmap[ 10 ] | ( bitmap[ 11 ] << 8 ) | ( bitmap[ 12 ] << 16 ) | ( bitmap[ 13 ] << 24 ) );
+        const unsigned char * palette = bitmap + 14 + ( bitmap[ 14 ] | ( bitmap[ 15 ] << 8 ) | ( bitmap[ 16 ] << 16 ) | ( bitmap[ 17 ] << 24 ) );
+        const unsigned char values[ 2 ] = { ( unsigned char )( palette[ 2 ] == 0xFF ? 0xFF : 0 ), ( unsigned char )( palette[ 6 ] == 0xFF ? 0xFF : 0 ) };
+        const int rowByteCount = textureSize / 8;
+
+        TinyTextEncoder_c encoder;
+
+        for ( unsigned int character = 0; character < 256; ++character )
+        {
+            TinyTextFontGlyph_s fontGlyph;
+            encoder.GetFontGlyph( ( unsigned char ) character, &fontGlyph );
+
+            SourceGlyph_s * glyph = AddSourceGlyph( font, fontGlyph.codePoint, fontGlyph.width, fontGlyph.height );
+            if ( !glyph )
+            {
+                return false;
+            }
+
+            glyph->xOffset = fontGlyph.xOffset;
+            glyph->yOffset = fontGlyph.yOffset;
+            glyph->advance = fontGlyph.advance;
+
+            for ( int y = 0; y < glyph->height; ++y )
+            {
+                int v = fontGlyph.v + y;
+                const unsigned char * row = pixels + ( textureSize - 1 - v ) * rowByteCount;
+
+                for ( int x = 0; x < glyph->width; ++x )
+                {
+                    int u = fontGlyph.u + x;
+                    if ( u < textureSize && v < textureSize )
+                    {
+                        glyph->texels[ y * glyph->width + x ] = values[ ( row[ u / 8 ] >> ( 7 - u % 8 ) ) & 1 ];
+                    }
+                }
+            }
+        }
+
+        font->lineHeight = encoder.GetLineHeight( );
+        return true;
+    }
+
+#if defined( _WIN32 )
+    /*---------------------------------------------------------------------------------
+        LoadTrueTypeFont
+        Renders the glyphs of a TrueType font with GDI
+    ---------------------------------------------------------------------------------*/
+    bool LoadTrueTypeFont( const char * faceName, const char * fontFileName, int size, const CodePointRange_s * ranges, int rangeCount, int threshold, SourceFont_s * font )
+    {
+        if ( fontFileName && !AddFontResourceExA( fontFileName, FR_PRIVATE, 0 ) )
+        {
+            fprintf( stderr, "%s: couldn't load font file\n", fontFileName );
+            return false;
+        }
+
+        HDC dc = CreateCompatibleDC( 0 );
+        HFONT gdiFont = CreateFontA( -size, 0, 0, 0, FW_NORMAL, FALSE, FALSE, FALSE, DEFAULT_CHARSET, OUT_TT_ONLY_PRECIS, CLIP_DEFAULT_PRECIS, ANTIALIASED_QUALITY, DEFAULT_PITCH, faceName );
+        HGDIOBJ previousFont = ( dc && gdiFont ) ? SelectObject( dc, gdiFont ) : 0;
+
+        TEXTMETRICA metrics;
+        bool result = previousFont && GetTextMetricsA( dc, &metrics );
+
+        // GGO_GRAY8_BITMAP returns 65 levels, from 0 to 64
+        const int grayThreshold = ( threshold * 64 + 127 ) / 255;
+        const MAT2 identity = { { 0, 1 }, { 0, 0 }, { 0, 0 }, { 0, 1 } };
+
+        unsigned char * buffer = 0;
+        DWORD bufferSize = 0;
+
+        for ( int r = 0; result && r < rangeCount; ++r )
+        {
+            for ( unsigned int codePoint = ranges[ r ].first; result && codePoint <= ranges[ r ].last && codePoint <= 0xFFFF; ++codePoint )
+            {
+                // Skip characters that the font doesn't have, rather than drawing its
+                // default glyph for them
+                WCHAR character = WCHAR( codePoint );
+                WORD index = 0;
+                if ( GetGlyphIndicesW( dc, &character, 1, &index, GGI_MARK_NONEXISTING_GLYPHS ) == GDI_ERROR || index == 0xFFFF )
+                {
+                    continue;
+                }
+
+                GLYPHMETRICS glyphMetrics;
+                DWORD byteCount = GetGlyphOutlineW( dc, codePoint, GGO_GRAY8_BITMAP, &glyphMetrics, 0, 0, &identity );
+                if ( byteCount == GDI_ERROR )
+                {
+                    continue;
+                }
+
+                if ( byteCount > bufferSize )
+                {
+                    free( buffer );
+                    buffer = ( unsigned char * ) malloc( byteCount );
+                    bufferSize = buffer ? byteCount : 0;
+                }
+
+                // A blank glyph (such as a space) has no bitmap at all
+                bool blank = byteCount == 0 || !buffer || GetGlyphOutlineW( dc, codePoint, GGO_GRAY8_BITMAP, &glyphMetrics, bufferSize, buffer, &identity ) == GDI_ERROR;
+
+                int width = blank ? 0 : int( glyphMetrics.gmBlackBoxX );
+                int height = blank ? 0 : int( glyphMetrics.gmBlackBoxY );
+
+                SourceGlyph_s * glyph = AddSourceGlyph( font, codePoint, width, height );
+                result = glyph != 0;
+
+                if ( result )
+                {
+                    glyph->xOffset = glyphMetrics.gmptGlyphOrigin.x;
+                    glyph->yOffset = metrics.tmAscent - glyphMetrics.gmptGlyphOrigin.y;
+                    glyph->advance = glyphMetrics.gmCellIncX;
+
+                    // Rows of the bitmap are padded to 4 bytes
+                    const int pitch = ( width + 3 ) & ~3;
+
+                    for ( int y = 0; y < height; ++y )
+                    {
+                        for ( int x = 0; x < width; ++x )
+                        {
+                            glyph->texels[ y * width + x ] = buffer[ y * pitch + x ] >= grayThreshold ? 0xFF : 0;
+                        }
+                    }
+                }
+            }
+        }
+
+        // Kerning pairs, which GDI returns in UTF-16 - pairs outside the BMP are lost
+        DWORD kerningCount = result ? GetKerningPairsW( dc, 0, 0 ) : 0;
+        KERNINGPAIR * kerningPairs = kerningCount ? ( KERNINGPAIR * ) malloc( kerningCount * sizeof( KERNINGPAIR ) ) : 0;
+
+        if ( kerningPairs )
+        {
+            kerningCount = GetKerningPairsW( dc, kerningCount, kerningPairs );
+
+            for ( DWORD i = 0; result && i < kerningCount; ++i )
+            {
+                result = AddSourceKerningPair( font, kerningPairs[ i ].wFirst, kerningPairs[ i ].wSecond, kerningPairs[ i ].iKernAmount );
+            }
+
+            free( kerningPairs );
+        }
+
+        if ( result )
+        {
+            font->lineHeight = metrics.tmHeight + metrics.tmExternalLeading;
+        }
+        else
+        {
+            fprintf( stderr, "%s: couldn't render font\n", faceName );
+        }
+
+        free( buffer );
+
+        if ( previousFont ) SelectObject( dc, previousFont );
+        if ( gdiFont ) DeleteObject( gdiFont );
+        if ( dc ) DeleteDC( dc );
+        if ( fontFileName ) RemoveFontResourceExA( fontFileName, FR_PRIVATE, 0 );
+
+        return result;
+    }
+#endif
+
+    /*---------------------------------------------------------------------------------
+        MakeDistanceField
+        Replaces the texels of a glyph with a signed distance field, padding it by
+        'spread' texels on every side. Each texel becomes the distance from its centre
+        to the nearest texel centre on the other side of the edge, less half a texel -
+        so that sampling a texel centre gives back exactly the texels that were kept -
+        mapped from '-spread' to 'spread' onto 0 to 256 (and clamped). The edge is at
+        128 rather than 127.5, so that a pixel centred between a texel inside and one
+        outside is drawn, rather than depending on how the GPU rounds a tie. Returns
+        'false' if out of memory
+    ---------------------------------------------------------------------------------*/
+    bool MakeDistanceField( SourceGlyph_s * glyph, int spread )
+    {
+        if ( !glyph->texels )
+        {
+            return true;
+        }
+
+        const int width = glyph->width + spread * 2;
+        const int height = glyph->height + spread * 2;
+
+        unsigned char * field = ( unsigned char * ) malloc( size_t( width ) * height );
+        if ( !field )
+        {
+            return false;
+        }
+
+        // Texels beyond the search radius are clamped to the ends of the range anyway
+        const int radius = spread + 1;
+
+        for ( int y = 0; y < height; ++y )
+        {
+            for ( int x = 0; x < width; ++x )
+            {
+                const int sourceX = x - spread;
+                const int sourceY = y - spread;
+                const bool inside = sourceX >= 0 && sourceX < glyph->width && sourceY >= 0 && sourceY < glyph->height && glyph->texels[ sourceY * glyph->width + sourceX ];
+
+                int nearest = radius * radius;
+
+                for ( int dy = -radius; dy <= radius; ++dy )
+                {
+                    for ( int dx = -radius; dx <= radius; ++dx )
+                    {
+                        const int otherX = sourceX + dx;
+                        const int otherY = sourceY + dy;
+                        const bool otherInside = otherX >= 0 && otherX < glyph->width && otherY >= 0 && otherY < glyph->height && glyph->texels[ otherY * glyph->width + otherX ];
+
+                        if ( otherInside != inside && dx * dx + dy * dy < nearest )
+                        {
+                            nearest = dx * dx + dy * dy;
+                        }
+                    }
+                }
+
+                const float distance = ( sqrtf( float( nearest ) ) - 0.5f ) * ( inside ? 1.0f : -1.0f );
+                const float value = floorf( 128.0f + distance * 128.0f / spread + 0.5f );
+
+                field[ y * width + x ] = ( unsigned char )( value < 0.0f ? 0.0f : ( value > 255.0f ? 255.0f : value ) );
+            }
+        }
+
+        free( glyph->texels );
+        glyph->texels = field;
+        glyph->width = width;
+        glyph->height = height;
+        glyph->xOffset -= spread;
+        glyph->yOffset -= spread;
+
+        return true;
+    }
+
+    /*---------------------------------------------------------------------------------
+        CompareCodePoints
+        Orders glyphs by code point, for 'qsort'
+    ---------------------------------------------------------------------------------*/
+    int CompareCodePoints( const void * a, const void * b )
+    {
+        const SourceGlyph_s * glyphA = ( const SourceGlyph_s * ) a;
+        const SourceGlyph_s * glyphB = ( const SourceGlyph_s * ) b;
+
+        return glyphA->codePoint < glyphB->codePoint ? -1 : ( glyphA->codePoint > glyphB->codePoint ? 1 : 0 );
+    }
+
+    /*---------------------------------------------------------------------------------
+        CompareKerningPairs
+        Orders kerning pairs by their first code point, then their second, for 'qsort'
+    ---------------------------------------------------------------------------------*/
+    int CompareKerningPairs( const void * a, const void * b )
+    {
+        const TinyTextFontKerningPair_s * pairA = ( const TinyTextFontKerningPair_s * ) a;
+        const TinyTextFontKerningPair_s * pairB = ( const TinyTextFontKerningPair_s * ) b;
+
+        if ( pairA->first != pairB->first )
+        {
+            return pairA->first < pairB->first ? -1 : 1;
+        }
+
+        return pairA->second < pairB->second ? -1 : ( pairA->second > pairB->second ? 1 : 0 );
+    }
+
+    /*---------------------------------------------------------------------------------
+        HasSourceGlyph
+        Returns 'true' if a font (whose glyphs are sorted by code point) has a glyph for
+        a code point
+    ---------------------------------------------------------------------------------*/
+    bool HasSourceGlyph( const SourceFont_s * font, unsigned int codePoint )
+    {
+        SourceGlyph_s key;
+        key.codePoint = codePoint;
+
+        return bsearch( &key, font->glyphs, font->glyphCount, sizeof( SourceGlyph_s ), CompareCodePoints ) != 0;
+    }
+
+    /*---------------------------------------------------------------------------------
+        CompareHeights
+        Orders pointers to glyphs tallest first, then widest first, for 'qsort'
+    ---------------------------------------------------------------------------------*/
+    int CompareHeights( const void * a, const void * b )
+    {
+        const SourceGlyph_s * glyphA = *( const SourceGlyph_s * const * ) a;
+        const SourceGlyph_s * glyphB = *( const SourceGlyph_s * const * ) b;
+
+        if ( glyphA->height != glyphB->height )
+        {
+            return glyphB->height - glyphA->height;
+        }
+
+        return glyphB->width - glyphA->width;
+    }
+
+    /*---------------------------------------------------------------------------------
+        PackGlyphs
+        Places glyphs (sorted tallest first) in shelves across an atlas of the
+        specified size - returns 'false' if they don't fit
+    ---------------------------------------------------------------------------------*/
+    bool PackGlyphs( SourceGlyph_s ** glyphs, unsigned int glyphCount, int atlasWidth, int atlasHeight )
+    {
+        int x = 0;
+        int y = 0;
+        int shelfHeight = 0;
+
+        for ( unsigned int i = 0; i < glyphCount; ++i )
+        {
+            SourceGlyph_s * glyph = glyphs[ i ];
+
+            // Glyphs with no texels take no space
+            if ( !glyph->width || !glyph->height )
+            {
+                glyph->u = 0;
+                glyph->v = 0;
+                continue;
+            }
+
+            if ( x + glyph->width > atlasWidth )
+            {
+                x = 0;
+                y += shelfHeight + AtlasGutter;
+                shelfHeight = 0;
+            }
+
+            if ( glyph->width > atlasWidth || y + glyph->height > atlasHeight )
+            {
+                return false;
+            }
+
+            glyph->u = x;
+            glyph->v = y;
+
+            x += glyph->width + AtlasGutter;
+            shelfHeight = glyph->height > shelfHeight ? glyph->height : shelfHeight;
+        }
+
+        return true;
+    }
+
+    /*---------------------------------------------------------------------------------
+        WriteFontPack
+        Packs the glyphs of a font into an atlas, and writes the font pack
+    ---------------------------------------------------------------------------------*/
+    bool WriteFontPack( SourceFont_s * font, bool distanceField, bool proportional, const char * fileName, unsigned int * byteCountOut, int * atlasWidthOut, int * atlasHeightOut )
+    {
+        // Sort by code point, and drop any code point that appears twice
+        qsort( font->glyphs, font->glyphCount, sizeof( SourceGlyph_s ), CompareCodePoints );
+
+        for ( unsigned int i = 0; i < font->glyphCount; ++i )
+        {
+            const SourceGlyph_s & glyph = font->glyphs[ i ];
+
+            if ( glyph.width > 255 || glyph.height > 255 || glyph.advance < 0 || glyph.advance > 255
+              || glyph.xOffset < -128 || glyph.xOffset > 127 || glyph.yOffset < -128 || glyph.yOffset > 127 )
+            {
+                fprintf( stderr, "error: glyph U+%04X is too large for a font pack\n", glyph.codePoint );
+                return false;
+            }
+        }
+
+        unsigned int glyphCount = 0;
+        int characterWidth = 0;
+
+        for ( unsigned int i = 0; i < font->glyphCount; ++i )
+        {
+            SourceGlyph_s glyph = font->glyphs[ i ];
+
+            if ( glyphCount > 0 && font->glyphs[ glyphCount - 1 ].codePoint == glyph.codePoint )
+            {
+                fprintf( stderr, "warning: code point U+%04X appears more than once - the first is kept\n", glyph.codePoint );
+                free( glyph.texels );
+                continue;
+            }
+
+            characterWidth = glyph.advance > characterWidth ? glyph.advance : characterWidth;
+            font->glyphs[ glyphCount++ ] = glyph;
+        }
+
+        font->glyphCount = glyphCount;
+
+        if ( !glyphCount || characterWidth <= 0 || font->lineHeight > 0xFFFF )
+        {
+            fprintf( stderr, "error: the font has no characters\n" );
+            return false;
+        }
+
+        // Keep the kerning pairs of a proportional font whose characters are both in
+        // the pack, sorted, dropping any pair that appears twice
+        unsigned int kerningCount = 0;
+
+        if ( proportional )
+        {
+            qsort( font->kerningPairs, font->kerningCount, sizeof( TinyTextFontKerningPair_s ), CompareKerningPairs );
+
+            for ( unsigned int i = 0; i < font->kerningCount; ++i )
+            {
+                TinyTextFontKerningPair_s pair = font->kerningPairs[ i ];
+
+                if ( !pair.amount || !HasSourceGlyph( font, pair.first ) || !HasSourceGlyph( font, pair.second ) )
+                {
+                    continue;
+                }
+
+                if ( kerningCount > 0 && font->kerningPairs[ kerningCount - 1 ].first == pair.first && font->kerningPairs[ kerningCount - 1 ].second == pair.second )
+                {
+                    continue;
+                }
+
+                if ( pair.amount < -MaxKerningAmount || pair.amount > MaxKerningAmount )
+                {
+                    fprintf( stderr, "warning: the kerning of U+%04X U+%04X is limited to %d pixels\n", pair.first, pair.second, MaxKerningAmount );
+                    pair.amount = pair.amount < 0 ? -MaxKerningAmount : MaxKerningAmount;
+                }
+
+                font->kerningPairs[ kerningCount++ ] = pair;
+            }
+        }
+
+        // Find the smallest power-of-two atlas that the glyphs fit in, trying the
+        // sizes in order of area (and wider before taller)
+        SourceGlyph_s ** sorted = ( SourceGlyph_s ** ) malloc( glyphCount * sizeof( SourceGlyph_s * ) );
+        if ( !sorted )
+        {
+            return false;
+        }
+
+        for ( unsigned int i = 0; i < glyphCount; ++i )
+        {
+            sorted[ i ] = &font->glyphs[ i ];
+        }
+
+        qsort( sorted, glyphCount, sizeof( SourceGlyph_s * ), CompareHeights );
+
+        int atlasWidth = 16;
+        int atlasHeight = 16;
+
+        while ( !PackGlyphs( sorted, glyphCount, atlasWidth, atlasHeight ) )
+        {
+            if ( atlasWidth == atlasHeight )
+            {
+                atlasWidth *= 2;
+            }
+            else
+            {
+                atlasHeight *= 2;
+            }
+
+            if ( atlasWidth > MaxAtlasSize )
+            {
+                fprintf( stderr, "error: the glyphs don't fit in a %dx%d atlas\n", MaxAtlasSize, MaxAtlasSize );
+                free( sorted );
+                return false;
+            }
+        }
+
+        free( sorted );
+
+        // Lay out the pack
+        TinyTextFontPackHeader_s header;
+        memset( &header, 0, sizeof( header ) );
+        memcpy( header.magic, "TTFP", 4 );
+        header.version = distanceField ? TinyTextFontPack_c::DistanceFieldVersion : TinyTextFontPack_c::Version;
+        header.atlasWidth = ( unsigned short ) atlasWidth;
+        header.atlasHeight = ( unsigned short ) atlasHeight;
+        header.characterWidth = ( unsigned short ) characterWidth;
+        header.lineHeight = ( unsigned short ) font->lineHeight;
+        header.glyphCount = glyphCount;
+        header.glyphOffset = sizeof( TinyTextFontPackHeader_s );
+        header.atlasOffset = ( header.glyphOffset + glyphCount * sizeof( TinyTextFontGlyph_s ) + 3 ) & ~3;
+        header.flags = proportional ? TinyTextFontPack_c::FlagProportional : 0;
+        header.kerningCount = kerningCount;
+        header.kerningOffset = ( header.atlasOffset + atlasWidth * atlasHeight + 3 ) & ~3;
+        header.byteCount = header.kerningOffset + kerningCount * sizeof( TinyTextFontKerningPair_s );
+
+        unsigned char * pack = ( unsigned char * ) calloc( header.byteCount, 1 );
+        if ( !pack )
+        {
+            return false;
+        }
+
+        memcpy( pack, &header, sizeof( header ) );
+
+        TinyTextFontGlyph_s * packGlyphs = ( TinyTextFontGlyph_s * )( pack + header.glyphOffset );
+        unsigned char * atlas = pack + header.atlasOffset;
+
+        for ( unsigned int i = 0; i < glyphCount; ++i )
+        {
+            const SourceGlyph_s & glyph = font->glyphs[ i ];
+            bool blank = !glyph.width || !glyph.height;
+
+            TinyTextFontGlyph_s & packGlyph = packGlyphs[ i ];
+            packGlyph.codePoint = glyph.codePoint;
+            packGlyph.u = ( unsigned short ) glyph.u;
+            packGlyph.v = ( unsigned short ) glyph.v;
+            packGlyph.width = ( unsigned char ) glyph.width;
+            packGlyph.height = blank ? 0 : ( unsigned char ) glyph.height;
+            packGlyph.xOffset = ( signed char ) glyph.xOffset;
+            packGlyph.yOffset = ( signed char ) glyph.yOffset;
+            packGlyph.advance = ( unsigned char ) glyph.advance;
+
+            for ( int y = 0; !blank && y < glyph.height; ++y )
+            {
+                memcpy( atlas + ( glyph.v + y ) * atlasWidth + glyph.u, glyph.texels + y * glyph.width, glyph.width );
+            }
+        }
+
+        if ( kerningCount )
+        {
+            memcpy( pack + header.kerningOffset, font->kerningPairs, kerningCount * sizeof( TinyTextFontKerningPair_s ) );
+        }
+
+        FILE * file = fopen( fileName, "wb" );
+        bool result = file && fwrite( pack, 1, header.byteCount, file ) == header.byteCount;
+
+        if ( file && fclose( file ) != 0 )
+        {
+            result = false;
+        }
+
+        free( pack );
+
+        if ( !result )
+        {
+            fprintf( stderr, "%s: couldn't write file\n", fileName );
+            return false;
+        }
+
+        *byteCountOut = header.byteCount;
+        *atlasWidthOut = atlasWidth;
+        *atlasHeightOut = atlasHeight;
+        return true;
+    }
+
+    /*---------------------------------------------------------------------------------
+        ParseRange
+        Parses a range of code points in the form 'first-last' (each in decimal, or
+        hexadecimal with a '0x' prefix)
+    ---------------------------------------------------------------------------------*/
+    bool ParseRange( const char * text, CodePointRange_s * range )
+    {
+        char * end = 0;
+        unsigned long first = strtoul( text, &end, 0 );
+        if ( end == text || *end != '-' )
+        {
+            return false;
+        }
+
+        const char * lastText = end + 1;
+        unsigned long last = strtoul( lastText, &end, 0 );
+        if ( end == lastText || *end != '\0' || last < first || last > 0x10FFFF )
+        {
+            return false;
+        }
+
+        range->first = ( unsigned int ) first;
+        range->last = ( unsigned int ) last;
+        return true;
+    }
+
+    /*---------------------------------------------------------------------------------
+        PrintUsage
+        Describes the command line
+    ---------------------------------------------------------------------------------*/
+    void PrintUsage( const char * program )
+    {
+        fprintf( stderr,
+                 "usage: %s <source> [options] <output file>\n"
+                 "\n"
+                 "sources:\n"
+                 "  --bmfont <file.fnt>      a BMFont text file, with .tga pages\n"
+                 "  --builtin                the built-in font\n"
+                 "  --truetype <face name>   a TrueType font (Windows only)\n"
+                 "\n"
+                 "options:\n"
+                 "  --font-file <file.ttf>   load the TrueType font from a file (Windows only)\n"
+                 "  --size <pixels>          size to render a TrueType font at (default %d)\n"
+                 "  --range <first>-<last>   code points to take from a TrueType font\n"
+                 "  --threshold <value>      keep texels at or above this value (default %d)\n"
+                 "  --distance-field <spread> compile a distance field, reaching 'spread' texels\n"
+                 "  --proportional           space characters by their advances and kerning\n",
+                 program, DefaultTrueTypeSize, DefaultThreshold );
+    }
+//}
+
+/*---------------------------------------------------------------------------------
+    main
+---------------------------------------------------------------------------------*/
+int main( int argc, char ** argv )
+{
+    const char * bmfontFileName = 0;
+    const char * faceName = 0;
+#if defined( _WIN32 )
+    const char * fontFileName = 0;
+#endif
+    const char * outputFileName = 0;
+    bool builtin = false;
+    bool proportional = false;
+    int size = DefaultTrueTypeSize;
+    int threshold = DefaultThreshold;
+    int spread = 0;
+
+    CodePointRange_s ranges[ MaxRanges ];
+    int rangeCount = 0;
+
+    for ( int i = 1; i < argc; ++i )
+    {
+        const char * value = i + 1 < argc ? argv[ i + 1 ] : 0;
+        bool valid = true;
+
+        if ( strcmp( argv[ i ], "--bmfont" ) == 0 )
+        {
+            bmfontFileName = value;
+            valid = value != 0;
+            ++i;
+        }
+        else if ( strcmp( argv[ i ], "--builtin" ) == 0 )
+        {
+            builtin = true;
+        }
+        else if ( strcmp( argv[ i ], "--truetype" ) == 0 )
+        {
+            faceName = value;
+            valid = value != 0;
+            ++i;
+        }
+        else if ( strcmp( argv[ i ], "--font-file" ) == 0 )
+        {
+        #if defined( _WIN32 )
+            fontFileName = value;
+            valid = value != 0;
+        #else
+            fprintf( stderr, "error: TrueType fonts can only be compiled on Windows - export them with BMFont instead\n" );
+            valid = false;
+        #endif
+            ++i;
+        }
+        else if ( strcmp( argv[ i ], "--size" ) == 0 )
+        {
+            size = value ? atoi( value ) : 0;
+            valid = size > 0;
+            ++i;
+        }
+        else if ( strcmp( argv[ i ], "--range" ) == 0 )
+        {
+            valid = value != 0 && rangeCount < MaxRanges && ParseRange( value, &ranges[ rangeCount++ ] );
+            ++i;
+        }
+        else if ( strcmp( argv[ i ], "--threshold" ) == 0 )
+        {
+            threshold = value ? atoi( value ) : 0;
+            valid = threshold > 0 && threshold <= 255;
+            ++i;
+        }
+        else if ( strcmp( argv[ i ], "--proportional" ) == 0 )
+        {
+            proportional = true;
+        }
+        else if ( strcmp( argv[ i ], "--distance-field" ) == 0 )
+        {
+            spread = value ? atoi( value ) : 0;
+            valid = spread > 0 && spread <= MaxDistanceFieldSpread;
+            ++i;
+        }
+        else
+        {
+            valid = !outputFileName;
+            outputFileName = argv[ i ];
+        }
+
+        if ( !valid )
+        {
+            PrintUsage( argv[ 0 ] );
+            return 1;
+        }
+    }
+
+    if ( !outputFileName || ( bmfontFileName != 0 ) + ( faceName != 0 ) + builtin != 1 )
+    {
+        PrintUsage( argv[ 0 ] );
+        return 1;
+    }
+
+    SourceFont_s font;
+    memset( &font, 0, sizeof( font ) );
+
+    bool result = false;
+
+    if ( bmfontFileName )
+    {
+        result = LoadBMFont( bmfontFileName, threshold, &font );
+    }
+    else if ( builtin )
+    {
+        result = LoadBuiltinFont( &font );
+    }
+    else
+    {
+    #if defined( _WIN32 )
+        // By default, take the printable characters of Windows-1252
+        if ( !rangeCount )
+        {
+            const CodePointRange_s windows1252[] = { { 0x20, 0x7E }, { 0xA0, 0xFF } };
+            memcpy( ranges, windows1252, sizeof( windows1252 ) );
+            rangeCount = 2;
+
+            for ( unsigned int c = 0x80; c < 0xA0 && rangeCount < MaxRanges; ++c )
+            {
+                unsigned int codePoint = TinyTextFontPack_c::GetWindows1252CodePoint( ( unsigned char ) c );
+                if ( codePoint != c )
+                {
+                    ranges[ rangeCount ].first = codePoint;
+                    ranges[ rangeCount ].last = codePoint;
+                    ++rangeCount;
+                }
+            }
+        }
+
+        result = LoadTrueTypeFont( faceName, fontFileName, size, ranges, rangeCount, threshold, &font );
+    #else
+        fprintf( stderr, "error: TrueType fonts can only be compiled on Windows - export them with BMFont instead\n" );
+    #endif
+    }
+
+    unsigned int byteCount = 0;
+    int atlasWidth = 0;
+    int atlasHeight = 0;
+
+    for ( unsigned int i = 0; result && spread && i < font.glyphCount; ++i )
+    {
+        result = MakeDistanceField( &font.glyphs[ i ], spread );
+    }
+
+    result = result && WriteFontPack( &font, spread != 0, proportional, outputFileName, &byteCount, &atlasWidth, &atlasHeight );
+
+    // Check the pack by loading it, as the library will
+    if ( result )
+    {
+        TinyTextFontPack_c pack;
+        result = pack.Open( outputFileName );
+
+        if ( result )
+        {
+            printf( "%s: %u glyphs, %u kerning pairs, %dx%d atlas, %dx%d cell, %u bytes\n", outputFileName, pack.GetNumGlyphs( ), pack.GetNumKerningPairs( ), atlasWidth, atlasHeight, pack.GetHeader( )->characterWidth, pack.GetHeader( )->lineHeight, byteCount );
+        }
+        else
+        {
+            fprintf( stderr, "%s: the pack that was written doesn't load\n", outputFileName );
+        }
+    }
+
+    FreeSourceFont( &font );
+
+    return result ? 0 : 1;
+}
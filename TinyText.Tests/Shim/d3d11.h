@@ -0,0 +1,341 @@
+/*=================================================================================
+
+    PROJECT:        Tiny Text Library for DirectX 10
+
+    DESCRIPTION:    The parts of the Direct3D 11 interface used by 'TinyText.cpp',
+                    so that the text context can be built and tested on platforms
+                    without Windows. Only put this directory on the include path
+                    of non-Windows builds
+
+    NOTES:          - Unlike the real interfaces, every method has a body, which
+                      does nothing or fails with 'E_NOTIMPL'. A mock only needs to
+                      override the methods that it is interested in
+
+                    - Only the members of the descriptions that 'TinyText.cpp'
+                      fills in are declared
+
+=================================================================================*/
+
+#pragma once
+
+/*---------------------------------------------------------------------------------
+    Includes
+---------------------------------------------------------------------------------*/
+#include <windows.h>
+
+/*---------------------------------------------------------------------------------
+    Enumerations
+---------------------------------------------------------------------------------*/
+enum DXGI_FORMAT
+{
+    DXGI_FORMAT_UNKNOWN = 0,
+    DXGI_FORMAT_R32G32_FLOAT = 16,
+    DXGI_FORMAT_R8G8B8A8_UNORM = 28,
+    DXGI_FORMAT_R16G16_UINT = 36,
+    DXGI_FORMAT_R8_UNORM = 61
+};
+
+enum D3D11_PRIMITIVE_TOPOLOGY
+{
+    D3D11_PRIMITIVE_TOPOLOGY_UNDEFINED = 0,
+    D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST = 4
+};
+
+enum D3D11_INPUT_CLASSIFICATION
+{
+    D3D11_INPUT_PER_VERTEX_DATA = 0
+};
+
+enum D3D11_USAGE
+{
+    D3D11_USAGE_DEFAULT = 0,
+    D3D11_USAGE_IMMUTABLE = 1,
+    D3D11_USAGE_DYNAMIC = 2
+};
+
+enum D3D11_BIND_FLAG
+{
+    D3D11_BIND_VERTEX_BUFFER = 0x1,
+    D3D11_BIND_SHADER_RESOURCE = 0x8
+};
+
+enum D3D11_CPU_ACCESS_FLAG
+{
+    D3D11_CPU_ACCESS_WRITE = 0x10000
+};
+
+enum D3D11_SRV_DIMENSION
+{
+    D3D11_SRV_DIMENSION_TEXTURE2DARRAY = 5
+};
+
+enum D3D11_FILTER
+{
+    D3D11_FILTER_MIN_MAG_MIP_POINT = 0,
+    D3D11_FILTER_MIN_MAG_MIP_LINEAR = 0x15
+};
+
+enum D3D11_TEXTURE_ADDRESS_MODE
+{
+    D3D11_TEXTURE_ADDRESS_WRAP = 1,
+    D3D11_TEXTURE_ADDRESS_CLAMP = 3
+};
+
+enum D3D11_COMPARISON_FUNC
+{
+    D3D11_COMPARISON_ALWAYS = 8
+};
+
+enum D3D11_DEPTH_WRITE_MASK
+{
+    D3D11_DEPTH_WRITE_MASK_ZERO = 0
+};
+
+enum D3D11_STENCIL_OP
+{
+    D3D11_STENCIL_OP_KEEP = 1
+};
+
+enum D3D11_MAP
+{
+    D3D11_MAP_WRITE_DISCARD = 4
+};
+
+enum D3D11_QUERY
+{
+    D3D11_QUERY_TIMESTAMP = 2,
+    D3D11_QUERY_TIMESTAMP_DISJOINT = 3
+};
+
+enum D3D11_ASYNC_GETDATA_FLAG
+{
+    D3D11_ASYNC_GETDATA_DONOTFLUSH = 0x1
+};
+
+#define D3D11_DEFAULT_STENCIL_READ_MASK     ( 0xff )
+#define D3D11_DEFAULT_STENCIL_WRITE_MASK    ( 0xff )
+
+/*---------------------------------------------------------------------------------
+    Structures
+---------------------------------------------------------------------------------*/
+struct D3D11_VIEWPORT
+{
+    float TopLeftX;
+    float TopLeftY;
+    float Width;
+    float Height;
+    float MinDepth;
+    float MaxDepth;
+};
+
+struct D3D11_BOX
+{
+    UINT left;
+    UINT top;
+    UINT front;
+    UINT right;
+    UINT bottom;
+    UINT back;
+};
+
+struct D3D11_INPUT_ELEMENT_DESC
+{
+    const char * SemanticName;
+    UINT SemanticIndex;
+    DXGI_FORMAT Format;
+    UINT InputSlot;
+    UINT AlignedByteOffset;
+    D3D11_INPUT_CLASSIFICATION InputSlotClass;
+    UINT InstanceDataStepRate;
+};
+
+struct D3D11_BUFFER_DESC
+{
+    UINT ByteWidth;
+    D3D11_USAGE Usage;
+    UINT BindFlags;
+    UINT CPUAccessFlags;
+    UINT MiscFlags;
+    UINT StructureByteStride;
+};
+
+struct DXGI_SAMPLE_DESC
+{
+    UINT Count;
+    UINT Quality;
+};
+
+struct D3D11_TEXTURE2D_DESC
+{
+    UINT Width;
+    UINT Height;
+    UINT MipLevels;
+    UINT ArraySize;
+    DXGI_FORMAT Format;
+    DXGI_SAMPLE_DESC SampleDesc;
+    D3D11_USAGE Usage;
+    UINT BindFlags;
+    UINT CPUAccessFlags;
+    UINT MiscFlags;
+};
+
+struct D3D11_SUBRESOURCE_DATA
+{
+    const void * pSysMem;
+    UINT SysMemPitch;
+    UINT SysMemSlicePitch;
+};
+
+struct D3D11_TEX2D_ARRAY_SRV
+{
+    UINT MostDetailedMip;
+    UINT MipLevels;
+    UINT FirstArraySlice;
+    UINT ArraySize;
+};
+
+struct D3D11_SHADER_RESOURCE_VIEW_DESC
+{
+    DXGI_FORMAT Format;
+    D3D11_SRV_DIMENSION ViewDimension;
+    D3D11_TEX2D_ARRAY_SRV Texture2DArray;
+};
+
+struct D3D11_SAMPLER_DESC
+{
+    D3D11_FILTER Filter;
+    D3D11_TEXTURE_ADDRESS_MODE AddressU;
+    D3D11_TEXTURE_ADDRESS_MODE AddressV;
+    D3D11_TEXTURE_ADDRESS_MODE AddressW;
+    float MipLODBias;
+    UINT MaxAnisotropy;
+    D3D11_COMPARISON_FUNC ComparisonFunc;
+    float BorderColor[ 4 ];
+    float MinLOD;
+    float MaxLOD;
+};
+
+struct D3D11_DEPTH_STENCILOP_DESC
+{
+    D3D11_STENCIL_OP StencilFailOp;
+    D3D11_STENCIL_OP StencilDepthFailOp;
+    D3D11_STENCIL_OP StencilPassOp;
+    D3D11_COMPARISON_FUNC StencilFunc;
+};
+
+struct D3D11_DEPTH_STENCIL_DESC
+{
+    BOOL DepthEnable;
+    D3D11_DEPTH_WRITE_MASK DepthWriteMask;
+    D3D11_COMPARISON_FUNC DepthFunc;
+    BOOL StencilEnable;
+    BYTE StencilReadMask;
+    BYTE StencilWriteMask;
+    D3D11_DEPTH_STENCILOP_DESC FrontFace;
+    D3D11_DEPTH_STENCILOP_DESC BackFace;
+};
+
+struct D3D11_MAPPED_SUBRESOURCE
+{
+    void * pData;
+    UINT RowPitch;
+    UINT DepthPitch;
+};
+
+struct D3D11_QUERY_DESC
+{
+    D3D11_QUERY Query;
+    UINT MiscFlags;
+};
+
+struct D3D11_QUERY_DATA_TIMESTAMP_DISJOINT
+{
+    UINT64 Frequency;
+    BOOL Disjoint;
+};
+
+/*---------------------------------------------------------------------------------
+    Interfaces
+---------------------------------------------------------------------------------*/
+struct IUnknown
+{
+    virtual ~IUnknown( ) { }
+    virtual ULONG AddRef( ) { return 1; }
+    virtual ULONG Release( ) { return 1; }
+};
+
+struct ID3D10Blob : IUnknown
+{
+    virtual void * GetBufferPointer( ) { return 0; }
+    virtual size_t GetBufferSize( ) { return 0; }
+};
+
+struct ID3D11DeviceChild : IUnknown { };
+struct ID3D11ClassLinkage : ID3D11DeviceChild { };
+struct ID3D11ClassInstance : ID3D11DeviceChild { };
+struct ID3D11VertexShader : ID3D11DeviceChild { };
+struct ID3D11GeometryShader : ID3D11DeviceChild { };
+struct ID3D11PixelShader : ID3D11DeviceChild { };
+struct ID3D11InputLayout : ID3D11DeviceChild { };
+struct ID3D11SamplerState : ID3D11DeviceChild { };
+struct ID3D11BlendState : ID3D11DeviceChild { };
+struct ID3D11DepthStencilState : ID3D11DeviceChild { };
+struct ID3D11RasterizerState : ID3D11DeviceChild { };
+struct ID3D11Resource : ID3D11DeviceChild { };
+struct ID3D11Buffer : ID3D11Resource { };
+struct ID3D11Texture2D : ID3D11Resource { };
+struct ID3D11View : ID3D11DeviceChild { };
+struct ID3D11ShaderResourceView : ID3D11View { };
+struct ID3D11RenderTargetView : ID3D11View { };
+struct ID3D11DepthStencilView : ID3D11View { };
+struct ID3D11Asynchronous : ID3D11DeviceChild { };
+struct ID3D11Query : ID3D11Asynchronous { };
+
+struct ID3D11Device : IUnknown
+{
+    virtual HRESULT CreateBuffer( const D3D11_BUFFER_DESC *, const D3D11_SUBRESOURCE_DATA *, ID3D11Buffer ** ) { return E_NOTIMPL; }
+    virtual HRESULT CreateTexture2D( const D3D11_TEXTURE2D_DESC *, const D3D11_SUBRESOURCE_DATA *, ID3D11Texture2D ** ) { return E_NOTIMPL; }
+    virtual HRESULT CreateShaderResourceView( ID3D11Resource *, const D3D11_SHADER_RESOURCE_VIEW_DESC *, ID3D11ShaderResourceView ** ) { return E_NOTIMPL; }
+    virtual HRESULT CreateInputLayout( const D3D11_INPUT_ELEMENT_DESC *, UINT, const void *, size_t, ID3D11InputLayout ** ) { return E_NOTIMPL; }
+    virtual HRESULT CreateVertexShader( const void *, size_t, ID3D11ClassLinkage *, ID3D11VertexShader ** ) { return E_NOTIMPL; }
+    virtual HRESULT CreatePixelShader( const void *, size_t, ID3D11ClassLinkage *, ID3D11PixelShader ** ) { return E_NOTIMPL; }
+    virtual HRESULT CreateDepthStencilState( const D3D11_DEPTH_STENCIL_DESC *, ID3D11DepthStencilState ** ) { return E_NOTIMPL; }
+    virtual HRESULT CreateSamplerState( const D3D11_SAMPLER_DESC *, ID3D11SamplerState ** ) { return E_NOTIMPL; }
+    virtual HRESULT CreateQuery( const D3D11_QUERY_DESC *, ID3D11Query ** ) { return E_NOTIMPL; }
+};
+
+struct ID3D11DeviceContext : IUnknown
+{
+    virtual void VSSetShader( ID3D11VertexShader *, ID3D11ClassInstance * const *, UINT ) { }
+    virtual void PSSetShader( ID3D11PixelShader *, ID3D11ClassInstance * const *, UINT ) { }
+    virtual void PSSetShaderResources( UINT, UINT, ID3D11ShaderResourceView * const * ) { }
+    virtual void PSSetSamplers( UINT, UINT, ID3D11SamplerState * const * ) { }
+    virtual void GSSetShader( ID3D11GeometryShader *, ID3D11ClassInstance * const *, UINT ) { }
+    virtual void IASetInputLayout( ID3D11InputLayout * ) { }
+    virtual void IASetVertexBuffers( UINT, UINT, ID3D11Buffer * const *, const UINT *, const UINT * ) { }
+    virtual void IASetPrimitiveTopology( D3D11_PRIMITIVE_TOPOLOGY ) { }
+    virtual void OMSetBlendState( ID3D11BlendState *, const float *, UINT ) { }
+    virtual void OMSetDepthStencilState( ID3D11DepthStencilState *, UINT ) { }
+    virtual void RSSetState( ID3D11RasterizerState * ) { }
+
+    virtual void VSGetShader( ID3D11VertexShader ** shader, ID3D11ClassInstance **, UINT * ) { *shader = 0; }
+    virtual void PSGetShader( ID3D11PixelShader ** shader, ID3D11ClassInstance **, UINT * ) { *shader = 0; }
+    virtual void PSGetShaderResources( UINT, UINT, ID3D11ShaderResourceView ** views ) { *views = 0; }
+    virtual void PSGetSamplers( UINT, UINT, ID3D11SamplerState ** samplers ) { *samplers = 0; }
+    virtual void GSGetShader( ID3D11GeometryShader ** shader, ID3D11ClassInstance **, UINT * ) { *shader = 0; }
+    virtual void IAGetInputLayout( ID3D11InputLayout ** inputLayout ) { *inputLayout = 0; }
+    virtual void IAGetVertexBuffers( UINT, UINT, ID3D11Buffer ** buffers, UINT *, UINT * ) { *buffers = 0; }
+    virtual void IAGetPrimitiveTopology( D3D11_PRIMITIVE_TOPOLOGY * topology ) { *topology = D3D11_PRIMITIVE_TOPOLOGY_UNDEFINED; }
+    virtual void OMGetBlendState( ID3D11BlendState ** blendState, float *, UINT * ) { *blendState = 0; }
+    virtual void OMGetDepthStencilState( ID3D11DepthStencilState ** depthStencilState, UINT * ) { *depthStencilState = 0; }
+    virtual void RSGetState( ID3D11RasterizerState ** rasterizerState ) { *rasterizerState = 0; }
+    virtual void OMGetRenderTargets( UINT, ID3D11RenderTargetView ** views, ID3D11DepthStencilView ** ) { *views = 0; }
+
+    virtual void Draw( UINT, UINT ) { }
+    virtual HRESULT Map( ID3D11Resource *, UINT, D3D11_MAP, UINT, D3D11_MAPPED_SUBRESOURCE * ) { return E_NOTIMPL; }
+    virtual void Unmap( ID3D11Resource *, UINT ) { }
+    virtual void UpdateSubresource( ID3D11Resource *, UINT, const D3D11_BOX *, const void *, UINT, UINT ) { }
+    virtual void Begin( ID3D11Asynchronous * ) { }
+    virtual void End( ID3D11Asynchronous * ) { }
+    virtual HRESULT GetData( ID3D11Asynchronous *, void *, UINT, UINT ) { return E_NOTIMPL; }
+};
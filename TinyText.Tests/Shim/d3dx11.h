@@ -0,0 +1,36 @@
+/*=================================================================================
+
+    PROJECT:        Tiny Text Library for DirectX 10
+
+    DESCRIPTION:    The two D3DX functions used by 'TinyText.cpp', so that the text
+                    context can be built and tested on platforms without Windows.
+                    They are only declared - a test that links 'TinyText.cpp' must
+                    define them. Only put this directory on the include path of
+                    non-Windows builds
+
+=================================================================================*/
+
+#pragma once
+
+/*---------------------------------------------------------------------------------
+    Includes
+---------------------------------------------------------------------------------*/
+#include <d3d11.h>
+
+/*---------------------------------------------------------------------------------
+    Types
+---------------------------------------------------------------------------------*/
+struct D3D10_SHADER_MACRO;
+struct ID3D10Include;
+struct ID3DX11ThreadPump;
+struct D3DX11_IMAGE_LOAD_INFO;
+
+/*---------------------------------------------------------------------------------
+    Functions
+---------------------------------------------------------------------------------*/
+HRESULT D3DX11CompileFromMemory( const char * srcData, size_t srcDataLen, const char * fileName, const D3D10_SHADER_MACRO * defines, ID3D10Include * include,
+                                 const char * functionName, const char * profile, UINT flags1, UINT flags2, ID3DX11ThreadPump * pump,
+                                 ID3D10Blob ** shader, ID3D10Blob ** errorMessages, HRESULT * result );
+
+HRESULT D3DX11CreateTextureFromMemory( ID3D11Device * device, const void * srcData, size_t srcDataSize, D3DX11_IMAGE_LOAD_INFO * loadInfo,
+                                       ID3DX11ThreadPump * pump, ID3D11Resource ** texture, HRESULT * result );
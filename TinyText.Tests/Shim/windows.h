@@ -0,0 +1,107 @@
+/*=================================================================================
+
+    PROJECT:        Tiny Text Library for DirectX 10
+
+    DESCRIPTION:    The few Windows types and functions used by 'TinyText.cpp', so
+                    that the text context can be built and tested on platforms
+                    without Windows. Only put this directory on the include path
+                    of non-Windows builds
+
+=================================================================================*/
+
+#pragma once
+
+#if defined( _WIN32 )
+#error The shim headers are for non-Windows builds - use the Windows SDK instead
+#endif
+
+/*---------------------------------------------------------------------------------
+    Includes
+---------------------------------------------------------------------------------*/
+#include <stddef.h>
+#include <string.h>
+#include <time.h>
+
+/*---------------------------------------------------------------------------------
+    Types
+---------------------------------------------------------------------------------*/
+typedef int BOOL;
+typedef unsigned char BYTE;
+typedef unsigned short WORD;
+typedef unsigned int DWORD;
+typedef unsigned int UINT;
+typedef long LONG;
+typedef unsigned long ULONG;
+typedef long long LONGLONG;
+typedef unsigned long long UINT64;
+typedef long HRESULT;
+
+union LARGE_INTEGER
+{
+    LONGLONG QuadPart;
+};
+
+struct RECT
+{
+    LONG left;
+    LONG top;
+    LONG right;
+    LONG bottom;
+};
+
+/*---------------------------------------------------------------------------------
+    Constants and macros
+---------------------------------------------------------------------------------*/
+#define TRUE                1
+#define FALSE               0
+
+#define S_OK                ( ( HRESULT ) 0 )
+#define S_FALSE             ( ( HRESULT ) 1 )
+#define E_NOTIMPL           ( ( HRESULT ) 0x80004001L )
+#define E_FAIL              ( ( HRESULT ) 0x80004005L )
+
+#define FAILED( hr )        ( ( HRESULT )( hr ) < 0 )
+#define SUCCEEDED( hr )     ( ( HRESULT )( hr ) >= 0 )
+
+#define ZeroMemory( destination, length )   memset( ( destination ), 0, ( length ) )
+
+/*---------------------------------------------------------------------------------
+    Functions
+---------------------------------------------------------------------------------*/
+inline BOOL QueryPerformanceCounter( LARGE_INTEGER * count )
+{
+    timespec now;
+    clock_gettime( CLOCK_MONOTONIC, &now );
+    count->QuadPart = LONGLONG( now.tv_sec ) * 1000000000 + now.tv_nsec;
+    return TRUE;
+}
+
+inline BOOL QueryPerformanceFrequency( LARGE_INTEGER * frequency )
+{
+    frequency->QuadPart = 1000000000;
+    return TRUE;
+}
+
+inline LONG InterlockedIncrement( volatile LONG * addend )
+{
+    return __sync_add_and_fetch( addend, 1 );
+}
+
+inline void MemoryBarrier( )
+{
+    __sync_synchronize( );
+}
+
+inline DWORD GetCurrentProcessId( )
+{
+    return 1;
+}
+
+inline DWORD GetCurrentThreadId( )
+{
+    return 1;
+}
+
+inline void OutputDebugStringA( const char * )
+{
+}
@@ -0,0 +1,283 @@
+/*=================================================================================
+
+    PROJECT:        Tiny Text Library for DirectX 10
+
+    DESCRIPTION:    Checks that 'TinyTextBlitter_c' draws the same pixels as the
+                    reference rasterizer, in every pixel format, with one thread
+                    and with several
+
+=================================================================================*/
+
+/*---------------------------------------------------------------------------------
+    Includes
+---------------------------------------------------------------------------------*/
+#include "TinyText.Core/TinyTextBlitter.h"
+#include "TinyText.Core/TinyTextRasterizer.h"
+#include "TinyTextTest.h"
+#include <stdio.h>
+#include <string.h>
+#include <new>
+
+/*---------------------------------------------------------------------------------
+    Constants
+---------------------------------------------------------------------------------*/
+//namespace
+//{
+    // Maximum number of characters in a frame
+    const unsigned int  FrameCapacity           = 32768;
+
+    // The value that every byte of a frame is cleared to, so that pixels which are
+    // written can be told apart from those which aren't
+    const unsigned char ClearValue              = 7;
+//}
+
+//namespace
+//{
+    /*---------------------------------------------------------------------------------
+        Random_c
+        A small random number generator, so that every platform tests the same text
+    ---------------------------------------------------------------------------------*/
+    class Random_c
+    {
+    private:
+
+        unsigned int m_State;
+
+    public:
+
+        // Constructor
+        explicit Random_c( unsigned int seed ) : m_State( seed ? seed : 1 ) { }
+
+        // Returns a number between zero and 'range' - 1
+        unsigned int Next( unsigned int range )
+        {
+            m_State ^= m_State << 13;
+            m_State ^= m_State >> 17;
+            m_State ^= m_State << 5;
+            return m_State % range;
+        }
+    };
+
+    /*---------------------------------------------------------------------------------
+        EncodeFrame
+        Encodes random strings of every character at random positions, some of them
+        partly outside the frame
+    ---------------------------------------------------------------------------------*/
+    void EncodeFrame( TinyTextEncoder_c & encoder, unsigned int * vertices, int width, int height, unsigned int seed )
+    {
+        Random_c random( seed );
+        char text[ 64 ];
+
+        encoder.Begin( vertices );
+
+        const int stringCount = width * height / 400 + 50;
+        for ( int i = 0; i < stringCount; ++i )
+        {
+            unsigned int length = 1 + random.Next( 40 );
+            for ( unsigned int j = 0; j < length; ++j )
+            {
+                text[ j ] = char( 32 + random.Next( 224 ) );
+            }
+
+            int x = int( random.Next( width + 40 ) ) - 20;
+            int y = int( random.Next( height + 30 ) ) - 15;
+            unsigned int colour = 0xFF000000 | ( random.Next( 0x1000000 ) );
+
+            encoder.Print( float( width ), float( height ), length, text, x, y, colour );
+        }
+
+        encoder.End( );
+    }
+
+    /*---------------------------------------------------------------------------------
+        IsWritten
+        Returns 'true' if the rasterizer wrote to a pixel
+    ---------------------------------------------------------------------------------*/
+    bool IsWritten( const unsigned char * pixel )
+    {
+        return pixel[ 0 ] != ClearValue || pixel[ 1 ] != ClearValue || pixel[ 2 ] != ClearValue || pixel[ 3 ] != ClearValue;
+    }
+
+    /*---------------------------------------------------------------------------------
+        TestFrame
+        Draws a frame of random text with the rasterizer and the blitter, and
+        compares them. NV12 frames are compared by which pixels (and which 2x2
+        blocks, for chroma) are written
+    ---------------------------------------------------------------------------------*/
+    void TestFrame( TinyTextEncoder_c & encoder, TinyTextBlitter_c & blitter, unsigned int * vertices, int width, int height )
+    {
+        EncodeFrame( encoder, vertices, width, height, width * 7 + height );
+        const unsigned int vertexCount = encoder.GetNumVertices( );
+
+        const size_t pixelCount = size_t( width ) * height;
+        const int chromaWidth = ( width + 1 ) / 2;
+        const int chromaHeight = ( height + 1 ) / 2;
+
+        unsigned char * expected = new unsigned char[ pixelCount * 4 ];
+        unsigned char * actual = new unsigned char[ pixelCount * 4 ];
+        unsigned char * chroma = new unsigned char[ size_t( chromaWidth ) * chromaHeight * 2 ];
+
+        memset( expected, ClearValue, pixelCount * 4 );
+        TinyTextRasterizer_c rasterizer;
+        rasterizer.Draw( vertices, vertexCount, expected, width, height, width * 4 );
+
+        // RGBA matches exactly
+        TinyTextFrame_s frame;
+        frame.format = TinyTextFrame_s::PixelFormatRGBA;
+        frame.width = width;
+        frame.height = height;
+        frame.planes[ 0 ] = actual;
+        frame.planes[ 1 ] = 0;
+        frame.pitches[ 0 ] = width * 4;
+        frame.pitches[ 1 ] = 0;
+
+        memset( actual, ClearValue, pixelCount * 4 );
+        blitter.Blit( vertices, vertexCount, frame );
+
+        unsigned int rgbaDifferences = 0;
+        for ( size_t i = 0; i < pixelCount * 4; ++i )
+        {
+            rgbaDifferences += expected[ i ] != actual[ i ];
+        }
+
+        // BGRA matches with red and blue swapped
+        frame.format = TinyTextFrame_s::PixelFormatBGRA;
+        memset( actual, ClearValue, pixelCount * 4 );
+        blitter.Blit( vertices, vertexCount, frame );
+
+        unsigned int bgraDifferences = 0;
+        for ( size_t i = 0; i < pixelCount; ++i )
+        {
+            const unsigned char * e = expected + i * 4;
+            const unsigned char * a = actual + i * 4;
+            bgraDifferences += a[ 0 ] != e[ 2 ] || a[ 1 ] != e[ 1 ] || a[ 2 ] != e[ 0 ] || a[ 3 ] != e[ 3 ];
+        }
+
+        // NV12 writes the luma of the same pixels, and the chroma of every 2x2 block
+        // that contains one of them
+        frame.format = TinyTextFrame_s::PixelFormatNV12;
+        frame.planes[ 1 ] = chroma;
+        frame.pitches[ 0 ] = width;
+        frame.pitches[ 1 ] = chromaWidth * 2;
+
+        memset( actual, ClearValue, pixelCount );
+        memset( chroma, ClearValue, size_t( chromaWidth ) * chromaHeight * 2 );
+        blitter.Blit( vertices, vertexCount, frame );
+
+        unsigned int lumaDifferences = 0;
+        for ( size_t i = 0; i < pixelCount; ++i )
+        {
+            lumaDifferences += IsWritten( expected + i * 4 ) != ( actual[ i ] != ClearValue );
+        }
+
+        unsigned int chromaDifferences = 0;
+        for ( int y = 0; y < chromaHeight; ++y )
+        {
+            for ( int x = 0; x < chromaWidth; ++x )
+            {
+                bool written = false;
+                for ( int i = 0; i < 4; ++i )
+                {
+                    int pixelX = x * 2 + ( i & 1 );
+                    int pixelY = y * 2 + ( i >> 1 );
+                    written |= pixelX < width && pixelY < height && IsWritten( expected + ( size_t( pixelY ) * width + pixelX ) * 4 );
+                }
+
+                chromaDifferences += written != ( chroma[ ( y * chromaWidth + x ) * 2 ] != ClearValue );
+            }
+        }
+
+        printf( "%dx%d, %d thread(s): %u glyphs, differences RGBA %u, BGRA %u, luma %u, chroma %u\n", width, height, blitter.GetNumThreads( ),
+                vertexCount / TinyTextEncoder_c::NumVerticesPerCharacter, rgbaDifferences, bgraDifferences, lumaDifferences, chromaDifferences );
+
+        CHECK( vertexCount > 0 );
+        CHECK( rgbaDifferences == 0 );
+        CHECK( bgraDifferences == 0 );
+        CHECK( lumaDifferences == 0 );
+        CHECK( chromaDifferences == 0 );
+
+        delete [] expected;
+        delete [] actual;
+        delete [] chroma;
+    }
+
+    /*---------------------------------------------------------------------------------
+        TestScaledFrame
+        Checks that the blitter skips characters that aren't drawn at a scale of 1,
+        whether by the font scale or the format, and still draws the rest
+    ---------------------------------------------------------------------------------*/
+    void TestScaledFrame( TinyTextEncoder_c & encoder, TinyTextBlitter_c & blitter, unsigned int * vertices )
+    {
+        const int width = 160;
+        const int height = 64;
+        static unsigned char expected[ width * height * 4 ];
+        static unsigned char actual[ width * height * 4 ];
+
+        TinyTextFormat_c scaled( 0, TinyTextFormat_c::DefaultTabSize, TinyTextFormat_c::AnchorLeft | TinyTextFormat_c::AnchorTop, 2 );
+
+        encoder.Begin( vertices );
+        encoder.SetFontScale( 3.0f );
+        encoder.Print( float( width ), float( height ), 64, "Scaled", 2, 2, 0xFFFFFFFF );
+        encoder.SetFontScale( 1.0f );
+        encoder.Print( float( width ), float( height ), scaled, 64, "Scaled", 2, 30, 0xFFFFFFFF );
+        encoder.End( );
+        const unsigned int scaledVertexCount = encoder.GetNumVertices( );
+
+        encoder.Begin( vertices + scaledVertexCount * 4 );
+        encoder.Print( float( width ), float( height ), 64, "Unscaled", 80, 2, 0xFF00FF00 );
+        encoder.End( );
+        const unsigned int vertexCount = scaledVertexCount + encoder.GetNumVertices( );
+
+        // Only the unscaled text is drawn
+        memset( expected, ClearValue, sizeof( expected ) );
+        TinyTextRasterizer_c rasterizer;
+        rasterizer.Draw( vertices + scaledVertexCount * 4, vertexCount - scaledVertexCount, expected, width, height, width * 4 );
+
+        TinyTextFrame_s frame;
+        frame.format = TinyTextFrame_s::PixelFormatRGBA;
+        frame.width = width;
+        frame.height = height;
+        frame.planes[ 0 ] = actual;
+        frame.planes[ 1 ] = 0;
+        frame.pitches[ 0 ] = width * 4;
+        frame.pitches[ 1 ] = 0;
+
+        memset( actual, ClearValue, sizeof( actual ) );
+        blitter.Blit( vertices, vertexCount, frame );
+
+        CHECK( scaledVertexCount > 0 );
+        CHECK( !memcmp( expected, actual, sizeof( expected ) ) );
+    }
+//}
+
+/*---------------------------------------------------------------------------------
+    main
+    Entry point
+---------------------------------------------------------------------------------*/
+int main( )
+{
+    TinyTextEncoder_c encoder;
+    CHECK( encoder.Initialise( FrameCapacity ) );
+
+    unsigned int * vertices = new unsigned int[ FrameCapacity * TinyTextEncoder_c::NumVertexElementsPerCharacter ];
+
+    // Odd sizes leave partial tiles and chroma blocks at the edges
+    const int sizes[ ][ 2 ] = { { 33, 15 }, { 321, 97 }, { 640, 480 }, { 1279, 719 } };
+    const int threadCounts[ ] = { 1, 4 };
+
+    for ( int i = 0; i < 2; ++i )
+    {
+        TinyTextBlitter_c blitter;
+        CHECK( blitter.Initialise( FrameCapacity, threadCounts[ i ] ) );
+
+        for ( int j = 0; j < 4; ++j )
+        {
+            TestFrame( encoder, blitter, vertices, sizes[ j ][ 0 ], sizes[ j ][ 1 ] );
+        }
+
+        TestScaledFrame( encoder, blitter, vertices );
+    }
+
+    delete [] vertices;
+    return TestResult( );
+}
@@ -0,0 +1,454 @@
+/*=================================================================================
+
+    PROJECT:        Tiny Text Library for DirectX 10
+
+    DESCRIPTION:    Tests the calls that 'TinyTextContext_c' makes on the device
+                    context, using a mock device and device context that count
+                    them. On platforms without Windows it is built against the
+                    interface shim in 'TinyText.Tests/Shim'
+
+=================================================================================*/
+
+/*---------------------------------------------------------------------------------
+    Includes
+---------------------------------------------------------------------------------*/
+#include "TinyText.Core/TinyText.h"
+#include "TinyText.Core/TinyTextCapture.h"
+#include "TinyTextTest.h"
+#include <d3dx11.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <new>
+
+//namespace
+//{
+    /*---------------------------------------------------------------------------------
+        g_LiveObjectCount
+        The number of mock objects that haven't been released
+    ---------------------------------------------------------------------------------*/
+    int g_LiveObjectCount = 0;
+
+    /*---------------------------------------------------------------------------------
+        MockObject_c
+        A reference-counted implementation of an interface, which does nothing
+    ---------------------------------------------------------------------------------*/
+    template < class Interface_t > class MockObject_c : public Interface_t
+    {
+    private:
+
+        ULONG m_ReferenceCount;
+
+    public:
+
+        // Constructor
+        MockObject_c( ) : m_ReferenceCount( 1 ) { ++g_LiveObjectCount; }
+
+        // Destructor
+        virtual ~MockObject_c( ) { --g_LiveObjectCount; }
+
+        // IUnknown
+        virtual ULONG AddRef( ) { return ++m_ReferenceCount; }
+        virtual ULONG Release( )
+        {
+            ULONG referenceCount = --m_ReferenceCount;
+            if ( !referenceCount )
+            {
+                delete this;
+            }
+
+            return referenceCount;
+        }
+    };
+
+    /*---------------------------------------------------------------------------------
+        MockBlob_c
+        A blob holding a few bytes of pretend shader bytecode
+    ---------------------------------------------------------------------------------*/
+    class MockBlob_c : public MockObject_c< ID3D10Blob >
+    {
+    private:
+
+        char m_Bytes[ 16 ];
+
+    public:
+
+        virtual void * GetBufferPointer( ) { return m_Bytes; }
+        virtual size_t GetBufferSize( ) { return sizeof( m_Bytes ); }
+    };
+
+    /*---------------------------------------------------------------------------------
+        MockBuffer_c
+        A buffer, backed by system memory so that it can be mapped
+    ---------------------------------------------------------------------------------*/
+    class MockBuffer_c : public MockObject_c< ID3D11Buffer >
+    {
+    public:
+
+        unsigned char * m_Bytes;
+        UINT m_ByteWidth;
+
+        // Constructor
+        explicit MockBuffer_c( UINT byteWidth ) : m_Bytes( new unsigned char[ byteWidth ] ), m_ByteWidth( byteWidth ) { }
+
+        // Destructor
+        virtual ~MockBuffer_c( ) { delete [] m_Bytes; }
+    };
+
+    /*---------------------------------------------------------------------------------
+        CreateMockObject
+        Creates a mock object, returning it through an interface pointer
+    ---------------------------------------------------------------------------------*/
+    template < class Interface_t > HRESULT CreateMockObject( Interface_t ** object )
+    {
+        *object = new MockObject_c< Interface_t >( );
+        return S_OK;
+    }
+
+    /*---------------------------------------------------------------------------------
+        MockDevice_c
+        A device that creates mock objects
+    ---------------------------------------------------------------------------------*/
+    class MockDevice_c : public ID3D11Device
+    {
+    public:
+
+        virtual HRESULT CreateBuffer( const D3D11_BUFFER_DESC * desc, const D3D11_SUBRESOURCE_DATA *, ID3D11Buffer ** buffer )
+        {
+            *buffer = new MockBuffer_c( desc->ByteWidth );
+            return S_OK;
+        }
+
+        virtual HRESULT CreateTexture2D( const D3D11_TEXTURE2D_DESC *, const D3D11_SUBRESOURCE_DATA *, ID3D11Texture2D ** texture ) { return CreateMockObject( texture ); }
+        virtual HRESULT CreateShaderResourceView( ID3D11Resource *, const D3D11_SHADER_RESOURCE_VIEW_DESC *, ID3D11ShaderResourceView ** view ) { return CreateMockObject( view ); }
+        virtual HRESULT CreateInputLayout( const D3D11_INPUT_ELEMENT_DESC *, UINT, const void *, size_t, ID3D11InputLayout ** inputLayout ) { return CreateMockObject( inputLayout ); }
+        virtual HRESULT CreateVertexShader( const void *, size_t, ID3D11ClassLinkage *, ID3D11VertexShader ** shader ) { return CreateMockObject( shader ); }
+        virtual HRESULT CreatePixelShader( const void *, size_t, ID3D11ClassLinkage *, ID3D11PixelShader ** shader ) { return CreateMockObject( shader ); }
+        virtual HRESULT CreateDepthStencilState( const D3D11_DEPTH_STENCIL_DESC *, ID3D11DepthStencilState ** state ) { return CreateMockObject( state ); }
+        virtual HRESULT CreateSamplerState( const D3D11_SAMPLER_DESC *, ID3D11SamplerState ** state ) { return CreateMockObject( state ); }
+        virtual HRESULT CreateQuery( const D3D11_QUERY_DESC *, ID3D11Query ** query ) { return CreateMockObject( query ); }
+    };
+
+    /*---------------------------------------------------------------------------------
+        MockDeviceContext_c
+        A device context that counts the calls made on it. It has a render target
+        bound, and every query completes immediately
+    ---------------------------------------------------------------------------------*/
+    class MockDeviceContext_c : public ID3D11DeviceContext
+    {
+    public:
+
+        unsigned int m_Calls;
+        unsigned int m_MapCount;
+        unsigned int m_UnmapCount;
+        unsigned int m_DrawCount;
+        unsigned int m_VerticesDrawn;
+        bool m_Mapped;
+
+        // Constructor
+        MockDeviceContext_c( ) { Reset( ); }
+
+        // Resets the counts
+        void Reset( )
+        {
+            m_Calls = 0;
+            m_MapCount = 0;
+            m_UnmapCount = 0;
+            m_DrawCount = 0;
+            m_VerticesDrawn = 0;
+            m_Mapped = false;
+        }
+
+        virtual void VSSetShader( ID3D11VertexShader *, ID3D11ClassInstance * const *, UINT ) { ++m_Calls; }
+        virtual void PSSetShader( ID3D11PixelShader *, ID3D11ClassInstance * const *, UINT ) { ++m_Calls; }
+        virtual void PSSetShaderResources( UINT, UINT, ID3D11ShaderResourceView * const * ) { ++m_Calls; }
+        virtual void PSSetSamplers( UINT, UINT, ID3D11SamplerState * const * ) { ++m_Calls; }
+        virtual void GSSetShader( ID3D11GeometryShader *, ID3D11ClassInstance * const *, UINT ) { ++m_Calls; }
+        virtual void IASetInputLayout( ID3D11InputLayout * ) { ++m_Calls; }
+        virtual void IASetVertexBuffers( UINT, UINT, ID3D11Buffer * const *, const UINT *, const UINT * ) { ++m_Calls; }
+        virtual void IASetPrimitiveTopology( D3D11_PRIMITIVE_TOPOLOGY ) { ++m_Calls; }
+        virtual void OMSetBlendState( ID3D11BlendState *, const float *, UINT ) { ++m_Calls; }
+        virtual void OMSetDepthStencilState( ID3D11DepthStencilState *, UINT ) { ++m_Calls; }
+        virtual void RSSetState( ID3D11RasterizerState * ) { ++m_Calls; }
+
+        virtual void VSGetShader( ID3D11VertexShader ** shader, ID3D11ClassInstance **, UINT * ) { ++m_Calls; *shader = 0; }
+        virtual void PSGetShader( ID3D11PixelShader ** shader, ID3D11ClassInstance **, UINT * ) { ++m_Calls; *shader = 0; }
+        virtual void PSGetShaderResources( UINT, UINT, ID3D11ShaderResourceView ** views ) { ++m_Calls; *views = 0; }
+        virtual void PSGetSamplers( UINT, UINT, ID3D11SamplerState ** samplers ) { ++m_Calls; *samplers = 0; }
+        virtual void GSGetShader( ID3D11GeometryShader ** shader, ID3D11ClassInstance **, UINT * ) { ++m_Calls; *shader = 0; }
+        virtual void IAGetInputLayout( ID3D11InputLayout ** inputLayout ) { ++m_Calls; *inputLayout = 0; }
+        virtual void IAGetVertexBuffers( UINT, UINT, ID3D11Buffer ** buffers, UINT *, UINT * ) { ++m_Calls; *buffers = 0; }
+        virtual void IAGetPrimitiveTopology( D3D11_PRIMITIVE_TOPOLOGY * topology ) { ++m_Calls; *topology = D3D11_PRIMITIVE_TOPOLOGY_UNDEFINED; }
+        virtual void OMGetBlendState( ID3D11BlendState ** blendState, float *, UINT * ) { ++m_Calls; *blendState = 0; }
+        virtual void OMGetDepthStencilState( ID3D11DepthStencilState ** depthStencilState, UINT * ) { ++m_Calls; *depthStencilState = 0; }
+        virtual void RSGetState( ID3D11RasterizerState ** rasterizerState ) { ++m_Calls; *rasterizerState = 0; }
+
+        virtual void OMGetRenderTargets( UINT, ID3D11RenderTargetView ** views, ID3D11DepthStencilView ** )
+        {
+            ++m_Calls;
+            CreateMockObject( views );
+        }
+
+        virtual void Draw( UINT vertexCount, UINT )
+        {
+            ++m_Calls;
+            ++m_DrawCount;
+            m_VerticesDrawn += vertexCount;
+        }
+
+        virtual HRESULT Map( ID3D11Resource * resource, UINT, D3D11_MAP, UINT, D3D11_MAPPED_SUBRESOURCE * mappedResource )
+        {
+            ++m_Calls;
+            ++m_MapCount;
+            CHECK( !m_Mapped );
+            m_Mapped = true;
+
+            MockBuffer_c * buffer = static_cast< MockBuffer_c * >( static_cast< ID3D11Buffer * >( resource ) );
+            mappedResource->pData = buffer->m_Bytes;
+            mappedResource->RowPitch = buffer->m_ByteWidth;
+            mappedResource->DepthPitch = buffer->m_ByteWidth;
+            return S_OK;
+        }
+
+        virtual void Unmap( ID3D11Resource *, UINT )
+        {
+            ++m_Calls;
+            ++m_UnmapCount;
+            CHECK( m_Mapped );
+            m_Mapped = false;
+        }
+
+        virtual void UpdateSubresource( ID3D11Resource *, UINT, const D3D11_BOX *, const void *, UINT, UINT ) { ++m_Calls; }
+        virtual void Begin( ID3D11Asynchronous * ) { ++m_Calls; }
+        virtual void End( ID3D11Asynchronous * ) { ++m_Calls; }
+
+        virtual HRESULT GetData( ID3D11Asynchronous *, void * data, UINT dataSize, UINT )
+        {
+            ++m_Calls;
+
+            if ( dataSize == sizeof( D3D11_QUERY_DATA_TIMESTAMP_DISJOINT ) )
+            {
+                D3D11_QUERY_DATA_TIMESTAMP_DISJOINT disjoint = { 1000000, FALSE };
+                memcpy( data, &disjoint, sizeof( disjoint ) );
+            }
+            else
+            {
+                memset( data, 0, dataSize );
+            }
+
+            return S_OK;
+        }
+    };
+
+    /*---------------------------------------------------------------------------------
+        TestFrame
+        Prints some text and renders it, then checks the calls made on the device
+        context against the context's own count of them, and returns that count
+    ---------------------------------------------------------------------------------*/
+    unsigned int TestFrame( TinyTextContext_c & context, MockDeviceContext_c & deviceContext, bool maintainState )
+    {
+        D3D11_VIEWPORT viewport = { 0.0f, 0.0f, 640.0f, 480.0f, 0.0f, 1.0f };
+        const char * text = "Tiny Text";
+
+        deviceContext.Reset( );
+        CHECK( context.Print( viewport, text, 8, 8 ) );
+        CHECK( context.Render( maintainState ) );
+
+        TinyTextStats_c frame;
+        context.GetStats( &frame, 0 );
+
+        // One quad per visible character, all in a single map and draw
+        const unsigned int glyphCount = ( unsigned int ) strlen( text ) - 1;
+        CHECK( deviceContext.m_MapCount == 1 );
+        CHECK( deviceContext.m_UnmapCount == 1 );
+        CHECK( deviceContext.m_DrawCount == 1 );
+        CHECK( deviceContext.m_VerticesDrawn == glyphCount * TinyTextEncoder_c::NumVerticesPerCharacter );
+        CHECK( !deviceContext.m_Mapped );
+
+        CHECK( frame.glyphsEncoded == glyphCount );
+        CHECK( frame.verticesDrawn == deviceContext.m_VerticesDrawn );
+        CHECK( frame.bytesUploaded == glyphCount * TinyTextEncoder_c::NumVertexElementsPerCharacter * 4 );
+        CHECK( frame.mapCount == deviceContext.m_MapCount );
+        CHECK( frame.drawCalls == deviceContext.m_DrawCount );
+        CHECK( frame.deviceContextCalls == deviceContext.m_Calls );
+
+        return deviceContext.m_Calls;
+    }
+//}
+
+/*---------------------------------------------------------------------------------
+    D3DX11CompileFromMemory
+    Returns a blob of pretend bytecode for every shader
+---------------------------------------------------------------------------------*/
+HRESULT D3DX11CompileFromMemory( const char *, size_t, const char *, const D3D10_SHADER_MACRO *, ID3D10Include *, const char *, const char *, UINT, UINT,
+                                 ID3DX11ThreadPump *, ID3D10Blob ** shader, ID3D10Blob ** errorMessages, HRESULT * )
+{
+    *shader = new MockBlob_c( );
+    *errorMessages = 0;
+    return S_OK;
+}
+
+/*---------------------------------------------------------------------------------
+    D3DX11CreateTextureFromMemory
+    Returns a mock texture
+---------------------------------------------------------------------------------*/
+HRESULT D3DX11CreateTextureFromMemory( ID3D11Device *, const void *, size_t, D3DX11_IMAGE_LOAD_INFO *, ID3DX11ThreadPump *, ID3D11Resource ** texture, HRESULT * )
+{
+    ID3D11Texture2D * texture2D = 0;
+    CreateMockObject( &texture2D );
+    *texture = texture2D;
+    return S_OK;
+}
+
+/*---------------------------------------------------------------------------------
+    main
+    Entry point
+---------------------------------------------------------------------------------*/
+int main( )
+{
+    MockDevice_c device;
+    MockDeviceContext_c deviceContext;
+
+    bool result = false;
+    TinyTextContext_c * context = new ( std::nothrow ) TinyTextContext_c( &device, &deviceContext, 1024, &result );
+    CHECK( context && result );
+
+    if ( !context || !result )
+    {
+        delete context;
+        return TestResult( );
+    }
+
+    // A frame that maintains the device state: a map and unmap, the render target
+    // check, 11 calls to capture the state, 11 to set it up, the draw and 11 calls
+    // to restore the state
+    CHECK( TestFrame( *context, deviceContext, true ) == 37 );
+    CHECK( TestFrame( *context, deviceContext, true ) == 37 );
+
+    // Without maintaining the state, the capture and restore are skipped
+    CHECK( TestFrame( *context, deviceContext, false ) == 15 );
+
+    // On a frame where nothing is printed, the statistics overlay maps the vertex
+    // buffer itself. It is drawn, but the frame reports the same as it would without
+    // the overlay: no maps, no glyphs and no more calls
+    TinyTextStats_c idleFrame;
+    deviceContext.Reset( );
+    CHECK( context->Render( ) );
+    context->GetStats( &idleFrame, 0 );
+    CHECK( deviceContext.m_MapCount == 0 );
+    CHECK( idleFrame.mapCount == 0 );
+
+    D3D11_VIEWPORT overlayViewport = { 0.0f, 0.0f, 640.0f, 480.0f, 0.0f, 1.0f };
+    TinyTextStats_c overlayFrame;
+    context->EnableStatsOverlay( &overlayViewport );
+    deviceContext.Reset( );
+    CHECK( context->Render( ) );
+    context->GetStats( &overlayFrame, 0 );
+    context->EnableStatsOverlay( 0 );
+
+    CHECK( deviceContext.m_MapCount == 1 );
+    CHECK( deviceContext.m_VerticesDrawn > 0 );
+    CHECK( overlayFrame.mapCount == 0 );
+    CHECK( overlayFrame.glyphsEncoded == 0 );
+    CHECK( overlayFrame.bytesUploaded == 0 );
+    CHECK( overlayFrame.verticesDrawn == 0 );
+    CHECK( overlayFrame.drawCalls == idleFrame.drawCalls );
+    CHECK( overlayFrame.deviceContextCalls == idleFrame.deviceContextCalls );
+    CHECK( overlayFrame.deviceContextCalls == deviceContext.m_Calls - 2 );
+
+    // GPU timing adds the queries around the draw and, from the second frame, reads
+    // the results of the previous frame's queries
+    CHECK( context->EnableGpuStats( true ) );
+    CHECK( TestFrame( *context, deviceContext, true ) == 37 + 4 );
+    CHECK( TestFrame( *context, deviceContext, true ) == 37 + 4 + 3 );
+
+    // Traced events are written as a JSON array, one event per line
+    CHECK( context->EnableTrace( 64 ) );
+    TestFrame( *context, deviceContext, true );
+    CHECK( context->WriteTrace( "tinytext-trace-test.json" ) );
+
+    char trace[ 4096 ] = { 0 };
+    FILE * file = fopen( "tinytext-trace-test.json", "r" );
+    CHECK( file );
+
+    if ( file )
+    {
+        fread( trace, 1, sizeof( trace ) - 1, file );
+        fclose( file );
+        remove( "tinytext-trace-test.json" );
+    }
+
+    CHECK( !strncmp( trace, "[\n{\"name\":", 10 ) );
+    CHECK( strstr( trace, "},\n{\"name\":\"Draw\"" ) );
+    CHECK( strstr( trace, "}\n]\n" ) );
+
+    // A capture starts with the settings in place when it was opened, and records
+    // each change of code page and font scale before the prints that it affects
+    D3D11_VIEWPORT viewport = { 0.0f, 0.0f, 640.0f, 480.0f, 0.0f, 1.0f };
+    context->SetFontScale( 3.0f );
+    CHECK( context->BeginCapture( "tinytext-capture-test.ttxc" ) );
+    CHECK( context->Print( viewport, "Scaled", 0, 0 ) );
+    context->SetCodePage( TinyTextContext_c::CodePage437 );
+    context->SetFontScale( 2.0f );
+    CHECK( context->Print( viewport, "\xb3", 0, 0 ) );
+    context->SetCodePage( TinyTextContext_c::CodePageUTF8 );
+    CHECK( context->Print( viewport, "\xc3\xa9", 0, 0 ) );
+    CHECK( context->Render( ) );
+    CHECK( context->EndCapture( ) );
+    context->SetCodePage( TinyTextContext_c::CodePageWindows1252 );
+    context->SetFontScale( 1.0f );
+
+    TinyTextCaptureReader_c captureReader;
+    TinyTextCaptureReader_c::Print_s print;
+    CHECK( captureReader.Load( "tinytext-capture-test.ttxc" ) );
+    remove( "tinytext-capture-test.ttxc" );
+
+    CHECK( captureReader.Read( &print ) == TinyTextCaptureReader_c::RecordPrint );
+    CHECK( print.fontScale == 3.0f && !print.utf8 && print.characterMap && print.characterMap[ 0xB3 ] == 0xB3 );
+    CHECK( captureReader.Read( &print ) == TinyTextCaptureReader_c::RecordPrint );
+    CHECK( print.fontScale == 2.0f && !print.utf8 && print.characterMap && print.characterMap[ 0xB3 ] == '|' );
+    CHECK( captureReader.Read( &print ) == TinyTextCaptureReader_c::RecordPrint );
+    CHECK( print.fontScale == 2.0f && print.utf8 );
+    CHECK( captureReader.Read( &print ) == TinyTextCaptureReader_c::RecordRender );
+    CHECK( captureReader.Read( &print ) == TinyTextCaptureReader_c::RecordEnd );
+
+    // Only blanks that would have been drawn count as skipped, not those that would
+    // have been culled by the viewport anyway
+    const unsigned int skippedVertices = context->GetNumSkippedVertices( );
+    CHECK( context->Print( viewport, "a b", 8, 8 ) );
+    CHECK( context->GetNumSkippedVertices( ) == skippedVertices + TinyTextEncoder_c::NumVerticesPerCharacter );
+    CHECK( context->Print( viewport, "a b", -100, 8 ) );
+    CHECK( context->Print( viewport, "a b", 8, 1000 ) );
+    CHECK( context->GetNumSkippedVertices( ) == skippedVertices + TinyTextEncoder_c::NumVerticesPerCharacter );
+    CHECK( context->Render( ) );
+
+    // Only one context in a process can publish shared counters, and the other
+    // can't remove them
+    TinyTextContext_c * otherContext = new ( std::nothrow ) TinyTextContext_c( &device, &deviceContext, 16, &result );
+    CHECK( otherContext && result );
+
+    if ( otherContext )
+    {
+        CHECK( context->EnableSharedCounters( true ) );
+        CHECK( !otherContext->EnableSharedCounters( true ) );
+        CHECK( otherContext->EnableSharedCounters( false ) );
+        TestFrame( *context, deviceContext, true );
+
+        TinyTextCountersReader_c reader;
+        TinyTextCounters_s counters;
+        CHECK( reader.Open( ( unsigned long ) getpid( ) ) );
+        CHECK( reader.Read( &counters ) );
+        CHECK( counters.deviceContextCalls == deviceContext.m_Calls );
+
+        // Once the first context stops publishing, the other can start
+        CHECK( context->EnableSharedCounters( false ) );
+        CHECK( otherContext->EnableSharedCounters( true ) );
+        delete otherContext;
+    }
+
+    // Everything that the context created is released
+    delete context;
+    CHECK( g_LiveObjectCount == 0 );
+
+    return TestResult( );
+}
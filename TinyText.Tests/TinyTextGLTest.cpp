@@ -0,0 +1,248 @@
+/*=================================================================================
+
+    PROJECT:        Tiny Text Library for DirectX 10
+
+    DESCRIPTION:    Checks that 'TinyTextContextGL_c' draws the same pixels as the
+                    reference rasterizer, both with a persistently mapped vertex
+                    buffer and without one
+
+    USAGE:          - This test is opt-in, as it needs EGL and an OpenGL 3.3 core
+                      profile driver. It renders off-screen, through a
+                      surfaceless EGL display, so Mesa's llvmpipe software driver
+                      is enough (set LIBGL_ALWAYS_SOFTWARE=1 to make sure that it
+                      is used)
+
+                    - It fails if no context can be created, rather than
+                      skipping the comparison
+
+=================================================================================*/
+
+/*---------------------------------------------------------------------------------
+    Includes
+---------------------------------------------------------------------------------*/
+#include "TinyText.Core/TinyTextGL.h"
+#include "TinyText.Core/TinyTextRasterizer.h"
+#include "TinyTextTest.h"
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <GL/glcorearb.h>
+#include <stdio.h>
+#include <string.h>
+
+/*---------------------------------------------------------------------------------
+    Constants
+---------------------------------------------------------------------------------*/
+//namespace
+//{
+    // Size of the render target (in pixels) - odd, so that no row is a multiple of
+    // a larger alignment
+    const int           TargetWidth             = 641;
+    const int           TargetHeight            = 359;
+
+    // Maximum number of characters in a frame
+    const unsigned int  FrameCapacity           = 2048;
+
+    // Number of frames drawn with each kind of vertex buffer
+    const int           FrameCount              = 6;
+//}
+
+/*---------------------------------------------------------------------------------
+    State
+---------------------------------------------------------------------------------*/
+//namespace
+//{
+    // Set to hide 'glBufferStorage', so that the context falls back to copying each
+    // frame into the vertex buffer
+    bool                HideBufferStorage       = false;
+//}
+
+//namespace
+//{
+    /*---------------------------------------------------------------------------------
+        GetProcAddress
+        Looks up an OpenGL function for the text context
+    ---------------------------------------------------------------------------------*/
+    void * GetProcAddress( const char * name )
+    {
+        if ( HideBufferStorage && !strcmp( name, "glBufferStorage" ) )
+        {
+            return 0;
+        }
+
+        return ( void * ) eglGetProcAddress( name );
+    }
+
+    /*---------------------------------------------------------------------------------
+        CreateContext
+        Creates an OpenGL 3.3 core profile context with no surface, and makes it
+        current - returns 'false' on failure
+    ---------------------------------------------------------------------------------*/
+    bool CreateContext( )
+    {
+        PFNEGLGETPLATFORMDISPLAYEXTPROC eglGetPlatformDisplayEXT = ( PFNEGLGETPLATFORMDISPLAYEXTPROC ) eglGetProcAddress( "eglGetPlatformDisplayEXT" );
+        if ( !eglGetPlatformDisplayEXT )
+        {
+            return false;
+        }
+
+        EGLDisplay display = eglGetPlatformDisplayEXT( EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, 0 );
+        EGLint major;
+        EGLint minor;
+
+        if ( display == EGL_NO_DISPLAY || !eglInitialize( display, &major, &minor ) || !eglBindAPI( EGL_OPENGL_API ) )
+        {
+            return false;
+        }
+
+        const EGLint configAttributes[ ] = { EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT, EGL_NONE };
+        EGLConfig config = 0;
+        EGLint configCount = 0;
+        eglChooseConfig( display, configAttributes, &config, 1, &configCount );
+
+        const EGLint contextAttributes[ ] =
+        {
+            EGL_CONTEXT_MAJOR_VERSION, 3,
+            EGL_CONTEXT_MINOR_VERSION, 3,
+            EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+            EGL_NONE
+        };
+
+        EGLContext context = eglCreateContext( display, configCount ? config : 0, EGL_NO_CONTEXT, contextAttributes );
+
+        return context != EGL_NO_CONTEXT && eglMakeCurrent( display, EGL_NO_SURFACE, EGL_NO_SURFACE, context );
+    }
+
+    /*---------------------------------------------------------------------------------
+        TestContext
+        Draws frames of text with a text context and the reference rasterizer, and
+        compares them
+    ---------------------------------------------------------------------------------*/
+    void TestContext( bool persistent )
+    {
+        PFNGLCLEARCOLORPROC glClearColor = ( PFNGLCLEARCOLORPROC ) eglGetProcAddress( "glClearColor" );
+        PFNGLCLEARPROC glClear = ( PFNGLCLEARPROC ) eglGetProcAddress( "glClear" );
+        PFNGLREADPIXELSPROC glReadPixels = ( PFNGLREADPIXELSPROC ) eglGetProcAddress( "glReadPixels" );
+        PFNGLPIXELSTOREIPROC glPixelStorei = ( PFNGLPIXELSTOREIPROC ) eglGetProcAddress( "glPixelStorei" );
+        PFNGLENABLEPROC glEnable = ( PFNGLENABLEPROC ) eglGetProcAddress( "glEnable" );
+        PFNGLISENABLEDPROC glIsEnabled = ( PFNGLISENABLEDPROC ) eglGetProcAddress( "glIsEnabled" );
+        PFNGLGETERRORPROC glGetError = ( PFNGLGETERRORPROC ) eglGetProcAddress( "glGetError" );
+
+        HideBufferStorage = !persistent;
+
+        bool result = false;
+        TinyTextContextGL_c * context = new TinyTextContextGL_c( GetProcAddress, FrameCapacity, &result );
+        CHECK( result );
+
+        // Only check the kind of buffer asked for if the driver could provide it
+        CHECK( !context->IsPersistentlyMapped( ) || persistent );
+
+        static unsigned int vertices[ FrameCapacity * TinyTextEncoder_c::NumVertexElementsPerCharacter ];
+        static unsigned char expected[ TargetWidth * TargetHeight * 4 ];
+        static unsigned char actual[ TargetWidth * TargetHeight * 4 ];
+
+        TinyTextEncoder_c encoder;
+        CHECK( encoder.Initialise( FrameCapacity ) );
+        TinyTextRasterizer_c rasterizer;
+
+        // State that the context changes, and must restore
+        glEnable( GL_BLEND );
+        glEnable( GL_DEPTH_TEST );
+        glPixelStorei( GL_PACK_ALIGNMENT, 1 );
+
+        unsigned int differences = 0;
+
+        for ( int frame = 0; frame < FrameCount; ++frame )
+        {
+            glClearColor( 0.0f, 0.0f, 0.0f, 0.0f );
+            glClear( GL_COLOR_BUFFER_BIT );
+
+            encoder.Begin( vertices );
+
+            for ( int line = 0; line < 30; ++line )
+            {
+                char text[ 128 ];
+                sprintf( text, "Frame %d line %d: The quick brown fox {}[]~ \xe9\xfc", frame, line );
+
+                int x = ( line * 7 + frame * 3 ) % 60 - 10;
+                int y = line * 12 - 5;
+                unsigned int colour = 0xFF000000 | ( ( line * 0x10305 * ( frame + 1 ) ) & 0xFFFFFF );
+
+                CHECK( context->Print( TargetWidth, TargetHeight, text, x, y, colour ) );
+                encoder.Print( float( TargetWidth ), float( TargetHeight ), 0xffffffff, text, x, y, colour );
+            }
+
+            const char * wrappedText = "Wrapped text that goes over several lines of the viewport";
+            TinyTextFormat_c format( 150 );
+            CHECK( context->Print( TargetWidth, TargetHeight, format, wrappedText, 400, 200, 0xFF00FFFF ) );
+            encoder.Print( float( TargetWidth ), float( TargetHeight ), format, 0xffffffff, wrappedText, 400, 200, 0xFF00FFFF );
+
+            encoder.End( );
+            CHECK( context->Render( ) );
+
+            // OpenGL's rows start at the bottom of the image
+            glReadPixels( 0, 0, TargetWidth, TargetHeight, GL_RGBA, GL_UNSIGNED_BYTE, actual );
+
+            memset( expected, 0, sizeof( expected ) );
+            rasterizer.Draw( vertices, encoder.GetNumVertices( ), expected, TargetWidth, TargetHeight, TargetWidth * 4 );
+
+            for ( int y = 0; y < TargetHeight; ++y )
+            {
+                const unsigned char * expectedRow = expected + y * TargetWidth * 4;
+                const unsigned char * actualRow = actual + ( TargetHeight - 1 - y ) * TargetWidth * 4;
+
+                for ( int x = 0; x < TargetWidth * 4; ++x )
+                {
+                    differences += expectedRow[ x ] != actualRow[ x ];
+                }
+            }
+        }
+
+        printf( "%s vertex buffer: %d frames, %u differences\n", context->IsPersistentlyMapped( ) ? "Persistently mapped" : "Copied", FrameCount, differences );
+
+        CHECK( differences == 0 );
+        CHECK( glIsEnabled( GL_BLEND ) );
+        CHECK( glIsEnabled( GL_DEPTH_TEST ) );
+        CHECK( glGetError( ) == GL_NO_ERROR );
+
+        delete context;
+        CHECK( glGetError( ) == GL_NO_ERROR );
+    }
+//}
+
+/*---------------------------------------------------------------------------------
+    main
+    Entry point
+---------------------------------------------------------------------------------*/
+int main( )
+{
+    if ( !CreateContext( ) )
+    {
+        printf( "Couldn't create an OpenGL 3.3 context through EGL\n" );
+        CHECK( false );
+        return TestResult( );
+    }
+
+    // Render into an RGBA framebuffer of its own
+    PFNGLGENFRAMEBUFFERSPROC glGenFramebuffers = ( PFNGLGENFRAMEBUFFERSPROC ) eglGetProcAddress( "glGenFramebuffers" );
+    PFNGLBINDFRAMEBUFFERPROC glBindFramebuffer = ( PFNGLBINDFRAMEBUFFERPROC ) eglGetProcAddress( "glBindFramebuffer" );
+    PFNGLGENRENDERBUFFERSPROC glGenRenderbuffers = ( PFNGLGENRENDERBUFFERSPROC ) eglGetProcAddress( "glGenRenderbuffers" );
+    PFNGLBINDRENDERBUFFERPROC glBindRenderbuffer = ( PFNGLBINDRENDERBUFFERPROC ) eglGetProcAddress( "glBindRenderbuffer" );
+    PFNGLRENDERBUFFERSTORAGEPROC glRenderbufferStorage = ( PFNGLRENDERBUFFERSTORAGEPROC ) eglGetProcAddress( "glRenderbufferStorage" );
+    PFNGLFRAMEBUFFERRENDERBUFFERPROC glFramebufferRenderbuffer = ( PFNGLFRAMEBUFFERRENDERBUFFERPROC ) eglGetProcAddress( "glFramebufferRenderbuffer" );
+    PFNGLVIEWPORTPROC glViewport = ( PFNGLVIEWPORTPROC ) eglGetProcAddress( "glViewport" );
+
+    GLuint framebuffer;
+    GLuint renderbuffer;
+    glGenFramebuffers( 1, &framebuffer );
+    glBindFramebuffer( GL_FRAMEBUFFER, framebuffer );
+    glGenRenderbuffers( 1, &renderbuffer );
+    glBindRenderbuffer( GL_RENDERBUFFER, renderbuffer );
+    glRenderbufferStorage( GL_RENDERBUFFER, GL_RGBA8, TargetWidth, TargetHeight );
+    glFramebufferRenderbuffer( GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, renderbuffer );
+    glViewport( 0, 0, TargetWidth, TargetHeight );
+
+    TestContext( true );
+    TestContext( false );
+
+    return TestResult( );
+}
@@ -0,0 +1,360 @@
+/*=================================================================================
+
+    PROJECT:        Tiny Text Library for DirectX 10
+
+    DESCRIPTION:    Checks that 'TinyTextGlyphCache_c' copies each glyph once,
+                    evicts the page used least recently (but never one used in
+                    the current frame) and forgets the ASCII glyphs of the pages
+                    it evicts, and that UTF-8 text printed through it draws '?'
+                    for malformed and truncated sequences
+
+=================================================================================*/
+
+/*---------------------------------------------------------------------------------
+    Includes
+---------------------------------------------------------------------------------*/
+#include "TinyText.Core/TinyTextEncoder.h"
+#include "TinyText.Core/TinyTextGlyphCache.h"
+#include "TinyTextTest.h"
+#include <stdio.h>
+#include <string.h>
+#include <new>
+
+/*---------------------------------------------------------------------------------
+    Constants
+---------------------------------------------------------------------------------*/
+//namespace
+//{
+    // The glyphs of the test font - '?', 'A' and the first few CJK ideographs - each
+    // a square of this many texels, side by side in the atlas
+    const unsigned int  GlyphSize               = 7;
+    const unsigned int  CJKCodePoint            = 0x4E00;
+    const unsigned int  CJKGlyphCount           = 16;
+    const unsigned int  GlyphCount              = 2 + CJKGlyphCount;
+
+    const unsigned int  AtlasWidth              = GlyphCount * ( GlyphSize + 1 );
+    const unsigned int  AtlasHeight             = GlyphSize;
+
+    // Size of the font pack, in 32-bit words
+    const unsigned int  FontPackWordCount       = ( sizeof( TinyTextFontPackHeader_s ) + GlyphCount * sizeof( TinyTextFontGlyph_s ) + AtlasWidth * AtlasHeight + 3 ) / 4;
+
+    // Pages of the cache - each has room for two shelves of two glyphs (with their
+    // gutters), so the font fills it several times over
+    const int           PageSize                = 16;
+    const int           PageCount               = 3;
+
+    // Size of the viewport that text is printed to
+    const float         ViewportWidth           = 640.0f;
+    const float         ViewportHeight          = 480.0f;
+//}
+
+//namespace
+//{
+    /*---------------------------------------------------------------------------------
+        BuildFontPack
+        Writes the test font into 'pack' - every texel of each glyph has a value of
+        its own, so a glyph copied to the wrong place, or from the wrong place, shows
+    ---------------------------------------------------------------------------------*/
+    void BuildFontPack( unsigned int * pack )
+    {
+        memset( pack, 0, FontPackWordCount * 4 );
+
+        TinyTextFontPackHeader_s * header = ( TinyTextFontPackHeader_s * ) pack;
+        memcpy( header->magic, "TTFP", 4 );
+        header->version = TinyTextFontPack_c::Version;
+        header->byteCount = FontPackWordCount * 4;
+        header->atlasWidth = AtlasWidth;
+        header->atlasHeight = AtlasHeight;
+        header->characterWidth = GlyphSize + 1;
+        header->lineHeight = GlyphSize + 1;
+        header->glyphCount = GlyphCount;
+        header->glyphOffset = sizeof( TinyTextFontPackHeader_s );
+        header->atlasOffset = header->glyphOffset + GlyphCount * sizeof( TinyTextFontGlyph_s );
+
+        TinyTextFontGlyph_s * glyphs = ( TinyTextFontGlyph_s * )( ( unsigned char * ) pack + header->glyphOffset );
+        unsigned char * atlas = ( unsigned char * ) pack + header->atlasOffset;
+
+        for ( unsigned int i = 0; i < GlyphCount; ++i )
+        {
+            TinyTextFontGlyph_s & glyph = glyphs[ i ];
+            glyph.codePoint = i == 0 ? '?' : i == 1 ? 'A' : CJKCodePoint + i - 2;
+            glyph.u = ( unsigned short )( i * ( GlyphSize + 1 ) );
+            glyph.width = GlyphSize;
+            glyph.height = GlyphSize;
+            glyph.advance = GlyphSize + 1;
+
+            for ( unsigned int y = 0; y < GlyphSize; ++y )
+            {
+                for ( unsigned int x = 0; x < GlyphSize; ++x )
+                {
+                    atlas[ y * AtlasWidth + glyph.u + x ] = ( unsigned char )( 1 + ( i * 49 + y * GlyphSize + x ) % 255 );
+                }
+            }
+        }
+    }
+
+    /*---------------------------------------------------------------------------------
+        IsGlyphAt
+        Returns 'true' if the cache's texture holds the pack's glyph of a code point at
+        the specified texel, followed by a blank gutter
+    ---------------------------------------------------------------------------------*/
+    bool IsGlyphAt( const TinyTextGlyphCache_c & cache, const TinyTextFontPack_c & pack, unsigned int codePoint, int u, int v )
+    {
+        const TinyTextFontGlyph_s * glyph = pack.FindGlyph( codePoint );
+
+        if ( !glyph || u < 0 || v < 0 || u + glyph->width + 1 > cache.GetTextureWidth( ) || v + glyph->height + 1 > cache.GetTextureHeight( ) )
+        {
+            return false;
+        }
+
+        for ( int y = 0; y <= glyph->height; ++y )
+        {
+            for ( int x = 0; x <= glyph->width; ++x )
+            {
+                const unsigned char expected = x < glyph->width && y < glyph->height ? pack.GetAtlas( )[ ( glyph->v + y ) * AtlasWidth + glyph->u + x ] : 0;
+
+                if ( cache.GetTexels( )[ ( v + y ) * cache.GetTextureWidth( ) + u + x ] != expected )
+                {
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    /*---------------------------------------------------------------------------------
+        FindGlyphs
+        Looks up a range of the CJK glyphs - returns the number found, each of which
+        must be in the cache's texture
+    ---------------------------------------------------------------------------------*/
+    unsigned int FindGlyphs( TinyTextGlyphCache_c & cache, const TinyTextFontPack_c & pack, unsigned int first, unsigned int count, bool * valid )
+    {
+        unsigned int found = 0;
+
+        for ( unsigned int i = first; i < first + count; ++i )
+        {
+            const TinyTextFontGlyph_s * glyph = cache.FindGlyph( CJKCodePoint + i );
+
+            if ( glyph )
+            {
+                *valid = *valid && IsGlyphAt( cache, pack, CJKCodePoint + i, glyph->u, glyph->v );
+                ++found;
+            }
+        }
+
+        return found;
+    }
+
+    /*---------------------------------------------------------------------------------
+        GetPage
+        Returns the page of the cache that a glyph is in
+    ---------------------------------------------------------------------------------*/
+    int GetPage( const TinyTextFontGlyph_s * glyph )
+    {
+        return glyph ? glyph->v / PageSize : -1;
+    }
+
+    /*---------------------------------------------------------------------------------
+        IsCharacterDrawn
+        Returns 'true' if the character at 'index' of the vertices was drawn with the
+        pack's glyph of a code point
+    ---------------------------------------------------------------------------------*/
+    bool IsCharacterDrawn( const TinyTextGlyphCache_c & cache, const TinyTextFontPack_c & pack, const unsigned int * vertices, unsigned int index, unsigned int codePoint )
+    {
+        // The second vertex of each character is its top-left corner
+        const unsigned int uv = vertices[ index * TinyTextEncoder_c::NumVertexElementsPerCharacter + 6 ];
+        return IsGlyphAt( cache, pack, codePoint, uv & 0xFFFF, uv >> 16 );
+    }
+
+    /*---------------------------------------------------------------------------------
+        PrintsAs
+        Prints some text through the cache, and returns 'true' if it draws exactly the
+        specified code points
+    ---------------------------------------------------------------------------------*/
+    bool PrintsAs( TinyTextEncoder_c & encoder, TinyTextGlyphCache_c & cache, const TinyTextFontPack_c & pack, unsigned int * vertices, const TinyTextFormat_c * format,
+                   size_t maxCharacterCount, const char * text, const unsigned int * codePoints, unsigned int codePointCount )
+    {
+        encoder.Begin( vertices );
+
+        if ( format )
+        {
+            encoder.Print( ViewportWidth, ViewportHeight, *format, maxCharacterCount, text, 8, 8, 0xFFFFFFFF );
+        }
+        else
+        {
+            encoder.Print( ViewportWidth, ViewportHeight, maxCharacterCount, text, 8, 8, 0xFFFFFFFF );
+        }
+
+        encoder.End( );
+        cache.EndFrame( );
+
+        if ( encoder.GetNumVertices( ) != codePointCount * TinyTextEncoder_c::NumVerticesPerCharacter )
+        {
+            return false;
+        }
+
+        for ( unsigned int i = 0; i < codePointCount; ++i )
+        {
+            if ( !IsCharacterDrawn( cache, pack, vertices, i, codePoints[ i ] ) )
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+//}
+
+/*---------------------------------------------------------------------------------
+    main
+    Entry point
+---------------------------------------------------------------------------------*/
+int main( )
+{
+    static unsigned int packWords[ FontPackWordCount ];
+    BuildFontPack( packWords );
+
+    TinyTextFontPack_c pack;
+    CHECK( pack.OpenMemory( packWords, sizeof( packWords ) ) );
+
+    TinyTextGlyphCache_c cache;
+    CHECK( cache.Initialise( &pack, PageSize, PageCount ) );
+
+    int firstRow;
+    int rowCount;
+    bool valid = true;
+
+    // Frame 1 copies four glyphs into the first page, and its rows need uploading
+    CHECK( FindGlyphs( cache, pack, 0, 4, &valid ) == 4 );
+    CHECK( cache.GetNumCopiedGlyphs( ) == 4 );
+    CHECK( cache.GetDirtyRows( &firstRow, &rowCount ) && firstRow == 0 && rowCount == PageSize );
+    CHECK( GetPage( cache.FindGlyph( CJKCodePoint ) ) == 0 );
+    cache.ClearDirtyRows( );
+    cache.EndFrame( );
+
+    // Frame 2 prints the same text, so copies and uploads nothing
+    CHECK( FindGlyphs( cache, pack, 0, 4, &valid ) == 4 );
+    CHECK( cache.GetNumCopiedGlyphs( ) == 0 );
+    CHECK( !cache.GetDirtyRows( &firstRow, &rowCount ) );
+    cache.EndFrame( );
+
+    // Frames 3 and 4 fill the other two pages - 'A' goes into the second
+    CHECK( GetPage( cache.FindGlyph( 'A' ) ) == 1 );
+    CHECK( FindGlyphs( cache, pack, 4, 3, &valid ) == 3 );
+    cache.EndFrame( );
+
+    CHECK( FindGlyphs( cache, pack, 8, 4, &valid ) == 4 );
+    CHECK( GetPage( cache.FindGlyph( CJKCodePoint + 8 ) ) == 2 );
+    cache.ClearDirtyRows( );
+    cache.EndFrame( );
+
+    CHECK( cache.GetNumCachedGlyphs( ) == 12 );
+    CHECK( cache.GetNumEvictedPages( ) == 0 );
+
+    // Frame 5 uses the first page again, so the second - used in frame 3 - is the
+    // least recently used, and is evicted to make room
+    CHECK( FindGlyphs( cache, pack, 0, 1, &valid ) == 1 );
+    CHECK( FindGlyphs( cache, pack, 12, 4, &valid ) == 4 );
+    CHECK( cache.GetNumEvictedPages( ) == 1 );
+    CHECK( GetPage( cache.FindGlyph( CJKCodePoint + 12 ) ) == 1 );
+    CHECK( cache.GetDirtyRows( &firstRow, &rowCount ) && firstRow == PageSize && rowCount == PageSize );
+
+    // The ASCII table forgets 'A', which went with the page, so it is copied again -
+    // into the third page, the only one not yet used in this frame
+    CHECK( GetPage( cache.FindGlyph( 'A' ) ) == 2 );
+    CHECK( cache.GetNumEvictedPages( ) == 2 );
+    CHECK( cache.FindGlyph( 'A' ) && IsGlyphAt( cache, pack, 'A', cache.FindGlyph( 'A' )->u, cache.FindGlyph( 'A' )->v ) );
+    CHECK( FindGlyphs( cache, pack, 4, 3, &valid ) == 3 );
+    CHECK( cache.GetNumCopiedGlyphs( ) == 8 );
+    CHECK( cache.GetDirtyRows( &firstRow, &rowCount ) && firstRow == PageSize && rowCount == 2 * PageSize );
+
+    // Every page is now used in this frame, so none can be evicted - the next glyph is
+    // left out, and the glyphs already encoded stay where they are
+    CHECK( !cache.FindGlyph( CJKCodePoint + 7 ) );
+    CHECK( cache.GetNumMissingGlyphs( ) == 1 );
+    CHECK( cache.GetNumEvictedPages( ) == 2 );
+    CHECK( FindGlyphs( cache, pack, 0, 1, &valid ) == 1 );
+    CHECK( FindGlyphs( cache, pack, 4, 3, &valid ) == 3 );
+    CHECK( FindGlyphs( cache, pack, 12, 4, &valid ) == 4 );
+    CHECK( cache.GetNumCopiedGlyphs( ) == 8 );
+    cache.ClearDirtyRows( );
+    cache.EndFrame( );
+
+    CHECK( cache.GetNumCopiedGlyphs( ) == 0 );
+    CHECK( cache.GetNumMissingGlyphs( ) == 0 );
+
+    // Frame 6 repeats frame 5, less the glyph that didn't fit - nothing is copied,
+    // evicted or uploaded
+    CHECK( FindGlyphs( cache, pack, 0, 1, &valid ) == 1 );
+    CHECK( FindGlyphs( cache, pack, 12, 4, &valid ) == 4 );
+    CHECK( cache.FindGlyph( 'A' ) != 0 );
+    CHECK( FindGlyphs( cache, pack, 4, 3, &valid ) == 3 );
+    CHECK( cache.GetNumCopiedGlyphs( ) == 0 );
+    CHECK( cache.GetNumEvictedPages( ) == 2 );
+    CHECK( !cache.GetDirtyRows( &firstRow, &rowCount ) );
+    cache.EndFrame( );
+
+    CHECK( valid );
+
+    // UTF-8 text printed through a cache with room for every glyph. Malformed
+    // sequences - and sequences cut short by the end of the text - draw '?' for each
+    // byte, and the decoder never reads past the character count
+    static unsigned int vertices[ 64 * TinyTextEncoder_c::NumVertexElementsPerCharacter ];
+
+    TinyTextGlyphCache_c textCache;
+    CHECK( textCache.Initialise( &pack, 64, 1 ) );
+
+    TinyTextEncoder_c encoder;
+    CHECK( encoder.Initialise( 64 ) );
+    encoder.SetFont( &pack );
+    encoder.SetGlyphCache( &textCache );
+    encoder.SetCodePage( TinyTextEncoder_c::CodePageUTF8 );
+
+    const TinyTextFormat_c format;
+    const TinyTextFormat_c * formats[] = { 0, &format };
+
+    for ( unsigned int i = 0; i < 2; ++i )
+    {
+        const TinyTextFormat_c * printFormat = formats[ i ];
+
+        const unsigned int wellFormed[] = { CJKCodePoint, 'A', CJKCodePoint + 15 };
+        CHECK( PrintsAs( encoder, textCache, pack, vertices, printFormat, ~size_t( 0 ), "\xE4\xB8\x80" "A" "\xE4\xB8\x8F", wellFormed, 3 ) );
+
+        // A stray continuation byte, a byte that never starts a sequence, an overlong
+        // encoding, a surrogate and a value beyond Unicode
+        const unsigned int malformed[] = { '?', '?', '?', 'A', '?', '?', '?' };
+        CHECK( PrintsAs( encoder, textCache, pack, vertices, printFormat, ~size_t( 0 ), "\x80\xFF\xC0\x80" "A" "\xED\xA0\x80\xF4\x90\x80\x80\xE4", malformed, 7 ) );
+
+        // A sequence interrupted by an ASCII character
+        const unsigned int interrupted[] = { '?', '?', 'A' };
+        CHECK( PrintsAs( encoder, textCache, pack, vertices, printFormat, ~size_t( 0 ), "\xE4\xB8" "A", interrupted, 3 ) );
+
+        // Sequences cut short by the character count, though the bytes after it would
+        // complete them
+        const unsigned int truncated[] = { 'A', '?', '?' };
+        CHECK( PrintsAs( encoder, textCache, pack, vertices, printFormat, 3, "A\xE4\xB8\x80", truncated, 3 ) );
+        CHECK( PrintsAs( encoder, textCache, pack, vertices, printFormat, 1, "\xF0\x9F\x98\x80", truncated + 1, 1 ) );
+    }
+
+    // Text that isn't terminated, and ends with a sequence cut short, in memory of its
+    // own. Printed without a format, it is read a byte at a time, so a build with an
+    // address sanitizer reports any read past its end (formatted text is scanned in
+    // aligned blocks of 16 bytes, which may run past the end but never cross a page)
+    char * unterminated = new ( std::nothrow ) char[ 3 ];
+    CHECK( unterminated != 0 );
+
+    if ( unterminated )
+    {
+        memcpy( unterminated, "A\xE4\xB8", 3 );
+
+        const unsigned int truncated[] = { 'A', '?', '?' };
+        CHECK( PrintsAs( encoder, textCache, pack, vertices, 0, 3, unterminated, truncated, 3 ) );
+
+        delete [] unterminated;
+    }
+
+    CHECK( textCache.GetNumEvictedPages( ) == 0 );
+
+    return TestResult( );
+}
@@ -0,0 +1,157 @@
+/*=================================================================================
+
+    PROJECT:        Tiny Text Library for DirectX 10
+
+    DESCRIPTION:    Encodes a scene of text, draws it with the reference rasterizer
+                    and compares the pixels with a golden image. Neither needs
+                    Direct3D, so this builds and runs on any platform
+
+    USAGE:          TinyTextGoldenTest [--write] [golden image]
+
+                    - The golden image defaults to
+                      'TinyText.Tests/Golden/Text.rgba', relative to the root of
+                      the repository. It is the raw pixels of the scene, four
+                      bytes (red, green, blue and alpha) per pixel, row by row,
+                      with no header
+
+                    - '--write' saves the image instead of comparing it. Only
+                      do this for a change that is meant to alter the output,
+                      and check the new image before committing it
+
+=================================================================================*/
+
+/*---------------------------------------------------------------------------------
+    Includes
+---------------------------------------------------------------------------------*/
+#include "TinyText.Core/TinyTextRasterizer.h"
+#include "TinyTextTest.h"
+#include <stdio.h>
+#include <string.h>
+
+/*---------------------------------------------------------------------------------
+    Constants
+---------------------------------------------------------------------------------*/
+//namespace
+//{
+    // Size of the scene (in pixels)
+    const int           SceneWidth              = 192;
+    const int           SceneHeight             = 96;
+
+    // Maximum number of characters in the scene
+    const unsigned int  SceneCapacity           = 256;
+//}
+
+//namespace
+//{
+    /*---------------------------------------------------------------------------------
+        EncodeScene
+        Encodes the scene: plain text, text partly off the image, and formatted text
+        that is wrapped, anchored, scaled and clipped
+    ---------------------------------------------------------------------------------*/
+    bool EncodeScene( TinyTextEncoder_c & encoder, unsigned int * vertices )
+    {
+        const float width = float( SceneWidth );
+        const float height = float( SceneHeight );
+        bool result = true;
+
+        encoder.Begin( vertices );
+
+        result &= encoder.Print( width, height, SceneCapacity, "Tiny Text 0123!", 2, 2, 0xFFFFFFFF );
+        result &= encoder.Print( width, height, SceneCapacity, "Off the edge", -5, 40, 0xFF0000FF );
+
+        TinyTextFormat_c wrapped( 80, TinyTextFormat_c::DefaultTabSize, TinyTextFormat_c::AnchorRight | TinyTextFormat_c::AnchorTop );
+        result &= encoder.Print( width, height, wrapped, SceneCapacity, "Wrapped to the right edge", SceneWidth - 2, 20, 0xFF00FF00 );
+
+        TinyTextFormat_c scaled( 0, TinyTextFormat_c::DefaultTabSize, TinyTextFormat_c::AnchorLeft | TinyTextFormat_c::AnchorBottom, 2 );
+        result &= encoder.Print( width, height, scaled, SceneCapacity, "x2\tTab", 2, SceneHeight - 2, 0xFFFF0000 );
+
+        TinyTextFormat_c clipped;
+        clipped.SetClipRect( 4, 60, 60, 66 );
+        result &= encoder.Print( width, height, clipped, SceneCapacity, "Clipped text", 2, 58, 0x80FFFF00 );
+
+        encoder.End( );
+        return result;
+    }
+//}
+
+/*---------------------------------------------------------------------------------
+    main
+    Entry point
+---------------------------------------------------------------------------------*/
+int main( int argc, char ** argv )
+{
+    bool write = false;
+    const char * fileName = "TinyText.Tests/Golden/Text.rgba";
+
+    for ( int i = 1; i < argc; ++i )
+    {
+        if ( !strcmp( argv[ i ], "--write" ) )
+        {
+            write = true;
+        }
+        else
+        {
+            fileName = argv[ i ];
+        }
+    }
+
+    // Encode and draw the scene
+    static unsigned int vertices[ SceneCapacity * TinyTextEncoder_c::NumVertexElementsPerCharacter ];
+    static unsigned char pixels[ SceneWidth * SceneHeight * 4 ];
+
+    TinyTextEncoder_c encoder;
+    CHECK( encoder.Initialise( SceneCapacity ) );
+    CHECK( EncodeScene( encoder, vertices ) );
+    CHECK( encoder.GetNumDroppedCharacters( ) == 0 );
+
+    TinyTextRasterizer_c rasterizer;
+    rasterizer.Draw( vertices, encoder.GetNumVertices( ), pixels, SceneWidth, SceneHeight, SceneWidth * 4 );
+
+    if ( write )
+    {
+        FILE * file = fopen( fileName, "wb" );
+        CHECK( file && fwrite( pixels, sizeof( pixels ), 1, file ) == 1 );
+
+        if ( file )
+        {
+            fclose( file );
+        }
+
+        return TestResult( );
+    }
+
+    // Compare with the golden image
+    static unsigned char golden[ sizeof( pixels ) ];
+
+    FILE * file = fopen( fileName, "rb" );
+    CHECK( file );
+
+    if ( !file )
+    {
+        return TestResult( );
+    }
+
+    CHECK( fread( golden, sizeof( golden ), 1, file ) == 1 );
+    CHECK( fgetc( file ) == EOF );
+    fclose( file );
+
+    int differences = 0;
+
+    for ( int y = 0; y < SceneHeight; ++y )
+    {
+        for ( int x = 0; x < SceneWidth; ++x )
+        {
+            const unsigned char * pixel = pixels + ( y * SceneWidth + x ) * 4;
+            const unsigned char * goldenPixel = golden + ( y * SceneWidth + x ) * 4;
+
+            if ( memcmp( pixel, goldenPixel, 4 ) && ++differences <= 10 )
+            {
+                printf( "pixel (%d, %d) is %02x%02x%02x%02x, expected %02x%02x%02x%02x\n", x, y,
+                        pixel[ 0 ], pixel[ 1 ], pixel[ 2 ], pixel[ 3 ], goldenPixel[ 0 ], goldenPixel[ 1 ], goldenPixel[ 2 ], goldenPixel[ 3 ] );
+            }
+        }
+    }
+
+    CHECK( differences == 0 );
+    return TestResult( );
+}
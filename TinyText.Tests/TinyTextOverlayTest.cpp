@@ -0,0 +1,211 @@
+/*=================================================================================
+
+    PROJECT:        Tiny Text Library for DirectX 10
+
+    DESCRIPTION:    Checks that 'TinyTextOverlay_c', which only redraws the cells
+                    that change from one frame to the next, always holds the same
+                    pixels as a full redraw of each frame with the reference
+                    rasterizer, and that it reports the areas it redraws
+
+=================================================================================*/
+
+/*---------------------------------------------------------------------------------
+    Includes
+---------------------------------------------------------------------------------*/
+#include "TinyText.Core/TinyTextOverlay.h"
+#include "TinyText.Core/TinyTextRasterizer.h"
+#include "TinyTextTest.h"
+#include <stdio.h>
+#include <string.h>
+
+/*---------------------------------------------------------------------------------
+    Constants
+---------------------------------------------------------------------------------*/
+//namespace
+//{
+    // Size of the overlay (in pixels)
+    const int           OverlayWidth            = 640;
+    const int           OverlayHeight           = 360;
+
+    // Maximum number of characters in a frame
+    const unsigned int  FrameCapacity           = 4096;
+
+    // Number of frames of the debug overlay
+    const int           FrameCount              = 120;
+//}
+
+//namespace
+//{
+    /*---------------------------------------------------------------------------------
+        EncodeOverlayFrame
+        Encodes a frame of a typical debug overlay: mostly static labels, a few
+        counters that change, a line that changes colour and, later on, a line that
+        moves
+    ---------------------------------------------------------------------------------*/
+    void EncodeOverlayFrame( TinyTextEncoder_c & encoder, unsigned int * vertices, int frame )
+    {
+        const float width = float( OverlayWidth );
+        const float height = float( OverlayHeight );
+        char text[ 64 ];
+
+        encoder.Begin( vertices );
+
+        for ( int line = 0; line < 40; ++line )
+        {
+            switch ( line % 4 )
+            {
+            case 0:
+                sprintf( text, "Frame time: %6.2f ms", 16.6 + ( frame % 7 ) * 0.01 );
+                break;
+            case 1:
+                sprintf( text, "Draw calls: %d", line * 3 + frame / 30 );
+                break;
+            case 2:
+                sprintf( text, "Static label that never changes" );
+                break;
+            default:
+                sprintf( text, "Camera (%d, %d, 0)", frame / 10, line );
+                break;
+            }
+
+            int x = ( line / 20 ) * 320 + ( ( frame >= 80 && line == 7 ) ? frame - 80 : 0 );
+            int y = 10 + ( line % 20 ) * 16;
+            unsigned int colour = ( line == 2 && ( frame / 20 ) % 2 ) ? 0xFF00FF00 : 0xFFFFFFFF;
+
+            encoder.Print( width, height, sizeof( text ), text, x, y, colour );
+        }
+
+        encoder.End( );
+    }
+
+    /*---------------------------------------------------------------------------------
+        MatchesFullRedraw
+        Returns 'true' if the overlay holds the same pixels as a full redraw of the
+        vertices
+    ---------------------------------------------------------------------------------*/
+    bool MatchesFullRedraw( const TinyTextOverlay_c & overlay, const unsigned int * vertices, unsigned int vertexCount, unsigned char * pixels )
+    {
+        memset( pixels, 0, OverlayWidth * OverlayHeight * 4 );
+
+        TinyTextRasterizer_c rasterizer;
+        rasterizer.Draw( vertices, vertexCount, pixels, OverlayWidth, OverlayHeight, OverlayWidth * 4 );
+
+        return !memcmp( pixels, overlay.GetPixels( ), OverlayWidth * OverlayHeight * 4 );
+    }
+
+    /*---------------------------------------------------------------------------------
+        AreDirtyRectsValid
+        Returns 'true' if the dirty rectangles lie inside the overlay, don't overlap,
+        and cover the number of dirty pixels reported
+    ---------------------------------------------------------------------------------*/
+    bool AreDirtyRectsValid( const TinyTextOverlay_c & overlay )
+    {
+        const TinyTextRect_s * rects = overlay.GetDirtyRects( );
+        unsigned int pixelCount = 0;
+
+        for ( unsigned int i = 0; i < overlay.GetNumDirtyRects( ); ++i )
+        {
+            const TinyTextRect_s & rect = rects[ i ];
+
+            if ( rect.left < 0 || rect.top < 0 || rect.right > OverlayWidth || rect.bottom > OverlayHeight || rect.left >= rect.right || rect.top >= rect.bottom )
+            {
+                return false;
+            }
+
+            for ( unsigned int j = 0; j < i; ++j )
+            {
+                const TinyTextRect_s & other = rects[ j ];
+
+                if ( rect.left < other.right && other.left < rect.right && rect.top < other.bottom && other.top < rect.bottom )
+                {
+                    return false;
+                }
+            }
+
+            pixelCount += ( rect.right - rect.left ) * ( rect.bottom - rect.top );
+        }
+
+        return pixelCount == overlay.GetNumDirtyPixels( );
+    }
+//}
+
+/*---------------------------------------------------------------------------------
+    main
+    Entry point
+---------------------------------------------------------------------------------*/
+int main( )
+{
+    static unsigned int vertices[ FrameCapacity * TinyTextEncoder_c::NumVertexElementsPerCharacter ];
+    static unsigned char pixels[ OverlayWidth * OverlayHeight * 4 ];
+
+    TinyTextEncoder_c encoder;
+    CHECK( encoder.Initialise( FrameCapacity ) );
+
+    TinyTextOverlay_c overlay;
+    CHECK( overlay.Initialise( OverlayWidth, OverlayHeight ) );
+
+    unsigned int mismatchedFrames = 0;
+    unsigned int invalidRectFrames = 0;
+    unsigned int dirtyPixels = 0;
+
+    for ( int frame = 0; frame < FrameCount; ++frame )
+    {
+        if ( frame == 60 )
+        {
+            overlay.Invalidate( );
+        }
+
+        EncodeOverlayFrame( encoder, vertices, frame );
+        overlay.Update( vertices, encoder.GetNumVertices( ) );
+
+        mismatchedFrames += !MatchesFullRedraw( overlay, vertices, encoder.GetNumVertices( ), pixels );
+        invalidRectFrames += !AreDirtyRectsValid( overlay );
+
+        if ( frame > 0 && frame != 60 )
+        {
+            dirtyPixels += overlay.GetNumDirtyPixels( );
+        }
+    }
+
+    printf( "%d frames: %u mismatched, %u with invalid rectangles, %.1f%% of the overlay redrawn per frame\n", FrameCount, mismatchedFrames, invalidRectFrames,
+            100.0 * dirtyPixels / ( FrameCount - 2 ) / ( OverlayWidth * OverlayHeight ) );
+
+    CHECK( mismatchedFrames == 0 );
+    CHECK( invalidRectFrames == 0 );
+
+    // Only a few counters change, so only a small part of the overlay is redrawn
+    CHECK( dirtyPixels < ( FrameCount - 2 ) * OverlayWidth * OverlayHeight / 10 );
+
+    // The same frame again redraws nothing
+    overlay.Update( vertices, encoder.GetNumVertices( ) );
+    CHECK( overlay.GetNumDirtyRects( ) == 0 );
+    CHECK( overlay.GetNumDirtyPixels( ) == 0 );
+
+    // An empty frame clears the text
+    encoder.Begin( vertices );
+    encoder.End( );
+    overlay.Update( vertices, 0 );
+    CHECK( MatchesFullRedraw( overlay, vertices, 0, pixels ) );
+    CHECK( AreDirtyRectsValid( overlay ) );
+
+    // A character in every other cell, in a checkerboard, changes more separate runs
+    // of cells than there are rectangles, so they are merged into one
+    encoder.Begin( vertices );
+    for ( int row = 0; row < OverlayHeight >> TinyTextOverlay_c::CellShiftY; ++row )
+    {
+        for ( int column = row & 1; column < OverlayWidth >> TinyTextOverlay_c::CellShiftX; column += 2 )
+        {
+            int x = ( column << TinyTextOverlay_c::CellShiftX ) + 4;
+            int y = ( row << TinyTextOverlay_c::CellShiftY ) + 1;
+            encoder.Print( float( OverlayWidth ), float( OverlayHeight ), 1, "#", x, y, 0xFF0000FF );
+        }
+    }
+    encoder.End( );
+
+    overlay.Update( vertices, encoder.GetNumVertices( ) );
+    CHECK( MatchesFullRedraw( overlay, vertices, encoder.GetNumVertices( ), pixels ) );
+    CHECK( AreDirtyRectsValid( overlay ) );
+    CHECK( overlay.GetNumDirtyRects( ) == 1 );
+
+    return TestResult( );
+}
@@ -0,0 +1,341 @@
+/*=================================================================================
+
+    PROJECT:        Tiny Text Library for DirectX 10
+
+    DESCRIPTION:    Checks that text in a proportional font is placed where a
+                    plain scalar sum of its advances and kerning places it - in
+                    formatted and unformatted text, at several scales, and in
+                    words longer than the spans that pen positions are found in
+
+=================================================================================*/
+
+/*---------------------------------------------------------------------------------
+    Includes
+---------------------------------------------------------------------------------*/
+#include "TinyText.Core/TinyTextEncoder.h"
+#include "TinyTextTest.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+/*---------------------------------------------------------------------------------
+    Constants
+---------------------------------------------------------------------------------*/
+//namespace
+//{
+    // The characters of the test font, in order of code point, and their advances
+    const char          FontCharacters[]        = " .?ATVWao";
+    const unsigned char FontAdvances[]          = { 3, 2, 5, 7, 6, 7, 9, 5, 5 };
+    const unsigned int  GlyphCount              = sizeof( FontCharacters ) - 1;
+    const unsigned int  GlyphHeight             = 8;
+
+    // Kerning pairs of the test font, sorted. The pairs with a space must never apply
+    const TinyTextFontKerningPair_s FontKerningPairs[] =
+    {
+        { ' ', 'V', -5 },
+        { 'A', ' ', -4 },
+        { 'A', 'T', -1 },
+        { 'A', 'V', -3 },
+        { 'T', 'o', -2 },
+        { 'V', 'A', -3 },
+        { 'V', 'o', -1 },
+        { 'W', 'a', -2 },
+        { 'o', 'o', 1 }
+    };
+
+    const unsigned int  KerningPairCount        = sizeof( FontKerningPairs ) / sizeof( FontKerningPairs[ 0 ] );
+
+    const unsigned int  AtlasWidth              = GlyphCount * 10;
+    const unsigned int  AtlasHeight             = GlyphHeight;
+
+    // Size of the font pack, in 32-bit words
+    const unsigned int  KerningOffset           = ( sizeof( TinyTextFontPackHeader_s ) + GlyphCount * sizeof( TinyTextFontGlyph_s ) + AtlasWidth * AtlasHeight + 3 ) & ~3;
+    const unsigned int  FontPackWordCount       = ( KerningOffset + sizeof( FontKerningPairs ) ) / 4;
+
+    // Number of characters whose pen positions are found at once - see
+    // 'TinyTextEncoder_c::GetPenPositions'
+    const unsigned int  PenPositionSpan         = 64;
+
+    // Largest text printed, in characters
+    const unsigned int  MaxTextLength           = 256;
+
+    // Size of the viewport that text is printed to, and where it is printed
+    const float         ViewportWidth           = 4096.0f;
+    const float         ViewportHeight          = 256.0f;
+    const int           TextX                   = 16;
+    const int           TextY                   = 16;
+//}
+
+//namespace
+//{
+    /*---------------------------------------------------------------------------------
+        BuildFontPack
+        Writes the test font into 'pack'. Every glyph but the space's is one texel
+        narrower than its advance, and starts at the pen position
+    ---------------------------------------------------------------------------------*/
+    void BuildFontPack( unsigned int * pack )
+    {
+        memset( pack, 0, FontPackWordCount * 4 );
+
+        TinyTextFontPackHeader_s * header = ( TinyTextFontPackHeader_s * ) pack;
+        memcpy( header->magic, "TTFP", 4 );
+        header->version = TinyTextFontPack_c::Version;
+        header->byteCount = FontPackWordCount * 4;
+        header->atlasWidth = AtlasWidth;
+        header->atlasHeight = AtlasHeight;
+        header->characterWidth = 9;
+        header->lineHeight = GlyphHeight + 2;
+        header->glyphCount = GlyphCount;
+        header->glyphOffset = sizeof( TinyTextFontPackHeader_s );
+        header->atlasOffset = header->glyphOffset + GlyphCount * sizeof( TinyTextFontGlyph_s );
+        header->flags = TinyTextFontPack_c::FlagProportional;
+        header->kerningCount = KerningPairCount;
+        header->kerningOffset = KerningOffset;
+
+        TinyTextFontGlyph_s * glyphs = ( TinyTextFontGlyph_s * )( ( unsigned char * ) pack + header->glyphOffset );
+        unsigned char * atlas = ( unsigned char * ) pack + header->atlasOffset;
+
+        for ( unsigned int i = 0; i < GlyphCount; ++i )
+        {
+            TinyTextFontGlyph_s & glyph = glyphs[ i ];
+            glyph.codePoint = ( unsigned char ) FontCharacters[ i ];
+            glyph.advance = FontAdvances[ i ];
+
+            if ( FontCharacters[ i ] != ' ' )
+            {
+                glyph.u = ( unsigned short )( i * 10 );
+                glyph.width = ( unsigned char )( FontAdvances[ i ] - 1 );
+                glyph.height = GlyphHeight;
+
+                for ( unsigned int y = 0; y < GlyphHeight; ++y )
+                {
+                    memset( atlas + y * AtlasWidth + glyph.u, 255, glyph.width );
+                }
+            }
+        }
+
+        memcpy( ( unsigned char * ) pack + KerningOffset, FontKerningPairs, sizeof( FontKerningPairs ) );
+    }
+
+    /*---------------------------------------------------------------------------------
+        GetAdvance
+        Returns the advance of a character of the test font
+    ---------------------------------------------------------------------------------*/
+    int GetAdvance( char character )
+    {
+        return FontAdvances[ strchr( FontCharacters, character ) - FontCharacters ];
+    }
+
+    /*---------------------------------------------------------------------------------
+        GetKerning
+        Returns the kerning of a pair of characters of the test font
+    ---------------------------------------------------------------------------------*/
+    int GetKerning( char first, char second )
+    {
+        for ( unsigned int i = 0; i < KerningPairCount; ++i )
+        {
+            if ( FontKerningPairs[ i ].first == ( unsigned char ) first && FontKerningPairs[ i ].second == ( unsigned char ) second )
+            {
+                return FontKerningPairs[ i ].amount;
+            }
+        }
+
+        return 0;
+    }
+
+    /*---------------------------------------------------------------------------------
+        ScalePosition
+        Scales an unscaled distance to the nearest pixel, rounding halves up - even
+        where kerning makes the distance negative
+    ---------------------------------------------------------------------------------*/
+    int ScalePosition( int distance, float scale )
+    {
+        return scale == 1.0f ? distance : int( floorf( float( distance ) * scale + 0.5f ) );
+    }
+
+    /*---------------------------------------------------------------------------------
+        GetReferencePositions
+        Finds the pen position of each character of some text, relative to the first,
+        and the position after the last, one character at a time. Kerning never applies
+        into or out of a space. Distances are scaled from their unscaled sums along
+        each span of 'PenPositionSpan' characters, and the rounded length of each span
+        carries on to the next. In formatted text, each word starts a span of its own,
+        and each space moves on by the scaled advance of the space
+    ---------------------------------------------------------------------------------*/
+    void GetReferencePositions( const char * text, float scale, bool formatted, int * positions )
+    {
+        const int spaceWidth = int( GetAdvance( ' ' ) * scale + 0.5f );
+        int spanX = 0;
+        int distance = 0;
+        unsigned int spanCount = 0;
+        char previous = 0;
+        size_t i = 0;
+
+        for ( ; text[ i ]; ++i )
+        {
+            const char character = text[ i ];
+
+            if ( formatted && character == ' ' )
+            {
+                spanX += ScalePosition( distance, scale );
+                positions[ i ] = spanX;
+                spanX += spaceWidth;
+                distance = 0;
+                spanCount = 0;
+                previous = 0;
+                continue;
+            }
+
+            if ( spanCount == PenPositionSpan )
+            {
+                spanX += ScalePosition( distance, scale );
+                distance = 0;
+                spanCount = 0;
+            }
+
+            if ( previous && character != ' ' )
+            {
+                distance += GetKerning( previous, character );
+            }
+
+            positions[ i ] = spanX + ScalePosition( distance, scale );
+            distance += GetAdvance( character );
+            ++spanCount;
+            previous = character != ' ' ? character : 0;
+        }
+
+        positions[ i ] = spanX + ScalePosition( distance, scale );
+    }
+
+    /*---------------------------------------------------------------------------------
+        IsPrintedAtReference
+        Prints some text, and returns 'true' if every character that isn't a space is
+        drawn at its reference position
+    ---------------------------------------------------------------------------------*/
+    bool IsPrintedAtReference( TinyTextEncoder_c & encoder, unsigned int * vertices, const char * text, float scale, bool formatted )
+    {
+        int positions[ MaxTextLength + 1 ];
+        GetReferencePositions( text, scale, formatted, positions );
+
+        encoder.SetFontScale( scale );
+        encoder.Begin( vertices );
+
+        if ( formatted )
+        {
+            encoder.Print( ViewportWidth, ViewportHeight, TinyTextFormat_c( ), strlen( text ), text, TextX, TextY, 0xFFFFFFFF );
+        }
+        else
+        {
+            encoder.Print( ViewportWidth, ViewportHeight, strlen( text ), text, TextX, TextY, 0xFFFFFFFF );
+        }
+
+        encoder.End( );
+
+        unsigned int character = 0;
+
+        for ( size_t i = 0; text[ i ]; ++i )
+        {
+            if ( text[ i ] == ' ' )
+            {
+                continue;
+            }
+
+            if ( character == encoder.GetNumVertices( ) / TinyTextEncoder_c::NumVerticesPerCharacter )
+            {
+                return false;
+            }
+
+            // The first vertex of each character is its bottom-left corner
+            float left;
+            memcpy( &left, &vertices[ character * TinyTextEncoder_c::NumVertexElementsPerCharacter ], sizeof( left ) );
+
+            if ( int( floorf( ( left + 1.0f ) * ViewportWidth / 2 + 0.5f ) ) != TextX + positions[ i ] )
+            {
+                printf( "'%c' at %u of \"%.16s...\" (scale %g, %s) is at %d, not %d\n", text[ i ], ( unsigned int ) i, text, scale, formatted ? "formatted" : "unformatted",
+                        int( floorf( ( left + 1.0f ) * ViewportWidth / 2 + 0.5f ) ) - TextX, positions[ i ] );
+                return false;
+            }
+
+            ++character;
+        }
+
+        return character == encoder.GetNumVertices( ) / TinyTextEncoder_c::NumVerticesPerCharacter;
+    }
+
+    /*---------------------------------------------------------------------------------
+        AppendText
+        Appends a piece of text to 'text' a number of times
+    ---------------------------------------------------------------------------------*/
+    void AppendText( char * text, const char * piece, unsigned int count )
+    {
+        for ( unsigned int i = 0; i < count; ++i )
+        {
+            strcat( text, piece );
+        }
+    }
+//}
+
+/*---------------------------------------------------------------------------------
+    main
+    Entry point
+---------------------------------------------------------------------------------*/
+int main( )
+{
+    static unsigned int packWords[ FontPackWordCount ];
+    BuildFontPack( packWords );
+
+    TinyTextFontPack_c pack;
+    CHECK( pack.OpenMemory( packWords, sizeof( packWords ) ) );
+    CHECK( pack.IsProportional( ) && pack.GetNumKerningPairs( ) == KerningPairCount );
+
+    static unsigned int vertices[ MaxTextLength * TinyTextEncoder_c::NumVertexElementsPerCharacter ];
+
+    TinyTextEncoder_c encoder;
+    CHECK( encoder.Initialise( MaxTextLength ) );
+    encoder.SetFont( &pack );
+    CHECK( encoder.IsProportional( ) );
+
+    // Short words, with kerning within them and pairs with the space around them
+    char shortWords[ MaxTextLength ] = "AVAVA To WAVo. oo AV A V Wa";
+
+    // A word whose first span ends between 'T' and 'o', so that the next span starts
+    // with a negative position - the rounding must go down, not toward zero
+    char longWord[ MaxTextLength ] = "A";
+    AppendText( longWord, "VA", 31 );
+    AppendText( longWord, "To", 1 );
+    AppendText( longWord, "WaVA", 5 );
+    AppendText( longWord, " AV. oo", 1 );
+
+    // A span of unformatted text that ends with a space, then a word of more than two
+    // spans that is kerned across both of their ends
+    char spaceAtSpanEnd[ MaxTextLength ] = "";
+    AppendText( spaceAtSpanEnd, "Wa", 31 );
+    AppendText( spaceAtSpanEnd, "A V", 1 );
+    AppendText( spaceAtSpanEnd, "AV", 40 );
+    AppendText( spaceAtSpanEnd, "oTo", 1 );
+
+    CHECK( longWord[ PenPositionSpan - 1 ] == 'T' && longWord[ PenPositionSpan ] == 'o' );
+    CHECK( spaceAtSpanEnd[ PenPositionSpan - 1 ] == ' ' && spaceAtSpanEnd[ 2 * PenPositionSpan - 1 ] == 'A' && spaceAtSpanEnd[ 2 * PenPositionSpan ] == 'V' );
+
+    const char * texts[] = { shortWords, longWord, spaceAtSpanEnd };
+    const float scales[] = { 1.0f, 1.5f, 2.5f };
+
+    for ( unsigned int i = 0; i < sizeof( texts ) / sizeof( texts[ 0 ] ); ++i )
+    {
+        for ( unsigned int j = 0; j < sizeof( scales ) / sizeof( scales[ 0 ] ); ++j )
+        {
+            CHECK( IsPrintedAtReference( encoder, vertices, texts[ i ], scales[ j ], false ) );
+            CHECK( IsPrintedAtReference( encoder, vertices, texts[ i ], scales[ j ], true ) );
+
+            // Formatted text is as wide as the pen position after its last character
+            int positions[ MaxTextLength + 1 ];
+            GetReferencePositions( texts[ i ], scales[ j ], true, positions );
+
+            int width = 0;
+            encoder.MeasureText( TinyTextFormat_c( ), strlen( texts[ i ] ), texts[ i ], &width, 0 );
+            CHECK( width == positions[ strlen( texts[ i ] ) ] );
+        }
+    }
+
+    return TestResult( );
+}
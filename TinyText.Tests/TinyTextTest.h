@@ -0,0 +1,58 @@
+/*=================================================================================
+
+    PROJECT:        Tiny Text Library for DirectX 10
+
+    DESCRIPTION:    A minimal check macro shared by the tests. Each test is a
+                    program of its own, which prints the checks that fail and
+                    returns 1 from 'main' if any did
+
+    USAGE:          - Call 'CHECK' with a condition. Failures are reported with
+                      their file and line, and counted in 'g_FailureCount'
+
+                    - Return 'TestResult( )' from 'main'
+
+=================================================================================*/
+
+#pragma once
+
+/*---------------------------------------------------------------------------------
+    Includes
+---------------------------------------------------------------------------------*/
+#include <stdio.h>
+
+/*---------------------------------------------------------------------------------
+    g_FailureCount
+    The number of checks that have failed
+---------------------------------------------------------------------------------*/
+static unsigned int g_FailureCount = 0;
+
+/*---------------------------------------------------------------------------------
+    CHECK
+    Reports a failure if a condition doesn't hold
+---------------------------------------------------------------------------------*/
+#define CHECK( condition )                                                          \
+    do                                                                              \
+    {                                                                               \
+        if ( !( condition ) )                                                       \
+        {                                                                           \
+            printf( "%s(%d): check failed: %s\n", __FILE__, __LINE__, #condition ); \
+            ++g_FailureCount;                                                       \
+        }                                                                           \
+    }                                                                               \
+    while ( false )
+
+/*---------------------------------------------------------------------------------
+    TestResult
+    Reports the outcome of a test, and returns the code for 'main' to exit with
+---------------------------------------------------------------------------------*/
+static int TestResult( )
+{
+    if ( g_FailureCount )
+    {
+        printf( "%u check(s) failed\n", g_FailureCount );
+        return 1;
+    }
+
+    printf( "All checks passed\n" );
+    return 0;
+}
@@ -36,14 +36,7 @@ bool Context::Print( Viewport^ viewport, System::String^ text, int x, int y )
 
 bool Context::Print( Viewport^ viewport, System::String^ text, int x, int y, DWORD colour )
 {
-    D3D11_VIEWPORT d3d11Viewport;
-
-    d3d11Viewport.Width = viewport->Width;
-    d3d11Viewport.Height = viewport->Height;
-    d3d11Viewport.MinDepth = viewport->MinZ;
-    d3d11Viewport.MaxDepth = viewport->MaxZ;
-    d3d11Viewport.TopLeftX = viewport->X;
-    d3d11Viewport.TopLeftY = viewport->Y;
+    D3D11_VIEWPORT d3d11Viewport = ConvertViewport( viewport );
 
     char* cString = (char*)(void*)Marshal::StringToHGlobalAnsi( text );
     bool result = mTinyTextContext->Print( d3d11Viewport, text->Length, cString, x, y, colour );
@@ -62,4 +55,91 @@ bool Context::Render( bool maintainState )
     return mTinyTextContext->Render( maintainState );
 }
 
+void Context::EnableStats( bool enable )
+{
+    mTinyTextContext->EnableStats( enable );
+}
+
+bool Context::EnableGpuStats( bool enable )
+{
+    return mTinyTextContext->EnableGpuStats( enable );
+}
+
+void Context::EnableStatsOverlay( Viewport^ viewport, int x, int y )
+{
+    if ( viewport == nullptr )
+    {
+        mTinyTextContext->EnableStatsOverlay( NULL );
+        return;
+    }
+
+    D3D11_VIEWPORT d3d11Viewport = ConvertViewport( viewport );
+    mTinyTextContext->EnableStatsOverlay( &d3d11Viewport, x, y );
+}
+
+bool Context::EnableTrace( int eventCapacity )
+{
+    return mTinyTextContext->EnableTrace( eventCapacity > 0 ? eventCapacity : 0 );
+}
+
+bool Context::WriteTrace( System::String^ fileName )
+{
+    char* cString = (char*)(void*)Marshal::StringToHGlobalAnsi( fileName );
+    bool result = mTinyTextContext->WriteTrace( cString );
+    Marshal::FreeHGlobal( IntPtr( (void*)cString ) );
+
+    return result;
+}
+
+Stats Context::GetFrameStats()
+{
+    TinyTextStats_c stats;
+    mTinyTextContext->GetStats( &stats, NULL );
+
+    return ConvertStats( stats );
+}
+
+Stats Context::GetRollingStats()
+{
+    TinyTextStats_c stats;
+    mTinyTextContext->GetStats( NULL, &stats );
+
+    return ConvertStats( stats );
+}
+
+D3D11_VIEWPORT Context::ConvertViewport( Viewport^ viewport )
+{
+    D3D11_VIEWPORT d3d11Viewport;
+
+    d3d11Viewport.Width = viewport->Width;
+    d3d11Viewport.Height = viewport->Height;
+    d3d11Viewport.MinDepth = viewport->MinZ;
+    d3d11Viewport.MaxDepth = viewport->MaxZ;
+    d3d11Viewport.TopLeftX = viewport->X;
+    d3d11Viewport.TopLeftY = viewport->Y;
+
+    return d3d11Viewport;
+}
+
+Stats Context::ConvertStats( const TinyTextStats_c & stats )
+{
+    Stats result;
+
+    result.GlyphsEncoded = stats.glyphsEncoded;
+    result.GlyphsDropped = stats.glyphsDropped;
+    result.VerticesDrawn = stats.verticesDrawn;
+    result.VerticesSkipped = stats.verticesSkipped;
+    result.BytesUploaded = stats.bytesUploaded;
+    result.MapCount = stats.mapCount;
+    result.CapacityHighWater = stats.capacityHighWater;
+    result.DeviceContextCalls = stats.deviceContextCalls;
+    result.DrawCalls = stats.drawCalls;
+    result.PrintMilliseconds = stats.printMilliseconds;
+    result.MapMilliseconds = stats.mapMilliseconds;
+    result.RenderMilliseconds = stats.renderMilliseconds;
+    result.GpuMilliseconds = stats.gpuMilliseconds;
+
+    return result;
+}
+
 }
\ No newline at end of file
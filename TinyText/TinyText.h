@@ -12,6 +12,24 @@ namespace TinyText
 {
 
 #pragma managed
+// Describes the work done by a text context during a frame. See 'TinyTextStats_c'
+public value struct Stats
+{
+    unsigned int GlyphsEncoded;
+    unsigned int GlyphsDropped;
+    unsigned int VerticesDrawn;
+    unsigned int VerticesSkipped;
+    unsigned int BytesUploaded;
+    unsigned int MapCount;
+    unsigned int CapacityHighWater;
+    unsigned int DeviceContextCalls;
+    unsigned int DrawCalls;
+    float PrintMilliseconds;
+    float MapMilliseconds;
+    float RenderMilliseconds;
+    float GpuMilliseconds;
+};
+
 public ref class Context
 {
 public:
@@ -27,7 +45,30 @@ public:
     bool Render();
     bool Render( bool maintainState );
 
+    // Enable or disable the timing of 'Print' and 'Render'
+    void EnableStats( bool enable );
+
+    // Enable or disable the timing of 'Render' on the GPU - returns 'false' if the
+    // timestamp queries could not be created
+    bool EnableGpuStats( bool enable );
+
+    // Draw the statistics of the last frame as part of every call to 'Render' - pass
+    // a null viewport to turn the panel off
+    void EnableStatsOverlay( Viewport^ viewport, int x, int y );
+
+    // Start recording trace events into a ring of the specified size (zero stops
+    // recording), and write them to a file as Chrome trace JSON
+    bool EnableTrace( int eventCapacity );
+    bool WriteTrace( System::String^ fileName );
+
+    // Retrieve the statistics for the last frame, or averaged over recent frames
+    Stats GetFrameStats();
+    Stats GetRollingStats();
+
 private:
+    static D3D11_VIEWPORT ConvertViewport( Viewport^ viewport );
+    static Stats ConvertStats( const TinyTextStats_c & stats );
+
     TinyTextContext_c* mTinyTextContext;
 };
 